@@ -0,0 +1,669 @@
+#include "Aurorapch.h"
+#include "AssetManager.h"
+
+#include "FileWatcher.h"
+#include "VirtualFileSystem.h"
+#include "Core/JobSystem.h"
+#include "Graphics/CubeTexture.h"
+#include "Graphics/Model.h"
+#include "Graphics/Shader.h"
+#include "Graphics/TextureFile.h"
+#include "Utils/ImageLoader.h"
+
+namespace Aurora {
+
+	struct AssetEntry
+	{
+		AssetMetadata Metadata;
+		Ref<RefCountedObject> Asset;
+
+		uint64_t LastUsedFrame = 0;
+		uint64_t MemorySize = 0;
+	};
+
+	struct PendingLoad
+	{
+		JobCounter Counter;
+		std::vector<AssetManager::LoadCallback> Callbacks;
+		Utils::ImageData Image; // Decoded on a worker, only for uncooked Texture2Ds
+		bool Finished = false;
+	};
+
+	// The new contents of an asset, read by a worker and swapped in by Update
+	struct PendingReload
+	{
+		JobCounter Counter;
+		Utils::ImageData Image; // Uncooked Texture2Ds
+		Ref<ModelImport> Import; // Models
+		bool Valid = false; // False if the file could not be read, the asset keeps what it has then
+	};
+
+	struct AssetManagerData
+	{
+		std::unordered_map<AssetHandle, AssetEntry> Assets;
+		std::unordered_map<std::string, AssetHandle> Registry; // Normalized path -> handle
+
+		// Kept around until their counter is done, the finishing job still touches the counter after it ran
+		std::unordered_map<AssetHandle, Scope<PendingLoad>> PendingLoads;
+
+		FileWatcher* Watcher = nullptr; // Only while hot reload is enabled
+		std::unordered_set<AssetHandle> ReloadRequests;
+		std::unordered_map<AssetHandle, Scope<PendingReload>> PendingReloads;
+		std::unordered_map<uint32_t, AssetManager::ReloadCallback> ReloadCallbacks;
+		uint32_t NextReloadCallbackID = 1;
+
+		uint64_t Budgets[(size_t)AssetType::Count] = {};
+		AssetManager::TypeStats Stats[(size_t)AssetType::Count];
+
+		uint64_t FrameIndex = 0;
+	};
+
+	static AssetManagerData* s_Data = nullptr;
+
+	namespace Utils {
+
+		static uint32_t BytesPerPixel(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::R8I:
+				case ImageFormat::R8UI:        return 1;
+				case ImageFormat::R16I:
+				case ImageFormat::R16UI:
+				case ImageFormat::RG8:         return 2;
+				case ImageFormat::RGB:         return 3;
+				case ImageFormat::RGBA16F:
+				case ImageFormat::RG32F:       return 8;
+				case ImageFormat::RGBA32F:     return 16;
+			}
+
+			return 4;
+		}
+
+		static uint64_t GetTextureMemorySize(const Texture2D& texture)
+		{
+			uint64_t size = 0;
+			for (uint32_t level = texture.GetResidentLevel(); level < texture.GetLevelCount(); level++)
+			{
+				uint32_t width = std::max(texture.GetWidth() >> level, 1u);
+				uint32_t height = std::max(texture.GetHeight() >> level, 1u);
+
+				if (TextureFile::IsBlockCompressed(texture.GetFormat()))
+					size += TextureFile::GetLevelSize(texture.GetFormat(), width, height);
+				else
+					size += (uint64_t)width * height * BytesPerPixel(texture.GetFormat());
+			}
+
+			return size;
+		}
+
+		static uint64_t GetModelMemorySize(const Model& model)
+		{
+			uint64_t size = 0;
+			for (const Mesh& mesh : model.meshes)
+				size += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint32_t);
+
+			return size;
+		}
+
+		// Textures used by models are counted as their own Texture2D assets
+		static uint64_t GetAssetMemorySize(AssetType type, const Ref<RefCountedObject>& asset)
+		{
+			switch (type)
+			{
+				case AssetType::Texture2D:   return GetTextureMemorySize(*static_cast<const Texture2D*>(asset.raw()));
+				case AssetType::CubeTexture:
+				{
+					const CubeTexture& cube = *static_cast<const CubeTexture*>(asset.raw());
+
+					uint64_t size = 0;
+					for (uint32_t level = 0; level < cube.GetLevelCount(); level++)
+						size += cube.GetLevelSize(level);
+
+					return size;
+				}
+				case AssetType::Model:       return GetModelMemorySize(*static_cast<const Model*>(asset.raw()));
+				case AssetType::Shader:      return 0;
+			}
+
+			return 0;
+		}
+
+		// Has to run on the main thread, image is what a worker already decoded for uncooked textures (or empty)
+		static Ref<RefCountedObject> CreateAsset(const AssetMetadata& metadata, const ImageData& image)
+		{
+			AR_PROFILE_FUNCTION();
+
+			if (!VirtualFileSystem::Exists(metadata.FilePath))
+			{
+				AR_CORE_ERROR_TAG("AssetManager", "Asset file '{0}' does not exist!", metadata.FilePath);
+				return nullptr;
+			}
+
+			switch (metadata.Type)
+			{
+				case AssetType::Texture2D:
+				{
+					if (TextureFile::IsTextureFile(metadata.FilePath))
+						return Texture2D::Create(metadata.FilePath, metadata.TextureProps);
+
+					if (image)
+						return Texture2D::Create(metadata.FilePath, image, metadata.TextureProps);
+
+					ImageData decoded = Texture2D::DecodeImage(metadata.FilePath, metadata.TextureProps);
+					if (!decoded)
+					{
+						AR_CORE_ERROR_TAG("AssetManager", "Failed to decode '{0}': {1}", metadata.FilePath, ImageLoader::GetFailureReason());
+						return nullptr;
+					}
+
+					return Texture2D::Create(metadata.FilePath, decoded, metadata.TextureProps);
+				}
+				case AssetType::CubeTexture:
+				{
+					Ref<CubeTexture> cube = CubeTexture::Create(metadata.FilePath);
+					if (!cube->IsLoaded())
+						return nullptr;
+
+					return cube;
+				}
+				case AssetType::Shader:      return Shader::Create(metadata.FilePath);
+				case AssetType::Model:       return Model::Create(metadata.FilePath);
+			}
+
+			AR_CORE_ASSERT(false, "Unknown asset type!");
+			return nullptr;
+		}
+
+		static AssetHandle RegisterAsset(const std::string& filePath, AssetType type, const TextureProperties& props)
+		{
+			std::string path = VirtualFileSystem::NormalizePath(filePath);
+			auto it = s_Data->Registry.find(path);
+			if (it != s_Data->Registry.end())
+			{
+				AR_CORE_ASSERT(s_Data->Assets.at(it->second).Metadata.Type == type, "Path was already imported as another type!");
+				return it->second;
+			}
+
+			AssetMetadata metadata;
+			metadata.Handle = AssetHandle();
+			metadata.Type = type;
+			metadata.FilePath = path;
+			metadata.TextureProps = props;
+
+			s_Data->Registry[path] = metadata.Handle;
+			s_Data->Assets[metadata.Handle].Metadata = metadata;
+
+			return metadata.Handle;
+		}
+
+		static void FinishLoad(AssetHandle handle)
+		{
+			AR_PROFILE_FUNCTION();
+
+			AssetEntry& entry = s_Data->Assets.at(handle);
+			PendingLoad& pending = *s_Data->PendingLoads.at(handle);
+
+			entry.Asset = CreateAsset(entry.Metadata, pending.Image);
+			entry.MemorySize = entry.Asset ? GetAssetMemorySize(entry.Metadata.Type, entry.Asset) : 0;
+			s_Data->Stats[(size_t)entry.Metadata.Type].Loads++;
+
+			pending.Image.Release();
+			pending.Finished = true;
+
+			// A callback is free to start more loads, so they are moved out first
+			std::vector<AssetManager::LoadCallback> callbacks = std::move(pending.Callbacks);
+			Ref<RefCountedObject> asset = entry.Asset;
+			for (const AssetManager::LoadCallback& callback : callbacks)
+			{
+				if (callback)
+					callback(handle, asset);
+			}
+		}
+
+		static void StartReload(AssetHandle handle)
+		{
+			AR_PROFILE_FUNCTION();
+
+			// Assets that are not loaded get the new file the next time they are used anyway
+			const AssetEntry& entry = s_Data->Assets.at(handle);
+			if (!entry.Asset)
+				return;
+
+			if (entry.Metadata.Type != AssetType::Texture2D && entry.Metadata.Type != AssetType::Model)
+			{
+				AR_CORE_WARN_TAG("AssetManager", "'{0}' changed but {1} assets can not be reloaded", entry.Metadata.FilePath, AssetManager::AssetTypeToString(entry.Metadata.Type));
+				return;
+			}
+
+			Scope<PendingReload> reload = CreateScope<PendingReload>();
+			PendingReload* pending = &*reload;
+			s_Data->PendingReloads[handle] = std::move(reload);
+
+			// Only reads the file, nothing touches the asset until FinishReload
+			JobFunction read = [pending, metadata = entry.Metadata]()
+			{
+				if (metadata.Type == AssetType::Model)
+				{
+					pending->Import = ModelImport::Create(metadata.FilePath);
+					pending->Valid = pending->Import->IsValid();
+				}
+				else if (TextureFile::IsTextureFile(metadata.FilePath))
+				{
+					// Cooked textures are read by the texture itself, this only makes sure that is going to work
+					TextureFileInfo info;
+					pending->Valid = TextureFile::ReadInfo(metadata.FilePath, info);
+				}
+				else
+				{
+					pending->Image = Texture2D::DecodeImage(metadata.FilePath, metadata.TextureProps);
+					pending->Valid = (bool)pending->Image;
+				}
+			};
+
+			if (JobSystem::GetWorkerCount() == 0)
+				read();
+			else
+				JobSystem::Execute(read, &pending->Counter);
+		}
+
+		static void FinishReload(AssetHandle handle, PendingReload& pending)
+		{
+			AR_PROFILE_FUNCTION();
+
+			// Copies since rebuilding a model loads its textures, which can grow the asset map
+			Ref<RefCountedObject> asset = s_Data->Assets.at(handle).Asset;
+			AssetMetadata metadata = s_Data->Assets.at(handle).Metadata;
+
+			// Unloaded while it was reloading
+			if (!asset)
+				return;
+
+			if (!pending.Valid)
+			{
+				AR_CORE_ERROR_TAG("AssetManager", "Could not reload '{0}', keeping what was loaded before", metadata.FilePath);
+				return;
+			}
+
+			Timer timer;
+
+			if (metadata.Type == AssetType::Model)
+				static_cast<Model*>(asset.raw())->Reload(*pending.Import);
+			else
+				static_cast<Texture2D*>(asset.raw())->Reload(pending.Image);
+
+			s_Data->Assets.at(handle).MemorySize = GetAssetMemorySize(metadata.Type, asset);
+			s_Data->Stats[(size_t)metadata.Type].Reloads++;
+
+			for (const auto& [id, callback] : s_Data->ReloadCallbacks)
+				callback(handle, asset);
+
+			AR_CORE_INFO_TAG("AssetManager", "Reloaded '{0}' in {1}ms", metadata.FilePath, timer.ElapsedMillis());
+		}
+
+		// This is the frame boundary the reloaded assets change at, nothing is drawing with them while it runs
+		static void UpdateReloads()
+		{
+			AR_PROFILE_FUNCTION();
+
+			if (s_Data->Watcher)
+			{
+				for (const std::string& path : s_Data->Watcher->GetChanges())
+				{
+					auto it = s_Data->Registry.find(path);
+					if (it != s_Data->Registry.end())
+						s_Data->ReloadRequests.insert(it->second);
+				}
+			}
+
+			for (auto it = s_Data->PendingReloads.begin(); it != s_Data->PendingReloads.end();)
+			{
+				if (!it->second->Counter.IsDone())
+				{
+					it++;
+					continue;
+				}
+
+				FinishReload(it->first, *it->second);
+				it = s_Data->PendingReloads.erase(it);
+			}
+
+			// The file changed again after a running reload read it, so that one has to be done before the next one starts
+			for (auto it = s_Data->ReloadRequests.begin(); it != s_Data->ReloadRequests.end();)
+			{
+				if (s_Data->PendingReloads.find(*it) != s_Data->PendingReloads.end())
+				{
+					it++;
+					continue;
+				}
+
+				StartReload(*it);
+				it = s_Data->ReloadRequests.erase(it);
+			}
+		}
+
+	}
+
+	void AssetManager::Init()
+	{
+		AR_CORE_ASSERT(!s_Data, "AssetManager already initialized!");
+
+		s_Data = new AssetManagerData();
+		s_Data->Budgets[(size_t)AssetType::Texture2D] = 512ull * 1024 * 1024;
+		s_Data->Budgets[(size_t)AssetType::CubeTexture] = 256ull * 1024 * 1024;
+		s_Data->Budgets[(size_t)AssetType::Model] = 256ull * 1024 * 1024;
+		s_Data->Budgets[(size_t)AssetType::Shader] = 0;
+	}
+
+	void AssetManager::ShutDown()
+	{
+		// Workers still hold pointers to the pending loads. Finishing a load runs its callbacks which can start new ones, so this
+		// starts over after every wait
+		bool waiting = true;
+		while (waiting)
+		{
+			waiting = false;
+			for (auto& [handle, pending] : s_Data->PendingLoads)
+			{
+				if (!pending->Counter.IsDone())
+				{
+					JobSystem::Wait(pending->Counter);
+					waiting = true;
+					break;
+				}
+			}
+		}
+
+		for (auto& [handle, reload] : s_Data->PendingReloads)
+			JobSystem::Wait(reload->Counter);
+
+		delete s_Data->Watcher;
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	AssetHandle AssetManager::Import(const std::string& filePath, AssetType type)
+	{
+		AR_CORE_ASSERT(type != AssetType::None && type != AssetType::Count, "Invalid asset type!");
+
+		return Utils::RegisterAsset(filePath, type, TextureProperties());
+	}
+
+	AssetHandle AssetManager::ImportTexture(const std::string& filePath, const TextureProperties& props)
+	{
+		return Utils::RegisterAsset(filePath, AssetType::Texture2D, props);
+	}
+
+	AssetHandle AssetManager::GetHandle(const std::string& filePath)
+	{
+		auto it = s_Data->Registry.find(VirtualFileSystem::NormalizePath(filePath));
+
+		return it != s_Data->Registry.end() ? it->second : AssetHandle(0);
+	}
+
+	const AssetMetadata& AssetManager::GetMetadata(AssetHandle handle)
+	{
+		AR_CORE_ASSERT(s_Data->Assets.find(handle) != s_Data->Assets.end(), "Unknown asset handle!");
+
+		return s_Data->Assets.at(handle).Metadata;
+	}
+
+	Ref<RefCountedObject> AssetManager::GetAsset(AssetHandle handle)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(s_Data->Assets.find(handle) != s_Data->Assets.end(), "Unknown asset handle!");
+
+		AssetEntry& entry = s_Data->Assets.at(handle);
+		entry.LastUsedFrame = s_Data->FrameIndex;
+
+		if (entry.Asset)
+		{
+			s_Data->Stats[(size_t)entry.Metadata.Type].CacheHits++;
+			return entry.Asset;
+		}
+
+		auto pendingIt = s_Data->PendingLoads.find(handle);
+		if (pendingIt != s_Data->PendingLoads.end() && !pendingIt->second->Finished)
+		{
+			// The main thread runs its own jobs while waiting so this also finishes the upload
+			JobSystem::Wait(pendingIt->second->Counter);
+			s_Data->PendingLoads.erase(handle);
+
+			return s_Data->Assets.at(handle).Asset;
+		}
+
+		Utils::ImageData noImage;
+		entry.Asset = Utils::CreateAsset(entry.Metadata, noImage);
+		entry.MemorySize = entry.Asset ? Utils::GetAssetMemorySize(entry.Metadata.Type, entry.Asset) : 0;
+		s_Data->Stats[(size_t)entry.Metadata.Type].Loads++;
+
+		return entry.Asset;
+	}
+
+	void AssetManager::LoadAsync(AssetHandle handle, LoadCallback callback)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(s_Data->Assets.find(handle) != s_Data->Assets.end(), "Unknown asset handle!");
+
+		AssetEntry& entry = s_Data->Assets.at(handle);
+		entry.LastUsedFrame = s_Data->FrameIndex;
+
+		if (entry.Asset)
+		{
+			s_Data->Stats[(size_t)entry.Metadata.Type].CacheHits++;
+			if (callback)
+				callback(handle, entry.Asset);
+
+			return;
+		}
+
+		auto pendingIt = s_Data->PendingLoads.find(handle);
+		if (pendingIt != s_Data->PendingLoads.end())
+		{
+			// A load that finished this frame without an asset failed, it is only retried once Update cleaned it up
+			if (!pendingIt->second->Finished)
+				pendingIt->second->Callbacks.push_back(std::move(callback));
+			else if (callback)
+				callback(handle, nullptr);
+
+			return;
+		}
+
+		// Without workers there is nothing to overlap the load with
+		if (JobSystem::GetWorkerCount() == 0)
+		{
+			Ref<RefCountedObject> asset = GetAsset(handle);
+			if (callback)
+				callback(handle, asset);
+
+			return;
+		}
+
+		Scope<PendingLoad> load = CreateScope<PendingLoad>();
+		load->Callbacks.push_back(std::move(callback));
+		PendingLoad* pending = &*load;
+		s_Data->PendingLoads[handle] = std::move(load);
+
+		JobFunction finish = [handle]() { Utils::FinishLoad(handle); };
+
+		const AssetMetadata& metadata = entry.Metadata;
+		if (metadata.Type == AssetType::Texture2D && !TextureFile::IsTextureFile(metadata.FilePath))
+		{
+			// The finishing job goes on the same counter before the decoding one is done, so the counter only hits zero after the upload
+			JobSystem::Execute([pending, filePath = metadata.FilePath, props = metadata.TextureProps, finish]()
+			{
+				pending->Image = Texture2D::DecodeImage(filePath, props);
+				JobSystem::ExecuteOnMainThread(finish, &pending->Counter);
+			}, &pending->Counter);
+		}
+		else
+		{
+			JobSystem::ExecuteOnMainThread(finish, &pending->Counter);
+		}
+	}
+
+	bool AssetManager::IsLoaded(AssetHandle handle)
+	{
+		auto it = s_Data->Assets.find(handle);
+
+		return it != s_Data->Assets.end() && it->second.Asset;
+	}
+
+	void AssetManager::Update()
+	{
+		AR_PROFILE_FUNCTION();
+
+		s_Data->FrameIndex++;
+
+		for (auto it = s_Data->PendingLoads.begin(); it != s_Data->PendingLoads.end();)
+		{
+			if (it->second->Finished && it->second->Counter.IsDone())
+				it = s_Data->PendingLoads.erase(it);
+			else
+				it++;
+		}
+
+		Utils::UpdateReloads();
+
+		uint64_t usage[(size_t)AssetType::Count] = {};
+		for (auto& [handle, entry] : s_Data->Assets)
+		{
+			if (!entry.Asset)
+				continue;
+
+			// Anything still referenced outside of the manager counts as used this frame
+			if (entry.Asset->GetRefCount() > 1)
+				entry.LastUsedFrame = s_Data->FrameIndex;
+
+			// Streamed textures change size every frame
+			entry.MemorySize = Utils::GetAssetMemorySize(entry.Metadata.Type, entry.Asset);
+			usage[(size_t)entry.Metadata.Type] += entry.MemorySize;
+		}
+
+		for (size_t type = 0; type < (size_t)AssetType::Count; type++)
+		{
+			uint64_t budget = s_Data->Budgets[type];
+			if (budget == 0 || usage[type] <= budget)
+				continue;
+
+			std::vector<AssetEntry*> unused;
+			for (auto& [handle, entry] : s_Data->Assets)
+			{
+				if ((size_t)entry.Metadata.Type == type && entry.Asset && entry.Asset->GetRefCount() == 1)
+					unused.push_back(&entry);
+			}
+
+			std::sort(unused.begin(), unused.end(), [](const AssetEntry* a, const AssetEntry* b) { return a->LastUsedFrame < b->LastUsedFrame; });
+
+			for (AssetEntry* entry : unused)
+			{
+				if (usage[type] <= budget)
+					break;
+
+				usage[type] -= entry->MemorySize;
+				entry->Asset = nullptr;
+				entry->MemorySize = 0;
+				s_Data->Stats[type].Evictions++;
+			}
+
+			if (usage[type] > budget)
+				AR_CORE_WARN_TAG("AssetManager", "{0} assets in use take {1} MB, over their budget of {2} MB", AssetTypeToString((AssetType)type), usage[type] / (1024 * 1024), budget / (1024 * 1024));
+		}
+	}
+
+	void AssetManager::Reload(AssetHandle handle)
+	{
+		AR_CORE_ASSERT(s_Data->Assets.find(handle) != s_Data->Assets.end(), "Unknown asset handle!");
+
+		s_Data->ReloadRequests.insert(handle);
+	}
+
+	void AssetManager::EnableHotReload(const std::string& directory)
+	{
+		if (s_Data->Watcher && s_Data->Watcher->GetDirectory() == directory)
+			return;
+
+		delete s_Data->Watcher;
+		s_Data->Watcher = new FileWatcher(directory);
+	}
+
+	void AssetManager::DisableHotReload()
+	{
+		delete s_Data->Watcher;
+		s_Data->Watcher = nullptr;
+	}
+
+	bool AssetManager::IsHotReloadEnabled()
+	{
+		return s_Data->Watcher != nullptr;
+	}
+
+	uint32_t AssetManager::AddReloadCallback(ReloadCallback callback)
+	{
+		uint32_t id = s_Data->NextReloadCallbackID++;
+		s_Data->ReloadCallbacks[id] = std::move(callback);
+
+		return id;
+	}
+
+	void AssetManager::RemoveReloadCallback(uint32_t id)
+	{
+		// Scenes can outlive the manager at shutdown
+		if (s_Data)
+			s_Data->ReloadCallbacks.erase(id);
+	}
+
+	void AssetManager::SetBudget(AssetType type, uint64_t bytes)
+	{
+		s_Data->Budgets[(size_t)type] = bytes;
+	}
+
+	uint64_t AssetManager::GetBudget(AssetType type)
+	{
+		return s_Data->Budgets[(size_t)type];
+	}
+
+	AssetManager::TypeStats AssetManager::GetStats(AssetType type)
+	{
+		TypeStats stats = s_Data->Stats[(size_t)type];
+		stats.Budget = s_Data->Budgets[(size_t)type];
+
+		for (const auto& [handle, entry] : s_Data->Assets)
+		{
+			if (entry.Metadata.Type != type || !entry.Asset)
+				continue;
+
+			stats.LoadedCount++;
+			stats.MemoryUsage += entry.MemorySize;
+			if (entry.Asset->GetRefCount() > 1)
+				stats.UsedCount++;
+		}
+
+		for (const auto& [handle, pending] : s_Data->PendingLoads)
+		{
+			if (!pending->Finished && s_Data->Assets.at(handle).Metadata.Type == type)
+				stats.PendingCount++;
+		}
+
+		return stats;
+	}
+
+	const char* AssetManager::AssetTypeToString(AssetType type)
+	{
+		switch (type)
+		{
+			case AssetType::None:        return "None";
+			case AssetType::Texture2D:   return "Texture2D";
+			case AssetType::CubeTexture: return "CubeTexture";
+			case AssetType::Shader:      return "Shader";
+			case AssetType::Model:       return "Model";
+		}
+
+		AR_CORE_ASSERT(false, "Unknown asset type!");
+		return "";
+	}
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+ * Every texture, cube map, shader and model file is loaded through here exactly once no matter how many things use it, so two
+ * entities with the same model or texture share the one GPU copy.
+ *
+ * Files are registered under a 64 bit AssetHandle the first time they are imported, importing the same (normalized) path again
+ * gives back the same handle. Loading a handle that is already loaded or loading just hands out another Ref to it, an async load
+ * of an asset that is already in flight only adds its callback to the load that is running.
+ *
+ * The manager keeps its own Ref to everything that is loaded. When that is the only Ref left the asset is unused, it stays loaded
+ * so that using it again is free, until its type goes over its memory budget. Update then unloads the unused assets of that type
+ * in least recently used order until it fits again. Assets that are in use are never unloaded, the budget can be exceeded by them.
+ *
+ * Only the decoding of source images happens on the JobSystem's workers. Everything that needs the GL context (uploading, shader
+ * compilation, building the meshes of models) runs as a main thread job, so an async load never stalls the frame that started it.
+ *
+ * With hot reload enabled a FileWatcher watches the resources, and loaded textures and models whose files changed are reloaded.
+ * The workers decode the image or import the model, and the next Update swaps the result into the asset that is already loaded.
+ * The asset stays the same object, so the handle and every Ref to it stay valid and see the new contents from that frame on.
+ */
+
+#include "Core/Base.h"
+#include "Core/UUID.h"
+#include "Graphics/Texture.h"
+
+#include <functional>
+#include <string>
+
+namespace Aurora {
+
+	class CubeTexture;
+	class Model;
+	class Shader;
+
+	using AssetHandle = UUID;
+
+	enum class AssetType : uint8_t
+	{
+		None = 0,
+		Texture2D,
+		CubeTexture,
+		Shader,
+		Model,
+
+		Count
+	};
+
+	template<typename T> struct AssetTypeOf;
+	template<> struct AssetTypeOf<Texture2D>   { static constexpr AssetType Type = AssetType::Texture2D; };
+	template<> struct AssetTypeOf<CubeTexture> { static constexpr AssetType Type = AssetType::CubeTexture; };
+	template<> struct AssetTypeOf<Shader>      { static constexpr AssetType Type = AssetType::Shader; };
+	template<> struct AssetTypeOf<Model>       { static constexpr AssetType Type = AssetType::Model; };
+
+	struct AssetMetadata
+	{
+		AssetHandle Handle = 0;
+		AssetType Type = AssetType::None;
+		std::string FilePath;
+		TextureProperties TextureProps; // Only used by Texture2D assets
+	};
+
+	class AssetManager
+	{
+	public:
+		// Called on the main thread once the asset is loaded, the asset is null if it failed to load
+		using LoadCallback = std::function<void(AssetHandle handle, const Ref<RefCountedObject>& asset)>;
+		// Called on the main thread right after an asset got its new contents, for whoever baked something out of the old ones
+		using ReloadCallback = std::function<void(AssetHandle handle, const Ref<RefCountedObject>& asset)>;
+
+		struct TypeStats
+		{
+			uint32_t LoadedCount = 0;
+			uint32_t UsedCount = 0; // Referenced by something other than the manager
+			uint32_t PendingCount = 0;
+			uint64_t MemoryUsage = 0;
+			uint64_t Budget = 0; // 0 means there is no budget
+			uint64_t Loads = 0;
+			uint64_t CacheHits = 0;
+			uint64_t Evictions = 0;
+			uint64_t Reloads = 0;
+		};
+
+	public:
+		static void Init();
+		static void ShutDown();
+
+		static AssetHandle Import(const std::string& filePath, AssetType type);
+		// Properties only apply to the first import of the path, later imports get the texture that was already imported
+		static AssetHandle ImportTexture(const std::string& filePath, const TextureProperties& props);
+		// 0 if the path was never imported
+		static AssetHandle GetHandle(const std::string& filePath);
+		static const AssetMetadata& GetMetadata(AssetHandle handle);
+
+		// Blocks until the asset is loaded, if an async load of it is in flight it waits for that one
+		static Ref<RefCountedObject> GetAsset(AssetHandle handle);
+		static void LoadAsync(AssetHandle handle, LoadCallback callback = nullptr);
+		static bool IsLoaded(AssetHandle handle);
+
+		template<typename T>
+		static Ref<T> Get(AssetHandle handle)
+		{
+			AR_CORE_ASSERT(GetMetadata(handle).Type == AssetTypeOf<T>::Type, "Asset is of another type!");
+
+			Ref<RefCountedObject> asset = GetAsset(handle);
+			return Ref<T>(static_cast<T*>(asset.raw()));
+		}
+
+		template<typename T>
+		static Ref<T> Load(const std::string& filePath)
+		{
+			return Get<T>(Import(filePath, AssetTypeOf<T>::Type));
+		}
+
+		static Ref<Texture2D> LoadTexture(const std::string& filePath, const TextureProperties& props)
+		{
+			return Get<Texture2D>(ImportTexture(filePath, props));
+		}
+
+		// Once per frame on the main thread. Swaps in the assets that finished reloading and unloads unused assets of the types that
+		// are over their budget
+		static void Update();
+
+		// Reloads the asset if it is loaded, only Texture2D and Model assets can be reloaded for now. If the asset is already being
+		// reloaded it goes again once that is done
+		static void Reload(AssetHandle handle);
+
+		// Reloads the assets whose files in the directory changed, see FileWatcher.h
+		static void EnableHotReload(const std::string& directory = "Resources");
+		static void DisableHotReload();
+		static bool IsHotReloadEnabled();
+
+		// Returns the id to remove it with
+		static uint32_t AddReloadCallback(ReloadCallback callback);
+		static void RemoveReloadCallback(uint32_t id);
+
+		static void SetBudget(AssetType type, uint64_t bytes);
+		static uint64_t GetBudget(AssetType type);
+		static TypeStats GetStats(AssetType type);
+
+		static const char* AssetTypeToString(AssetType type);
+
+	};
+
+}
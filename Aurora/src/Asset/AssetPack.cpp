@@ -0,0 +1,330 @@
+#include "Aurorapch.h"
+#include "AssetPack.h"
+
+#include "VirtualFileSystem.h"
+#include "Core/JobSystem.h"
+#include "Utils/LZ4.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static constexpr Byte AssetPackIdentifier[8] = { 'A', 'P', 'A', 'K', '\r', '\n', 0x1A, '\n' };
+		static constexpr uint32_t AssetPackVersion = 1;
+		static constexpr uint64_t AssetPackAlignment = 16;
+
+		struct AssetPackHeader
+		{
+			Byte Identifier[8];
+			uint32_t Version;
+			uint32_t EntryCount;
+			uint64_t TableOffset;
+			uint64_t PathsOffset;
+			uint64_t PathsSize;
+		};
+
+		static uint64_t AlignPackOffset(uint64_t offset)
+		{
+			return (offset + AssetPackAlignment - 1) & ~(AssetPackAlignment - 1);
+		}
+
+		static bool IsStoredExtension(const std::filesystem::path& path, const AssetPackBuildSettings& settings)
+		{
+			std::string extension = path.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+
+			return std::find(settings.StoredExtensions.begin(), settings.StoredExtensions.end(), extension) != settings.StoredExtensions.end();
+		}
+
+		// A file on its way into a pack
+		struct PackedFile
+		{
+			std::string Path;
+			std::vector<Byte> Data; // What goes into the pack, compressed or not
+			uint64_t Size = 0;
+			bool Compressed = false;
+			bool Valid = false;
+		};
+
+		static void PackFile(PackedFile& file, const AssetPackBuildSettings& settings)
+		{
+			AR_PROFILE_FUNCTION();
+
+			// Always the loose file, even if a mounted pack has one under the same path
+			std::ifstream stream(file.Path, std::ios::binary | std::ios::ate);
+			if (!stream)
+				return;
+
+			std::vector<Byte> contents((size_t)stream.tellg());
+			stream.seekg(0, std::ios::beg);
+			if (!stream.read((char*)contents.data(), contents.size()))
+				return;
+
+			file.Size = contents.size();
+			file.Valid = true;
+
+			if (!contents.empty() && !IsStoredExtension(file.Path, settings))
+			{
+				std::vector<Byte> compressed(LZ4::GetCompressBound(contents.size()));
+				size_t compressedSize = LZ4::Compress(contents.data(), contents.size(), compressed.data(), compressed.size());
+				if (compressedSize && compressedSize <= (size_t)(contents.size() * settings.MaxCompressionRatio))
+				{
+					compressed.resize(compressedSize);
+					file.Data = std::move(compressed);
+					file.Compressed = true;
+
+					return;
+				}
+			}
+
+			file.Data = std::move(contents);
+		}
+
+	}
+
+	AssetPack::AssetPack(const std::string& filePath)
+		: m_FilePath(filePath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!Map())
+		{
+			AR_CORE_ERROR_TAG("AssetPack", "'{0}' could not be mapped or is not a valid asset pack!", filePath);
+			Unmap();
+		}
+	}
+
+	AssetPack::~AssetPack()
+	{
+		Unmap();
+	}
+
+	Ref<AssetPack> AssetPack::Create(const std::string& filePath)
+	{
+		return CreateRef<AssetPack>(filePath);
+	}
+
+	bool AssetPack::Map()
+	{
+		HANDLE file = CreateFileA(m_FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		m_FileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart < sizeof(Utils::AssetPackHeader))
+			return false;
+
+		m_Size = (uint64_t)size.QuadPart;
+
+		m_MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_MappingHandle)
+			return false;
+
+		m_Data = (const Byte*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (!m_Data)
+			return false;
+
+		Utils::AssetPackHeader header;
+		memcpy(&header, m_Data, sizeof(Utils::AssetPackHeader));
+
+		bool valid = memcmp(header.Identifier, Utils::AssetPackIdentifier, sizeof(header.Identifier)) == 0
+			&& header.Version == Utils::AssetPackVersion
+			&& header.TableOffset % alignof(AssetPackEntry) == 0
+			&& header.TableOffset <= m_Size && (uint64_t)header.EntryCount * sizeof(AssetPackEntry) <= m_Size - header.TableOffset
+			&& header.PathsOffset <= m_Size && header.PathsSize <= m_Size - header.PathsOffset;
+
+		if (!valid)
+			return false;
+
+		const AssetPackEntry* entries = (const AssetPackEntry*)(m_Data + header.TableOffset);
+		for (uint32_t i = 0; i < header.EntryCount; i++)
+		{
+			const AssetPackEntry& entry = entries[i];
+			if (entry.DataOffset > m_Size || entry.StoredSize > m_Size - entry.DataOffset || (uint64_t)entry.PathOffset + entry.PathLength > header.PathsSize)
+				return false;
+
+			if (!IsCompressed(entry) && entry.StoredSize != entry.Size)
+				return false;
+		}
+
+		m_Entries = entries;
+		m_EntryCount = header.EntryCount;
+		m_Paths = (const char*)(m_Data + header.PathsOffset);
+		m_PathsSize = header.PathsSize;
+
+		return true;
+	}
+
+	void AssetPack::Unmap()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Entries = nullptr;
+		m_EntryCount = 0;
+		m_Paths = nullptr;
+		m_PathsSize = 0;
+	}
+
+	const AssetPackEntry* AssetPack::FindEntry(std::string_view path) const
+	{
+		const AssetPackEntry* end = m_Entries + m_EntryCount;
+		const AssetPackEntry* it = std::lower_bound(m_Entries, end, path, [this](const AssetPackEntry& entry, std::string_view value)
+		{
+			return GetEntryPath(entry) < value;
+		});
+
+		if (it != end && GetEntryPath(*it) == path)
+			return it;
+
+		return nullptr;
+	}
+
+	std::string_view AssetPack::GetEntryPath(const AssetPackEntry& entry) const
+	{
+		return std::string_view(m_Paths + entry.PathOffset, entry.PathLength);
+	}
+
+	bool AssetPack::ReadEntry(const AssetPackEntry& entry, Byte* outData) const
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!IsCompressed(entry))
+		{
+			memcpy(outData, GetEntryData(entry), entry.Size);
+			return true;
+		}
+
+		if (!Utils::LZ4::Decompress(GetEntryData(entry), entry.StoredSize, outData, entry.Size))
+		{
+			AR_CORE_ERROR_TAG("AssetPack", "Entry '{0}' of '{1}' is corrupted!", GetEntryPath(entry), m_FilePath);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool AssetPack::Build(const std::string& packPath, const std::vector<std::string>& filePaths, const AssetPackBuildSettings& settings)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("AssetPack::Build");
+
+		std::vector<Utils::PackedFile> files(filePaths.size());
+		for (size_t i = 0; i < filePaths.size(); i++)
+			files[i].Path = VirtualFileSystem::NormalizePath(filePaths[i]);
+
+		// The table of contents is looked up with a binary search
+		std::sort(files.begin(), files.end(), [](const Utils::PackedFile& a, const Utils::PackedFile& b) { return a.Path < b.Path; });
+		for (size_t i = 1; i < files.size(); i++)
+		{
+			if (files[i].Path == files[i - 1].Path)
+			{
+				AR_CORE_ERROR_TAG("AssetPack", "'{0}' was given more than once!", files[i].Path);
+				return false;
+			}
+		}
+
+		JobSystem::ParallelFor((uint32_t)files.size(), 1, [&](uint32_t i)
+		{
+			Utils::PackFile(files[i], settings);
+		});
+
+		Utils::AssetPackHeader header = {};
+		memcpy(header.Identifier, Utils::AssetPackIdentifier, sizeof(header.Identifier));
+		header.Version = Utils::AssetPackVersion;
+		header.EntryCount = (uint32_t)files.size();
+
+		std::vector<AssetPackEntry> entries(files.size());
+		std::string paths;
+		uint64_t offset = Utils::AlignPackOffset(sizeof(Utils::AssetPackHeader));
+		uint64_t originalSize = 0;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			const Utils::PackedFile& file = files[i];
+			if (!file.Valid)
+			{
+				AR_CORE_ERROR_TAG("AssetPack", "Could not read '{0}'!", file.Path);
+				return false;
+			}
+
+			AssetPackEntry& entry = entries[i];
+			entry.DataOffset = offset;
+			entry.StoredSize = file.Data.size();
+			entry.Size = file.Size;
+			entry.PathOffset = (uint32_t)paths.size();
+			entry.PathLength = (uint32_t)file.Path.size();
+			entry.Flags = file.Compressed ? EntryFlagCompressed : 0;
+			entry.Reserved = 0;
+
+			paths += file.Path;
+			offset = Utils::AlignPackOffset(offset + entry.StoredSize);
+			originalSize += file.Size;
+		}
+
+		header.TableOffset = offset;
+		header.PathsOffset = offset + entries.size() * sizeof(AssetPackEntry);
+		header.PathsSize = paths.size();
+
+		FILE* f;
+		fopen_s(&f, packPath.c_str(), "wb");
+		if (!f)
+		{
+			AR_CORE_ERROR_TAG("AssetPack", "Could not open '{0}' for writing!", packPath);
+			return false;
+		}
+
+		static constexpr Byte padding[Utils::AssetPackAlignment] = {};
+
+		fwrite(&header, sizeof(Utils::AssetPackHeader), 1, f);
+		uint64_t written = sizeof(Utils::AssetPackHeader);
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			fwrite(padding, 1, entries[i].DataOffset - written, f);
+			fwrite(files[i].Data.data(), 1, files[i].Data.size(), f);
+			written = entries[i].DataOffset + entries[i].StoredSize;
+		}
+
+		fwrite(padding, 1, header.TableOffset - written, f);
+		fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), f);
+		fwrite(paths.data(), 1, paths.size(), f);
+
+		bool valid = ferror(f) == 0;
+		fclose(f);
+
+		if (!valid)
+		{
+			AR_CORE_ERROR_TAG("AssetPack", "Failed to write '{0}'!", packPath);
+			return false;
+		}
+
+		AR_CORE_INFO_TAG("AssetPack", "Packed {0} files into '{1}', {2} MB -> {3} MB", files.size(), packPath, originalSize / (1024 * 1024), header.PathsOffset / (1024 * 1024));
+
+		return true;
+	}
+
+	bool AssetPack::BuildFromDirectory(const std::string& packPath, const std::string& directory, const AssetPackBuildSettings& settings)
+	{
+		std::vector<std::string> filePaths;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+		{
+			// Other packs in the directory would just get packed twice
+			if (entry.is_regular_file() && entry.path().extension() != Extension)
+				filePaths.push_back(entry.path().generic_string());
+		}
+
+		return Build(packPath, filePaths, settings);
+	}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+ * An asset pack (.apak) is a lot of files bundled into one, so that loading them is one open and a memory map instead of an open,
+ * a few seeks and a close per file. The layout is:
+ *  - A header
+ *  - The data of the entries, every entry starts on a 16 byte boundary so pointers into the mapping are aligned
+ *  - The table of contents, sorted by path so that looking an entry up is a binary search
+ *  - The paths of the entries, one after the other without terminators
+ *
+ * Entries are stored either as they are or as a single LZ4 block (see Utils/LZ4.h), whichever the builder decided on. The pack is
+ * read through a memory map, the data of stored entries is used straight out of the mapping without being copied anywhere.
+ * Paths in the pack are the same relative paths the engine loads files with ("Resources/textures/..."), normalized the same way as
+ * the VirtualFileSystem normalizes the paths it is asked for.
+ *
+ * Packs are only read by the engine, use the VirtualFileSystem to get at their contents. Build makes them.
+ */
+
+#include "Core/Base.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Aurora {
+
+	// One entry of the table of contents, this is also its on disk layout
+	struct AssetPackEntry
+	{
+		uint64_t DataOffset;
+		uint64_t StoredSize; // Size in the pack
+		uint64_t Size; // Size once decompressed
+		uint32_t PathOffset; // Into the path table
+		uint32_t PathLength;
+		uint32_t Flags;
+		uint32_t Reserved;
+	};
+
+	struct AssetPackBuildSettings
+	{
+		// An entry is only compressed if that makes it at most this big (relative to the original), otherwise decompressing it
+		// costs more than the I/O it saves
+		float MaxCompressionRatio = 0.9f;
+		// Never compressed, so they can be read in parts straight out of the mapping. Cooked textures stream their levels one at a
+		// time and their block compressed data does not compress well anyway
+		std::vector<std::string> StoredExtensions = { ".atex" };
+	};
+
+	class AssetPack : public RefCountedObject
+	{
+	public:
+		static constexpr const char* Extension = ".apak";
+		static constexpr uint32_t EntryFlagCompressed = 1 << 0;
+
+	public:
+		AssetPack(const std::string& filePath);
+		virtual ~AssetPack();
+
+		static Ref<AssetPack> Create(const std::string& filePath);
+
+		// Packs up the files, which are stored under the paths they are given with. The files are compressed on the JobSystem's workers
+		static bool Build(const std::string& packPath, const std::vector<std::string>& filePaths, const AssetPackBuildSettings& settings = AssetPackBuildSettings());
+		// Every file in the directory and its sub directories
+		static bool BuildFromDirectory(const std::string& packPath, const std::string& directory, const AssetPackBuildSettings& settings = AssetPackBuildSettings());
+
+		// path has to be normalized already (see VirtualFileSystem::NormalizePath), nullptr if the pack does not have it
+		const AssetPackEntry* FindEntry(std::string_view path) const;
+
+		// Straight into the mapping, for compressed entries this is the compressed data
+		[[nodiscard]] const Byte* GetEntryData(const AssetPackEntry& entry) const { return m_Data + entry.DataOffset; }
+		[[nodiscard]] std::string_view GetEntryPath(const AssetPackEntry& entry) const;
+		[[nodiscard]] static bool IsCompressed(const AssetPackEntry& entry) { return entry.Flags & EntryFlagCompressed; }
+
+		// outData has to be entry.Size bytes, works for both stored and compressed entries
+		bool ReadEntry(const AssetPackEntry& entry, Byte* outData) const;
+
+		[[nodiscard]] inline const AssetPackEntry* GetEntries() const { return m_Entries; }
+		[[nodiscard]] inline uint32_t GetEntryCount() const { return m_EntryCount; }
+		[[nodiscard]] inline const std::string& GetFilePath() const { return m_FilePath; }
+		// False if the file could not be mapped or is not a valid pack, the pack is empty then
+		[[nodiscard]] inline bool IsLoaded() const { return m_Entries != nullptr; }
+
+	private:
+		bool Map();
+		void Unmap();
+
+	private:
+		std::string m_FilePath;
+
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+		const Byte* m_Data = nullptr;
+		uint64_t m_Size = 0;
+
+		const AssetPackEntry* m_Entries = nullptr;
+		uint32_t m_EntryCount = 0;
+		const char* m_Paths = nullptr;
+		uint64_t m_PathsSize = 0;
+
+	};
+
+}
@@ -0,0 +1,312 @@
+#include "Aurorapch.h"
+#include "FileWatcher.h"
+
+#include "VirtualFileSystem.h"
+
+#include <chrono>
+#include <mutex>
+
+#if defined(__linux__)
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+namespace Aurora {
+
+	using FileWatcherClock = std::chrono::steady_clock;
+
+	struct FileWatcherData
+	{
+		std::thread Thread;
+		bool Watching = false;
+
+		std::mutex ChangesMutex;
+		std::unordered_map<std::string, FileWatcherClock::time_point> Changes; // Path -> when it last changed
+
+#if defined(AURORA_PLATFORM_WINDOWS)
+		HANDLE DirectoryHandle = INVALID_HANDLE_VALUE;
+		HANDLE StopEvent = nullptr;
+#elif defined(__linux__)
+		int INotify = -1;
+		int StopPipe[2] = { -1, -1 };
+		std::unordered_map<int, std::filesystem::path> WatchedDirectories; // Watch descriptor -> directory, the thread owns it once it runs
+#endif
+	};
+
+	namespace Utils {
+
+		static void RecordChange(FileWatcherData& data, const std::filesystem::path& path)
+		{
+			std::string normalized = VirtualFileSystem::NormalizePath(path.string());
+
+			std::scoped_lock<std::mutex> lock(data.ChangesMutex);
+			data.Changes[normalized] = FileWatcherClock::now();
+		}
+
+#if defined(AURORA_PLATFORM_WINDOWS)
+
+		static void WatchThreadFunc(FileWatcherData& data, std::filesystem::path directory)
+		{
+			OVERLAPPED overlapped = {};
+			overlapped.hEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+
+			// The notifications are DWORD aligned so the buffer has to be too
+			std::vector<DWORD> buffer(64 * 1024 / sizeof(DWORD));
+			constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+			while (true)
+			{
+				if (!ReadDirectoryChangesW(data.DirectoryHandle, buffer.data(), (DWORD)(buffer.size() * sizeof(DWORD)), TRUE, filter, nullptr, &overlapped, nullptr))
+				{
+					AR_CORE_ERROR_TAG("FileWatcher", "Stopped watching '{0}', ReadDirectoryChangesW failed ({1})", directory.string(), GetLastError());
+					break;
+				}
+
+				HANDLE events[2] = { overlapped.hEvent, data.StopEvent };
+				DWORD result = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+
+				DWORD bytes = 0;
+				if (result != WAIT_OBJECT_0)
+				{
+					// The read writes into the buffer until it is cancelled, so it has to be done before the buffer goes away
+					CancelIo(data.DirectoryHandle);
+					GetOverlappedResult(data.DirectoryHandle, &overlapped, &bytes, TRUE);
+					break;
+				}
+
+				if (!GetOverlappedResult(data.DirectoryHandle, &overlapped, &bytes, FALSE))
+					break;
+
+				// Nothing means there were more changes than fit into the buffer and all of them were dropped
+				if (bytes == 0)
+				{
+					AR_CORE_WARN_TAG("FileWatcher", "Too many changes in '{0}' at once, some of them were missed", directory.string());
+					continue;
+				}
+
+				const Byte* notification = (const Byte*)buffer.data();
+				while (true)
+				{
+					const FILE_NOTIFY_INFORMATION& info = *(const FILE_NOTIFY_INFORMATION*)notification;
+					if (info.Action == FILE_ACTION_ADDED || info.Action == FILE_ACTION_MODIFIED || info.Action == FILE_ACTION_RENAMED_NEW_NAME)
+					{
+						std::filesystem::path path = directory / std::wstring(info.FileName, info.FileNameLength / sizeof(WCHAR));
+
+						// Directories count as modified whenever something in them is
+						std::error_code error;
+						if (std::filesystem::is_regular_file(path, error))
+							RecordChange(data, path);
+					}
+
+					if (info.NextEntryOffset == 0)
+						break;
+
+					notification += info.NextEntryOffset;
+				}
+			}
+
+			CloseHandle(overlapped.hEvent);
+		}
+
+		static bool StartWatching(FileWatcherData& data, const std::string& directory)
+		{
+			data.DirectoryHandle = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			if (data.DirectoryHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			data.StopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+			data.Thread = std::thread(WatchThreadFunc, std::ref(data), std::filesystem::path(directory));
+
+			return true;
+		}
+
+		static void StopWatching(FileWatcherData& data)
+		{
+			if (data.Thread.joinable())
+			{
+				SetEvent(data.StopEvent);
+				data.Thread.join();
+			}
+
+			if (data.StopEvent)
+				CloseHandle(data.StopEvent);
+
+			if (data.DirectoryHandle != INVALID_HANDLE_VALUE)
+				CloseHandle(data.DirectoryHandle);
+		}
+
+#elif defined(__linux__)
+
+		// inotify is not recursive, every directory needs a watch of its own. Files only count once they are closed after writing
+		// or moved in, that is when they are complete
+		static void AddWatches(FileWatcherData& data, const std::filesystem::path& directory)
+		{
+			int descriptor = inotify_add_watch(data.INotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+			if (descriptor < 0)
+			{
+				AR_CORE_WARN_TAG("FileWatcher", "Could not watch '{0}'", directory.string());
+				return;
+			}
+
+			data.WatchedDirectories[descriptor] = directory;
+
+			std::error_code error;
+			for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+			{
+				if (entry.is_directory(error))
+					AddWatches(data, entry.path());
+			}
+		}
+
+		static void WatchThreadFunc(FileWatcherData& data)
+		{
+			alignas(inotify_event) char buffer[16 * 1024];
+			pollfd descriptors[2] = { { data.INotify, POLLIN, 0 }, { data.StopPipe[0], POLLIN, 0 } };
+
+			while (true)
+			{
+				if (poll(descriptors, 2, -1) < 0)
+				{
+					if (errno == EINTR)
+						continue;
+
+					break;
+				}
+
+				if (descriptors[1].revents)
+					break;
+
+				ssize_t length = read(data.INotify, buffer, sizeof(buffer));
+				if (length <= 0)
+					continue;
+
+				for (const char* it = buffer; it < buffer + length;)
+				{
+					const inotify_event& event = *(const inotify_event*)it;
+					it += sizeof(inotify_event) + event.len;
+
+					if (event.mask & IN_Q_OVERFLOW)
+					{
+						AR_CORE_WARN_TAG("FileWatcher", "Too many changes at once, some of them were missed");
+						continue;
+					}
+
+					// The directory is gone
+					if (event.mask & IN_IGNORED)
+					{
+						data.WatchedDirectories.erase(event.wd);
+						continue;
+					}
+
+					auto directory = data.WatchedDirectories.find(event.wd);
+					if (directory == data.WatchedDirectories.end() || event.len == 0)
+						continue;
+
+					std::filesystem::path path = directory->second / event.name;
+					if (event.mask & IN_ISDIR)
+						AddWatches(data, path);
+					else if (event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+						RecordChange(data, path);
+				}
+			}
+		}
+
+		static bool StartWatching(FileWatcherData& data, const std::string& directory)
+		{
+			data.INotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (data.INotify < 0)
+				return false;
+
+			if (pipe(data.StopPipe) != 0)
+				return false;
+
+			AddWatches(data, directory);
+			if (data.WatchedDirectories.empty())
+				return false;
+
+			data.Thread = std::thread(WatchThreadFunc, std::ref(data));
+
+			return true;
+		}
+
+		static void StopWatching(FileWatcherData& data)
+		{
+			if (data.Thread.joinable())
+			{
+				char stop = 1;
+				write(data.StopPipe[1], &stop, 1);
+				data.Thread.join();
+			}
+
+			for (int descriptor : { data.INotify, data.StopPipe[0], data.StopPipe[1] })
+			{
+				if (descriptor >= 0)
+					close(descriptor);
+			}
+		}
+
+#else
+
+		static bool StartWatching(FileWatcherData& data, const std::string& directory)
+		{
+			return false;
+		}
+
+		static void StopWatching(FileWatcherData& data)
+		{
+		}
+
+#endif
+
+	}
+
+	FileWatcher::FileWatcher(const std::string& directory)
+		: m_Directory(directory), m_Data(new FileWatcherData())
+	{
+		AR_PROFILE_FUNCTION();
+
+		m_Data->Watching = Utils::StartWatching(*m_Data, directory);
+
+		if (m_Data->Watching)
+			AR_CORE_INFO_TAG("FileWatcher", "Watching '{0}' for changes", directory);
+		else
+			AR_CORE_WARN_TAG("FileWatcher", "Could not watch '{0}' for changes!", directory);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Utils::StopWatching(*m_Data);
+
+		delete m_Data;
+		m_Data = nullptr;
+	}
+
+	std::vector<std::string> FileWatcher::GetChanges(float settleTime)
+	{
+		std::vector<std::string> changes;
+		FileWatcherClock::time_point settled = FileWatcherClock::now() - std::chrono::duration_cast<FileWatcherClock::duration>(std::chrono::duration<float>(settleTime));
+
+		std::scoped_lock<std::mutex> lock(m_Data->ChangesMutex);
+		for (auto it = m_Data->Changes.begin(); it != m_Data->Changes.end();)
+		{
+			if (it->second <= settled)
+			{
+				changes.push_back(it->first);
+				it = m_Data->Changes.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+
+		return changes;
+	}
+
+	bool FileWatcher::IsWatching() const
+	{
+		return m_Data->Watching;
+	}
+
+}
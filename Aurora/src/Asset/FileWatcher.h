@@ -0,0 +1,44 @@
+#pragma once
+
+/*
+ * Watches a directory and everything under it for files that were written, created or renamed into it. The platform API is run on a
+ * thread of its own (ReadDirectoryChangesW on Windows, inotify on Linux) which only collects the paths, whoever owns the watcher
+ * picks them up with GetChanges whenever it suits them.
+ *
+ * Saving a file is usually more than one write (or writing a temporary file and renaming it over the original), so a file is only
+ * reported once it has had no changes for a while, and only once no matter how many changes it had.
+ */
+
+#include "Core/Base.h"
+
+#include <string>
+#include <vector>
+
+namespace Aurora {
+
+	struct FileWatcherData;
+
+	class FileWatcher
+	{
+	public:
+		FileWatcher(const std::string& directory);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		// The files that changed and had no changes for at least settleTime seconds since, normalized the same way as the
+		// VirtualFileSystem normalizes paths and starting with the watched directory
+		std::vector<std::string> GetChanges(float settleTime = 0.25f);
+
+		[[nodiscard]] inline const std::string& GetDirectory() const { return m_Directory; }
+		// False if the directory could not be watched or the platform has no watcher
+		[[nodiscard]] bool IsWatching() const;
+
+	private:
+		std::string m_Directory;
+		FileWatcherData* m_Data = nullptr;
+
+	};
+
+}
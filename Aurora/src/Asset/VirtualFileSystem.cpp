@@ -0,0 +1,320 @@
+#include "Aurorapch.h"
+#include "VirtualFileSystem.h"
+
+#include <shared_mutex>
+
+namespace Aurora {
+
+	struct VirtualFileSystemData
+	{
+		std::shared_mutex MountMutex;
+		std::vector<Ref<AssetPack>> Packs; // In mount order
+	};
+
+	static VirtualFileSystemData* s_Data = nullptr;
+
+	namespace Utils {
+
+		// Where the entries under the directory start in the sorted table of contents
+		static const AssetPackEntry* FindFirstEntryIn(const AssetPack& pack, const std::string& directoryPrefix)
+		{
+			const AssetPackEntry* end = pack.GetEntries() + pack.GetEntryCount();
+
+			return std::lower_bound(pack.GetEntries(), end, std::string_view(directoryPrefix), [&pack](const AssetPackEntry& entry, std::string_view value)
+			{
+				return pack.GetEntryPath(entry) < value;
+			});
+		}
+
+		static bool StartsWith(std::string_view string, std::string_view prefix)
+		{
+			return string.size() >= prefix.size() && string.compare(0, prefix.size(), prefix) == 0;
+		}
+
+		static std::string GetDirectoryPrefix(const std::string& directory)
+		{
+			std::string prefix = VirtualFileSystem::NormalizePath(directory);
+			if (!prefix.empty() && prefix.back() != '/')
+				prefix += '/';
+
+			return prefix;
+		}
+
+	}
+
+	FileReader::FileReader(const std::string& filePath)
+	{
+		std::string path = VirtualFileSystem::NormalizePath(filePath);
+
+		Ref<AssetPack> pack;
+		const AssetPackEntry* entry = VirtualFileSystem::FindEntry(path, pack);
+		if (entry)
+		{
+			if (AssetPack::IsCompressed(*entry))
+			{
+				m_Decompressed.resize(entry->Size);
+				if (!pack->ReadEntry(*entry, m_Decompressed.data()))
+				{
+					m_Decompressed.clear();
+					return;
+				}
+
+				m_Memory = m_Decompressed.data();
+			}
+			else
+			{
+				m_Memory = pack->GetEntryData(*entry);
+			}
+
+			m_Pack = pack;
+			m_Size = entry->Size;
+			m_Open = true;
+
+			return;
+		}
+
+		fopen_s(&m_File, filePath.c_str(), "rb");
+		if (!m_File)
+			return;
+
+		_fseeki64(m_File, 0, SEEK_END);
+		m_Size = (uint64_t)_ftelli64(m_File);
+		_fseeki64(m_File, 0, SEEK_SET);
+		m_Open = true;
+	}
+
+	FileReader::~FileReader()
+	{
+		Close();
+	}
+
+	FileReader::FileReader(FileReader&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	FileReader& FileReader::operator=(FileReader&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+
+			m_File = other.m_File;
+			m_Pack = std::move(other.m_Pack);
+			m_Decompressed = std::move(other.m_Decompressed);
+			m_Memory = other.m_Memory; // Moving the vector keeps its buffer, so this still points at the right place
+			m_Size = other.m_Size;
+			m_Position = other.m_Position;
+			m_Open = other.m_Open;
+
+			other.m_File = nullptr;
+			other.m_Memory = nullptr;
+			other.m_Size = 0;
+			other.m_Position = 0;
+			other.m_Open = false;
+		}
+
+		return *this;
+	}
+
+	void FileReader::Close()
+	{
+		if (m_File)
+			fclose(m_File);
+
+		m_File = nullptr;
+		m_Pack = nullptr;
+		m_Memory = nullptr;
+		m_Decompressed = std::vector<Byte>();
+		m_Size = 0;
+		m_Position = 0;
+		m_Open = false;
+	}
+
+	bool FileReader::Read(void* data, uint64_t size)
+	{
+		if (!m_Open || size > m_Size - m_Position)
+			return false;
+
+		if (m_Memory)
+			memcpy(data, m_Memory + m_Position, size);
+		else if (fread(data, 1, size, m_File) != size)
+			return false;
+
+		m_Position += size;
+		return true;
+	}
+
+	bool FileReader::ReadAll(std::vector<Byte>& outData)
+	{
+		outData.resize(m_Size);
+
+		return Seek(0) && Read(outData.data(), m_Size);
+	}
+
+	bool FileReader::Seek(uint64_t position)
+	{
+		if (!m_Open || position > m_Size)
+			return false;
+
+		if (m_File && _fseeki64(m_File, (int64_t)position, SEEK_SET) != 0)
+			return false;
+
+		m_Position = position;
+		return true;
+	}
+
+	void VirtualFileSystem::Init()
+	{
+		AR_CORE_ASSERT(!s_Data, "VirtualFileSystem already initialized!");
+
+		s_Data = new VirtualFileSystemData();
+
+		if (std::filesystem::exists(GetDefaultPackPath()))
+			Mount(GetDefaultPackPath());
+	}
+
+	void VirtualFileSystem::ShutDown()
+	{
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	bool VirtualFileSystem::Mount(const std::string& packPath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		Ref<AssetPack> pack = AssetPack::Create(packPath);
+		if (!pack->IsLoaded())
+			return false;
+
+		std::unique_lock<std::shared_mutex> lock(s_Data->MountMutex);
+		s_Data->Packs.push_back(pack);
+
+		AR_CORE_INFO_TAG("VirtualFileSystem", "Mounted '{0}' with {1} files", packPath, pack->GetEntryCount());
+
+		return true;
+	}
+
+	void VirtualFileSystem::Unmount(const std::string& packPath)
+	{
+		std::unique_lock<std::shared_mutex> lock(s_Data->MountMutex);
+
+		auto& packs = s_Data->Packs;
+		packs.erase(std::remove_if(packs.begin(), packs.end(), [&packPath](const Ref<AssetPack>& pack) { return pack->GetFilePath() == packPath; }), packs.end());
+	}
+
+	const char* VirtualFileSystem::GetDefaultPackPath()
+	{
+		return "Resources.apak";
+	}
+
+	std::string VirtualFileSystem::NormalizePath(const std::string& path)
+	{
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	const AssetPackEntry* VirtualFileSystem::FindEntry(const std::string& normalizedPath, Ref<AssetPack>& outPack)
+	{
+		// Without Init (tools that only deal with loose files) there is nothing mounted
+		if (!s_Data)
+			return nullptr;
+
+		std::shared_lock<std::shared_mutex> lock(s_Data->MountMutex);
+
+		for (auto it = s_Data->Packs.rbegin(); it != s_Data->Packs.rend(); it++)
+		{
+			const AssetPackEntry* entry = (*it)->FindEntry(normalizedPath);
+			if (entry)
+			{
+				outPack = *it;
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool VirtualFileSystem::Exists(const std::string& path)
+	{
+		if (IsPacked(path))
+			return true;
+
+		if (s_Data)
+		{
+			std::string prefix = Utils::GetDirectoryPrefix(path);
+
+			std::shared_lock<std::shared_mutex> lock(s_Data->MountMutex);
+			for (const Ref<AssetPack>& pack : s_Data->Packs)
+			{
+				const AssetPackEntry* entry = Utils::FindFirstEntryIn(*pack, prefix);
+				if (entry != pack->GetEntries() + pack->GetEntryCount() && Utils::StartsWith(pack->GetEntryPath(*entry), prefix))
+					return true;
+			}
+		}
+
+		return std::filesystem::exists(path);
+	}
+
+	bool VirtualFileSystem::IsPacked(const std::string& filePath)
+	{
+		Ref<AssetPack> pack;
+
+		return FindEntry(NormalizePath(filePath), pack) != nullptr;
+	}
+
+	bool VirtualFileSystem::ReadFile(const std::string& filePath, std::vector<Byte>& outData)
+	{
+		AR_PROFILE_FUNCTION();
+
+		FileReader reader(filePath);
+		if (!reader)
+			return false;
+
+		return reader.ReadAll(outData);
+	}
+
+	std::vector<std::string> VirtualFileSystem::ListDirectory(const std::string& directory)
+	{
+		AR_PROFILE_FUNCTION();
+
+		std::vector<std::string> files;
+
+		std::error_code error;
+		if (std::filesystem::is_directory(directory, error))
+		{
+			for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+			{
+				if (entry.is_regular_file())
+					files.push_back(NormalizePath(entry.path().string()));
+			}
+		}
+
+		if (s_Data)
+		{
+			std::string prefix = Utils::GetDirectoryPrefix(directory);
+
+			std::shared_lock<std::shared_mutex> lock(s_Data->MountMutex);
+			for (const Ref<AssetPack>& pack : s_Data->Packs)
+			{
+				const AssetPackEntry* end = pack->GetEntries() + pack->GetEntryCount();
+				for (const AssetPackEntry* entry = Utils::FindFirstEntryIn(*pack, prefix); entry != end; entry++)
+				{
+					std::string_view path = pack->GetEntryPath(*entry);
+					if (!Utils::StartsWith(path, prefix))
+						break;
+
+					// Anything with another slash after the prefix is in a sub directory
+					if (path.find('/', prefix.size()) == std::string_view::npos)
+						files.emplace_back(path);
+				}
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+
+		return files;
+	}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+/*
+ * Every loader reads its files through here instead of opening them itself, so they do not care whether a file is a loose file on
+ * disk or an entry of a mounted asset pack (see AssetPack.h).
+ *
+ * Mounted packs are searched first, the pack mounted last first, and only if none of them has the file it is opened from disk. So
+ * shipping a pack next to the executable is all it takes to stop loading the loose files, and without a pack (while developing)
+ * everything comes from disk like before. Lookups in packs are by the normalized relative path, they are case sensitive.
+ *
+ * Reading is thread safe, workers decode and stream textures through FileReaders. Mounting and unmounting are too, a reader keeps
+ * the pack it reads from mapped until it is closed.
+ */
+
+#include "Core/Base.h"
+#include "AssetPack.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Aurora {
+
+	// Reads a file through the VirtualFileSystem. For pack entries the whole file is already in memory, stored entries are read straight
+	// out of the pack's mapping and compressed ones are decompressed once when the reader is opened
+	class FileReader
+	{
+	public:
+		FileReader() = default;
+		FileReader(const std::string& filePath);
+		~FileReader();
+
+		FileReader(FileReader&& other) noexcept;
+		FileReader& operator=(FileReader&& other) noexcept;
+
+		FileReader(const FileReader&) = delete;
+		FileReader& operator=(const FileReader&) = delete;
+
+		void Close();
+
+		// Reads exactly size bytes from the current position, false if there are not enough left
+		bool Read(void* data, uint64_t size);
+		bool ReadAll(std::vector<Byte>& outData);
+		bool Seek(uint64_t position);
+
+		[[nodiscard]] inline uint64_t GetSize() const { return m_Size; }
+		[[nodiscard]] inline uint64_t GetPosition() const { return m_Position; }
+		// The whole file for pack entries, nullptr for loose files
+		[[nodiscard]] inline const Byte* GetData() const { return m_Memory; }
+		[[nodiscard]] inline bool IsPacked() const { return m_Pack; }
+		[[nodiscard]] inline bool IsOpen() const { return m_Open; }
+
+		explicit operator bool() const { return m_Open; }
+
+	private:
+		FILE* m_File = nullptr;
+
+		Ref<AssetPack> m_Pack;
+		const Byte* m_Memory = nullptr;
+		std::vector<Byte> m_Decompressed;
+
+		uint64_t m_Size = 0;
+		uint64_t m_Position = 0;
+		bool m_Open = false;
+
+	};
+
+	class VirtualFileSystem
+	{
+	public:
+		// Mounts GetDefaultPackPath if there is one
+		static void Init();
+		static void ShutDown();
+
+		static bool Mount(const std::string& packPath);
+		static void Unmount(const std::string& packPath);
+
+		// The pack that is mounted on startup, relative to the working directory
+		static const char* GetDefaultPackPath();
+
+		// How paths are stored in packs and looked up: lexically normal with forward slashes
+		static std::string NormalizePath(const std::string& path);
+
+		// Also true for directories, loose ones or ones that only exist in a pack
+		static bool Exists(const std::string& path);
+		static bool IsPacked(const std::string& filePath);
+		static bool ReadFile(const std::string& filePath, std::vector<Byte>& outData);
+
+		// The files (not sub directories) in a directory, from disk and from every pack, sorted and without duplicates
+		static std::vector<std::string> ListDirectory(const std::string& directory);
+
+	private:
+		// The pack that has the file, checked in reverse mount order
+		static const AssetPackEntry* FindEntry(const std::string& normalizedPath, Ref<AssetPack>& outPack);
+
+		friend class FileReader;
+
+	};
+
+}
@@ -10,6 +10,7 @@
 
 #include "Core/TimeStep.h"
 #include "Core/Random.h"
+#include "Core/JobSystem.h"
 
 #include "Core/Input.h"
 #include "Core/KeyCodes.h"
@@ -24,19 +25,29 @@
 #include "Scene/ScriptableEntity.h"
 #include "Scene/Components.h"
 
+#include "Asset/AssetManager.h"
+#include "Asset/AssetPack.h"
+#include "Asset/FileWatcher.h"
+#include "Asset/VirtualFileSystem.h"
+
 #include "Renderer/Renderer.h"
 #include "Renderer/Renderer3D.h"
 #include "Renderer/RenderCommand.h"
 #include "Renderer/RendererPorperties.h"
+#include "Renderer/Environment.h"
 
 #include "Graphics/VertexBuffer.h"
 #include "Graphics/IndexBuffer.h"
 #include "Graphics/CubeTexture.h"
 #include "Graphics/Framebuffers.h"
+#include "Graphics/GeometryPool.h"
 #include "Graphics/Material.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/Pipeline.h"
 #include "Graphics/Shader.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureArray.h"
+#include "Graphics/TextureCooker.h"
 #include "Graphics/VertexArray.h"
 
 #include "Debugging/Instrumentation.h"
@@ -1,6 +1,10 @@
 #include "Aurorapch.h"
 #include "Application.h"
 
+#include "JobSystem.h"
+
+#include "Asset/AssetManager.h"
+#include "Asset/VirtualFileSystem.h"
 #include "Renderer/Renderer3D.h"
 #include "Utils/UtilFunctions.h"
 
@@ -21,7 +25,8 @@ namespace Aurora {
 		if (!m_Specification.WorkingDirectory.empty())
 			std::filesystem::current_path(m_Specification.WorkingDirectory);
 
-		m_Profiler = new PerformanceProfiler();
+		// Before anything loads a file, the default pack is relative to the working directory
+		VirtualFileSystem::Init();
 
 		WindowSpecification windowSpec;
 		windowSpec.Title = specification.Name;
@@ -41,6 +46,7 @@ namespace Aurora {
 			m_Window->Center();
 
 		Renderer3D::Init(); // This handles the Renderer3D, RenderCommand and RendererProperties initialization
+		AssetManager::Init();
 
 		if (m_Specification.EnableImGui)
 		{
@@ -64,7 +70,9 @@ namespace Aurora {
 			delete layer;
 		}
 
+		AssetManager::ShutDown();
 		Renderer3D::ShutDown(); // Look into moving to Aurora Core Shutdown with similar shutdown functions
+		VirtualFileSystem::ShutDown();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -110,8 +118,6 @@ namespace Aurora {
 			layer->OnImGuiRender();
 
 		m_ImGuiLayer->End();
-
-		m_Profiler->Clear();
 	}
 
 	void Application::Run()
@@ -130,6 +136,10 @@ namespace Aurora {
 
 			ProcessEvents();
 
+			// GL bound work that other threads handed over to the main thread
+			JobSystem::ProcessMainThreadJobs();
+			AssetManager::Update();
+
 			if (!m_Minimized)
 			{
 				Timer cpuTimer;
@@ -162,6 +172,9 @@ namespace Aurora {
 
 				m_CPUTime = cpuTimer.ElapsedMillis();
 				m_Window->Update();
+
+				// Pushes this frame's counters into the history, has to be after RenderImGui so that its own timer is included
+				PerformanceProfiler::EndFrame();
 			}
 
 			float time = Utils::Time::GetTime();
@@ -79,8 +79,6 @@ namespace Aurora {
 		inline static Application& GetApp() { return *s_Instance; }
 		inline const ApplicationSpecification& GetSpecification() const { return m_Specification; }
 
-		inline PerformanceProfiler* GetPerformanceProfiler() const { return m_Profiler; }
-
 	private:
 		void Run();
 		bool OnWindowClose(WindowCloseEvent& e);
@@ -99,7 +97,6 @@ namespace Aurora {
 		float m_CPUTime = 0.0f;
 		float m_TickDelta = 1.0f;
 		TimeStep m_Timestep;
-		PerformanceProfiler* m_Profiler = nullptr; // TODO: Should be null in Dist
 
 		bool m_Running = true;
 		bool m_Minimized = false;
@@ -2,6 +2,7 @@
 
 #include "Base.h"
 #include "Random.h"
+#include "JobSystem.h"
 
 namespace Aurora {
 
@@ -9,6 +10,7 @@ namespace Aurora {
 	{
 		Logger::Log::Init();
 		Random::Init();
+		JobSystem::Init();
 
 		AR_CORE_TRACE_TAG("Core", "Aurora Engine");
 		AR_CORE_TRACE_TAG("Core", "Initializing...");
@@ -18,6 +20,7 @@ namespace Aurora {
 	{
 		AR_CORE_TRACE_TAG("Core", "Shutting down...");
 
+		JobSystem::ShutDown();
 		Logger::Log::ShutDown();
 	}
 
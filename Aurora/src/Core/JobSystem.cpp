@@ -0,0 +1,278 @@
+#include "Aurorapch.h"
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+
+namespace Aurora {
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		uint32_t WorkerCount = 0;
+		std::vector<std::thread> Workers;
+		WorkerQueue Queues[JobSystem::MaxWorkers];
+
+		std::mutex MainThreadMutex;
+		std::vector<Job> MainThreadJobs;
+
+		// Sleeping workers wait on this, PendingJobs is what they check before going to sleep
+		std::mutex SleepMutex;
+		std::condition_variable SleepCV;
+		std::atomic<uint32_t> PendingJobs{ 0 };
+		std::atomic<bool> Running{ false };
+
+		std::atomic<uint32_t> NextQueue{ 0 };
+		std::thread::id MainThreadID;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+
+	// The instrumentors keep the pointer to the thread name so these have to outlive the workers
+	static char s_WorkerNames[JobSystem::MaxWorkers][32];
+
+	// Index of the worker owning the calling thread, ~0 for threads that are not workers
+	static thread_local uint32_t s_WorkerIndex = ~0u;
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(!s_Data, "JobSystem already initialized!");
+
+		s_Data = new JobSystemData();
+		s_Data->MainThreadID = std::this_thread::get_id();
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		s_Data->WorkerCount = std::min(workerCount, MaxWorkers);
+		s_Data->Running.store(true, std::memory_order_release);
+
+		s_Data->Workers.reserve(s_Data->WorkerCount);
+		for (uint32_t i = 0; i < s_Data->WorkerCount; i++)
+			s_Data->Workers.emplace_back(&JobSystem::WorkerThreadFunc, i);
+
+		AR_CORE_INFO_TAG("JobSystem", "Initialized JobSystem with {0} worker threads", s_Data->WorkerCount);
+	}
+
+	void JobSystem::ShutDown()
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!s_Data)
+			return;
+
+		// Finish whatever is left so nothing that was promised to run gets lost
+		while (TryExecuteJob(~0u)) {}
+		ProcessMainThreadJobs();
+
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->Running.store(false, std::memory_order_release);
+		}
+		s_Data->SleepCV.notify_all();
+
+		for (std::thread& worker : s_Data->Workers)
+			worker.join();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void JobSystem::Execute(JobFunction function, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_Value.fetch_add(1, std::memory_order_acq_rel);
+
+		Submit({ std::move(function), counter });
+	}
+
+	void JobSystem::ExecuteAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_Value.fetch_add(1, std::memory_order_acq_rel);
+
+		{
+			// FinishJob takes the same lock after the counter hits zero, so either we see zero here or it sees our continuation
+			std::scoped_lock<std::mutex> lock(dependency.m_ContinuationsMutex);
+			if (dependency.m_Value.load(std::memory_order_acquire) != 0)
+			{
+				dependency.m_Continuations.push_back({ std::move(function), counter });
+				return;
+			}
+		}
+
+		Submit({ std::move(function), counter });
+	}
+
+	void JobSystem::ExecuteOnMainThread(JobFunction function, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_Value.fetch_add(1, std::memory_order_acq_rel);
+
+		std::scoped_lock<std::mutex> lock(s_Data->MainThreadMutex);
+		s_Data->MainThreadJobs.push_back({ std::move(function), counter });
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		AR_PROFILE_FUNCTION();
+
+		bool isMainThread = IsMainThread();
+		while (!counter.IsDone())
+		{
+			// The main thread has to keep on running its own queue otherwise waiting on a GL job would deadlock
+			if (isMainThread)
+				ProcessMainThreadJobs();
+
+			if (!TryExecuteJob(s_WorkerIndex))
+				std::this_thread::yield();
+		}
+
+		// The counter could hit zero while the last job is still inside FinishJob holding the lock, the caller is very likely
+		// to destroy the counter once we return so wait for that to be done
+		std::scoped_lock<std::mutex> lock(counter.m_ContinuationsMutex);
+	}
+
+	void JobSystem::ProcessMainThreadJobs()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(IsMainThread(), "Main thread jobs can only be processed on the main thread!");
+
+		std::vector<Job> jobs;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->MainThreadMutex);
+			jobs.swap(s_Data->MainThreadJobs);
+		}
+
+		for (Job& job : jobs)
+		{
+			job.Function();
+			FinishJob(job);
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data ? s_Data->WorkerCount : 0;
+	}
+
+	bool JobSystem::IsMainThread()
+	{
+		return s_Data && std::this_thread::get_id() == s_Data->MainThreadID;
+	}
+
+	void JobSystem::Submit(Job&& job)
+	{
+		AR_CORE_ASSERT(s_Data, "JobSystem is not initialized!");
+
+		// Workers push to their own queue to keep the work local, everyone else spreads it over the workers
+		uint32_t queueIndex = s_WorkerIndex != ~0u ? s_WorkerIndex : s_Data->NextQueue.fetch_add(1, std::memory_order_relaxed) % s_Data->WorkerCount;
+
+		// Incremented before the push so that a thief can never decrement it first
+		s_Data->PendingJobs.fetch_add(1, std::memory_order_release);
+
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Queues[queueIndex].Mutex);
+			s_Data->Queues[queueIndex].Jobs.push_back(std::move(job));
+		}
+
+		// Taking the sleep lock makes sure a worker that just checked PendingJobs is already waiting and will get the notification
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->SleepMutex);
+		}
+		s_Data->SleepCV.notify_one();
+	}
+
+	void JobSystem::FinishJob(Job& job)
+	{
+		JobCounter* counter = job.Counter;
+		if (!counter)
+			return;
+
+		// The decrement happens under the lock so that ExecuteAfter and Wait can synchronize with it
+		std::vector<Job> continuations;
+		{
+			std::scoped_lock<std::mutex> lock(counter->m_ContinuationsMutex);
+			if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				continuations.swap(counter->m_Continuations);
+		}
+
+		// NOTE: After this point the counter could be destroyed by the thread waiting on it, so do not touch it anymore
+		for (Job& continuation : continuations)
+			Submit(std::move(continuation));
+	}
+
+	bool JobSystem::TryExecuteJob(uint32_t workerIndex)
+	{
+		Job job;
+		bool found = false;
+
+		// Own queue first, newest job since it is the most likely to still be in cache
+		if (workerIndex != ~0u)
+		{
+			WorkerQueue& queue = s_Data->Queues[workerIndex];
+			std::scoped_lock<std::mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+				found = true;
+			}
+		}
+
+		// Then steal the oldest job from the others
+		uint32_t start = workerIndex != ~0u ? workerIndex + 1 : 0;
+		for (uint32_t i = 0; i < s_Data->WorkerCount && !found; i++)
+		{
+			WorkerQueue& queue = s_Data->Queues[(start + i) % s_Data->WorkerCount];
+			std::scoped_lock<std::mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				job = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found)
+			return false;
+
+		s_Data->PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+		job.Function();
+		FinishJob(job);
+
+		return true;
+	}
+
+	void JobSystem::WorkerThreadFunc(uint32_t workerIndex)
+	{
+		snprintf(s_WorkerNames[workerIndex], sizeof(s_WorkerNames[workerIndex]), "Aurora Worker %u", workerIndex);
+		AR_PROFILE_THREAD(s_WorkerNames[workerIndex]);
+
+		s_WorkerIndex = workerIndex;
+
+		while (true)
+		{
+			if (TryExecuteJob(workerIndex))
+				continue;
+
+			std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->SleepCV.wait(lock, []() { return s_Data->PendingJobs.load(std::memory_order_acquire) > 0 || !s_Data->Running.load(std::memory_order_acquire); });
+
+			if (!s_Data->Running.load(std::memory_order_acquire) && s_Data->PendingJobs.load(std::memory_order_acquire) == 0)
+				break;
+		}
+	}
+
+}
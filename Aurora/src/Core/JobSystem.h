@@ -0,0 +1,131 @@
+#pragma once
+
+/*
+ * The engine wide job system.
+ * There is one worker thread per core (minus the main thread), every worker owns a deque of jobs, it pushes and pops its own
+ * work from the back and when it runs out it steals from the front of the other workers' deques. Jobs submitted from threads
+ * that are not workers (the main thread for example) are spread over the workers round robin.
+ *
+ * Waiting is done with JobCounters, every job submitted with a counter increments it and decrements it when it finishes, so
+ * waiting on a counter means waiting for all the jobs that were submitted with it. A thread that waits does not sleep, it keeps
+ * on executing jobs until the counter reaches zero.
+ * Dependencies between jobs are expressed with ExecuteAfter, the job gets queued only when the counter it depends on hits zero,
+ * which is enough to build task graphs (every node gets a counter and its children wait on it).
+ *
+ * Anything that touches OpenGL HAS to run on the main thread since that is where the context is current, so those jobs are
+ * submitted with ExecuteOnMainThread and get executed once per frame by the Application (or while the main thread waits on a counter).
+ */
+
+#include "Core/Base.h"
+#include "Debugging/Instrumentation.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Aurora {
+
+	using JobFunction = std::function<void()>;
+
+	class JobCounter;
+
+	struct Job
+	{
+		JobFunction Function;
+		JobCounter* Counter = nullptr;
+	};
+
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		inline bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+		inline uint32_t GetValue() const { return m_Value.load(std::memory_order_acquire); }
+
+	private:
+		std::atomic<uint32_t> m_Value{ 0 };
+
+		// Jobs waiting for this counter to reach zero
+		std::mutex m_ContinuationsMutex;
+		std::vector<Job> m_Continuations;
+
+		friend class JobSystem;
+
+	};
+
+	class JobSystem
+	{
+	public:
+		static constexpr uint32_t MaxWorkers = 64;
+
+	public:
+		// workerCount of 0 means one worker per hardware thread minus the main thread
+		static void Init(uint32_t workerCount = 0);
+		static void ShutDown();
+
+		// Queues the job on the workers, if a counter is passed it is incremented now and decremented once the job is done
+		static void Execute(JobFunction function, JobCounter* counter = nullptr);
+
+		// Queues the job only once the dependency reaches zero (immediately if it is already zero)
+		static void ExecuteAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+		// For jobs that need the GL context, these get executed in ProcessMainThreadJobs
+		static void ExecuteOnMainThread(JobFunction function, JobCounter* counter = nullptr);
+
+		// Runs function(index) for every index in [0, count) in batches of batchSize, blocks until all of them are done
+		template<typename Func>
+		static void ParallelFor(uint32_t count, uint32_t batchSize, Func&& function)
+		{
+			AR_PROFILE_FUNCTION();
+
+			if (count == 0)
+				return;
+
+			batchSize = std::max(batchSize, 1u);
+
+			// Not worth the overhead of queueing anything
+			if (count <= batchSize || GetWorkerCount() == 0)
+			{
+				for (uint32_t i = 0; i < count; i++)
+					function(i);
+
+				return;
+			}
+
+			JobCounter counter;
+			for (uint32_t start = 0; start < count; start += batchSize)
+			{
+				uint32_t end = std::min(start + batchSize, count);
+				Execute([&function, start, end]()
+				{
+					for (uint32_t i = start; i < end; i++)
+						function(i);
+				}, &counter);
+			}
+
+			Wait(counter);
+		}
+
+		// Executes other jobs while waiting, so it is fine to call this from inside a job
+		static void Wait(JobCounter& counter);
+
+		// Called by the application every frame
+		static void ProcessMainThreadJobs();
+
+		static uint32_t GetWorkerCount();
+		static bool IsMainThread();
+
+	private:
+		static void Submit(Job&& job);
+		static void FinishJob(Job& job);
+		// Tries to run one job, returns false if there was nothing to do
+		static bool TryExecuteJob(uint32_t workerIndex);
+		static void WorkerThreadFunc(uint32_t workerIndex);
+
+	};
+
+}
@@ -240,6 +240,9 @@ namespace Aurora {
 			return *this;
 		}
 
+		T* raw() { return m_Ptr; }
+		const T* raw() const { return m_Ptr; }
+
 		operator bool() const { return m_Ptr != nullptr; }
 
 		bool operator==(const ScopedPointer& other) const { return m_Ptr == other.m_Ptr; }
@@ -183,16 +183,24 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		auto& imageData = Utils::ImageLoader::LoadImageFile(m_Specification.WindowIconPath);
+		// GLFW wants 8 bit RGBA
+		Utils::ImageLoadSettings loadSettings;
+		loadSettings.Channels = 4;
+		loadSettings.AllowHDR = false;
 
-		GLFWimage images[1];
-		images[0].width = imageData.Width;
-		images[0].height = imageData.Height;
-		images[0].pixels = imageData.PixelData;
+		Utils::ImageData icon = Utils::ImageLoader::LoadImageFile(m_Specification.WindowIconPath, loadSettings);
+		if (!icon)
+		{
+			AR_CORE_ERROR_TAG("Window", "Could not load the window icon '{0}': {1}", m_Specification.WindowIconPath, Utils::ImageLoader::GetFailureReason());
+			return;
+		}
 
-		glfwSetWindowIcon(m_Window, 1, images);
+		GLFWimage images[1];
+		images[0].width = icon.GetWidth();
+		images[0].height = icon.GetHeight();
+		images[0].pixels = icon.GetPixels();
 
-		Utils::ImageLoader::FreeImage(); // Free image right after glfw copies its data internally
+		glfwSetWindowIcon(m_Window, 1, images); // GLFW copies the pixels, the image is freed right after
 	}
 
 	void Window::SetGLFWCallbacks()
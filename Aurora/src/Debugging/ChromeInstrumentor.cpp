@@ -0,0 +1,201 @@
+#include "Aurorapch.h"
+#include "ChromeInstrumentor.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static void AppendEscapedJSONString(std::string& out, const char* str)
+		{
+			for (const char* c = str; *c; c++)
+			{
+				if (*c == '"' || *c == '\\')
+					out.push_back('\\');
+
+				out.push_back(*c);
+			}
+		}
+
+	}
+
+	Instrumentor::~Instrumentor()
+	{
+		EndSession();
+
+		for (ThreadBuffer* buffer : m_ThreadBuffers)
+			delete buffer;
+	}
+
+	void Instrumentor::BeginSession(const char* name, const char* filepath)
+	{
+		std::scoped_lock<std::mutex> lock(m_SessionMutex);
+
+		if (m_SessionActive.load(std::memory_order_relaxed))
+		{
+			if (Logger::Log::GetCoreLogger())
+				AR_CORE_WARN_TAG("Instrumentor", "Session {0} started while another session is still active! Ignoring it.", name);
+
+			return;
+		}
+
+		std::filesystem::path path = filepath;
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path());
+
+		m_OutputStream.open(path);
+		if (!m_OutputStream.is_open())
+		{
+			if (Logger::Log::GetCoreLogger())
+				AR_CORE_ERROR_TAG("Instrumentor", "Chrome Instrumentor could not open file: {0}", filepath);
+
+			return;
+		}
+
+		m_OutputStream << "{\"otherData\":{},\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		m_FirstEvent = true;
+		m_WriteBuffer.reserve(1 << 20);
+
+		// Events still sitting in the buffers from outside of a session are thrown away, and all thread names get written again
+		{
+			std::scoped_lock<std::mutex> buffersLock(m_ThreadBuffersMutex);
+			for (ThreadBuffer* buffer : m_ThreadBuffers)
+			{
+				buffer->Tail.store(buffer->Head.load(std::memory_order_acquire), std::memory_order_release);
+				buffer->DroppedEvents.store(0, std::memory_order_relaxed);
+				buffer->NameWritten = false;
+			}
+		}
+
+		m_SessionStart = std::chrono::steady_clock::now();
+		m_StopWriter = false;
+		m_WriterThread = std::thread([this]() { WriterThreadFunc(); });
+
+		m_SessionActive.store(true, std::memory_order_release);
+	}
+
+	void Instrumentor::EndSession()
+	{
+		std::scoped_lock<std::mutex> lock(m_SessionMutex);
+
+		if (!m_SessionActive.load(std::memory_order_relaxed))
+			return;
+
+		m_SessionActive.store(false, std::memory_order_release);
+
+		{
+			std::scoped_lock<std::mutex> writerLock(m_WriterMutex);
+			m_StopWriter = true;
+		}
+		m_WriterCV.notify_one();
+		m_WriterThread.join();
+
+		// The writer thread is gone so whatever came in after its last flush is drained here
+		FlushThreadBuffers();
+
+		uint32_t droppedEvents = 0;
+		{
+			std::scoped_lock<std::mutex> buffersLock(m_ThreadBuffersMutex);
+			for (ThreadBuffer* buffer : m_ThreadBuffers)
+				droppedEvents += buffer->DroppedEvents.exchange(0, std::memory_order_relaxed);
+		}
+
+		m_OutputStream << "]}";
+		m_OutputStream.close();
+
+		if (droppedEvents && Logger::Log::GetCoreLogger())
+			AR_CORE_WARN_TAG("Instrumentor", "Dropped {0} events since the thread buffers were full, consider increasing ThreadBufferCapacity", droppedEvents);
+	}
+
+	void Instrumentor::SetThreadName(const char* name)
+	{
+		ThreadBuffer* buffer = s_ThreadBuffer ? s_ThreadBuffer : RegisterThread();
+		buffer->Name.store(name, std::memory_order_release);
+	}
+
+	Instrumentor::ThreadBuffer* Instrumentor::RegisterThread()
+	{
+		ThreadBuffer* buffer = new ThreadBuffer();
+
+		std::scoped_lock<std::mutex> lock(m_ThreadBuffersMutex);
+		buffer->ThreadID = (uint32_t)m_ThreadBuffers.size();
+		m_ThreadBuffers.push_back(buffer);
+		s_ThreadBuffer = buffer;
+
+		return buffer;
+	}
+
+	void Instrumentor::WriterThreadFunc()
+	{
+		AR_CT_PROF_THREAD("Instrumentor Writer");
+
+		std::unique_lock<std::mutex> lock(m_WriterMutex);
+		while (!m_StopWriter)
+		{
+			m_WriterCV.wait_for(lock, std::chrono::milliseconds(WriterSleepMilliseconds), [this]() { return m_StopWriter; });
+
+			lock.unlock();
+			FlushThreadBuffers();
+			lock.lock();
+		}
+	}
+
+	uint32_t Instrumentor::FlushThreadBuffers()
+	{
+		std::vector<ThreadBuffer*> buffers;
+		{
+			std::scoped_lock<std::mutex> lock(m_ThreadBuffersMutex);
+			buffers = m_ThreadBuffers;
+		}
+
+		uint32_t eventCount = 0;
+		char line[64];
+		for (ThreadBuffer* buffer : buffers)
+		{
+			const char* threadName = buffer->Name.load(std::memory_order_acquire);
+			if (threadName && !buffer->NameWritten)
+			{
+				m_WriteBuffer += m_FirstEvent ? "" : ",";
+				m_WriteBuffer += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+				m_WriteBuffer += std::to_string(buffer->ThreadID);
+				m_WriteBuffer += ",\"args\":{\"name\":\"";
+				Utils::AppendEscapedJSONString(m_WriteBuffer, threadName);
+				m_WriteBuffer += "\"}}";
+
+				buffer->NameWritten = true;
+				m_FirstEvent = false;
+			}
+
+			uint32_t startTail = buffer->Tail.load(std::memory_order_relaxed);
+			uint32_t tail = startTail;
+			uint32_t head = buffer->Head.load(std::memory_order_acquire);
+			for (; tail != head; tail++)
+			{
+				const TraceEvent& event = buffer->Events[tail & (ThreadBufferCapacity - 1)];
+
+				m_WriteBuffer += m_FirstEvent ? "{\"cat\":\"function\",\"name\":\"" : ",{\"cat\":\"function\",\"name\":\"";
+				Utils::AppendEscapedJSONString(m_WriteBuffer, event.Name);
+
+				// Chrome wants microseconds, the fractional part keeps the nanosecond precision
+				snprintf(line, sizeof(line), "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,", buffer->ThreadID);
+				m_WriteBuffer += line;
+				snprintf(line, sizeof(line), "\"ts\":%.3f,\"dur\":%.3f}", (double)event.Start * 0.001, (double)event.Duration * 0.001);
+				m_WriteBuffer += line;
+
+				m_FirstEvent = false;
+			}
+
+			// Hand the slots back to the producer only after we are done reading them
+			buffer->Tail.store(tail, std::memory_order_release);
+			eventCount += head - startTail;
+		}
+
+		if (!m_WriteBuffer.empty())
+		{
+			m_OutputStream.write(m_WriteBuffer.data(), m_WriteBuffer.size());
+			m_WriteBuffer.clear();
+		}
+
+		return eventCount;
+	}
+
+}
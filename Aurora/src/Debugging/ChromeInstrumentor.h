@@ -1,102 +1,76 @@
 #pragma once
 
-// !!-------DEPRECATED---------!!
-
 /*
- * This is now a deprecated Profiler, it was used mainly before introducing Optick into the engine and all the profiled information were
- * dumped into a json file which then was displayed in Chrome://tracing. It was good as DIY profiling however it is nothing compared
- * to Optick which is why it is now deprecated.
+ * This is the built in tracer that outputs Chrome tracing json files (can be opened in chrome://tracing or ui.perfetto.dev).
+ * It used to be deprecated in favour of Optick, however Optick is not usable on every platform so this is the fallback and
+ * it is now cheap enough to leave on for the whole Profile build.
+ *
+ * How it works:
+ *  - Every thread that records an event gets its own fixed size ring buffer of binary TraceEvents, the owning thread is the
+ *    only producer and the writer thread is the only consumer so pushing an event is just two relaxed loads and a release store.
+ *  - If a ring buffer is full the event is dropped (and counted) instead of blocking the thread that is being profiled.
+ *  - A background writer thread drains all the ring buffers every few milliseconds, formats the json in big chunks and writes
+ *    them out to the file. Nothing is formatted or flushed on the thread that ends the scope.
+ *
+ * NOTE: Event names are stored as pointers and only resolved on the writer thread, so they HAVE to be string literals (or at
+ * least outlive the session), which is the case for __FUNCSIG__ and all the AR_PROFILE_SCOPE call sites.
  */
 
 #include "Core/Base.h"
-#include "Logging/Log.h"
 
-#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
-#include <iomanip>
+#include <mutex>
 #include <string>
 #include <thread>
-#include <mutex>
-#include <sstream>
+#include <vector>
 
 namespace Aurora {
 
-    using FloatingPointMicroseconds = std::chrono::duration<float, std::micro>;
-
-    struct ProfileResult
-    {
-        std::string Name;
-
-        FloatingPointMicroseconds Start;
-        std::chrono::microseconds ElapsedTime;
-        std::thread::id ThreadID;
-    };
-
-    struct InstrumentationSession
+    struct TraceEvent
     {
         const char* Name;
+        uint64_t Start; // Nanoseconds since the session started
+        uint64_t Duration; // Nanoseconds
     };
 
     class Instrumentor
     {
+    public:
+        static constexpr uint32_t ThreadBufferCapacity = 1 << 14; // Has to be a power of 2
+        static constexpr uint32_t WriterSleepMilliseconds = 10;
+
     public:
         Instrumentor(const Instrumentor&) = delete;
         Instrumentor(Instrumentor&&) = delete;
 
-        void BeginSession(const char* name, const char* filepath = "results.json")
-        {
-            std::lock_guard lock(m_Mutex);
-            
-            if (!std::filesystem::exists(filepath))
-                std::filesystem::create_directory(filepath);
+        void BeginSession(const char* name, const char* filepath = "results.json");
+        void EndSession();
 
-            m_OutputStream.open(filepath);
-            if (m_OutputStream.is_open())
-            {
-                m_CurrentSession = new InstrumentationSession{ name };
-                WriteHeader();
-            }
-            else
-            {
-                if(Logger::Log::GetCoreLogger())
-                    AR_CORE_ERROR_TAG("Instrumentor", "Chrome Instrumentor could not open file: {0}", filepath);
-            }
-        }
+        // Gives the calling thread a name in the trace, the thread still gets a default one if this is never called
+        void SetThreadName(const char* name);
 
-        void EndSession()
+        AR_FORCE_INLINE bool IsSessionActive() const { return m_SessionActive.load(std::memory_order_relaxed); }
+        AR_FORCE_INLINE uint64_t GetTimestamp() const
         {
-            std::lock_guard lock(m_Mutex);
-            if (m_CurrentSession)
-            {
-                WriteFooter();
-                m_OutputStream.close();
-                delete m_CurrentSession;
-                m_CurrentSession = nullptr;
-            }
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_SessionStart).count();
         }
 
-        void WriteProfile(const ProfileResult& result)
+        AR_FORCE_INLINE void WriteProfile(const char* name, uint64_t start, uint64_t duration)
         {
-            std::stringstream fileOutput;
-
-            fileOutput << std::setprecision(3) << std::fixed;
-            fileOutput << ",{";
-            fileOutput << "\"cat\":\"function\",";
-            fileOutput << "\"dur\":" << (result.ElapsedTime.count()) << ',';
-            fileOutput << "\"name\":\"" << result.Name << "\",";
-            fileOutput << "\"ph\":\"X\",";
-            fileOutput << "\"pid\":0,";
-            fileOutput << "\"tid\":" << result.ThreadID << ",";
-            fileOutput << "\"ts\":" << result.Start.count();
-            fileOutput << "}";
-
-            std::lock_guard lock(m_Mutex);
-            if (m_CurrentSession)
+            ThreadBuffer* buffer = s_ThreadBuffer ? s_ThreadBuffer : RegisterThread();
+
+            uint32_t head = buffer->Head.load(std::memory_order_relaxed);
+            if (head - buffer->Tail.load(std::memory_order_acquire) >= ThreadBufferCapacity)
             {
-                m_OutputStream << fileOutput.str();
-                m_OutputStream.flush();
+                buffer->DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
+
+            buffer->Events[head & (ThreadBufferCapacity - 1)] = { name, start, duration };
+            buffer->Head.store(head + 1, std::memory_order_release);
         }
 
         static Instrumentor& Get()
@@ -106,65 +80,70 @@ namespace Aurora {
         }
 
     private:
-        Instrumentor()
-            : m_CurrentSession(nullptr)
+        struct ThreadBuffer
         {
-        }
+            TraceEvent Events[ThreadBufferCapacity];
+            std::atomic<uint32_t> Head{ 0 }; // Written by the owning thread only
+            std::atomic<uint32_t> Tail{ 0 }; // Written by the writer thread only
+            std::atomic<uint32_t> DroppedEvents{ 0 };
+            std::atomic<const char*> Name{ nullptr };
+            bool NameWritten = false; // Writer thread only
+            uint32_t ThreadID = 0;
+        };
 
-        void WriteHeader()
-        {
-            m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
-            m_OutputStream.flush();
-        }
+    private:
+        Instrumentor() = default;
+        ~Instrumentor();
 
-        void WriteFooter()
-        {
-            m_OutputStream << "]}";
-            m_OutputStream.flush();
-        }
+        ThreadBuffer* RegisterThread();
+
+        void WriterThreadFunc();
+        // Drains all the thread buffers into the file, returns the amount of events written
+        uint32_t FlushThreadBuffers();
 
     private:
-        std::mutex m_Mutex;
-        InstrumentationSession* m_CurrentSession;
+        std::mutex m_SessionMutex;
+        std::atomic<bool> m_SessionActive{ false };
+        std::chrono::steady_clock::time_point m_SessionStart;
         std::ofstream m_OutputStream;
+        std::string m_WriteBuffer;
+        bool m_FirstEvent = true;
+
+        std::thread m_WriterThread;
+        std::mutex m_WriterMutex;
+        std::condition_variable m_WriterCV;
+        bool m_StopWriter = false;
+
+        // Buffers are never freed while the program is running since the writer could still be draining a thread that exited
+        std::mutex m_ThreadBuffersMutex;
+        std::vector<ThreadBuffer*> m_ThreadBuffers;
+
+        inline static thread_local ThreadBuffer* s_ThreadBuffer = nullptr;
 
     };
 
     class InstrumentationTimer
     {
-    private:
-        using HighResClock = std::chrono::high_resolution_clock;
-        using MicroSeconds = std::chrono::microseconds;
-
     public:
-        InstrumentationTimer(const char* name)
-            : m_Name(name), m_Stopped(false)
+        AR_FORCE_INLINE InstrumentationTimer(const char* name)
+            : m_Name(Instrumentor::Get().IsSessionActive() ? name : nullptr)
         {
-            m_Start = std::chrono::high_resolution_clock::now();
+            if (m_Name)
+                m_Start = Instrumentor::Get().GetTimestamp();
         }
 
-        ~InstrumentationTimer()
+        AR_FORCE_INLINE ~InstrumentationTimer()
         {
-            if (!m_Stopped)
-                Stop();
-        }
-
-        void Stop()
-        {
-            HighResClock::time_point endTimepoint = HighResClock::now();
-
-            auto highResStart = FloatingPointMicroseconds{ m_Start.time_since_epoch() };
-            auto elapsedTime = std::chrono::time_point_cast<MicroSeconds>(endTimepoint).time_since_epoch() - std::chrono::time_point_cast<MicroSeconds>(m_Start).time_since_epoch();
-
-            Instrumentor::Get().WriteProfile({ m_Name, highResStart, elapsedTime, std::this_thread::get_id() });
-
-            m_Stopped = true;
+            if (m_Name)
+            {
+                Instrumentor& instrumentor = Instrumentor::Get();
+                instrumentor.WriteProfile(m_Name, m_Start, instrumentor.GetTimestamp() - m_Start);
+            }
         }
 
     private:
         const char* m_Name;
-        std::chrono::time_point<HighResClock> m_Start;
-        bool m_Stopped;
+        uint64_t m_Start = 0;
 
     };
 
@@ -174,10 +153,18 @@ namespace Aurora {
 
     #define CH_EXTENSION ".json"
 
+    #ifdef _MSC_VER
+        #define AR_CT_FUNC_SIG __FUNCSIG__
+    #else
+        #define AR_CT_FUNC_SIG __PRETTY_FUNCTION__
+    #endif
+
     #define AR_CT_PROF_BEGIN_SESSION(name, filepath)       ::Aurora::Instrumentor::Get().BeginSession(name, filepath"/Chrome/" name CH_EXTENSION)
     #define AR_CT_PROF_END_SESSION()                       ::Aurora::Instrumentor::Get().EndSession()
-    #define AR_CT_PROF_SCOPE(name)                         ::Aurora::InstrumentationTimer Instrumentor##__LINE__(name)
-    #define AR_CT_PROF_FUNCTION()                          AR_CT_PROF_SCOPE(__FUNCSIG__)
+    #define AR_CT_PROF_SCOPE(name)                         ::Aurora::InstrumentationTimer AR_CONCAT_MACRO(Instrumentor, __LINE__)(name)
+    #define AR_CT_PROF_FUNCTION()                          AR_CT_PROF_SCOPE(AR_CT_FUNC_SIG)
+    #define AR_CT_PROF_FRAME(name)                         AR_CT_PROF_SCOPE(name)
+    #define AR_CT_PROF_THREAD(name)                        ::Aurora::Instrumentor::Get().SetThreadName(name)
 
 #else
 
@@ -185,5 +172,7 @@ namespace Aurora {
     #define AR_CT_PROF_END_SESSION()
     #define AR_CT_PROF_SCOPE(name)
     #define AR_CT_PROF_FUNCTION()
+    #define AR_CT_PROF_FRAME(name)
+    #define AR_CT_PROF_THREAD(name)
 
-#endif // AURORA_CORE_PROFILE
\ No newline at end of file
+#endif // AURORA_CORE_PROFILE
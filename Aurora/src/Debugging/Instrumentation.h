@@ -3,8 +3,15 @@
 #include "ChromeInstrumentor.h"
 #include "OptickInstrumentor.h"
 
-// If you want to use Optick for profiling leave it at 1, however if for some reason you want to use Chrome Tracing (Not advised) make it 0
-#define AURORA_USE_OPTICK 1
+// If you want to use Optick for profiling leave it at 1, otherwise set it to 0 to use the built in Chrome tracer which writes
+// Profiling/Chrome/*.json files. Optick is not available on every platform so the built in tracer is the default outside of windows
+#ifndef AURORA_USE_OPTICK
+    #ifdef AURORA_PLATFORM_WINDOWS
+        #define AURORA_USE_OPTICK 1
+    #else
+        #define AURORA_USE_OPTICK 0
+    #endif
+#endif
 
 #ifdef AURORA_CORE_PROFILE
 
@@ -22,11 +29,11 @@
 
         #define AR_PROFILE_BEGIN_SESSION(name, filepath)      AR_CT_PROF_BEGIN_SESSION(name, filepath)
         #define AR_PROFILE_END_SESSION(name)                  AR_CT_PROF_END_SESSION()
-        #define AR_PROFILE_FRAME(...)
+        #define AR_PROFILE_FRAME(name)                        AR_CT_PROF_FRAME(name)
         #define AR_PROFILE_FUNCTION(...)                      AR_CT_PROF_FUNCTION()
         #define AR_PROFILE_TAG(name, ...)
         #define AR_PROFILE_SCOPE(name)                        AR_CT_PROF_SCOPE(name)
-        #define AR_PROFILE_THREAD(...)
+        #define AR_PROFILE_THREAD(name)                       AR_CT_PROF_THREAD(name)
 
     #endif // AURORA_USE_OPTICK
 
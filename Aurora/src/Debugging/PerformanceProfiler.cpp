@@ -0,0 +1,243 @@
+#include "Aurorapch.h"
+#include "PerformanceProfiler.h"
+
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace Aurora {
+
+	// Everything here is constant initialized (zeroed) before any dynamic initialization happens, which is what allows
+	// AR_SCOPE_PERF to register counters from static initializers in other translation units
+	static std::mutex s_RegistryMutex;
+	static const char* s_CounterNames[PerformanceProfiler::MaxCounters];
+	static std::atomic<uint32_t> s_CounterCount{ 0 };
+
+	static std::atomic<uint32_t> s_ThreadCount{ 0 };
+	static std::atomic<void*> s_ThreadBlocks[PerformanceProfiler::MaxThreads];
+
+	static float s_History[PerformanceProfiler::MaxCounters][PerformanceProfiler::HistoryFrameCount];
+	static uint32_t s_LastCallCount[PerformanceProfiler::MaxCounters];
+	static uint32_t s_HistoryHead = 0; // Index where the next frame will be written
+	static uint32_t s_HistorySize = 0;
+
+	uint32_t PerformanceProfiler::RegisterCounter(const char* name)
+	{
+		std::scoped_lock<std::mutex> lock(s_RegistryMutex);
+
+		uint32_t count = s_CounterCount.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (strcmp(s_CounterNames[i], name) == 0)
+				return i;
+		}
+
+		if (count >= MaxCounters)
+		{
+			AR_CORE_ASSERT(false, "Exceeded the maximum amount of performance counters!");
+			return InvalidCounter;
+		}
+
+		s_CounterNames[count] = name;
+		s_CounterCount.store(count + 1, std::memory_order_release);
+
+		return count;
+	}
+
+	PerformanceProfiler::ThreadCounters* PerformanceProfiler::RegisterThread()
+	{
+		uint32_t index = s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+		if (index >= MaxThreads)
+			return nullptr;
+
+		// These blocks live for the whole program since the collector could be reading them while a thread is exiting
+		ThreadCounters* counters = new ThreadCounters();
+		s_ThreadBlocks[index].store(counters, std::memory_order_release);
+		s_ThreadCounters = counters;
+
+		return counters;
+	}
+
+	void PerformanceProfiler::EndFrame()
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint32_t counterCount = s_CounterCount.load(std::memory_order_acquire);
+		uint32_t threadCount = std::min(s_ThreadCount.load(std::memory_order_acquire), MaxThreads);
+
+		float frameTotals[MaxCounters] = {};
+		uint32_t frameCalls[MaxCounters] = {};
+
+		for (uint32_t t = 0; t < threadCount; t++)
+		{
+			// The slot could be reserved but not published yet, in that case it will be collected next frame
+			ThreadCounters* counters = (ThreadCounters*)s_ThreadBlocks[t].load(std::memory_order_acquire);
+			if (!counters)
+				continue;
+
+			for (uint32_t i = 0; i < counterCount; i++)
+			{
+				uint64_t nanoSeconds = counters->Nanoseconds[i].exchange(0, std::memory_order_relaxed);
+				uint32_t calls = counters->CallCount[i].exchange(0, std::memory_order_relaxed);
+				frameTotals[i] += (float)((double)nanoSeconds * 0.000001);
+				frameCalls[i] += calls;
+			}
+		}
+
+		for (uint32_t i = 0; i < counterCount; i++)
+		{
+			s_History[i][s_HistoryHead] = frameTotals[i];
+			s_LastCallCount[i] = frameCalls[i];
+		}
+
+		s_HistoryHead = (s_HistoryHead + 1) % HistoryFrameCount;
+		s_HistorySize = std::min(s_HistorySize + 1, HistoryFrameCount);
+	}
+
+	uint32_t PerformanceProfiler::GetCounterCount()
+	{
+		return s_CounterCount.load(std::memory_order_acquire);
+	}
+
+	const char* PerformanceProfiler::GetCounterName(uint32_t counterID)
+	{
+		AR_CORE_ASSERT(counterID < GetCounterCount(), "Invalid counter ID!");
+
+		return s_CounterNames[counterID];
+	}
+
+	uint32_t PerformanceProfiler::GetHistorySize()
+	{
+		return s_HistorySize;
+	}
+
+	uint32_t PerformanceProfiler::GetHistoryOffset()
+	{
+		// Until the ring buffer wraps around the oldest frame is at 0, after that it is the one about to be overwritten
+		return s_HistorySize < HistoryFrameCount ? 0 : s_HistoryHead;
+	}
+
+	const float* PerformanceProfiler::GetCounterHistory(uint32_t counterID)
+	{
+		AR_CORE_ASSERT(counterID < GetCounterCount(), "Invalid counter ID!");
+
+		return s_History[counterID];
+	}
+
+	PerformanceProfiler::CounterStats PerformanceProfiler::GetCounterStats(uint32_t counterID)
+	{
+		AR_CORE_ASSERT(counterID < GetCounterCount(), "Invalid counter ID!");
+
+		CounterStats stats;
+		if (s_HistorySize == 0)
+			return stats;
+
+		uint32_t lastFrame = (s_HistoryHead + HistoryFrameCount - 1) % HistoryFrameCount;
+		stats.Last = s_History[counterID][lastFrame];
+		stats.LastCallCount = s_LastCallCount[counterID];
+
+		float sorted[HistoryFrameCount];
+		uint32_t offset = GetHistoryOffset();
+		double sum = 0.0;
+		for (uint32_t i = 0; i < s_HistorySize; i++)
+		{
+			sorted[i] = s_History[counterID][(offset + i) % HistoryFrameCount];
+			sum += sorted[i];
+		}
+
+		std::sort(sorted, sorted + s_HistorySize);
+
+		// Nearest rank percentiles
+		auto percentile = [&sorted](uint32_t size, float p) -> float
+		{
+			uint32_t rank = (uint32_t)std::ceil(p * (float)size);
+			return sorted[std::clamp(rank, 1u, size) - 1];
+		};
+
+		stats.Min = sorted[0];
+		stats.Max = sorted[s_HistorySize - 1];
+		stats.Avg = (float)(sum / (double)s_HistorySize);
+		stats.P95 = percentile(s_HistorySize, 0.95f);
+		stats.P99 = percentile(s_HistorySize, 0.99f);
+
+		return stats;
+	}
+
+	bool PerformanceProfiler::ExportToCSV(const std::string& filepath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		std::ofstream stream(filepath);
+		if (!stream.is_open())
+		{
+			AR_CORE_ERROR_TAG("PerformanceProfiler", "Could not open file for writing: {0}", filepath);
+
+			return false;
+		}
+
+		uint32_t counterCount = GetCounterCount();
+		uint32_t offset = GetHistoryOffset();
+
+		stream << "Frame";
+		for (uint32_t i = 0; i < counterCount; i++)
+			stream << ",\"" << s_CounterNames[i] << '"';
+		stream << '\n';
+
+		for (uint32_t frame = 0; frame < s_HistorySize; frame++)
+		{
+			stream << frame;
+			for (uint32_t i = 0; i < counterCount; i++)
+				stream << ',' << s_History[i][(offset + frame) % HistoryFrameCount];
+			stream << '\n';
+		}
+
+		AR_CORE_INFO_TAG("PerformanceProfiler", "Exported {0} frames of {1} counters to {2}", s_HistorySize, counterCount, filepath);
+
+		return true;
+	}
+
+	bool PerformanceProfiler::ExportToJSON(const std::string& filepath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		std::ofstream stream(filepath);
+		if (!stream.is_open())
+		{
+			AR_CORE_ERROR_TAG("PerformanceProfiler", "Could not open file for writing: {0}", filepath);
+
+			return false;
+		}
+
+		uint32_t counterCount = GetCounterCount();
+		uint32_t offset = GetHistoryOffset();
+
+		stream << "{\n\t\"FrameCount\": " << s_HistorySize << ",\n\t\"Counters\": [";
+		for (uint32_t i = 0; i < counterCount; i++)
+		{
+			CounterStats stats = GetCounterStats(i);
+
+			stream << (i == 0 ? "\n" : ",\n");
+			stream << "\t\t{\n";
+			stream << "\t\t\t\"Name\": \"" << s_CounterNames[i] << "\",\n";
+			stream << "\t\t\t\"Min\": " << stats.Min << ",\n";
+			stream << "\t\t\t\"Avg\": " << stats.Avg << ",\n";
+			stream << "\t\t\t\"P95\": " << stats.P95 << ",\n";
+			stream << "\t\t\t\"P99\": " << stats.P99 << ",\n";
+			stream << "\t\t\t\"Max\": " << stats.Max << ",\n";
+			stream << "\t\t\t\"Samples\": [";
+			for (uint32_t frame = 0; frame < s_HistorySize; frame++)
+			{
+				if (frame > 0)
+					stream << ", ";
+				stream << s_History[i][(offset + frame) % HistoryFrameCount];
+			}
+			stream << "]\n\t\t}";
+		}
+		stream << "\n\t]\n}\n";
+
+		AR_CORE_INFO_TAG("PerformanceProfiler", "Exported {0} frames of {1} counters to {2}", s_HistorySize, counterCount, filepath);
+
+		return true;
+	}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ * The per frame performance counters.
+ * Every AR_SCOPE_PERF call site registers its name ONCE and gets back an integer slot that it keeps in a function local
+ * static, so the hot path (DrawQuad gets hit thousands of times a frame) is just a clock read and a relaxed atomic add into
+ * a block that belongs to the calling thread. No map lookups, no allocations and no locks after the first call.
+ * Each thread that submits a timing gets its own block of accumulators, and at the end of the frame the main thread collects
+ * and resets all the blocks and pushes the totals into a ring buffer that holds the last HistoryFrameCount frames.
+ * Stats (min/avg/p95/p99/max) are only computed when someone asks for them, which is the editor once per tick.
+ *
+ * All the storage is static and constant initialized so that counters can be registered during static initialization
+ * without caring about the order in which translation units get initialized.
+ */
+
+#include "Core/Base.h"
+
+#include <atomic>
+#include <string>
+
+namespace Aurora {
+
+	class PerformanceProfiler
+	{
+	public:
+		static constexpr uint32_t MaxCounters = 128;
+		static constexpr uint32_t MaxThreads = 64;
+		static constexpr uint32_t HistoryFrameCount = 240;
+		static constexpr uint32_t InvalidCounter = ~0u;
+
+		struct CounterStats
+		{
+			float Last = 0.0f; // Milliseconds
+			float Min = 0.0f;
+			float Avg = 0.0f;
+			float P95 = 0.0f;
+			float P99 = 0.0f;
+			float Max = 0.0f;
+			uint32_t LastCallCount = 0;
+		};
+
+	public:
+		// Returns the slot of the counter, if a counter with the same name was registered before its slot is returned
+		static uint32_t RegisterCounter(const char* name);
+
+		AR_FORCE_INLINE static void SubmitTiming(uint32_t counterID, uint64_t nanoSeconds)
+		{
+			if (counterID == InvalidCounter)
+				return;
+
+			ThreadCounters* counters = s_ThreadCounters ? s_ThreadCounters : RegisterThread();
+			if (!counters)
+				return;
+
+			// Only the owning thread ever adds into its block, the collector exchanges with 0 at the end of the frame
+			counters->Nanoseconds[counterID].fetch_add(nanoSeconds, std::memory_order_relaxed);
+			counters->CallCount[counterID].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Collects the accumulated timings of all threads into the history, should be called once per frame from the main thread
+		static void EndFrame();
+
+		static uint32_t GetCounterCount();
+		static const char* GetCounterName(uint32_t counterID);
+
+		// Number of frames that contain valid data in the history, maxes at HistoryFrameCount
+		static uint32_t GetHistorySize();
+		// Index of the oldest frame inside the ring buffer, useful for ImGui::PlotLines values_offset
+		static uint32_t GetHistoryOffset();
+		// Returns a pointer to HistoryFrameCount floats (the ring buffer of the counter)
+		static const float* GetCounterHistory(uint32_t counterID);
+
+		static CounterStats GetCounterStats(uint32_t counterID);
+
+		// Both export the whole history of all the counters in chronological order, returns false if the file could not be opened
+		static bool ExportToCSV(const std::string& filepath);
+		static bool ExportToJSON(const std::string& filepath);
+
+	private:
+		struct ThreadCounters
+		{
+			std::atomic<uint64_t> Nanoseconds[MaxCounters];
+			std::atomic<uint32_t> CallCount[MaxCounters];
+		};
+
+		static ThreadCounters* RegisterThread();
+
+	private:
+		inline static thread_local ThreadCounters* s_ThreadCounters = nullptr;
+
+	};
+
+}
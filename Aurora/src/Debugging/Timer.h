@@ -1,8 +1,9 @@
 #pragma once
 
 #include "Logging/Log.h"
+#include "PerformanceProfiler.h"
 
-#include <unordered_map>
+#include <chrono>
 
 namespace Aurora {
 
@@ -46,41 +47,24 @@ namespace Aurora {
 		Timer m_Timer;
 	};
 
-	class PerformanceProfiler
+	class PerFrameTimer
 	{
-	public:
-		void SetPerFrameTiming(const char* name, float time)
-		{
-			if (m_PerFrameData.find(name) == m_PerFrameData.end())
-				m_PerFrameData[name] = 0.0f;
-
-			m_PerFrameData[name] += time;
-		}
-
-		void Clear() { m_PerFrameData.clear(); }
-		const std::unordered_map<const char*, float>& GetPerFrameData() const { return m_PerFrameData; }
-
 	private:
-		std::unordered_map<const char*, float> m_PerFrameData;
-
-	};
+		using HighResClock = std::chrono::high_resolution_clock;
 
-	class PerFrameTimer
-	{
 	public:
-		PerFrameTimer(const char* name, PerformanceProfiler* profiler)
-			: m_Name(name), m_Profiler(profiler) {}
+		AR_FORCE_INLINE PerFrameTimer(uint32_t counterID)
+			: m_CounterID(counterID), m_Start(HighResClock::now()) {}
 
-		~PerFrameTimer()
+		AR_FORCE_INLINE ~PerFrameTimer()
 		{
-			float time = (float)m_Timer.ElapsedMillis();
-			m_Profiler->SetPerFrameTiming(m_Name, time);
+			uint64_t nanoSeconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(HighResClock::now() - m_Start).count();
+			PerformanceProfiler::SubmitTiming(m_CounterID, nanoSeconds);
 		}
 
 	private:
-		const char* m_Name;
-		PerformanceProfiler* m_Profiler;
-		Timer m_Timer;
+		uint32_t m_CounterID;
+		std::chrono::time_point<HighResClock> m_Start;
 
 	};
 
@@ -89,7 +73,9 @@ namespace Aurora {
 // To disable timers just do #if 0
 #if 1
 
-	#define AR_SCOPE_PERF(name)      Aurora::PerFrameTimer AR_CONCAT_MACRO(timer, __LINE__)(name, Aurora::Application::GetApp().GetPerformanceProfiler())
+	// The counter slot is resolved once per call site, after that it is only a clock read and an atomic add
+	#define AR_SCOPE_PERF(name)      static const uint32_t AR_CONCAT_MACRO(perfCounter, __LINE__) = ::Aurora::PerformanceProfiler::RegisterCounter(name);\
+                                     ::Aurora::PerFrameTimer AR_CONCAT_MACRO(timer, __LINE__)(AR_CONCAT_MACRO(perfCounter, __LINE__))
 	#define AR_SCOPED_TIMER(name)    Aurora::ScopedTimer AR_CONCAT_MACRO(timer, __LINE__)(name)
 
 #else
@@ -31,6 +31,7 @@ namespace Aurora {
 		void Focus(const glm::vec3& focusPoint);
 
 		void SetViewportSize(uint32_t width, uint32_t height);
+		inline uint32_t GetViewportHeight() const { return m_ViewportHeight; }
 
 		float GetCameraSpeed() const;
 
@@ -45,6 +46,8 @@ namespace Aurora {
 		inline void SetDistance(float distance) { m_Distance = distance; }
 
 		const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
+		inline float GetNearClip() const { return m_NearClip; }
+		inline float GetFarClip() const { return m_FarClip; }
 		glm::mat4 GetViewProjection() const { return GetProjection() * m_ViewMatrix; }
 
 		[[nodiscard]] float GetPitch() const { return m_Pitch; }
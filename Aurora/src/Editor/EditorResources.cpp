@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "EditorResources.h"
 
+#include "Asset/VirtualFileSystem.h"
+
 namespace Aurora {
 
 	void EditorResources::Init()
@@ -33,7 +35,7 @@ namespace Aurora {
 	{
 		std::filesystem::path path = std::filesystem::path("Resources") / "EditorInternal" / texturePath;
 
-		if (!std::filesystem::exists(path))
+		if (!VirtualFileSystem::Exists(path.string()))
 		{
 			AR_CORE_CRITICAL_TAG("EditorResources", "Texture Path {0} does not exist!", path.string());
 			AR_CORE_ASSERT(false);
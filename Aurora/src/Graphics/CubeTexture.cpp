@@ -1,28 +1,136 @@
 #include "Aurorapch.h"
 #include "CubeTexture.h"
 
+#include "Asset/VirtualFileSystem.h"
+#include "Core/JobSystem.h"
+#include "Renderer/RenderCommand.h"
 #include "Utils/ImageLoader.h"
 
 #include <glad/glad.h>
-#include <stb_image/stb_image.h>
 
 namespace Aurora {
 
+	namespace Utils {
+
+		// Names the faces usually go by, in face order
+		static const std::vector<std::vector<const char*>> CubeFaceNames = {
+			{ "right", "posx", "px" },
+			{ "left", "negx", "nx" },
+			{ "top", "posy", "py", "up" },
+			{ "bottom", "negy", "ny", "down" },
+			{ "front", "posz", "pz" },
+			{ "back", "negz", "nz" }
+		};
+
+		static bool IsCubeFaceImage(const std::filesystem::path& path)
+		{
+			std::string extension = path.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+
+			return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp" || extension == ".hdr";
+		}
+
+		static int32_t CubeFaceFromName(const std::filesystem::path& path)
+		{
+			std::string name = path.stem().string();
+			std::transform(name.begin(), name.end(), name.begin(), [](char c) { return (char)std::tolower(c); });
+
+			for (uint32_t face = 0; face < CubeFaceNames.size(); face++)
+			{
+				for (const char* faceName : CubeFaceNames[face])
+				{
+					if (name.find(faceName) != std::string::npos)
+						return (int32_t)face;
+				}
+			}
+
+			return -1;
+		}
+
+		static GLenum GLInternalFormatFromAFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::RGBA:        return GL_RGBA8;
+				case ImageFormat::RG16F:       return GL_RG16F;
+				case ImageFormat::RGBA16F:     return GL_RGBA16F;
+				case ImageFormat::RGBA32F:     return GL_RGBA32F;
+			}
+
+			AR_CORE_ASSERT(false, "Unsupported cube texture format!");
+			return 0;
+		}
+
+		static GLenum GLDataFormatFromAFormat(ImageFormat format)
+		{
+			return format == ImageFormat::RG16F ? GL_RG : GL_RGBA;
+		}
+
+		static GLenum GLDataTypeFromAFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::RGBA:        return GL_UNSIGNED_BYTE;
+				case ImageFormat::RG16F:
+				case ImageFormat::RGBA16F:     return GL_HALF_FLOAT;
+				case ImageFormat::RGBA32F:     return GL_FLOAT;
+			}
+
+			AR_CORE_ASSERT(false, "Unsupported cube texture format!");
+			return 0;
+		}
+
+		static uint32_t BytesPerTexel(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::RGBA:        return 4;
+				case ImageFormat::RG16F:       return 4;
+				case ImageFormat::RGBA16F:     return 8;
+				case ImageFormat::RGBA32F:     return 16;
+			}
+
+			AR_CORE_ASSERT(false, "Unsupported cube texture format!");
+			return 0;
+		}
+
+	}
+
 	CubeTexture::CubeTexture(const std::string& directory)
 		: m_Directory(directory)
 	{
-		LoadFromDirectory();
+		std::vector<std::string> faces = GetFacePaths(m_Directory);
+		if (faces.empty())
+		{
+			AR_CORE_ERROR_TAG("CubeTexture", "'{0}' does not have the six faces of a cube map!", directory);
+			return;
+		}
+
+		LoadFaces(faces);
 	}
 
 	CubeTexture::CubeTexture(const std::vector<std::string>& filepaths)
 		: m_Directory(), m_Filepaths(filepaths)
 	{
-		LoadFromFilePaths();
+		if (m_Filepaths.size() != FaceCount)
+		{
+			AR_CORE_ERROR_TAG("CubeTexture", "A cube map needs six faces, {0} were given!", m_Filepaths.size());
+			return;
+		}
+
+		LoadFaces(m_Filepaths);
+	}
+
+	CubeTexture::CubeTexture(ImageFormat format, uint32_t size, uint32_t levelCount)
+	{
+		Allocate(format, size, levelCount);
 	}
 
 	CubeTexture::~CubeTexture()
 	{
 		glDeleteTextures(1, &m_TextureID);
+
+		RenderCommand::ResetStateCache();
 	}
 
 	Ref<CubeTexture> CubeTexture::Create(const std::string& filepath)
@@ -35,122 +143,157 @@ namespace Aurora {
 		return CreateRef<CubeTexture>(filepaths);
 	}
 
+	Ref<CubeTexture> CubeTexture::Create(ImageFormat format, uint32_t size, uint32_t levelCount)
+	{
+		return CreateRef<CubeTexture>(format, size, levelCount);
+	}
+
+	std::vector<std::string> CubeTexture::GetFacePaths(const std::filesystem::path& directory)
+	{
+		AR_PROFILE_FUNCTION();
+
+		// Sorted already, the faces can come from an asset pack too
+		std::vector<std::filesystem::path> images;
+		for (const std::string& file : VirtualFileSystem::ListDirectory(directory.string()))
+		{
+			if (Utils::IsCubeFaceImage(file))
+				images.push_back(file);
+		}
+
+		if (images.size() != FaceCount)
+			return {};
+
+		std::vector<std::string> faces(FaceCount);
+		bool matched = true;
+		for (const std::filesystem::path& image : images)
+		{
+			int32_t face = Utils::CubeFaceFromName(image);
+			if (face < 0 || !faces[face].empty())
+			{
+				matched = false;
+				break;
+			}
+
+			faces[face] = image.string();
+		}
+
+		if (!matched)
+		{
+			for (uint32_t face = 0; face < FaceCount; face++)
+				faces[face] = images[face].string();
+		}
+
+		return faces;
+	}
+
 	void CubeTexture::Bind(uint32_t slot) const
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, m_TextureID);
+		RenderCommand::BindTexture(slot, m_TextureID);
 	}
 
 	void CubeTexture::UnBind(uint32_t slot) const
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, 0);
+		RenderCommand::BindTexture(slot, 0);
 	}
 
-	void CubeTexture::LoadFromDirectory()
+	void CubeTexture::BindImage(uint32_t unit, ImageAccess access, uint32_t mipLevel) const
 	{
-		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(mipLevel < m_LevelCount, "Mip level is out of range!");
 
-		std::vector<std::string> cubeFaces;
-		for (auto& path : std::filesystem::directory_iterator(m_Directory))
-		{
-			cubeFaces.push_back(path.path().string());
-		}
+		RenderCommand::BindImageTexture(unit, m_TextureID, mipLevel, access, m_Format, true);
+	}
 
-		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-		for (int i = 0; i < cubeFaces.size(); i++)
-		{
-			auto& imageData = Utils::ImageLoader::LoadImageFile(cubeFaces[i]);
+	uint32_t CubeTexture::GetLevelSize(uint32_t level) const
+	{
+		uint32_t size = std::max(m_Size >> level, 1u);
 
-			if (imageData.PixelData)
-			{
-				uint32_t width = imageData.Width;
-				uint32_t height = imageData.Height;
-				uint32_t numChannels = imageData.Channels;
+		return size * size * FaceCount * Utils::BytesPerTexel(m_Format);
+	}
 
-				GLint internalFormat = 0;
-				GLenum format = 0;
-				if (numChannels == 1)
-				{
-					internalFormat = GL_R32I;
-					format = GL_RED;
-				}
-				else if (numChannels == 3)
-				{
-					internalFormat = GL_RGB8;
-					format = GL_RGB;
-				}
-				else if (numChannels == 4)
-				{
-					internalFormat = GL_RGBA8;
-					format = GL_RGBA;
-				}
+	void CubeTexture::SetLevelData(uint32_t level, const void* data, uint32_t size)
+	{
+		AR_PROFILE_FUNCTION();
 
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, imageData.PixelData);
-			}
-			else
-				AR_CORE_ERROR_TAG("CubeTexture", "Failed to load face : {0}.", cubeFaces[i]);
+		AR_CORE_ASSERT(level < m_LevelCount, "Mip level is out of range!");
+		AR_CORE_ASSERT(size == GetLevelSize(level), "Data has to cover all six faces of the level!");
 
-			Utils::ImageLoader::FreeImage();
-		}
+		uint32_t levelSize = std::max(m_Size >> level, 1u);
+		glTextureSubImage3D(m_TextureID, level, 0, 0, 0, levelSize, levelSize, FaceCount, Utils::GLDataFormatFromAFormat(m_Format), Utils::GLDataTypeFromAFormat(m_Format), data);
 	}
 
-	void CubeTexture::LoadFromFilePaths()
+	void CubeTexture::GetLevelData(uint32_t level, std::vector<Byte>& outData) const
 	{
 		AR_PROFILE_FUNCTION();
 
+		AR_CORE_ASSERT(level < m_LevelCount, "Mip level is out of range!");
+
+		outData.resize(GetLevelSize(level));
+		glGetTextureImage(m_TextureID, level, Utils::GLDataFormatFromAFormat(m_Format), Utils::GLDataTypeFromAFormat(m_Format), (GLsizei)outData.size(), outData.data());
+	}
+
+	void CubeTexture::Allocate(ImageFormat format, uint32_t size, uint32_t levelCount)
+	{
+		m_Format = format;
+		m_Size = size;
+		m_LevelCount = levelCount;
+
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-		for (int i = 0; i < m_Filepaths.size(); i++)
+		glTextureStorage2D(m_TextureID, levelCount, Utils::GLInternalFormatFromAFormat(format), size, size);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	}
+
+	void CubeTexture::LoadFaces(const std::vector<std::string>& faces)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("CubeTexture::LoadFaces");
+
+		// Decoding is most of the time spent here, so every face gets its own job
+		Utils::ImageData images[FaceCount];
+		JobSystem::ParallelFor(FaceCount, 1, [&](uint32_t face)
 		{
-			auto& imageData = Utils::ImageLoader::LoadImageFile(m_Filepaths[i]);
+			Utils::ImageLoadSettings loadSettings;
+			loadSettings.Channels = 4;
+
+			images[face] = Utils::ImageLoader::LoadImageFile(faces[face], loadSettings);
+		});
 
-			if (imageData.PixelData)
+		bool valid = true;
+		for (uint32_t face = 0; face < FaceCount; face++)
+		{
+			const Utils::ImageData& image = images[face];
+			if (!image)
+			{
+				AR_CORE_ERROR_TAG("CubeTexture", "Failed to load face : {0}.", faces[face]);
+				valid = false;
+			}
+			else if (image.GetWidth() != image.GetHeight() || image.GetWidth() != images[0].GetWidth() || image.IsHDR() != images[0].IsHDR())
 			{
-				uint32_t width = imageData.Width;
-				uint32_t height = imageData.Height;
-				uint32_t numChannels = imageData.Channels;
+				AR_CORE_ERROR_TAG("CubeTexture", "Face {0} has to be square and match the size and type of the other faces!", faces[face]);
+				valid = false;
+			}
+		}
 
-				GLint internalFormat = 0;
-				GLenum format = 0;
-				if (numChannels == 1)
-				{
-					internalFormat = GL_R32I;
-					format = GL_RED;
-				}
-				else if (numChannels == 3)
-				{
-					internalFormat = GL_RGB8;
-					format = GL_RGB;
-				}
-				else if (numChannels == 4)
-				{
-					internalFormat = GL_RGBA8;
-					format = GL_RGBA;
-				}
+		if (valid)
+		{
+			uint32_t size = images[0].GetWidth();
+			uint32_t levelCount = 1 + (uint32_t)std::floor(std::log2((float)size));
 
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, imageData.PixelData);
-			}
-			else
-				AR_CORE_ERROR_TAG("CubeTexture", "Failed to load face : {0}.", m_Filepaths[i]);
+			// HDR faces are kept in half floats, that is plenty for lighting and half the memory of the decoded floats
+			Allocate(images[0].IsHDR() ? ImageFormat::RGBA16F : ImageFormat::RGBA, size, levelCount);
+
+			for (uint32_t face = 0; face < FaceCount; face++)
+				glTextureSubImage3D(m_TextureID, 0, 0, 0, face, size, size, 1, GL_RGBA, images[face].IsHDR() ? GL_FLOAT : GL_UNSIGNED_BYTE, images[face].GetPixels());
 
-			Utils::ImageLoader::FreeImage();
+			glGenerateTextureMipmap(m_TextureID);
 		}
 	}
 
-}
\ No newline at end of file
+}
@@ -5,34 +5,68 @@
 
 #include <filesystem>
 
+/*
+ * Cube maps are always stored with immutable storage and a full mip chain. The six faces of a cube map loaded from images are decoded
+ * in parallel on the JobSystem's workers and then uploaded together on the main thread. Faces are in the GL order everywhere:
+ * +X, -X, +Y, -Y, +Z, -Z (right, left, top, bottom, front, back).
+ *
+ * The empty cube maps are for compute shaders to render into, see Renderer/Environment.h.
+ */
+
 namespace Aurora {
 
 	class CubeTexture : public Texture
 	{
+	public:
+		static constexpr uint32_t FaceCount = 6;
+
 	public:
 		CubeTexture() = default;
-		CubeTexture(const std::string& directory); // This constructor is uses the filesystem api to get all the entries
-		CubeTexture(const std::vector<std::string>& filepaths);
+		CubeTexture(const std::string& directory); // The faces are picked from the directory by their names, see GetFacePaths
+		CubeTexture(const std::vector<std::string>& filepaths); // Has to be the six faces in order
+		CubeTexture(ImageFormat format, uint32_t size, uint32_t levelCount);
 		virtual ~CubeTexture();
 
 		static Ref<CubeTexture> Create(const std::string& filepath);
 		static Ref<CubeTexture> Create(const std::vector<std::string>& filepaths);
+		static Ref<CubeTexture> Create(ImageFormat format, uint32_t size, uint32_t levelCount);
+
+		// The six image files of the directory in face order. Faces are matched by the usual names (right/left/top/bottom/front/back,
+		// posx/negx..., px/nx...), if that does not work out they are taken in the order of their file names.
+		// Empty if the directory does not have exactly six images
+		static std::vector<std::string> GetFacePaths(const std::filesystem::path& directory);
 
 		virtual void Bind(uint32_t slot = 0) const override;
 		virtual void UnBind(uint32_t slot = 0) const override;
 
+		// Binds all six faces of a mip level for image load/store, as an imageCube in the shader
+		void BindImage(uint32_t unit, ImageAccess access, uint32_t mipLevel = 0) const;
+
+		// All six faces of a level one after the other in face order, RGBA16F levels are in half floats
+		uint32_t GetLevelSize(uint32_t level) const;
+		void SetLevelData(uint32_t level, const void* data, uint32_t size);
+		void GetLevelData(uint32_t level, std::vector<Byte>& outData) const;
+
 		[[nodiscard]] inline virtual uint32_t GetTextureID() const override { return m_TextureID; }
+		[[nodiscard]] inline ImageFormat GetFormat() const { return m_Format; }
+		[[nodiscard]] inline uint32_t GetSize() const { return m_Size; }
+		[[nodiscard]] inline uint32_t GetLevelCount() const { return m_LevelCount; }
+		// False if any of the faces could not be loaded, the texture is empty then
+		[[nodiscard]] inline bool IsLoaded() const { return m_TextureID != 0; }
 
 	private:
-		void LoadFromDirectory();
-		void LoadFromFilePaths();
+		void LoadFaces(const std::vector<std::string>& faces);
+		void Allocate(ImageFormat format, uint32_t size, uint32_t levelCount);
 
 	private:
 		uint32_t m_TextureID = 0;
+		ImageFormat m_Format = ImageFormat::None;
+		uint32_t m_Size = 0;
+		uint32_t m_LevelCount = 0;
 
 		std::filesystem::path m_Directory;
 		std::vector<std::string> m_Filepaths;
 
 	};
 
-}
\ No newline at end of file
+}
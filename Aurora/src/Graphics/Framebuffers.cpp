@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "Framebuffers.h"
 
+#include "Renderer/RenderCommand.h"
+
 #include <glad/glad.h>
 
 namespace Aurora {
@@ -257,6 +259,8 @@ namespace Aurora {
 		glDeleteFramebuffers(1, &m_FrameBufferID);
 		glDeleteTextures((GLsizei)m_ColorAttachments.size(), m_ColorAttachments.data());
 		glDeleteRenderbuffers(1, &m_DepthAttachment);
+
+		RenderCommand::ResetStateCache();
 	}
 
 	void Framebuffer::Invalidate()
@@ -348,6 +352,9 @@ namespace Aurora {
 		AR_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Incomplete Frambuffer!");
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// The attachments were bound with glBindTexture on whatever unit was active
+		RenderCommand::ResetStateCache();
 	}
 
 	void Framebuffer::Blit(uint32_t src, uint32_t dst, uint32_t srcWidth, uint32_t srcHeight, uint32_t srcAttachment, uint32_t dstWidth, uint32_t dstHeight, uint32_t dstAttachment)
@@ -357,6 +364,11 @@ namespace Aurora {
 		glBlitNamedFramebuffer(src, dst, 0, 0, srcWidth, srcHeight, 0, 0, dstWidth, dstHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 	}
 
+	void Framebuffer::BlitDepth(uint32_t src, uint32_t dst, uint32_t width, uint32_t height)
+	{
+		glBlitNamedFramebuffer(src, dst, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	}
+
 	void Framebuffer::Resize(uint32_t width, uint32_t height)
 	{
 		constexpr uint32_t s_MaxFramebufferSize = 8192;
@@ -384,6 +396,15 @@ namespace Aurora {
 		glReadPixels(x, y, 1, 1, Utils::GLFormatFromAFormat(spec.TextureFormat), Utils::GLDataTypeFromAFormat(spec.TextureFormat), data);
 	}
 
+	void Framebuffer::BindColorAttachmentImage(uint32_t attachmentIndex, uint32_t unit, ImageAccess access) const
+	{
+		AR_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size(), "Attachment index can not be more than the available attachments");
+		AR_CORE_ASSERT(m_Specification.Samples <= 1, "Multisampled attachments can not be bound as images");
+
+		const auto& spec = m_ColorAttachmentsSpecification[attachmentIndex];
+		RenderCommand::BindImageTexture(unit, m_ColorAttachments[attachmentIndex], 0, access, spec.TextureFormat);
+	}
+
 	// TODO: Remove or maybe keep it since this is really not needed once ray casting is a thing
 	void Framebuffer::ClearTextureAttachment(uint32_t attachmentIndex, const void* data)
 	{
@@ -64,6 +64,8 @@ namespace Aurora {
 
 		static Ref<Framebuffer> Create(const FramebufferSpecification& spec);
 		static void Blit(uint32_t src, uint32_t dst, uint32_t srcWidth, uint32_t srcHeight, uint32_t srcAttachment, uint32_t dstWidth, uint32_t dstHeight, uint32_t dstAttachment);
+		// Resolves the depth attachment, both framebuffers need the same depth format and the same size
+		static void BlitDepth(uint32_t src, uint32_t dst, uint32_t width, uint32_t height);
 
 		void Invalidate();
 		void Resize(uint32_t width, uint32_t height);
@@ -74,11 +76,16 @@ namespace Aurora {
 		void ReadPixel(uint32_t attachmentIndex, int x, int y, void* data);
 		void ClearTextureAttachment(uint32_t attachmentIndex, const void* data);
 
+		// For compute passes that read or write the attachment directly (post processing...), single sampled framebuffers only
+		void BindColorAttachmentImage(uint32_t attachmentIndex, uint32_t unit, ImageAccess access) const;
+
 		uint32_t GetFramebufferID() const { return m_FrameBufferID; }
 		const FramebufferSpecification& GetSpecification() const { return m_Specification; }
 		uint32_t GetColorAttachmentID(uint32_t index = 0) const { AR_CORE_ASSERT(index < m_ColorAttachments.size(), "Index cant be greater than the size");  return m_ColorAttachments[index]; }
 
 		bool HasDepthAttachment() const { return m_DepthAttachment ? true : false; }
+		// Only a texture if DepthAttachmentAsTexture was set, otherwise this is a renderbuffer
+		uint32_t GetDepthAttachmentID() const { return m_DepthAttachment; }
 
 	private:
 		uint32_t m_FrameBufferID = 0;
@@ -0,0 +1,233 @@
+#include "Aurorapch.h"
+#include "GeometryPool.h"
+
+#include "Mesh.h"
+
+#include <glad/glad.h>
+
+namespace Aurora {
+
+	struct GeometryRange
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	struct GeometryPoolData
+	{
+		uint32_t VertexArrayID = 0;
+		uint32_t VertexBufferID = 0;
+		uint32_t IndexBufferID = 0;
+		uint32_t DrawIndexBufferID = 0;
+
+		// Everything past the end is free, the free ranges are the holes before it sorted by offset
+		uint32_t VertexEnd = 0;
+		uint32_t IndexEnd = 0;
+		std::vector<GeometryRange> FreeVertexRanges;
+		std::vector<GeometryRange> FreeIndexRanges;
+
+		uint32_t VertexCount = 0;
+		uint32_t IndexCount = 0;
+	};
+
+	static GeometryPoolData* s_Data = nullptr;
+
+	namespace Utils {
+
+		// First fit in the free ranges, otherwise at the end of the used part. Returns false if neither has room
+		static bool AllocateRange(std::vector<GeometryRange>& freeRanges, uint32_t& end, uint32_t max, uint32_t count, uint32_t& outOffset)
+		{
+			for (auto it = freeRanges.begin(); it != freeRanges.end(); it++)
+			{
+				if (it->Count < count)
+					continue;
+
+				outOffset = it->Offset;
+				it->Offset += count;
+				it->Count -= count;
+				if (it->Count == 0)
+					freeRanges.erase(it);
+
+				return true;
+			}
+
+			if (end + count > max)
+				return false;
+
+			outOffset = end;
+			end += count;
+
+			return true;
+		}
+
+		// Merges the range with the free ranges next to it, if that reaches the end of the used part the end just moves back
+		static void FreeRange(std::vector<GeometryRange>& freeRanges, uint32_t& end, uint32_t offset, uint32_t count)
+		{
+			if (count == 0)
+				return;
+
+			auto it = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset, [](const GeometryRange& range, uint32_t value) { return range.Offset < value; });
+			it = freeRanges.insert(it, { offset, count });
+
+			if (it + 1 != freeRanges.end() && it->Offset + it->Count == (it + 1)->Offset)
+			{
+				it->Count += (it + 1)->Count;
+				freeRanges.erase(it + 1);
+			}
+
+			if (it != freeRanges.begin() && (it - 1)->Offset + (it - 1)->Count == it->Offset)
+			{
+				(it - 1)->Count += it->Count;
+				it = freeRanges.erase(it) - 1;
+			}
+
+			if (it->Offset + it->Count == end)
+			{
+				end = it->Offset;
+				freeRanges.erase(it);
+			}
+		}
+
+	}
+
+	void GeometryPool::Init()
+	{
+		AR_PROFILE_FUNCTION();
+
+		s_Data = new GeometryPoolData();
+
+		glCreateBuffers(1, &s_Data->VertexBufferID);
+		glNamedBufferStorage(s_Data->VertexBufferID, (GLsizeiptr)MaxVertices * sizeof(Vertex), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateBuffers(1, &s_Data->IndexBufferID);
+		glNamedBufferStorage(s_Data->IndexBufferID, (GLsizeiptr)MaxIndices * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		std::vector<uint32_t> drawIndices(MaxDrawsPerBatch);
+		for (uint32_t i = 0; i < MaxDrawsPerBatch; i++)
+			drawIndices[i] = i;
+
+		glCreateBuffers(1, &s_Data->DrawIndexBufferID);
+		glNamedBufferStorage(s_Data->DrawIndexBufferID, MaxDrawsPerBatch * sizeof(uint32_t), drawIndices.data(), 0);
+
+		uint32_t vao = 0;
+		glCreateVertexArrays(1, &vao);
+		s_Data->VertexArrayID = vao;
+
+		glVertexArrayVertexBuffer(vao, 0, s_Data->VertexBufferID, 0, sizeof(Vertex));
+		glVertexArrayElementBuffer(vao, s_Data->IndexBufferID);
+
+		// Same layout that the meshes used to set up for themselves
+		auto floatAttribute = [vao](uint32_t location, int count, size_t offset)
+		{
+			glEnableVertexArrayAttrib(vao, location);
+			glVertexArrayAttribFormat(vao, location, count, GL_FLOAT, GL_FALSE, (GLuint)offset);
+			glVertexArrayAttribBinding(vao, location, 0);
+		};
+
+		floatAttribute(0, 3, offsetof(Vertex, Position));
+		floatAttribute(1, 3, offsetof(Vertex, Normal));
+		floatAttribute(2, 2, offsetof(Vertex, TexCoords));
+		floatAttribute(3, 3, offsetof(Vertex, Tangent));
+		floatAttribute(4, 3, offsetof(Vertex, Bitangent));
+
+		glEnableVertexArrayAttrib(vao, 5);
+		glVertexArrayAttribIFormat(vao, 5, MAX_BONE_INFLUENCE, GL_INT, (GLuint)offsetof(Vertex, m_BoneIDs));
+		glVertexArrayAttribBinding(vao, 5, 0);
+
+		floatAttribute(6, MAX_BONE_INFLUENCE, offsetof(Vertex, m_Weights));
+
+		// Draw index, advances once per instance and starts at the baseInstance of the indirect command
+		glVertexArrayVertexBuffer(vao, 1, s_Data->DrawIndexBufferID, 0, sizeof(uint32_t));
+		glVertexArrayBindingDivisor(vao, 1, 1);
+		glEnableVertexArrayAttrib(vao, DrawIndexAttributeLocation);
+		glVertexArrayAttribIFormat(vao, DrawIndexAttributeLocation, 1, GL_UNSIGNED_INT, 0);
+		glVertexArrayAttribBinding(vao, DrawIndexAttributeLocation, 1);
+
+		AR_CORE_INFO_TAG("GeometryPool", "Allocated geometry pool for {0} vertices and {1} indices ({2} MBs)", MaxVertices, MaxIndices,
+			((uint64_t)MaxVertices * sizeof(Vertex) + (uint64_t)MaxIndices * sizeof(uint32_t)) / (1024 * 1024));
+	}
+
+	void GeometryPool::ShutDown()
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!s_Data)
+			return;
+
+		glDeleteVertexArrays(1, &s_Data->VertexArrayID);
+		glDeleteBuffers(1, &s_Data->VertexBufferID);
+		glDeleteBuffers(1, &s_Data->IndexBufferID);
+		glDeleteBuffers(1, &s_Data->DrawIndexBufferID);
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	GeometryAllocation GeometryPool::Allocate(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(s_Data, "GeometryPool is not initialized!");
+
+		// Nothing could be drawn from it and the vertices could never be freed since the allocation would not be valid
+		if (indexCount == 0)
+			return {};
+
+		GeometryAllocation allocation;
+		bool allocated = Utils::AllocateRange(s_Data->FreeVertexRanges, s_Data->VertexEnd, MaxVertices, vertexCount, allocation.BaseVertex);
+		if (allocated && !Utils::AllocateRange(s_Data->FreeIndexRanges, s_Data->IndexEnd, MaxIndices, indexCount, allocation.FirstIndex))
+		{
+			Utils::FreeRange(s_Data->FreeVertexRanges, s_Data->VertexEnd, allocation.BaseVertex, vertexCount);
+			allocated = false;
+		}
+
+		if (!allocated)
+		{
+			AR_CORE_ERROR_TAG("GeometryPool", "Geometry pool is full! Could not allocate {0} vertices and {1} indices", vertexCount, indexCount);
+
+			return {};
+		}
+
+		allocation.VertexCount = vertexCount;
+		allocation.IndexCount = indexCount;
+
+		// Indices stay relative to the mesh, the draws offset them with BaseVertex
+		glNamedBufferSubData(s_Data->VertexBufferID, (GLintptr)allocation.BaseVertex * sizeof(Vertex), (GLsizeiptr)vertexCount * sizeof(Vertex), vertices);
+		glNamedBufferSubData(s_Data->IndexBufferID, (GLintptr)allocation.FirstIndex * sizeof(uint32_t), (GLsizeiptr)indexCount * sizeof(uint32_t), indices);
+
+		s_Data->VertexCount += vertexCount;
+		s_Data->IndexCount += indexCount;
+
+		return allocation;
+	}
+
+	void GeometryPool::Free(GeometryAllocation& allocation)
+	{
+		// The pool might already be gone when the last models are destroyed at shutdown
+		if (!s_Data || !allocation.IsValid())
+			return;
+
+		Utils::FreeRange(s_Data->FreeVertexRanges, s_Data->VertexEnd, allocation.BaseVertex, allocation.VertexCount);
+		Utils::FreeRange(s_Data->FreeIndexRanges, s_Data->IndexEnd, allocation.FirstIndex, allocation.IndexCount);
+
+		s_Data->VertexCount -= allocation.VertexCount;
+		s_Data->IndexCount -= allocation.IndexCount;
+
+		allocation = {};
+	}
+
+	uint32_t GeometryPool::GetVertexArrayID()
+	{
+		return s_Data->VertexArrayID;
+	}
+
+	uint32_t GeometryPool::GetUsedVertexCount()
+	{
+		return s_Data ? s_Data->VertexCount : 0;
+	}
+
+	uint32_t GeometryPool::GetUsedIndexCount()
+	{
+		return s_Data ? s_Data->IndexCount : 0;
+	}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+ * One big vertex buffer and one big index buffer that all the static meshes are sub-allocated from.
+ * Since every mesh lives in the same buffers with the same vertex format, they all share one vertex array and a whole scene of
+ * meshes can be drawn with a single glMultiDrawElementsIndirect call where every draw just points to its range in the pool.
+ *
+ * The vertex array also has a per instance attribute (location 7) that reads from a buffer filled with 0, 1, 2, ... this is how a
+ * multi draw finds its per draw data: every indirect command sets its baseInstance to the index of its first instance's data and
+ * the shader uses that attribute to index into the per draw storage buffer, so instanced commands just read consecutive entries.
+ * It works on any 4.5 context without needing gl_DrawID.
+ *
+ * Freed ranges go into a free list per buffer that is kept sorted and merged with its neighbours, allocations take the first free
+ * range that fits and only grow the used part of the pool when none does. Model frees the allocations of its meshes when it is
+ * destroyed or reloaded.
+ */
+
+#include "Core/Base.h"
+
+namespace Aurora {
+
+	struct Vertex;
+
+	struct GeometryAllocation
+	{
+		uint32_t BaseVertex = 0;
+		uint32_t VertexCount = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+
+		inline bool IsValid() const { return IndexCount != 0; }
+	};
+
+	class GeometryPool
+	{
+	public:
+		static constexpr uint32_t MaxVertices = 512 * 1024;
+		static constexpr uint32_t MaxIndices = 3 * 1024 * 1024;
+		static constexpr uint32_t MaxDrawsPerBatch = 16384; // Size of the draw index buffer, this is instances not commands
+		static constexpr uint32_t DrawIndexAttributeLocation = 7;
+
+	public:
+		static void Init();
+		static void ShutDown();
+
+		// Returns an invalid allocation if the pool is full
+		static GeometryAllocation Allocate(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+		// Gives the ranges back to the pool and invalidates the allocation, anything that still draws from them has to be rebuilt
+		static void Free(GeometryAllocation& allocation);
+
+		static uint32_t GetVertexArrayID();
+
+		// What the live allocations take up, without the free ranges in between them
+		static uint32_t GetUsedVertexCount();
+		static uint32_t GetUsedIndexCount();
+
+	};
+
+}
@@ -338,6 +338,8 @@ namespace Aurora {
 		{
 			m_MaterialFlags &= ~(uint32_t)flag;
 		}
+
+		m_Pipeline = nullptr;
 	}
 
 	const ShaderUniform* Material::FindUniformDeclaration(const std::string& name) const
@@ -7,6 +7,7 @@
 #include "Shader.h"
 #include "Texture.h"
 #include "CubeTexture.h"
+#include "Pipeline.h"
 #include "UniformBuffer.h"
 
 #include <glm/glm.hpp>
@@ -88,7 +89,12 @@ namespace Aurora {
 		bool HasFlag(MaterialFlag flag) const { return (uint32_t)flag & m_MaterialFlags; }
 		void SetFlag(MaterialFlag flag, bool value);
 
+		// The pipeline made from the flags, kept by the renderer so it is not looked up on every draw. Changing a flag drops it
+		const Ref<Pipeline>& GetPipeline() const { return m_Pipeline; }
+		void SetPipeline(const Ref<Pipeline>& pipeline) const { m_Pipeline = pipeline; }
+
 		const Ref<Shader>& GetShader() const { return m_Shader; }
+		const std::map<uint32_t, Ref<Texture2D>>& GetTexture2Ds() const { return m_Texture2Ds; }
 		const std::string& GetName() const { return m_Name; }
 
 	private:
@@ -148,6 +154,7 @@ namespace Aurora {
 		//mutable std::vector<Ref<Texture>> m_Textures; // This contains Texture2Ds plus the CubeTextures
 
 		uint32_t m_MaterialFlags = 0;
+		mutable Ref<Pipeline> m_Pipeline;
 
 		mutable Buffer m_UniformStorageBuffer;
 		// These are automatically sorted according to their slot index which is perfect!
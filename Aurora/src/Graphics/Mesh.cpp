@@ -24,7 +24,6 @@ namespace Aurora {
         uint32_t heightNr = 1;
         for (uint32_t i = 0; i < textures.size(); i++)
         {
-            glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
             // retrieve texture number (the N in diffuse_textureN)
             std::string number;
             std::string name(textures[i].type);
@@ -40,60 +39,28 @@ namespace Aurora {
             // now set the sampler to the correct texture unit
             //shader.SetUniform1i((name + number).c_str(), i); // Not needed when we have bindings
             // and finally bind the texture
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            RenderCommand::BindTexture(i, textures[i].GetTextureID());
         }
 
         // draw mesh
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<uint32_t>(indices.size()), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-
-        // always good practice to set everything back to defaults once configured.
-        glActiveTexture(GL_TEXTURE0);
+        RenderCommand::BindVertexArray(GeometryPool::GetVertexArrayID());
+        glDrawElementsBaseVertex(GL_TRIANGLES, Allocation.IndexCount, GL_UNSIGNED_INT, (void*)((size_t)Allocation.FirstIndex * sizeof(uint32_t)), Allocation.BaseVertex);
     }
 
     void Mesh::setupMesh()
     {
-        // create buffers/arrays
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
-
-        glBindVertexArray(VAO);
-        // load data into vertex buffers
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        // A great thing about structs is that their memory layout is sequential for all its items.
-        // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-        // again translates to 3/2 floats which translates to a byte array.
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), &indices[0], GL_STATIC_DRAW);
+        // all the meshes share the vertex/index buffers and the vertex array of the geometry pool
+        Allocation = GeometryPool::Allocate(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size());
 
-        // set the vertex attribute pointers
-        // vertex Positions
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex normals
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-        // vertex texture coords
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-        // vertex tangent
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-        // vertex bitangent
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
-        // ids
-        glEnableVertexAttribArray(5);
-        glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
-
-        // weights
-        glEnableVertexAttribArray(6);
-        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
-        glBindVertexArray(0);
+        if (vertices.size())
+        {
+            BoundsMin = BoundsMax = vertices[0].Position;
+            for (const Vertex& vertex : vertices)
+            {
+                BoundsMin = glm::min(BoundsMin, vertex.Position);
+                BoundsMax = glm::max(BoundsMax, vertex.Position);
+            }
+        }
     }
 
 }
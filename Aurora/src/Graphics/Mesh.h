@@ -38,7 +38,9 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include "Graphics/GeometryPool.h"
 #include "Graphics/Shader.h"
+#include "Graphics/Texture.h"
 #include "Renderer/RenderCommand.h"
 
 #include <string>
@@ -66,9 +68,12 @@ namespace Aurora {
     };
 
     struct TextureMesh {
-        unsigned int id;
         std::string type;
         std::string path;
+        // null if the texture failed to load. the id is not cached since reloading the texture gives it a new one
+        Ref<Texture2D> texture;
+
+        uint32_t GetTextureID() const { return texture ? texture->GetTextureID() : 0; }
     };
 
     class Mesh {
@@ -77,7 +82,11 @@ namespace Aurora {
         std::vector<Vertex>       vertices;
         std::vector<unsigned int> indices;
         std::vector<TextureMesh>      textures;
-        unsigned int VAO;
+        // where the vertices and indices live inside the GeometryPool, meshes get copied around so the model owning them frees it
+        GeometryAllocation Allocation;
+        // local space bounding box, used for occlusion culling
+        glm::vec3 BoundsMin = glm::vec3(0.0f);
+        glm::vec3 BoundsMax = glm::vec3(0.0f);
 
         // constructor
         Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<TextureMesh> textures);
@@ -86,9 +95,6 @@ namespace Aurora {
         void Draw(Aurora::Shader& shader);
 
     private:
-        // render data 
-        uint32_t VBO, EBO;
-
         // initializes all the buffer objects/arrays
         void setupMesh();
     };
@@ -1,53 +1,104 @@
 #include "Aurorapch.h"
 #include "Model.h"
 
-#include <glad/glad.h>
-#include <stb_image/stb_image.h>
+#include "TextureCooker.h"
+#include "Asset/AssetManager.h"
+#include "Asset/VirtualFileSystem.h"
 
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/postprocess.h>
 
 namespace Aurora {
 
-    static uint32_t TextureFromFile(const std::string& path, const std::string& directory)
-    {
-        std::string filename = path;
-        filename = directory + '/' + filename;
-
-        uint32_t textureID;
-        glGenTextures(1, &textureID);
+    namespace Utils {
 
-        int width, height, nrComponents;
-        Byte* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-        if (data)
+        // lets assimp open the model and whatever files it references (materials, buffers...) through the virtual file system
+        class AssimpFileStream : public Assimp::IOStream
         {
-            GLenum format;
-            if (nrComponents == 1)
-                format = GL_RED;
-            else if (nrComponents == 3)
-                format = GL_RGB;
-            else if (nrComponents == 4)
-                format = GL_RGBA;
-
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            stbi_image_free(data);
-        }
-        else
+        public:
+            AssimpFileStream(FileReader&& reader)
+                : m_Reader(std::move(reader)) {}
+
+            virtual size_t Read(void* buffer, size_t size, size_t count) override
+            {
+                // assimp wants whole elements only
+                size_t elementCount = size ? std::min<size_t>(count, (m_Reader.GetSize() - m_Reader.GetPosition()) / size) : 0;
+                return m_Reader.Read(buffer, (uint64_t)elementCount * size) ? elementCount : 0;
+            }
+
+            virtual size_t Write(const void* buffer, size_t size, size_t count) override { return 0; }
+
+            virtual aiReturn Seek(size_t offset, aiOrigin origin) override
+            {
+                uint64_t position = offset;
+                if (origin == aiOrigin_CUR)
+                    position += m_Reader.GetPosition();
+                else if (origin == aiOrigin_END)
+                    position = m_Reader.GetSize() - std::min<uint64_t>(offset, m_Reader.GetSize());
+
+                return m_Reader.Seek(position) ? aiReturn_SUCCESS : aiReturn_FAILURE;
+            }
+
+            virtual size_t Tell() const override { return (size_t)m_Reader.GetPosition(); }
+            virtual size_t FileSize() const override { return (size_t)m_Reader.GetSize(); }
+            virtual void Flush() override {}
+
+        private:
+            FileReader m_Reader;
+        };
+
+        class AssimpFileSystem : public Assimp::IOSystem
         {
-            AR_CORE_ERROR_TAG("TempModel", "Texture failed to load at path: {0}", path);
-            stbi_image_free(data);
-        }
+        public:
+            virtual bool Exists(const char* filePath) const override { return VirtualFileSystem::Exists(filePath); }
+            virtual char getOsSeparator() const override { return '/'; }
+
+            virtual Assimp::IOStream* Open(const char* filePath, const char* mode) override
+            {
+                // models are only ever read
+                if (std::strchr(mode, 'w') || std::strchr(mode, 'a'))
+                    return nullptr;
+
+                FileReader reader(filePath);
+                if (!reader)
+                    return nullptr;
+
+                return new AssimpFileStream(std::move(reader));
+            }
+
+            virtual void Close(Assimp::IOStream* stream) override { delete stream; }
+        };
 
-        return textureID;
+    }
+
+    ModelImport::ModelImport(const std::string& path)
+        : m_Path(path), m_Importer(new Assimp::Importer())
+    {
+        AR_PROFILE_FUNCTION();
+
+        // read file via ASSIMP
+        m_Importer->SetIOHandler(new Utils::AssimpFileSystem()); // the importer owns it from here on
+        m_Importer->ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+        // check for errors
+        if (!IsValid())
+            AR_CORE_ERROR_TAG("ERROR::ASSIMP", "->{0}", m_Importer->GetErrorString());
+    }
+
+    ModelImport::~ModelImport() = default;
+
+    Ref<ModelImport> ModelImport::Create(const std::string& path)
+    {
+        return CreateRef<ModelImport>(path);
+    }
+
+    bool ModelImport::IsValid() const
+    {
+        const aiScene* scene = m_Importer->GetScene();
+
+        return scene && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode;
     }
 
     Model::Model(std::string path, bool gamma)
@@ -56,24 +107,49 @@ namespace Aurora {
         loadModel(path);
     }
 
+    Model::~Model()
+    {
+        for (Mesh& mesh : meshes)
+            GeometryPool::Free(mesh.Allocation);
+    }
+
+    Ref<Model> Model::Create(const std::string& path)
+    {
+        return CreateRef<Model>(path);
+    }
+
     void Model::Draw(Aurora::Shader & shader)
     {
         for (uint32_t i = 0; i < meshes.size(); i++)
             meshes[i].Draw(shader);
     }
 
+    void Model::Reload(const ModelImport& import)
+    {
+        for (Mesh& mesh : meshes)
+            GeometryPool::Free(mesh.Allocation);
+
+        meshes.clear();
+        textures_loaded.clear();
+
+        buildModel(import);
+    }
+
     void Model::loadModel(std::string& path)
     {
-        // read file via ASSIMP
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-        // check for errors
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
-        {
-            AR_CORE_ERROR_TAG("ERROR::ASSIMP", "->{0}", importer.GetErrorString());
+        ModelImport import(path);
+        buildModel(import);
+    }
+
+    void Model::buildModel(const ModelImport& import)
+    {
+        if (!import.IsValid())
             return;
-        }
+
+        const aiScene* scene = import.m_Importer->GetScene();
+
         // retrieve the directory path of the filepath
+        std::string path = import.m_Path;
         std::replace(path.begin(), path.end(), '\\', '/');
         directory = path.substr(0, path.find_last_of('/'));
 
@@ -204,7 +280,11 @@ namespace Aurora {
             if (!skip)
             {   // if texture hasn't been loaded already, load it
                 TextureMesh texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                // a cooked version next to the source comes block compressed with its mips, so that one is preferred.
+                // going through the asset manager shares the texture with every other model that uses the same file
+                std::string sourcePath = this->directory + '/' + str.C_Str();
+                std::string cookedPath = TextureCooker::GetCookedPath(sourcePath);
+                texture.texture = AssetManager::Load<Texture2D>(VirtualFileSystem::Exists(cookedPath) ? cookedPath : sourcePath);
                 texture.type = typeName;
                 texture.path = str.C_Str();
                 textures.push_back(texture);
@@ -14,9 +14,34 @@ struct aiMesh;
 struct aiMaterial;
 enum aiTextureType;
 
+namespace Assimp {
+    class Importer;
+}
+
 namespace Aurora {
 
-    class Model
+    // a model file that assimp read and post processed but that no meshes were built from yet. importing is most of the work of
+    // loading a model and it does not touch GL, so it can happen on a worker
+    class ModelImport : public RefCountedObject
+    {
+    public:
+        ModelImport(const std::string& path);
+        virtual ~ModelImport();
+
+        static Ref<ModelImport> Create(const std::string& path);
+
+        // false if assimp could not read the file
+        bool IsValid() const;
+        const std::string& GetPath() const { return m_Path; }
+
+    private:
+        std::string m_Path;
+        Scope<Assimp::Importer> m_Importer;
+
+        friend class Model;
+    };
+
+    class Model : public RefCountedObject
     {
     public:
         // model data 
@@ -28,14 +53,27 @@ namespace Aurora {
         Model() = default;
         // constructor, expects a filepath to a 3D model.
         Model(std::string path, bool gamma = false);
+        // gives the space of the meshes in the GeometryPool back
+        virtual ~Model();
+
+        // always loads the file, go through the AssetManager to share one model between every entity using the same file
+        static Ref<Model> Create(const std::string& path);
 
         // draws the model, and thus all its meshes
         void Draw(Aurora::Shader& shader);
 
+        // throws the meshes away and builds them again from a new import of the file. the model stays the same object so everything
+        // holding on to it sees the new meshes. the old meshes are freed from the GeometryPool, so static batches that baked them have
+        // to be rebuilt
+        void Reload(const ModelImport& import);
+
     private:
         // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
         void loadModel(std::string& path);
 
+        // builds the meshes of an import, their textures are loaded through the AssetManager so this has to be on the main thread
+        void buildModel(const ModelImport& import);
+
         // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
         void processNode(aiNode* node, const aiScene* scene);
 
@@ -0,0 +1,155 @@
+#include "Aurorapch.h"
+#include "Pipeline.h"
+
+#include <unordered_map>
+
+namespace Aurora {
+
+	namespace Utils {
+
+		// FNV-1a, same as the one used for the log tags
+		static void HashCombine(uint64_t& hash, uint64_t value)
+		{
+			for (uint32_t i = 0; i < sizeof(uint64_t); i++)
+			{
+				hash ^= (value >> (i * 8)) & 0xff;
+				hash *= 0x100000001b3ull;
+			}
+		}
+
+		static bool LayoutsMatch(const BufferLayout& a, const BufferLayout& b)
+		{
+			if (a.GetStride() != b.GetStride() || a.GetElements().size() != b.GetElements().size())
+				return false;
+
+			for (size_t i = 0; i < a.GetElements().size(); i++)
+			{
+				const BufferElement& elementA = a.GetElements()[i];
+				const BufferElement& elementB = b.GetElements()[i];
+				if (elementA.type != elementB.type || elementA.offset != elementB.offset || elementA.normalized != elementB.normalized)
+					return false;
+			}
+
+			return true;
+		}
+
+		static bool FramebuffersMatch(const Ref<Framebuffer>& a, const Ref<Framebuffer>& b)
+		{
+			if (!a || !b)
+				return !a && !b;
+
+			const FramebufferSpecification& specA = a->GetSpecification();
+			const FramebufferSpecification& specB = b->GetSpecification();
+			const auto& attachmentsA = specA.AttachmentsSpecification.Attachments;
+			const auto& attachmentsB = specB.AttachmentsSpecification.Attachments;
+			if (specA.Samples != specB.Samples || attachmentsA.size() != attachmentsB.size())
+				return false;
+
+			for (size_t i = 0; i < attachmentsA.size(); i++)
+			{
+				if (attachmentsA[i].TextureFormat != attachmentsB[i].TextureFormat)
+					return false;
+			}
+
+			return true;
+		}
+
+		// Compares everything that goes into the hash
+		static bool SpecificationsMatch(const PipelineSpecification& a, const PipelineSpecification& b)
+		{
+			return a.Shader->GetFilePath() == b.Shader->GetFilePath()
+				&& LayoutsMatch(a.Layout, b.Layout)
+				&& FramebuffersMatch(a.TargetFramebuffer, b.TargetFramebuffer)
+				&& a.DepthTest == b.DepthTest
+				&& a.DepthWrite == b.DepthWrite
+				&& a.DepthFunction == b.DepthFunction
+				&& a.ColorWrite == b.ColorWrite
+				&& a.Culling == b.Culling
+				&& a.Blend == b.Blend
+				&& a.BlendDstFunction == b.BlendDstFunction
+				&& a.PolygonMode == b.PolygonMode;
+		}
+
+	}
+
+	static std::unordered_map<uint64_t, Ref<Pipeline>> s_PipelineCache;
+
+	Pipeline::Pipeline(const PipelineSpecification& spec, uint64_t hash)
+		: m_Specification(spec), m_Hash(hash)
+	{
+	}
+
+	Ref<Pipeline> Pipeline::Create(const PipelineSpecification& spec)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(spec.Shader, "Pipeline needs a shader!");
+
+		uint64_t hash = HashSpecification(spec);
+
+		// A different specification with the same hash gets the next free one, RenderCommand::BindPipeline tells pipelines apart by
+		// their hash so it has to be unique
+		for (auto it = s_PipelineCache.find(hash); it != s_PipelineCache.end(); it = s_PipelineCache.find(++hash))
+		{
+			if (Utils::SpecificationsMatch(it->second->GetSpecification(), spec))
+				return it->second;
+		}
+
+		Ref<Pipeline> pipeline = CreateRef<Pipeline>(spec, hash);
+		s_PipelineCache[hash] = pipeline;
+
+		AR_CORE_TRACE_TAG("Pipeline", "Created pipeline {0} ({1} cached)", spec.DebugName.empty() ? spec.Shader->GetName() : spec.DebugName, s_PipelineCache.size());
+
+		return pipeline;
+	}
+
+	uint64_t Pipeline::HashSpecification(const PipelineSpecification& spec)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+
+		// The asset path and not the program ID so that reloading a shader keeps the same pipelines
+		Utils::HashCombine(hash, spec.Shader ? spec.Shader->GetHash() : 0);
+
+		for (const BufferElement& element : spec.Layout)
+		{
+			Utils::HashCombine(hash, (uint64_t)element.type);
+			Utils::HashCombine(hash, element.offset);
+			Utils::HashCombine(hash, element.normalized);
+		}
+		Utils::HashCombine(hash, spec.Layout.GetStride());
+
+		if (spec.TargetFramebuffer)
+		{
+			const FramebufferSpecification& fbSpec = spec.TargetFramebuffer->GetSpecification();
+			for (const FramebufferTextureSpecification& attachment : fbSpec.AttachmentsSpecification.Attachments)
+				Utils::HashCombine(hash, (uint64_t)attachment.TextureFormat);
+			Utils::HashCombine(hash, fbSpec.Samples);
+		}
+
+		Utils::HashCombine(hash, spec.DepthTest);
+		Utils::HashCombine(hash, spec.DepthWrite);
+		Utils::HashCombine(hash, (uint64_t)spec.DepthFunction);
+		Utils::HashCombine(hash, spec.ColorWrite);
+		Utils::HashCombine(hash, (uint64_t)spec.Culling);
+		Utils::HashCombine(hash, spec.Blend);
+		Utils::HashCombine(hash, (uint64_t)spec.BlendDstFunction);
+		Utils::HashCombine(hash, (uint64_t)spec.PolygonMode);
+
+		return hash;
+	}
+
+	void Pipeline::ClearCache()
+	{
+		s_PipelineCache.clear();
+	}
+
+	uint32_t Pipeline::GetCachedPipelineCount()
+	{
+		return (uint32_t)s_PipelineCache.size();
+	}
+
+	void Pipeline::Bind() const
+	{
+		RenderCommand::BindPipeline(*this);
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ * A Pipeline bundles everything that describes how a draw is going to be rasterized: the shader, the vertex layout it expects, the
+ * depth/blend/cull/polygon state and the format of the framebuffer it renders into.
+ * Pipelines are immutable, the specification is hashed at creation and Pipeline::Create hands back the already existing pipeline if
+ * one with the same specification was created before, so two draws with the same state always end up with the same pipeline object.
+ * Binding a pipeline goes through RenderCommand::BindPipeline which does nothing if that same pipeline is still bound and otherwise
+ * only issues the state that differs from what is currently set.
+ *
+ * NOTE: In OpenGL the vertex layout lives in the VertexArray so here it is only part of the hash (and validation), however it is
+ * needed for the day there is a Vulkan backend.
+ */
+
+#include "Core/Base.h"
+#include "Shader.h"
+#include "VertexBuffer.h"
+#include "Framebuffers.h"
+#include "Renderer/RenderCommand.h"
+
+namespace Aurora {
+
+	enum class CullMode
+	{
+		None = 0,
+		Front,
+		Back
+	};
+
+	struct PipelineSpecification
+	{
+		Ref<Shader> Shader;
+		BufferLayout Layout;
+
+		// Only its attachment formats and sample count are used, nullptr means the pipeline does not care about the target
+		Ref<Framebuffer> TargetFramebuffer;
+
+		bool DepthTest = true;
+		bool DepthWrite = true;
+		OpenGLFunction DepthFunction = OpenGLFunction::Less;
+
+		// False for depth only passes (depth pre-pass...)
+		bool ColorWrite = true;
+
+		CullMode Culling = CullMode::Back;
+
+		bool Blend = true;
+		OpenGLFunction BlendDstFunction = OpenGLFunction::OneMinusSrcAlpha;
+
+		// RenderFlags::None leaves the polygon mode to whatever the editor has set (wireframe toggle...)
+		RenderFlags PolygonMode = RenderFlags::None;
+
+		std::string DebugName;
+	};
+
+	class Pipeline : public RefCountedObject
+	{
+	public:
+		Pipeline(const PipelineSpecification& spec, uint64_t hash);
+		~Pipeline() = default;
+
+		// Returns the cached pipeline if one with the same specification already exists
+		static Ref<Pipeline> Create(const PipelineSpecification& spec);
+		static uint64_t HashSpecification(const PipelineSpecification& spec);
+
+		static void ClearCache();
+		static uint32_t GetCachedPipelineCount();
+
+		void Bind() const;
+
+		inline const PipelineSpecification& GetSpecification() const { return m_Specification; }
+		inline uint64_t GetHash() const { return m_Hash; }
+
+	private:
+		PipelineSpecification m_Specification;
+		uint64_t m_Hash = 0;
+
+	};
+
+}
@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "Shader.h"
 
+#include "Asset/VirtualFileSystem.h"
+#include "Renderer/RenderCommand.h"
 #include "Utils/UtilFunctions.h"
 
 #include <glad/glad.h>
@@ -27,6 +29,139 @@ namespace Aurora {
 				std::filesystem::create_directories(cacheDir);
 		}
 
+		// Bump whenever the program cache changes so that the old caches are not used anymore
+		static constexpr uint32_t ProgramCacheVersion = 1;
+		static constexpr char ProgramCacheMagic[4] = { 'A', 'P', 'R', 'G' };
+
+		static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+		// The linked program as the driver gave it to us, which is only good for that same driver and the exact same SPIR-V
+		struct ProgramCacheHeader
+		{
+			char Magic[4];
+			uint32_t Version;
+			uint64_t Key; // Hash of the OpenGL SPIR-V of every stage and the driver, see GetProgramCacheKey
+			uint32_t BinaryFormat; // What glGetProgramBinary returned, glProgramBinary needs it back
+			uint32_t BinarySize;
+		};
+
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = FNVOffsetBasis)
+		{
+			const Byte* bytes = (const Byte*)data;
+			for (size_t i = 0; i < size; i++)
+				hash = (hash ^ bytes[i]) * FNVPrime;
+
+			return hash;
+		}
+
+		// Some drivers do not support any binary formats at all, then every program is linked from SPIR-V
+		static bool IsProgramCacheSupported()
+		{
+			static const bool supported = []()
+			{
+				GLint formatCount = 0;
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+				return formatCount > 0;
+			}();
+
+			return supported;
+		}
+
+		// A driver update can change what the binaries look like, the version string contains the driver version for the vendors
+		// that matter. The stages are hashed in order since the unordered_map does not promise any
+		static uint64_t GetProgramCacheKey(const std::unordered_map<uint32_t, std::vector<uint32_t>>& spirv)
+		{
+			static const uint64_t driverHash = []()
+			{
+				uint64_t hash = FNVOffsetBasis;
+				for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+				{
+					const char* string = (const char*)glGetString(name);
+					if (string)
+						hash = HashBytes(string, strlen(string) + 1, hash);
+				}
+
+				return hash;
+			}();
+
+			std::vector<uint32_t> stages;
+			for (const auto& [type, data] : spirv)
+				stages.push_back(type);
+			std::sort(stages.begin(), stages.end());
+
+			uint64_t hash = driverHash;
+			for (uint32_t type : stages)
+			{
+				const std::vector<uint32_t>& data = spirv.at(type);
+				hash = HashBytes(&type, sizeof(uint32_t), hash);
+				hash = HashBytes(data.data(), data.size() * sizeof(uint32_t), hash);
+			}
+
+			return hash;
+		}
+
+		static std::string GetProgramCachePath(const std::string& shaderPath)
+		{
+			return (std::filesystem::path(GetCacheDirectory()) / (std::filesystem::path(shaderPath).filename().string() + ".cachedProgram")).string();
+		}
+
+		static bool ReadProgramCache(const std::string& filePath, uint64_t key, ProgramCacheHeader& outHeader, std::vector<Byte>& outBinary)
+		{
+			AR_PROFILE_FUNCTION();
+
+			FileReader reader(filePath);
+			if (!reader)
+				return false;
+
+			// Anything that does not match is an old cache or from another driver, it gets linked again and overwritten
+			bool valid = reader.Read(&outHeader, sizeof(ProgramCacheHeader))
+				&& memcmp(outHeader.Magic, ProgramCacheMagic, sizeof(outHeader.Magic)) == 0
+				&& outHeader.Version == ProgramCacheVersion
+				&& outHeader.Key == key
+				&& outHeader.BinarySize == reader.GetSize() - sizeof(ProgramCacheHeader);
+
+			if (!valid)
+				return false;
+
+			outBinary.resize(outHeader.BinarySize);
+			return reader.Read(outBinary.data(), outBinary.size());
+		}
+
+		static void WriteProgramCache(const std::string& filePath, uint64_t key, uint32_t program)
+		{
+			AR_PROFILE_FUNCTION();
+
+			GLint length = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+			if (length <= 0)
+				return;
+
+			std::vector<Byte> binary(length);
+			GLenum format = 0;
+			glGetProgramBinary(program, length, &length, &format, binary.data());
+
+			ProgramCacheHeader header = {};
+			memcpy(header.Magic, ProgramCacheMagic, sizeof(header.Magic));
+			header.Version = ProgramCacheVersion;
+			header.Key = key;
+			header.BinaryFormat = format;
+			header.BinarySize = (uint32_t)length;
+
+			FILE* f;
+			fopen_s(&f, filePath.c_str(), "wb");
+			if (!f)
+			{
+				AR_CORE_ERROR_TAG("Shader", "Could not open file for writing '{0}'", filePath);
+				return;
+			}
+
+			fwrite(&header, sizeof(ProgramCacheHeader), 1, f);
+			fwrite(binary.data(), 1, header.BinarySize, f);
+			fclose(f);
+		}
+
 		static uint32_t/*GLenum*/ ShaderTypeFromString(const std::string& type)
 		{
 			if (type == "vertex")
@@ -260,7 +395,39 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		glDeleteProgram(m_ShaderID);
+		// Precompiled shaders never had a program, and are destroyed on the cooker's workers
+		if (m_ShaderID)
+		{
+			glDeleteProgram(m_ShaderID);
+			RenderCommand::ResetStateCache();
+		}
+	}
+
+	bool Shader::Precompile(const std::string& filepath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		std::string source = Utils::FileIO::ReadTextFile(filepath);
+		if (source.empty())
+			return false;
+
+		Shader shader;
+		shader.m_AssetPath = filepath;
+		shader.m_Name = std::filesystem::path(filepath).stem().string();
+		shader.m_OpenGLShaderSource = shader.SplitSource(source);
+
+		Utils::CreateCacheDirIfNeeded();
+
+		// The cache is only looked up by file name, the cooker only calls this when the source changed so it always has to compile
+		shader.CompileOrGetVulkanBinary(shader.m_OpenGLShaderSource, true);
+		shader.CompileOrGetOpenGLBinary(true);
+
+		return true;
+	}
+
+	const char* Shader::GetCacheDirectory()
+	{
+		return Utils::GetCacheDirectory();
 	}
 
 	void Shader::Reload(bool forceCompile)
@@ -278,6 +445,10 @@ namespace Aurora {
 		CompileOrGetVulkanBinary(m_OpenGLShaderSource, forceCompile);
 		CompileOrGetOpenGLBinary(forceCompile);
 		CreateProgram();
+
+		// The pipeline hash comes from the shader path so it did not change, the cache would keep the deleted program bound
+		RenderCommand::ResetStateCache();
+
 		AR_CORE_WARN_TAG("Shader", "Reloading {0} took {1}ms", m_Name, timer.ElapsedMillis());
 	}
 
@@ -313,18 +484,19 @@ namespace Aurora {
 			std::filesystem::path cachedPath = cacheDir / (shaderFilePath.filename().string() + Utils::GLShaderTypeCachedVulkanFileExtension(type));
 			std::string p = cachedPath.string();
 
-			FILE* f1;
-			fopen_s(&f1, p.c_str(), "rb"); // read binary
-			if (f1 && !forceCompile)
+			// The cache can come from an asset pack as well
+			bool cached = false;
+			if (!forceCompile)
 			{
-				fseek(f1, 0, SEEK_END);
-				uint64_t size = ftell(f1);
-				fseek(f1, 0, SEEK_SET);
-				m_VulkanSPIRV[type].resize(size / sizeof(uint32_t));
-				fread(m_VulkanSPIRV[type].data(), sizeof(uint32_t), size, f1);
-				fclose(f1);
+				FileReader reader(p);
+				if (reader)
+				{
+					m_VulkanSPIRV[type].resize(reader.GetSize() / sizeof(uint32_t));
+					cached = reader.Read(m_VulkanSPIRV[type].data(), m_VulkanSPIRV[type].size() * sizeof(uint32_t));
+				}
 			}
-			else
+
+			if (!cached)
 			{
 				shaderc::Compiler compiler;
 				shaderc::CompileOptions options;
@@ -348,9 +520,6 @@ namespace Aurora {
 
 				m_VulkanSPIRV[type] = std::vector<uint32_t>(result.cbegin(), result.cend());
 
-				if (f1)
-					fclose(f1);
-
 				FILE* f2;
 				fopen_s(&f2, p.c_str(), "wb"); // write binary
 				if (f2)
@@ -373,6 +542,28 @@ namespace Aurora {
 		std::filesystem::path cacheDir = Utils::GetCacheDirectory();
 
 		//m_OpenGLSPIRV.clear();
+		std::unordered_set<ShaderStage> cachedStages;
+		if (!forceCompile)
+		{
+			for (const auto& [type, spirv] : m_VulkanSPIRV)
+			{
+				std::filesystem::path shaderFilePath = m_AssetPath;
+				std::string p = (cacheDir / (shaderFilePath.filename().string() + Utils::GLShaderTypeCachedOpenGLFileExtension(type))).string();
+
+				FileReader reader(p);
+				if (reader)
+				{
+					m_OpenGLSPIRV[type].resize(reader.GetSize() / sizeof(uint32_t));
+					if (reader.Read(m_OpenGLSPIRV[type].data(), m_OpenGLSPIRV[type].size() * sizeof(uint32_t)))
+						cachedStages.insert(type);
+				}
+			}
+		}
+
+		// The OpenGL source is only needed to compile the OpenGL SPIR-V, so when every stage is cached there is nothing to cross compile
+		if (cachedStages.size() == m_VulkanSPIRV.size())
+			return;
+
 		short int PushBinding = 0;
 		for (const auto& [type, spirv] : m_VulkanSPIRV)
 		{
@@ -380,7 +571,7 @@ namespace Aurora {
 			std::filesystem::path cachedPath = cacheDir / (shaderFilePath.filename().string() + Utils::GLShaderTypeCachedOpenGLFileExtension(type));
 			std::string p = cachedPath.string();
 
-			// I am doing this step here so that i can get the ogl source code everytime and not only when the shaders are compiled
+			// The push constant locations count up over all the stages, so the cached ones still have to be counted
 			spirv_cross::CompilerGLSL glslCompiler = spirv_cross::CompilerGLSL(spirv);
 			auto& pushConstResources = glslCompiler.get_shader_resources().push_constant_buffers;
 			for (int i = 0; i < pushConstResources.size(); i++)
@@ -388,22 +579,11 @@ namespace Aurora {
 				glslCompiler.set_decoration(pushConstResources[i].id, spv::DecorationLocation, PushBinding++);
 			}
 
-			// At this stage it contains split OpenGL source code
-			m_OpenGLShaderSource[type] = glslCompiler.compile();
-
-			FILE* f1;
-			fopen_s(&f1, p.c_str(), "rb"); // read binary
-			if (f1 && !forceCompile)
-			{
-				fseek(f1, 0, SEEK_END);
-				uint64_t size = ftell(f1);
-				fseek(f1, 0, SEEK_SET);
-				m_OpenGLSPIRV[type].resize(size / sizeof(uint32_t));
-				fread(m_OpenGLSPIRV[type].data(), sizeof(uint32_t), size, f1);
-				fclose(f1);
-			}
-			else
+			if (cachedStages.find(type) == cachedStages.end())
 			{
+				// At this stage it contains split OpenGL source code
+				m_OpenGLShaderSource[type] = glslCompiler.compile();
+
 				shaderc::Compiler compiler;
 				shaderc::CompileOptions options;
 
@@ -431,9 +611,6 @@ namespace Aurora {
 				tools.Disassemble(m_OpenGLSPIRV[type], &wassup);
 				AR_WARN("Shader: {0} - {1}\n{2}", m_Name, Utils::GLShaderTypeToString(type), wassup);
 
-				if (f1)
-					fclose(f1);
-
 				FILE* f2;
 				fopen_s(&f2, p.c_str(), "wb"); // write binary
 				if (f2)
@@ -455,21 +632,57 @@ namespace Aurora {
 
 		GLuint program = glCreateProgram();
 
-		std::vector<GLuint> shaderIDs;
-		for (const auto& [type, spirv] : m_OpenGLSPIRV)
+		bool programCache = Utils::IsProgramCacheSupported();
+		uint64_t programKey = programCache ? Utils::GetProgramCacheKey(m_OpenGLSPIRV) : 0;
+		std::string programCachePath = Utils::GetProgramCachePath(m_AssetPath);
+
+		// The linked program from the last time skips specializing and linking the SPIR-V
+		bool linkedFromCache = false;
+		if (programCache)
 		{
-			GLuint shaderID = glCreateShader(type);
-			shaderIDs.push_back(shaderID);
+			Utils::ProgramCacheHeader header;
+			std::vector<Byte> binary;
+			if (Utils::ReadProgramCache(programCachePath, programKey, header, binary))
+			{
+				glProgramBinary(program, header.BinaryFormat, binary.data(), (GLsizei)binary.size());
+
+				GLint status;
+				glGetProgramiv(program, GL_LINK_STATUS, &status);
+				linkedFromCache = status;
+
+				// Drivers are allowed to reject any binary, it is linked from the SPIR-V again and the cache gets overwritten
+				if (!linkedFromCache)
+				{
+					AR_CORE_WARN_TAG("Shader", "Driver rejected the cached program of {0}, linking it again", m_Name);
 
-			glShaderBinary(1, &shaderID, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), (GLsizei)spirv.size() * sizeof(uint32_t));
-			glSpecializeShader(shaderID, "main", 0, nullptr, nullptr);
-			glAttachShader(program, shaderID);
+					glDeleteProgram(program);
+					program = glCreateProgram();
+				}
+			}
 		}
 
-		glLinkProgram(program);
+		std::vector<GLuint> shaderIDs;
+		GLint link = linkedFromCache;
+		if (!linkedFromCache)
+		{
+			for (const auto& [type, spirv] : m_OpenGLSPIRV)
+			{
+				GLuint shaderID = glCreateShader(type);
+				shaderIDs.push_back(shaderID);
+
+				glShaderBinary(1, &shaderID, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), (GLsizei)spirv.size() * sizeof(uint32_t));
+				glSpecializeShader(shaderID, "main", 0, nullptr, nullptr);
+				glAttachShader(program, shaderID);
+			}
+
+			if (programCache)
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+			glLinkProgram(program);
+
+			glGetProgramiv(program, GL_LINK_STATUS, &link);
+		}
 
-		GLint link;
-		glGetProgramiv(program, GL_LINK_STATUS, &link);
 		if (!link)
 		{
 			GLint length = 0;
@@ -491,6 +704,9 @@ namespace Aurora {
 			glDeleteShader(id);
 		}
 
+		if (link && programCache && !linkedFromCache)
+			Utils::WriteProgramCache(programCachePath, programKey, program);
+
 		m_ShaderID = program;
 
 		// Reflection happens after the shaders have been created otherwise we cant know stuff about the sampled images
@@ -500,7 +716,7 @@ namespace Aurora {
 		// If no push_constant blocks are found, this loop will not enter and thus no uniforms are there to query their location
 		for (auto& [bufferName, buffer] : m_Buffers)
 		{
-			glUseProgram(m_ShaderID);
+			RenderCommand::BindShader(m_ShaderID);
 			for (auto& [name, uniform] : buffer.Uniforms)
 			{
 				// glGetUniformLocation return a GL_INVALID_VALUE and the object is not a valid object generated by
@@ -511,7 +727,7 @@ namespace Aurora {
 
 				m_UniformLocations[name] = location;
 			}
-			glUseProgram(0);
+			RenderCommand::BindShader(0);
 		}
 	}
 
@@ -527,6 +743,8 @@ namespace Aurora {
 		AR_CORE_TRACE_TAG("REFLECT", "\t{0} Uniform Buffers", resources.uniform_buffers.size());
 		AR_CORE_TRACE_TAG("REFLECT", "\t{0} Push Constants", resources.push_constant_buffers.size());
 		AR_CORE_TRACE_TAG("REFLECT", "\t{0} Resources", resources.sampled_images.size());
+		AR_CORE_TRACE_TAG("REFLECT", "\t{0} Storage Buffers", resources.storage_buffers.size());
+		AR_CORE_TRACE_TAG("REFLECT", "\t{0} Storage Images", resources.storage_images.size());
 
 		AR_CORE_TRACE_TAG("REFLECT", "------------------------------");
 
@@ -559,6 +777,8 @@ namespace Aurora {
 			AR_CORE_TRACE_TAG("REFLECT", "\t   Binding: {0}", binding);
 			AR_CORE_TRACE_TAG("REFLECT", "\t   Member Count: {0}", memberCount);
 			AR_CORE_TRACE_TAG("REFLECT", "------------------------------");
+
+			m_StorageBuffers[bufferName] = ShaderResourceDeclaration(bufferName, binding, 1);
 		}
 
 		AR_CORE_TRACE_TAG("REFLECT", "Push Constant Buffers:");
@@ -657,7 +877,29 @@ namespace Aurora {
 		}
 		AR_CORE_TRACE_TAG("REFLECT", "------------------------------");
 
-		// TODO: Storage images.... however i wont get to that until ambient occlusion, and even then i might not use them!!!
+		AR_CORE_TRACE_TAG("REFLECT", "Storage Images:");
+		for (const spirv_cross::Resource& res : resources.storage_images)
+		{
+			uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
+			const std::string& name = res.name;
+
+			// Image units are set from the layout binding so there is no uniform to set here, unlike the samplers
+			m_StorageImages[name] = ShaderResourceDeclaration(name, binding, 1);
+
+			AR_CORE_TRACE_TAG("REFLECT", "\tName: {0}", name);
+			AR_CORE_TRACE_TAG("REFLECT", "\t   Binding: {0}", binding);
+		}
+		AR_CORE_TRACE_TAG("REFLECT", "------------------------------");
+
+		if (type == GL_COMPUTE_SHADER)
+		{
+			m_WorkGroupSize.x = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, 0);
+			m_WorkGroupSize.y = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, 1);
+			m_WorkGroupSize.z = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, 2);
+
+			AR_CORE_TRACE_TAG("REFLECT", "Work Group Size: {0}, {1}, {2}", m_WorkGroupSize.x, m_WorkGroupSize.y, m_WorkGroupSize.z);
+			AR_CORE_TRACE_TAG("REFLECT", "------------------------------");
+		}
 	}
 
 	std::unordered_map<uint32_t/*GLenum*/, std::string> Shader::SplitSource(const std::string& source)
@@ -701,12 +943,12 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		glUseProgram(m_ShaderID);
+		RenderCommand::BindShader(m_ShaderID);
 	}
 
 	void Shader::UnBind() const
 	{
-		glUseProgram(0);
+		RenderCommand::BindShader(0);
 	}
 
 	const ShaderResourceDeclaration* Shader::GetShaderResource(const std::string& name) const
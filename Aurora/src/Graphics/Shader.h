@@ -101,6 +101,11 @@ namespace Aurora {
 		void UnBind() const;
 
 		static Ref<Shader> Create(const std::string& filepath, bool forceCompile = false);
+		// Compiles the shader into the cache without creating a program, so it does not need a GL context. Used by the cooker so
+		// that the runtime finds the binaries already cached. The linked programs depend on the driver, those are only cached at runtime
+		static bool Precompile(const std::string& filepath);
+		// Where the compiled binaries are cached, relative to the working directory
+		static const char* GetCacheDirectory();
 
 		size_t GetHash() const;
 
@@ -126,6 +131,12 @@ namespace Aurora {
 		
 		const std::unordered_map<std::string, ShaderPushBuffer>& GetShaderBuffers() const { return m_Buffers; }
 		const std::unordered_map<std::string, ShaderResourceDeclaration>& GetShaderResources() const { return m_Resources; }
+		const std::unordered_map<std::string, ShaderResourceDeclaration>& GetStorageBuffers() const { return m_StorageBuffers; }
+		const std::unordered_map<std::string, ShaderResourceDeclaration>& GetStorageImages() const { return m_StorageImages; }
+
+		inline bool IsCompute() const { return m_IsCompute; }
+		// local_size of the compute shader, (0, 0, 0) for the other shaders
+		inline const glm::uvec3& GetWorkGroupSize() const { return m_WorkGroupSize; }
 
 		// This is temporary untill i have an asset manager. It kind of acts as an asset manager lol having all the shaders
 		static std::vector<Ref<Shader>> s_AllShaders;
@@ -168,6 +179,7 @@ namespace Aurora {
 		std::string m_AssetPath;
 
 		bool m_IsCompute = false;
+		glm::uvec3 m_WorkGroupSize = glm::uvec3(0);
 
 		std::unordered_map<ShaderStage, std::string> m_OpenGLShaderSource; // OpenGL Source Code...
 		std::unordered_map<ShaderStage, std::vector<uint32_t>> m_VulkanSPIRV;
@@ -175,6 +187,8 @@ namespace Aurora {
 
 		std::unordered_map<std::string, ShaderPushBuffer> m_Buffers;
 		std::unordered_map<std::string, ShaderResourceDeclaration> m_Resources;
+		std::unordered_map<std::string, ShaderResourceDeclaration> m_StorageBuffers;
+		std::unordered_map<std::string, ShaderResourceDeclaration> m_StorageImages;
 		mutable std::unordered_map<std::string, int> m_UniformLocations;
 
 	};
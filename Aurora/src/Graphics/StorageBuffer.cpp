@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "StorageBuffer.h"
 
+#include "Renderer/RenderCommand.h"
+
 #include <glad/glad.h>
 
 namespace Aurora {
@@ -15,11 +17,12 @@ namespace Aurora {
 	{
 		glCreateBuffers(1, &m_BufferID);
 		glNamedBufferData(m_BufferID, size, nullptr, GL_DYNAMIC_DRAW);
-		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_BufferID);
+		RenderCommand::BindStorageBuffer(binding, m_BufferID);
 	}
 
 	StorageBuffer::~StorageBuffer()
 	{
+		RenderCommand::OnStorageBufferDeleted(m_BufferID);
 		glDeleteBuffers(1, &m_BufferID);
 	}
 
@@ -28,4 +31,9 @@ namespace Aurora {
 		glNamedBufferSubData(m_BufferID, offset, size, data);
 	}
 
+	void StorageBuffer::Bind() const
+	{
+		RenderCommand::BindStorageBuffer(m_BindingPoint, m_BufferID);
+	}
+
 }
\ No newline at end of file
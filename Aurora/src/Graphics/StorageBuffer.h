@@ -14,8 +14,12 @@ namespace Aurora {
 
 		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
 
+		// Binds it back to its binding point, only needed when another buffer was bound there in the meantime
+		void Bind() const;
+
 		uint32_t GetSize() const { return m_Size; }
 		uint32_t GetBinding() const { return m_BindingPoint; }
+		uint32_t GetBufferID() const { return m_BufferID; }
 
 	private:
 		uint32_t m_BufferID = 0;
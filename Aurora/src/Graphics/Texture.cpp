@@ -1,10 +1,21 @@
 #include "Aurorapch.h"
 #include "Texture.h"
 
+#include "TextureFile.h"
+#include "Renderer/RenderCommand.h"
+#include "Renderer/Renderer3D.h"
+#include "Renderer/TextureStreamer.h"
 #include "Utils/ImageLoader.h"
 
 #include <glad/glad.h>
-#include <stb_image/stb_image.h>
+
+// S3TC is not core so glad does not have these, every desktop driver supports EXT_texture_compression_s3tc though
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
 
 namespace Aurora {
 
@@ -58,6 +69,15 @@ namespace Aurora {
 				case ImageFormat::RGBA16F:					return GL_RGBA16F;
 				case ImageFormat::RGBA32F:					return GL_RGBA32F;
 				case ImageFormat::SRGB:						return GL_SRGB8;
+				case ImageFormat::BC1:						return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+				case ImageFormat::BC1SRGB:					return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+				case ImageFormat::BC3:						return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				case ImageFormat::BC3SRGB:					return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+				case ImageFormat::BC4:						return GL_COMPRESSED_RED_RGTC1;
+				case ImageFormat::BC5:						return GL_COMPRESSED_RG_RGTC2;
+				case ImageFormat::BC6H:						return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+				case ImageFormat::BC7:						return GL_COMPRESSED_RGBA_BPTC_UNORM;
+				case ImageFormat::BC7SRGB:					return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
 				case ImageFormat::DEPTH32FSTENCIL8UINT:		return GL_DEPTH32F_STENCIL8;
 				case ImageFormat::DEPTH24STENCIL8:			return GL_DEPTH24_STENCIL8;
 				case ImageFormat::DEPTH32F:					return GL_DEPTH_COMPONENT32F;
@@ -161,6 +181,11 @@ namespace Aurora {
 		return CreateRef<Texture2D>(filePath, props);
 	}
 
+	Ref<Texture2D> Texture2D::Create(const std::string& filePath, const Utils::ImageData& image, const TextureProperties& props)
+	{
+		return CreateRef<Texture2D>(filePath, image, props);
+	}
+
 	Texture2D::Texture2D(ImageFormat format, uint32_t width, uint32_t height, const void* data, const TextureProperties& props)
 		: m_Width(width), m_Height(height), m_Format(format), m_Properties(props)
 	{
@@ -178,62 +203,257 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		int32_t width, height, numChannels;
-
-		if (stbi_is_hdr(filePath.c_str()))
+		if (TextureFile::IsTextureFile(filePath))
 		{
-			// TODO: Log if the texture is SRGB or not!
-			AR_CORE_INFO_TAG("Texture", "Loading an HDR texture from: {0}, SRGB: {1}", filePath.c_str(), props.SRGB);
+			if (props.Streaming && TextureStreamer::IsInitialized())
+				LoadStreamed();
+			else
+				LoadCooked();
+
+			return;
+		}
 
-			stbi_set_flip_vertically_on_load(props.FlipOnLoad);
+		Utils::ImageData image = DecodeImage(filePath, props);
+		AR_CORE_ASSERT(image, "Image was not loaded!");
 
-			float* imageData = stbi_loadf(filePath.c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-			AR_CORE_ASSERT(imageData, "Image was not loaded!");
+		LoadFromImage(image);
+	}
 
-			stbi_set_flip_vertically_on_load(false); // Reset since it is kind of a global state inside stb!
+	Texture2D::Texture2D(const std::string& filePath, const Utils::ImageData& image, const TextureProperties& props)
+		: m_AssetPath(filePath), m_Properties(props), m_Width(0), m_Height(0)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(image, "Image was not loaded!");
 
-			m_ImageData = Buffer(imageData, Utils::GetImageMemorySize(ImageFormat::RGBA32F, width, height));
-			m_Format = ImageFormat::RGBA32F;
+		LoadFromImage(image);
+	}
+
+	void Texture2D::Reload(const Utils::ImageData& image)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (m_StreamID)
+			TextureStreamer::Unregister(this);
+
+		Renderer3D::OnTextureReloaded(*this);
+
+		glDeleteTextures(1, &m_TextureID);
+		m_TextureID = 0;
+		m_LevelCount = 1;
+		m_ResidentLevel = 0;
+
+		// Deleting a texture unbinds it from all the units
+		RenderCommand::ResetStateCache();
+
+		if (TextureFile::IsTextureFile(m_AssetPath))
+		{
+			if (m_Properties.Streaming && TextureStreamer::IsInitialized())
+				LoadStreamed();
+			else
+				LoadCooked();
+
+			return;
 		}
+
+		AR_CORE_ASSERT(image, "Image was not loaded!");
+
+		LoadFromImage(image);
+	}
+
+	Utils::ImageData Texture2D::DecodeImage(const std::string& filePath, const TextureProperties& props)
+	{
+		AR_PROFILE_FUNCTION();
+
+		bool hdr = Utils::ImageLoader::IsHDR(filePath);
+
+		// TODO: Log if the texture is SRGB or not!
+		if (hdr)
+			AR_CORE_INFO_TAG("Texture", "Loading an HDR texture from: {0}, SRGB: {1}", filePath.c_str(), props.SRGB);
 		else
-		{
 			AR_CORE_INFO_TAG("Texture", "Loading a texture from: {0}, SRGB: {1}", filePath.c_str(), props.SRGB);
 
-			stbi_set_flip_vertically_on_load(props.FlipOnLoad);
-
-			uint8_t* imageData = stbi_load(filePath.c_str(), &width, &height, &numChannels, props.SRGB ? STBI_rgb : STBI_rgb_alpha);
-			AR_CORE_ASSERT(imageData);
+		Utils::ImageLoadSettings loadSettings;
+		loadSettings.Channels = hdr || !props.SRGB ? 4 : 3;
+		loadSettings.FlipVertically = props.FlipOnLoad;
 
-			stbi_set_flip_vertically_on_load(false); // Reset since it is kind of a global state inside stb!
+		return Utils::ImageLoader::LoadImageFile(filePath, loadSettings);
+	}
 
-			ImageFormat format = props.SRGB ? ImageFormat::RGB : ImageFormat::RGBA;
-			m_ImageData = Buffer(imageData, Utils::GetImageMemorySize(format, width, height));
-			m_Format = format;
-		}
+	void Texture2D::LoadFromImage(const Utils::ImageData& image)
+	{
+		m_Format = image.IsHDR() ? ImageFormat::RGBA32F : image.GetChannels() == 3 ? ImageFormat::RGB : ImageFormat::RGBA;
+		m_ImageData = Buffer((void*)image.GetPixels(), (uint32_t)image.GetSize());
 
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
 
-		glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, Utils::GLFilterTypeFromTextureFilter(props.SamplerFilter, props.GenerateMips));
-		glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, Utils::GLFilterTypeFromTextureFilter(props.SamplerFilter, false));
-		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_R, Utils::GLWrapTypeFromTextureWrap(props.SamplerWrap));
-		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, Utils::GLWrapTypeFromTextureWrap(props.SamplerWrap));
-		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, Utils::GLWrapTypeFromTextureWrap(props.SamplerWrap));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, m_Properties.GenerateMips));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, false));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_R, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
 
-		m_Width = width;
-		m_Height = height;
+		m_Width = image.GetWidth();
+		m_Height = image.GetHeight();
 
 		Invalidate();
 
-		stbi_image_free(m_ImageData.GetData());
-		m_ImageData = Buffer(); // Reset the buffer
+		m_ImageData = Buffer(); // The pixels belong to the image
+	}
+
+	void Texture2D::LoadCooked()
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_INFO_TAG("Texture", "Loading a cooked texture from: {0}", m_AssetPath.c_str());
+
+		CookedTexture cooked;
+		bool loaded = TextureFile::Read(m_AssetPath, cooked);
+		AR_CORE_ASSERT(loaded, "Cooked texture was not loaded!");
+
+		if (!loaded)
+			return;
+
+		m_Width = cooked.Width;
+		m_Height = cooked.Height;
+		m_Format = cooked.Format;
+
+		uint32_t levelCount = cooked.GetLevelCount();
+		m_LevelCount = levelCount;
+		GLenum internalFormat = Utils::GLInternalFormatFromAFormat(m_Format);
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
+
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, levelCount > 1));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, false));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_R, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+
+		// The mips are part of the file, nothing gets generated here
+		glTextureStorage2D(m_TextureID, levelCount, internalFormat, m_Width, m_Height);
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			uint32_t width = std::max(m_Width >> level, 1u);
+			uint32_t height = std::max(m_Height >> level, 1u);
+			const std::vector<Byte>& data = cooked.Levels[level];
+
+			glCompressedTextureSubImage2D(m_TextureID, level, 0, 0, width, height, internalFormat, (GLsizei)data.size(), data.data());
+		}
+	}
+
+	void Texture2D::LoadStreamed()
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_INFO_TAG("Texture", "Loading a streamed texture from: {0}", m_AssetPath.c_str());
+
+		TextureFileInfo info;
+		bool loaded = TextureFile::ReadInfo(m_AssetPath, info);
+		AR_CORE_ASSERT(loaded, "Cooked texture was not loaded!");
+
+		if (!loaded)
+			return;
+
+		m_Width = info.Width;
+		m_Height = info.Height;
+		m_Format = info.Format;
+		m_LevelCount = info.GetLevelCount();
+
+		// The first level that is small enough is pinned along with everything below it
+		uint32_t pinnedLevel = 0;
+		while (pinnedLevel + 1 < m_LevelCount && std::max(m_Width >> pinnedLevel, m_Height >> pinnedLevel) > TextureStreamer::PinnedLevelSize)
+			pinnedLevel++;
+
+		// Nothing is resident yet, the levels are read from the smallest one up and then all of them go into one texture
+		m_ResidentLevel = m_LevelCount;
+
+		std::vector<std::vector<Byte>> levels(m_LevelCount);
+		uint32_t residentLevel = m_LevelCount;
+		while (residentLevel > pinnedLevel && TextureFile::ReadLevel(m_AssetPath, info, residentLevel - 1, levels[residentLevel - 1]))
+			residentLevel--;
+
+		AR_CORE_ASSERT(residentLevel < m_LevelCount, "None of the levels of the cooked texture could be loaded!");
+
+		if (residentLevel < m_LevelCount)
+		{
+			Respecify(residentLevel);
+			for (uint32_t level = residentLevel; level < m_LevelCount; level++)
+				UploadLevelData(level, levels[level].data(), (uint32_t)levels[level].size());
+		}
+
+		TextureStreamer::Register(this, info, pinnedLevel);
+	}
+
+	void Texture2D::UploadLevel(uint32_t level, const void* data, uint32_t size)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(level + 1 == m_ResidentLevel, "Streamed levels have to be uploaded in order!");
+
+		Respecify(level);
+		UploadLevelData(level, data, size);
+	}
+
+	void Texture2D::EvictLevel()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(m_ResidentLevel + 1 < m_LevelCount, "Can not evict the last level of a texture!");
+
+		Respecify(m_ResidentLevel + 1);
+	}
+
+	void Texture2D::Respecify(uint32_t residentLevel)
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint32_t textureID;
+		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+		glTextureStorage2D(textureID, m_LevelCount - residentLevel, Utils::GLInternalFormatFromAFormat(m_Format), std::max(m_Width >> residentLevel, 1u), std::max(m_Height >> residentLevel, 1u));
+
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, m_LevelCount > 1));
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, false));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_R, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+
+		// The levels that both textures have are copied on the GPU, a newly resident level is uploaded by the caller
+		if (m_TextureID)
+		{
+			for (uint32_t level = std::max(residentLevel, m_ResidentLevel); level < m_LevelCount; level++)
+			{
+				uint32_t width = std::max(m_Width >> level, 1u);
+				uint32_t height = std::max(m_Height >> level, 1u);
+				glCopyImageSubData(m_TextureID, GL_TEXTURE_2D, level - m_ResidentLevel, 0, 0, 0, textureID, GL_TEXTURE_2D, level - residentLevel, 0, 0, 0, width, height, 1);
+			}
+
+			glDeleteTextures(1, &m_TextureID);
+			RenderCommand::OnTextureDeleted(m_TextureID);
+		}
+
+		m_TextureID = textureID;
+		m_ResidentLevel = residentLevel;
+	}
+
+	void Texture2D::UploadLevelData(uint32_t level, const void* data, uint32_t size)
+	{
+		uint32_t width = std::max(m_Width >> level, 1u);
+		uint32_t height = std::max(m_Height >> level, 1u);
+
+		glCompressedTextureSubImage2D(m_TextureID, level - m_ResidentLevel, 0, 0, width, height, Utils::GLInternalFormatFromAFormat(m_Format), (GLsizei)size, data);
 	}
 
 	Texture2D::~Texture2D()
 	{
 		AR_PROFILE_FUNCTION();
 
+		if (m_StreamID)
+			TextureStreamer::Unregister(this);
+
 		glDeleteTextures(1, &m_TextureID);
 		m_TextureID = 0; // Reset textureID just for safety
+
+		// Deleting a texture unbinds it from all the units
+		RenderCommand::ResetStateCache();
 	}
 
 	void Texture2D::Invalidate()
@@ -244,6 +464,7 @@ namespace Aurora {
 		internalFormat = Utils::GLInternalFormatFromAFormat(m_Format);
 
 		uint32_t mipCount = Utils::CalcMipCount(m_Width, m_Height);
+		m_LevelCount = mipCount;
 		glTextureStorage2D(m_TextureID, mipCount, internalFormat, m_Width, m_Height);
 		if (m_ImageData)
 		{
@@ -260,14 +481,21 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, m_TextureID);
+		RenderCommand::BindTexture(slot, m_TextureID);
+	}
+
+	void Texture2D::BindImage(uint32_t unit, ImageAccess access, uint32_t mipLevel) const
+	{
+		AR_PROFILE_FUNCTION();
+
+		RenderCommand::BindImageTexture(unit, m_TextureID, mipLevel, access, m_Format);
 	}
 
 	void Texture2D::UnBind(uint32_t slot) const
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, 0);
+		RenderCommand::BindTexture(slot, 0);
 	}
 
 }
\ No newline at end of file
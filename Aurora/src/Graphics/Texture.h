@@ -16,6 +16,12 @@
 
 namespace Aurora {
 
+	namespace Utils {
+
+		class ImageData;
+
+	}
+
 	enum class ImageFormat : uint8_t
 	{
 		None = 0,
@@ -38,6 +44,17 @@ namespace Aurora {
 
 		SRGB, // Currently not supported
 
+		// Block compressed, these only come from cooked textures, see TextureCooker.h
+		BC1,
+		BC1SRGB,
+		BC3,
+		BC3SRGB,
+		BC4,
+		BC5,
+		BC6H,
+		BC7,
+		BC7SRGB,
+
 		// Depth / Stencil
 		DEPTH24STENCIL8,
 		DEPTH32FSTENCIL8UINT,
@@ -55,6 +72,14 @@ namespace Aurora {
 		Storage // Currently not used for anything
 	};
 
+	// How a compute shader is allowed to touch an image bound for load/store
+	enum class ImageAccess : uint8_t
+	{
+		ReadOnly = 0,
+		WriteOnly,
+		ReadWrite
+	};
+
 	enum class TextureWrap : uint8_t // Wrapping settings
 	{
 		None = 0,
@@ -77,6 +102,7 @@ namespace Aurora {
 		bool FlipOnLoad = false;
 		bool GenerateMips = true;
 		bool SRGB = false; // Currently not supported! However it is used to determine the number of channels to be loaded with stb
+		bool Streaming = true; // Only cooked textures can be streamed, see TextureStreamer.h
 	};
 
 	class Texture : public RefCountedObject
@@ -96,24 +122,61 @@ namespace Aurora {
 	public:
 		Texture2D(const std::string& filePath, const TextureProperties& props = TextureProperties());
 		Texture2D(ImageFormat format, uint32_t width, uint32_t height, const void* data, const TextureProperties& props = TextureProperties());
+		// image has to come from DecodeImage with the same properties
+		Texture2D(const std::string& filePath, const Utils::ImageData& image, const TextureProperties& props = TextureProperties());
 		virtual ~Texture2D();
 
 		static Ref<Texture2D> Create(const std::string& filePath, const TextureProperties& props = TextureProperties());
 		static Ref<Texture2D> Create(ImageFormat format, uint32_t width, uint32_t height, const void* data, const TextureProperties& props = TextureProperties());
+		static Ref<Texture2D> Create(const std::string& filePath, const Utils::ImageData& image, const TextureProperties& props = TextureProperties());
+
+		// The decoding part of loading an image file, it does not touch GL so it can run on any thread. Not for cooked textures
+		static Utils::ImageData DecodeImage(const std::string& filePath, const TextureProperties& props = TextureProperties());
 
 		void Invalidate();
 
+		// Loads the file again into this same object, so everything that holds on to the texture sees the new contents. The GL
+		// texture is a new one, do not keep its ID around. image has to come from DecodeImage for source images, cooked textures
+		// read their file themselves and ignore it
+		void Reload(const Utils::ImageData& image);
+
 		virtual void Bind(uint32_t slot = 0) const override;
 		virtual void UnBind(uint32_t slot = 0) const override;
 
+		// Binds a mip level of the texture for image load/store in compute shaders
+		void BindImage(uint32_t unit, ImageAccess access, uint32_t mipLevel = 0) const;
+
 		[[nodiscard]] inline uint32_t GetWidth() const { return m_Width; }
 		[[nodiscard]] inline uint32_t GetHeight() const { return m_Height; }
+		[[nodiscard]] inline ImageFormat GetFormat() const { return m_Format; }
+		[[nodiscard]] inline uint32_t GetLevelCount() const { return m_LevelCount; }
 		[[nodiscard]] inline const std::string& GetAssetPath() const { return m_AssetPath; }
 		[[nodiscard]] inline virtual uint32_t GetTextureID() const override { return m_TextureID; }
 		[[nodiscard]] inline TextureProperties& GetTextureProperties() { return m_Properties; }
 
+		// For streamed textures the finest mip that is in memory, it is always 0 for everything else
+		[[nodiscard]] inline uint32_t GetResidentLevel() const { return m_ResidentLevel; }
+		[[nodiscard]] inline bool IsStreamed() const { return m_StreamID != 0; }
+
 		bool operator==(const Texture2D& other) const { return m_TextureID == other.m_TextureID; }
 
+	private:
+		void LoadFromImage(const Utils::ImageData& image);
+		// Cooked textures (see TextureCooker.h) come with all their mips already block compressed
+		void LoadCooked();
+		// Same but only the pinned levels are loaded, the TextureStreamer takes care of the rest
+		void LoadStreamed();
+
+		// Streamed textures grow and shrink one level at a time, level has to be one finer than the resident level
+		void UploadLevel(uint32_t level, const void* data, uint32_t size);
+		void EvictLevel();
+
+		// Streamed textures only have storage for the resident levels, so level 0 of the GL texture is m_ResidentLevel. Immutable
+		// storage can not grow or give memory back, so changing the resident level makes a new texture that the levels are copied to
+		void Respecify(uint32_t residentLevel);
+		// level is a level of the whole chain, it has to be resident already
+		void UploadLevelData(uint32_t level, const void* data, uint32_t size);
+
 	private:
 		uint32_t m_TextureID = 0;
 		std::string m_AssetPath;
@@ -125,6 +188,12 @@ namespace Aurora {
 
 		ImageFormat m_Format = ImageFormat::None;
 
+		uint64_t m_StreamID = 0;
+		uint32_t m_LevelCount = 1;
+		uint32_t m_ResidentLevel = 0;
+
+		friend class TextureStreamer;
+
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "Aurorapch.h"
+#include "TextureArray.h"
+
+#include "Renderer/RenderCommand.h"
+
+#include <glad/glad.h>
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static GLenum GLInternalFormatFromAFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::R8UI:						return GL_R8UI;
+				case ImageFormat::R16UI:					return GL_R16UI;
+				case ImageFormat::R32UI:					return GL_R32UI;
+				case ImageFormat::R32F:						return GL_R32F;
+				case ImageFormat::RGB:						return GL_RGB8;
+				case ImageFormat::RGBA:						return GL_RGBA8;
+				case ImageFormat::RGBA16F:					return GL_RGBA16F;
+				case ImageFormat::RGBA32F:					return GL_RGBA32F;
+				case ImageFormat::SRGB:						return GL_SRGB8;
+				case ImageFormat::BC1:						return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+				case ImageFormat::BC1SRGB:					return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+				case ImageFormat::BC3:						return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				case ImageFormat::BC3SRGB:					return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+				case ImageFormat::BC4:						return GL_COMPRESSED_RED_RGTC1;
+				case ImageFormat::BC5:						return GL_COMPRESSED_RG_RGTC2;
+				case ImageFormat::BC6H:						return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+				case ImageFormat::BC7:						return GL_COMPRESSED_RGBA_BPTC_UNORM;
+				case ImageFormat::BC7SRGB:					return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+			}
+
+			AR_CORE_ASSERT(false, "Unsupported Texture Array Format!");
+			return 0;
+		}
+
+		static GLenum GLFilterTypeFromTextureFilter(TextureFilter type, bool hasMipmap)
+		{
+			if (type == TextureFilter::Nearest)
+				return hasMipmap ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+
+			return hasMipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+		}
+
+		static GLenum GLWrapTypeFromTextureWrap(TextureWrap type)
+		{
+			return type == TextureWrap::Clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+		}
+
+	}
+
+	Ref<Texture2DArray> Texture2DArray::Create(ImageFormat format, uint32_t width, uint32_t height, uint32_t levelCount, uint32_t layerCount, const TextureProperties& props)
+	{
+		return CreateRef<Texture2DArray>(format, width, height, levelCount, layerCount, props);
+	}
+
+	Texture2DArray::Texture2DArray(ImageFormat format, uint32_t width, uint32_t height, uint32_t levelCount, uint32_t layerCount, const TextureProperties& props)
+		: m_Properties(props), m_Format(format), m_Width(width), m_Height(height), m_LevelCount(std::max(levelCount, 1u)), m_LayerCount(std::max(layerCount, 1u))
+	{
+		AR_PROFILE_FUNCTION();
+
+		m_TextureID = CreateStorage(m_LayerCount);
+	}
+
+	Texture2DArray::~Texture2DArray()
+	{
+		AR_PROFILE_FUNCTION();
+
+		glDeleteTextures(1, &m_TextureID);
+		RenderCommand::OnTextureDeleted(m_TextureID);
+		m_TextureID = 0;
+	}
+
+	uint32_t Texture2DArray::CreateStorage(uint32_t layerCount) const
+	{
+		uint32_t textureID;
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &textureID);
+
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, m_Properties.GenerateMips && m_LevelCount > 1));
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, Utils::GLFilterTypeFromTextureFilter(m_Properties.SamplerFilter, false));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, Utils::GLWrapTypeFromTextureWrap(m_Properties.SamplerWrap));
+
+		glTextureStorage3D(textureID, m_LevelCount, Utils::GLInternalFormatFromAFormat(m_Format), m_Width, m_Height, layerCount);
+
+		return textureID;
+	}
+
+	void Texture2DArray::CopyLayer(uint32_t layer, const Texture2D& texture)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(layer < m_LayerCount, "Layer is out of range!");
+		AR_CORE_ASSERT(texture.GetFormat() == m_Format && texture.GetWidth() == m_Width && texture.GetHeight() == m_Height, "Texture does not match the array!");
+		AR_CORE_ASSERT(texture.GetLevelCount() == m_LevelCount, "Texture does not have the same number of mips as the array!");
+
+		for (uint32_t level = 0; level < m_LevelCount; level++)
+		{
+			uint32_t width = std::max(m_Width >> level, 1u);
+			uint32_t height = std::max(m_Height >> level, 1u);
+
+			glCopyImageSubData(texture.GetTextureID(), GL_TEXTURE_2D, level, 0, 0, 0, m_TextureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1);
+		}
+	}
+
+	void Texture2DArray::Resize(uint32_t layerCount)
+	{
+		AR_PROFILE_FUNCTION();
+
+		layerCount = std::max(layerCount, 1u);
+		if (layerCount == m_LayerCount)
+			return;
+
+		uint32_t textureID = CreateStorage(layerCount);
+
+		// All the layers of a level are copied in one go
+		uint32_t keptLayers = std::min(layerCount, m_LayerCount);
+		for (uint32_t level = 0; level < m_LevelCount; level++)
+		{
+			uint32_t width = std::max(m_Width >> level, 1u);
+			uint32_t height = std::max(m_Height >> level, 1u);
+
+			glCopyImageSubData(m_TextureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, width, height, keptLayers);
+		}
+
+		glDeleteTextures(1, &m_TextureID);
+		RenderCommand::OnTextureDeleted(m_TextureID);
+
+		m_TextureID = textureID;
+		m_LayerCount = layerCount;
+	}
+
+	void Texture2DArray::Bind(uint32_t slot) const
+	{
+		AR_PROFILE_FUNCTION();
+
+		RenderCommand::BindTexture(slot, m_TextureID);
+	}
+
+	void Texture2DArray::UnBind(uint32_t slot) const
+	{
+		AR_PROFILE_FUNCTION();
+
+		RenderCommand::BindTexture(slot, 0);
+	}
+
+}
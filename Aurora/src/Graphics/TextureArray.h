@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Texture.h"
+
+/*
+ * A GL_TEXTURE_2D_ARRAY where every layer has the same format, size and number of mips. Layers are filled by copying an existing
+ * Texture2D into them on the GPU (glCopyImageSubData), so any texture that matches the array, block compressed ones included, can
+ * be moved into it without going back to the CPU. This is what the SpritePacker uses to put many sprite textures behind one binding.
+ */
+
+namespace Aurora {
+
+	class Texture2DArray : public Texture
+	{
+	public:
+		Texture2DArray(ImageFormat format, uint32_t width, uint32_t height, uint32_t levelCount, uint32_t layerCount, const TextureProperties& props = TextureProperties());
+		virtual ~Texture2DArray();
+
+		static Ref<Texture2DArray> Create(ImageFormat format, uint32_t width, uint32_t height, uint32_t levelCount, uint32_t layerCount, const TextureProperties& props = TextureProperties());
+
+		// Copies every level of texture into layer, the texture has to match the format, size and level count of the array
+		void CopyLayer(uint32_t layer, const Texture2D& texture);
+
+		// Reallocates the array with room for layerCount layers, the layers that still fit are kept. This changes the texture id!
+		void Resize(uint32_t layerCount);
+
+		virtual void Bind(uint32_t slot = 0) const override;
+		virtual void UnBind(uint32_t slot = 0) const override;
+
+		[[nodiscard]] inline uint32_t GetWidth() const { return m_Width; }
+		[[nodiscard]] inline uint32_t GetHeight() const { return m_Height; }
+		[[nodiscard]] inline uint32_t GetLevelCount() const { return m_LevelCount; }
+		[[nodiscard]] inline uint32_t GetLayerCount() const { return m_LayerCount; }
+		[[nodiscard]] inline ImageFormat GetFormat() const { return m_Format; }
+		[[nodiscard]] inline virtual uint32_t GetTextureID() const override { return m_TextureID; }
+
+	private:
+		uint32_t CreateStorage(uint32_t layerCount) const;
+
+	private:
+		uint32_t m_TextureID = 0;
+		TextureProperties m_Properties;
+
+		ImageFormat m_Format = ImageFormat::None;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_LevelCount = 1;
+		uint32_t m_LayerCount = 0;
+
+	};
+
+}
@@ -0,0 +1,717 @@
+#include "Aurorapch.h"
+#include "TextureCooker.h"
+
+#include "Core/JobSystem.h"
+#include "Utils/ImageLoader.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+	#define AR_TEXTURE_COOKER_SSE 1
+	#include <xmmintrin.h>
+#else
+	#define AR_TEXTURE_COOKER_SSE 0
+#endif
+
+namespace Aurora {
+
+	namespace Utils {
+
+		// Interpolation weights of the 4 bit indices of BC6H and BC7
+		static constexpr uint32_t BPTCWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		static const glm::vec4 RGBMask = { 1.0f, 1.0f, 1.0f, 0.0f };
+		static const glm::vec4 RGBAMask = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		struct CookImage
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			std::vector<glm::vec4> Pixels; // Linear, 0-1 for LDR images
+		};
+
+		// The 16 texels of a 4x4 block split by channel so that SSE can work on 4 texels at once
+		struct ColorBlock
+		{
+			alignas(16) float Channels[4][16];
+
+			inline glm::vec4 GetTexel(uint32_t index) const { return { Channels[0][index], Channels[1][index], Channels[2][index], Channels[3][index] }; }
+		};
+
+		struct BlockBitWriter
+		{
+			Byte* Data;
+			uint32_t Position = 0;
+
+			BlockBitWriter(Byte* data)
+				: Data(data) {}
+
+			void Write(uint32_t value, uint32_t bitCount)
+			{
+				for (uint32_t bit = 0; bit < bitCount; bit++, Position++)
+				{
+					if ((value >> bit) & 1)
+						Data[Position >> 3] |= (Byte)(1 << (Position & 7));
+				}
+			}
+		};
+
+		static float SRGBToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		static float LinearToSRGB(float value)
+		{
+			return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		}
+
+		static uint32_t CalcFullMipCount(uint32_t width, uint32_t height)
+		{
+			return (uint32_t)std::floor(std::log2(std::max(width, height))) + 1;
+		}
+
+		static TextureCompression PickCompression(const void* pixels, uint32_t width, uint32_t height, bool hdr, const TextureCookSettings& settings)
+		{
+			if (hdr)
+				return TextureCompression::BC6H;
+
+			if (settings.NormalMap)
+				return TextureCompression::BC5;
+
+			const Byte* bytes = (const Byte*)pixels;
+			for (size_t i = 0; i < (size_t)width * height; i++)
+			{
+				if (bytes[i * 4 + 3] != 255)
+					return TextureCompression::BC7;
+			}
+
+			return TextureCompression::BC1;
+		}
+
+		static ImageFormat CookedFormatFromCompression(TextureCompression compression, bool srgb)
+		{
+			switch (compression)
+			{
+				case TextureCompression::BC1:     return srgb ? ImageFormat::BC1SRGB : ImageFormat::BC1;
+				case TextureCompression::BC3:     return srgb ? ImageFormat::BC3SRGB : ImageFormat::BC3;
+				case TextureCompression::BC4:     return ImageFormat::BC4;
+				case TextureCompression::BC5:     return ImageFormat::BC5;
+				case TextureCompression::BC6H:    return ImageFormat::BC6H;
+				case TextureCompression::BC7:     return srgb ? ImageFormat::BC7SRGB : ImageFormat::BC7;
+			}
+
+			AR_CORE_ASSERT(false, "Unknown Texture Compression!");
+			return ImageFormat::None;
+		}
+
+		// 2x2 box filter, odd edges reuse the last row/column
+		static CookImage Downsample(const CookImage& source, bool normalMap)
+		{
+			AR_PROFILE_FUNCTION();
+
+			CookImage result;
+			result.Width = std::max(source.Width / 2, 1u);
+			result.Height = std::max(source.Height / 2, 1u);
+			result.Pixels.resize((size_t)result.Width * result.Height);
+
+			for (uint32_t y = 0; y < result.Height; y++)
+			{
+				uint32_t y0 = std::min(y * 2, source.Height - 1);
+				uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+
+				for (uint32_t x = 0; x < result.Width; x++)
+				{
+					uint32_t x0 = std::min(x * 2, source.Width - 1);
+					uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+
+					glm::vec4 sum = source.Pixels[(size_t)y0 * source.Width + x0] + source.Pixels[(size_t)y0 * source.Width + x1]
+						+ source.Pixels[(size_t)y1 * source.Width + x0] + source.Pixels[(size_t)y1 * source.Width + x1];
+					glm::vec4 average = sum * 0.25f;
+
+					// Averaged normals get shorter, which would make the lighting of the smaller mips flatter
+					if (normalMap)
+					{
+						glm::vec3 normal = glm::vec3(average) * 2.0f - 1.0f;
+						float length = glm::length(normal);
+						if (length > 1e-6f)
+							average = glm::vec4(normal / length * 0.5f + 0.5f, average.a);
+					}
+
+					result.Pixels[(size_t)y * result.Width + x] = average;
+				}
+			}
+
+			return result;
+		}
+
+		static void FetchBlock(const std::vector<glm::vec4>& texels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, ColorBlock& outBlock)
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				// Blocks hanging over the edge repeat the last texels
+				uint32_t x = std::min(blockX * 4 + (i & 3), width - 1);
+				uint32_t y = std::min(blockY * 4 + (i >> 2), height - 1);
+
+				const glm::vec4& texel = texels[(size_t)y * width + x];
+				for (uint32_t channel = 0; channel < 4; channel++)
+					outBlock.Channels[channel][i] = texel[channel];
+			}
+		}
+
+		static void ComputeBounds(const ColorBlock& block, glm::vec4& outMin, glm::vec4& outMax)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+#if AR_TEXTURE_COOKER_SSE
+				__m128 minValue = _mm_load_ps(&block.Channels[channel][0]);
+				__m128 maxValue = minValue;
+				for (uint32_t i = 4; i < 16; i += 4)
+				{
+					__m128 values = _mm_load_ps(&block.Channels[channel][i]);
+					minValue = _mm_min_ps(minValue, values);
+					maxValue = _mm_max_ps(maxValue, values);
+				}
+
+				minValue = _mm_min_ps(minValue, _mm_shuffle_ps(minValue, minValue, _MM_SHUFFLE(2, 3, 0, 1)));
+				minValue = _mm_min_ps(minValue, _mm_shuffle_ps(minValue, minValue, _MM_SHUFFLE(1, 0, 3, 2)));
+				maxValue = _mm_max_ps(maxValue, _mm_shuffle_ps(maxValue, maxValue, _MM_SHUFFLE(2, 3, 0, 1)));
+				maxValue = _mm_max_ps(maxValue, _mm_shuffle_ps(maxValue, maxValue, _MM_SHUFFLE(1, 0, 3, 2)));
+
+				outMin[channel] = _mm_cvtss_f32(minValue);
+				outMax[channel] = _mm_cvtss_f32(maxValue);
+#else
+				outMin[channel] = block.Channels[channel][0];
+				outMax[channel] = block.Channels[channel][0];
+				for (uint32_t i = 1; i < 16; i++)
+				{
+					outMin[channel] = std::min(outMin[channel], block.Channels[channel][i]);
+					outMax[channel] = std::max(outMax[channel], block.Channels[channel][i]);
+				}
+#endif
+			}
+		}
+
+		// dot(texel - origin, axis) for every texel
+		static void ProjectOntoAxis(const ColorBlock& block, const glm::vec4& origin, const glm::vec4& axis, float* outDistances)
+		{
+#if AR_TEXTURE_COOKER_SSE
+			for (uint32_t i = 0; i < 16; i += 4)
+			{
+				__m128 distance = _mm_setzero_ps();
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					__m128 delta = _mm_sub_ps(_mm_load_ps(&block.Channels[channel][i]), _mm_set1_ps(origin[channel]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(delta, _mm_set1_ps(axis[channel])));
+				}
+
+				_mm_storeu_ps(outDistances + i, distance);
+			}
+#else
+			for (uint32_t i = 0; i < 16; i++)
+				outDistances[i] = glm::dot(block.GetTexel(i) - origin, axis);
+#endif
+		}
+
+		// Squared distance of every texel to color, channels with a mask of 0 are ignored
+		static void DistancesToColor(const ColorBlock& block, const glm::vec4& color, const glm::vec4& mask, float* outDistances)
+		{
+#if AR_TEXTURE_COOKER_SSE
+			for (uint32_t i = 0; i < 16; i += 4)
+			{
+				__m128 distance = _mm_setzero_ps();
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					__m128 delta = _mm_sub_ps(_mm_load_ps(&block.Channels[channel][i]), _mm_set1_ps(color[channel]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_mul_ps(delta, delta), _mm_set1_ps(mask[channel])));
+				}
+
+				_mm_storeu_ps(outDistances + i, distance);
+			}
+#else
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				glm::vec4 delta = block.GetTexel(i) - color;
+				outDistances[i] = glm::dot(delta * delta, mask);
+			}
+#endif
+		}
+
+		static void FindClosestIndices(const ColorBlock& block, const glm::vec4* palette, uint32_t paletteSize, const glm::vec4& mask, uint32_t* outIndices)
+		{
+			float bestDistances[16];
+			float distances[16];
+
+			DistancesToColor(block, palette[0], mask, bestDistances);
+			for (uint32_t i = 0; i < 16; i++)
+				outIndices[i] = 0;
+
+			for (uint32_t entry = 1; entry < paletteSize; entry++)
+			{
+				DistancesToColor(block, palette[entry], mask, distances);
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					if (distances[i] < bestDistances[i])
+					{
+						bestDistances[i] = distances[i];
+						outIndices[i] = entry;
+					}
+				}
+			}
+		}
+
+		// Endpoints at the extremes of the texels along their principal axis
+		static void FitEndpoints(const ColorBlock& block, const glm::vec4& mask, glm::vec4& outStart, glm::vec4& outEnd)
+		{
+			glm::vec4 mean = glm::vec4(0.0f);
+			for (uint32_t i = 0; i < 16; i++)
+				mean += block.GetTexel(i);
+			mean = mean / 16.0f * mask;
+
+			glm::mat4 covariance = glm::mat4(0.0f);
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				glm::vec4 delta = (block.GetTexel(i) - mean) * mask;
+				covariance += glm::outerProduct(delta, delta);
+			}
+
+			// Power iteration, starting from the diagonal of the bounding box
+			glm::vec4 minValue, maxValue;
+			ComputeBounds(block, minValue, maxValue);
+
+			glm::vec4 axis = (maxValue - minValue) * mask;
+			for (uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				float length = glm::length(axis);
+				if (length < 1e-6f)
+					break;
+
+				axis = covariance * (axis / length);
+			}
+
+			float length = glm::length(axis);
+			if (length < 1e-6f)
+			{
+				// Every texel has the same color
+				outStart = mean;
+				outEnd = mean;
+				return;
+			}
+
+			axis /= length;
+
+			float distances[16];
+			ProjectOntoAxis(block, mean, axis, distances);
+
+			float minDistance = distances[0];
+			float maxDistance = distances[0];
+			for (uint32_t i = 1; i < 16; i++)
+			{
+				minDistance = std::min(minDistance, distances[i]);
+				maxDistance = std::max(maxDistance, distances[i]);
+			}
+
+			outStart = mean + axis * minDistance;
+			outEnd = mean + axis * maxDistance;
+		}
+
+		static uint16_t PackRGB565(const glm::vec4& color)
+		{
+			uint32_t r = (uint32_t)glm::clamp(std::round(color.r * 31.0f / 255.0f), 0.0f, 31.0f);
+			uint32_t g = (uint32_t)glm::clamp(std::round(color.g * 63.0f / 255.0f), 0.0f, 63.0f);
+			uint32_t b = (uint32_t)glm::clamp(std::round(color.b * 31.0f / 255.0f), 0.0f, 31.0f);
+
+			return (uint16_t)((r << 11) | (g << 5) | b);
+		}
+
+		static glm::vec4 UnpackRGB565(uint16_t color)
+		{
+			uint32_t r = (color >> 11) & 31;
+			uint32_t g = (color >> 5) & 63;
+			uint32_t b = color & 31;
+
+			return { (float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)), 255.0f };
+		}
+
+		// Texels are 0-255, the color block of BC3 is always decoded with 4 colors so it can not use the transparent mode
+		static void EncodeBC1(const ColorBlock& block, Byte* output, bool allowTransparency)
+		{
+			bool hasTransparency = false;
+			for (uint32_t i = 0; allowTransparency && i < 16; i++)
+				hasTransparency |= block.Channels[3][i] < 128.0f;
+
+			glm::vec4 start, end;
+			FitEndpoints(block, RGBMask, start, end);
+
+			// color0 > color1 selects the 4 color mode, color0 <= color1 the 3 color mode with transparent black at index 3
+			uint16_t color0 = PackRGB565(end);
+			uint16_t color1 = PackRGB565(start);
+			if (hasTransparency ? color0 > color1 : color0 < color1)
+				std::swap(color0, color1);
+
+			glm::vec4 palette[4];
+			palette[0] = UnpackRGB565(color0);
+			palette[1] = UnpackRGB565(color1);
+
+			uint32_t paletteSize = 4;
+			if (color0 > color1 || !allowTransparency)
+			{
+				palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+				palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+			}
+			else
+			{
+				palette[2] = (palette[0] + palette[1]) * 0.5f;
+				paletteSize = 3;
+			}
+
+			uint32_t indices[16];
+			FindClosestIndices(block, palette, paletteSize, RGBMask, indices);
+
+			uint32_t indexBits = 0;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t index = hasTransparency && block.Channels[3][i] < 128.0f ? 3 : indices[i];
+				indexBits |= index << (i * 2);
+			}
+
+			memcpy(output, &color0, sizeof(uint16_t));
+			memcpy(output + 2, &color1, sizeof(uint16_t));
+			memcpy(output + 4, &indexBits, sizeof(uint32_t));
+		}
+
+		// One channel of the texels (0-255), always uses the 8 value mode
+		static void EncodeBC4(const ColorBlock& block, uint32_t channel, Byte* output)
+		{
+			float minValue = block.Channels[channel][0];
+			float maxValue = block.Channels[channel][0];
+			for (uint32_t i = 1; i < 16; i++)
+			{
+				minValue = std::min(minValue, block.Channels[channel][i]);
+				maxValue = std::max(maxValue, block.Channels[channel][i]);
+			}
+
+			uint32_t value0 = (uint32_t)glm::clamp(std::round(maxValue), 0.0f, 255.0f);
+			uint32_t value1 = (uint32_t)glm::clamp(std::round(minValue), 0.0f, 255.0f);
+
+			uint64_t indexBits = 0;
+			if (value0 > value1)
+			{
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					// Step from value1 (0) to value0 (7), index 0 is value0, 1 is value1 and 2-7 are the steps in between from value0 down
+					float step = (block.Channels[channel][i] - (float)value1) / (float)(value0 - value1) * 7.0f;
+					uint32_t position = (uint32_t)glm::clamp(std::round(step), 0.0f, 7.0f);
+					uint64_t index = position == 7 ? 0 : position == 0 ? 1 : 8 - position;
+
+					indexBits |= index << (i * 3);
+				}
+			}
+
+			output[0] = (Byte)value0;
+			output[1] = (Byte)value1;
+			for (uint32_t i = 0; i < 6; i++)
+				output[2 + i] = (Byte)(indexBits >> (i * 8));
+		}
+
+		// Texels are 0-255, mode 6: RGBA 7 bit endpoints with a p-bit each and 4 bit indices
+		static void EncodeBC7(const ColorBlock& block, Byte* output)
+		{
+			glm::vec4 endpoints[2];
+			FitEndpoints(block, RGBAMask, endpoints[0], endpoints[1]);
+
+			glm::uvec4 quantized[2];
+			uint32_t pBits[2];
+			for (uint32_t e = 0; e < 2; e++)
+			{
+				float bestError = std::numeric_limits<float>::max();
+				for (uint32_t pBit = 0; pBit < 2; pBit++)
+				{
+					glm::uvec4 candidate;
+					float error = 0.0f;
+					for (uint32_t channel = 0; channel < 4; channel++)
+					{
+						candidate[channel] = (uint32_t)glm::clamp(std::round((endpoints[e][channel] - (float)pBit) / 2.0f), 0.0f, 127.0f);
+						float delta = (float)((candidate[channel] << 1) | pBit) - endpoints[e][channel];
+						error += delta * delta;
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						quantized[e] = candidate;
+						pBits[e] = pBit;
+					}
+				}
+			}
+
+			glm::vec4 palette[16];
+			for (uint32_t entry = 0; entry < 16; entry++)
+			{
+				uint32_t weight = BPTCWeights4[entry];
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					uint32_t value0 = (quantized[0][channel] << 1) | pBits[0];
+					uint32_t value1 = (quantized[1][channel] << 1) | pBits[1];
+					palette[entry][channel] = (float)(((64 - weight) * value0 + weight * value1 + 32) >> 6);
+				}
+			}
+
+			uint32_t indices[16];
+			FindClosestIndices(block, palette, 16, RGBAMask, indices);
+
+			// The first texel's index only has 3 bits, so its top bit has to be 0
+			if (indices[0] >= 8)
+			{
+				std::swap(quantized[0], quantized[1]);
+				std::swap(pBits[0], pBits[1]);
+				for (uint32_t i = 0; i < 16; i++)
+					indices[i] = 15 - indices[i];
+			}
+
+			memset(output, 0, 16);
+			BlockBitWriter writer(output);
+			writer.Write(1 << 6, 7); // Mode 6
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				writer.Write(quantized[0][channel], 7);
+				writer.Write(quantized[1][channel], 7);
+			}
+			writer.Write(pBits[0], 1);
+			writer.Write(pBits[1], 1);
+			writer.Write(indices[0], 3);
+			for (uint32_t i = 1; i < 16; i++)
+				writer.Write(indices[i], 4);
+		}
+
+		static uint32_t QuantizeBC6H(float value)
+		{
+			return (uint32_t)glm::clamp(std::round((value - 32.0f) / 64.0f), 0.0f, 1023.0f);
+		}
+
+		static uint32_t UnquantizeBC6H(uint32_t value)
+		{
+			if (value == 0)
+				return 0;
+
+			if (value == 1023)
+				return 0xFFFF;
+
+			return ((value << 16) + 0x8000) >> 10;
+		}
+
+		// Texels are in the 16 bit space the decoder interpolates in (half bits * 64 / 31), mode 11: 10 bit endpoints, 4 bit indices
+		static void EncodeBC6H(const ColorBlock& block, Byte* output)
+		{
+			glm::vec4 endpoints[2];
+			FitEndpoints(block, RGBMask, endpoints[0], endpoints[1]);
+
+			glm::uvec3 quantized[2];
+			glm::uvec3 unquantized[2];
+			for (uint32_t e = 0; e < 2; e++)
+			{
+				for (uint32_t channel = 0; channel < 3; channel++)
+				{
+					quantized[e][channel] = QuantizeBC6H(endpoints[e][channel]);
+					unquantized[e][channel] = UnquantizeBC6H(quantized[e][channel]);
+				}
+			}
+
+			glm::vec4 palette[16];
+			for (uint32_t entry = 0; entry < 16; entry++)
+			{
+				uint32_t weight = BPTCWeights4[entry];
+				for (uint32_t channel = 0; channel < 3; channel++)
+					palette[entry][channel] = (float)(((64 - weight) * unquantized[0][channel] + weight * unquantized[1][channel] + 32) >> 6);
+				palette[entry].a = 0.0f;
+			}
+
+			uint32_t indices[16];
+			FindClosestIndices(block, palette, 16, RGBMask, indices);
+
+			if (indices[0] >= 8)
+			{
+				std::swap(quantized[0], quantized[1]);
+				for (uint32_t i = 0; i < 16; i++)
+					indices[i] = 15 - indices[i];
+			}
+
+			memset(output, 0, 16);
+			BlockBitWriter writer(output);
+			writer.Write(0x03, 5); // Mode 11
+			for (uint32_t e = 0; e < 2; e++)
+			{
+				for (uint32_t channel = 0; channel < 3; channel++)
+					writer.Write(quantized[e][channel], 10);
+			}
+			writer.Write(indices[0], 3);
+			for (uint32_t i = 1; i < 16; i++)
+				writer.Write(indices[i], 4);
+		}
+
+		static void EncodeBlock(const ColorBlock& block, ImageFormat format, Byte* output)
+		{
+			switch (format)
+			{
+				case ImageFormat::BC1:
+				case ImageFormat::BC1SRGB:    EncodeBC1(block, output, true); return;
+				case ImageFormat::BC3:
+				case ImageFormat::BC3SRGB:    EncodeBC4(block, 3, output); EncodeBC1(block, output + 8, false); return;
+				case ImageFormat::BC4:        EncodeBC4(block, 0, output); return;
+				case ImageFormat::BC5:        EncodeBC4(block, 0, output); EncodeBC4(block, 1, output + 8); return;
+				case ImageFormat::BC6H:       EncodeBC6H(block, output); return;
+				case ImageFormat::BC7:
+				case ImageFormat::BC7SRGB:    EncodeBC7(block, output); return;
+			}
+
+			AR_CORE_ASSERT(false, "Unknown Block Compressed Format!");
+		}
+
+		// Converts the linear pixels into what the encoders work on, 0-255 (encoded back to sRGB if the source was) or the BC6H interpolation space
+		static std::vector<glm::vec4> ToEncoderSpace(const CookImage& image, ImageFormat format, bool sourceSRGB)
+		{
+			std::vector<glm::vec4> texels(image.Pixels.size());
+
+			for (size_t i = 0; i < image.Pixels.size(); i++)
+			{
+				const glm::vec4& pixel = image.Pixels[i];
+
+				if (format == ImageFormat::BC6H)
+				{
+					for (uint32_t channel = 0; channel < 3; channel++)
+					{
+						float value = std::isfinite(pixel[channel]) ? glm::clamp(pixel[channel], 0.0f, 65504.0f) : 0.0f;
+						texels[i][channel] = (float)glm::packHalf1x16(value) * 64.0f / 31.0f;
+					}
+
+					texels[i].a = 0.0f;
+					continue;
+				}
+
+				glm::vec4 value = glm::clamp(pixel, 0.0f, 1.0f);
+				if (sourceSRGB)
+					value = { LinearToSRGB(value.r), LinearToSRGB(value.g), LinearToSRGB(value.b), value.a };
+
+				texels[i] = glm::round(value * 255.0f);
+			}
+
+			return texels;
+		}
+
+		static std::vector<Byte> EncodeLevel(const CookImage& image, ImageFormat format, bool sourceSRGB)
+		{
+			AR_PROFILE_FUNCTION();
+
+			std::vector<glm::vec4> texels = ToEncoderSpace(image, format, sourceSRGB);
+
+			uint32_t blocksX = (image.Width + 3) / 4;
+			uint32_t blocksY = (image.Height + 3) / 4;
+			uint32_t blockSize = TextureFile::GetLevelSize(format, 4, 4);
+
+			std::vector<Byte> data((size_t)blocksX * blocksY * blockSize);
+
+			// One row of blocks per job
+			JobSystem::ParallelFor(blocksY, 1, [&](uint32_t blockY)
+			{
+				ColorBlock block;
+				for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+				{
+					FetchBlock(texels, image.Width, image.Height, blockX, blockY, block);
+					EncodeBlock(block, format, &data[((size_t)blockY * blocksX + blockX) * blockSize]);
+				}
+			});
+
+			return data;
+		}
+
+	}
+
+	CookedTexture TextureCooker::Cook(const void* pixels, uint32_t width, uint32_t height, bool hdr, const TextureCookSettings& settings)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("TextureCooker::Cook");
+
+		AR_CORE_ASSERT(pixels && width > 0 && height > 0);
+
+		TextureCompression compression = settings.Compression;
+		if (compression == TextureCompression::Auto)
+			compression = Utils::PickCompression(pixels, width, height, hdr, settings);
+
+		if (hdr && compression != TextureCompression::BC6H)
+			AR_CORE_WARN_TAG("TextureCooker", "Cooking an HDR image into an LDR format, the colors are clamped to [0, 1]!");
+
+		bool linearFormat = compression == TextureCompression::BC4 || compression == TextureCompression::BC5 || compression == TextureCompression::BC6H;
+		bool sourceSRGB = settings.SourceSRGB && !hdr && !settings.NormalMap && !linearFormat;
+
+		CookedTexture result;
+		result.Format = Utils::CookedFormatFromCompression(compression, settings.SRGB && sourceSRGB);
+		result.Width = width;
+		result.Height = height;
+
+		Utils::CookImage image;
+		image.Width = width;
+		image.Height = height;
+		image.Pixels.resize((size_t)width * height);
+
+		for (size_t i = 0; i < image.Pixels.size(); i++)
+		{
+			if (hdr)
+			{
+				const float* pixel = (const float*)pixels + i * 4;
+				image.Pixels[i] = { pixel[0], pixel[1], pixel[2], pixel[3] };
+				continue;
+			}
+
+			const Byte* pixel = (const Byte*)pixels + i * 4;
+			glm::vec4 value = glm::vec4(pixel[0], pixel[1], pixel[2], pixel[3]) / 255.0f;
+
+			// Filtering has to happen on linear values
+			if (sourceSRGB)
+				value = { Utils::SRGBToLinear(value.r), Utils::SRGBToLinear(value.g), Utils::SRGBToLinear(value.b), value.a };
+
+			image.Pixels[i] = value;
+		}
+
+		uint32_t levelCount = settings.GenerateMips ? Utils::CalcFullMipCount(width, height) : 1;
+		result.Levels.reserve(levelCount);
+
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			if (level > 0)
+				image = Utils::Downsample(image, settings.NormalMap);
+
+			result.Levels.push_back(Utils::EncodeLevel(image, result.Format, sourceSRGB));
+		}
+
+		return result;
+	}
+
+	bool TextureCooker::CookFile(const std::string& sourcePath, const std::string& destinationPath, const TextureCookSettings& settings)
+	{
+		AR_PROFILE_FUNCTION();
+
+		Utils::ImageLoadSettings loadSettings;
+		loadSettings.Channels = 4;
+		loadSettings.FlipVertically = settings.FlipVertically;
+
+		Utils::ImageData image = Utils::ImageLoader::LoadImageFile(sourcePath, loadSettings);
+		if (!image)
+		{
+			AR_CORE_ERROR_TAG("TextureCooker", "Could not load '{0}': {1}", sourcePath, Utils::ImageLoader::GetFailureReason());
+			return false;
+		}
+
+		AR_CORE_INFO_TAG("TextureCooker", "Cooking '{0}' ({1}x{2}, HDR: {3}) into '{4}'", sourcePath, image.GetWidth(), image.GetHeight(), image.IsHDR(), destinationPath);
+
+		CookedTexture cooked = Cook(image.GetPixels(), image.GetWidth(), image.GetHeight(), image.IsHDR(), settings);
+
+		return TextureFile::Write(destinationPath, cooked);
+	}
+
+	std::string TextureCooker::GetCookedPath(const std::string& sourcePath)
+	{
+		return std::filesystem::path(sourcePath).replace_extension(TextureFile::Extension).string();
+	}
+
+}
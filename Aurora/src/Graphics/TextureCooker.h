@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ * Offline texture cooking. A source image (anything stb can load) gets its whole mip chain generated on the CPU and every level is
+ * encoded into a block compressed format, the result is written into a TextureFile (.atex) which Texture2D uploads as is, no
+ * conversion and no glGenerateTextureMipmap at load time.
+ *
+ * Mips are box filtered in linear space, so sRGB encoded sources are converted to linear before averaging and back afterwards
+ * (averaging the sRGB values directly darkens the smaller mips). That happens whether or not the output is an sRGB format, a UNORM
+ * format just stores the re-encoded values as they are. Normal maps are renormalized after every step down.
+ *
+ * The encoders favor speed and simplicity over the last bit of quality, every block gets its endpoints from the principal axis of
+ * its colors and the indices picked against the actual palette the GPU decodes:
+ *  - BC1: RGB (+1 bit alpha), 4 bits per texel
+ *  - BC3: RGBA, BC1 color + BC4 alpha, 8 bits per texel
+ *  - BC4: single channel, 4 bits per texel
+ *  - BC5: two channels, used for normal maps (the shader has to reconstruct Z), 8 bits per texel
+ *  - BC6H: HDR RGB, only mode 11 (one subset, 10 bit endpoints), 8 bits per texel
+ *  - BC7: RGBA, only mode 6 (one subset, 7 bit endpoints + p-bit), 8 bits per texel
+ * The per block math runs on SSE when it is available. Blocks are encoded in parallel on the JobSystem if it is running.
+ */
+
+#include "Core/Base.h"
+#include "TextureFile.h"
+
+#include <string>
+
+namespace Aurora {
+
+	enum class TextureCompression : uint8_t
+	{
+		Auto = 0, // BC6H for HDR, BC5 for normal maps, BC1 if the image is opaque and BC7 if not
+		BC1,
+		BC3,
+		BC4,
+		BC5,
+		BC6H,
+		BC7
+	};
+
+	struct TextureCookSettings
+	{
+		TextureCompression Compression = TextureCompression::Auto;
+		// The source values are sRGB encoded, which is the case for color textures. Decides whether the mips are filtered in linear space.
+		// Ignored for HDR images, normal maps, BC4 and BC5 which are always linear data
+		bool SourceSRGB = true;
+		// Picks the *SRGB variant of the format so the GPU decodes on sampling, only applies to sRGB sources. Off by default since
+		// Texture2D and the shaders do not do sRGB yet, an sRGB format would make the sampled colors darker than the uncooked texture
+		bool SRGB = false;
+		bool NormalMap = false;
+		bool GenerateMips = true;
+		bool FlipVertically = false;
+	};
+
+	class TextureCooker
+	{
+	public:
+		// Loads the image at sourcePath, cooks it and writes it to destinationPath
+		static bool CookFile(const std::string& sourcePath, const std::string& destinationPath, const TextureCookSettings& settings = TextureCookSettings());
+
+		// pixels are tightly packed RGBA8, or RGBA32F if hdr is set
+		static CookedTexture Cook(const void* pixels, uint32_t width, uint32_t height, bool hdr, const TextureCookSettings& settings = TextureCookSettings());
+
+		// Where the cooked version of a source texture goes by default, next to the source with the TextureFile extension
+		static std::string GetCookedPath(const std::string& sourcePath);
+
+	};
+
+}
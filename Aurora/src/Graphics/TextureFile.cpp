@@ -0,0 +1,255 @@
+#include "Aurorapch.h"
+#include "TextureFile.h"
+
+#include "Asset/VirtualFileSystem.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static constexpr Byte TextureFileIdentifier[12] = { 0xAB, 'A', 'T', 'X', ' ', '1', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		static constexpr uint32_t MaxTextureFileLevels = 16;
+
+		struct TextureFileHeader
+		{
+			Byte Identifier[12];
+			uint32_t VkFormat;
+			uint32_t Width;
+			uint32_t Height;
+			uint32_t LevelCount;
+			uint32_t Flags; // Unused for now
+		};
+
+		// The VkFormat numbers of the formats, same as what KTX2 stores
+		static uint32_t VkFormatFromAFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::BC1:         return 133; // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+				case ImageFormat::BC1SRGB:     return 134; // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+				case ImageFormat::BC3:         return 137; // VK_FORMAT_BC3_UNORM_BLOCK
+				case ImageFormat::BC3SRGB:     return 138; // VK_FORMAT_BC3_SRGB_BLOCK
+				case ImageFormat::BC4:         return 139; // VK_FORMAT_BC4_UNORM_BLOCK
+				case ImageFormat::BC5:         return 141; // VK_FORMAT_BC5_UNORM_BLOCK
+				case ImageFormat::BC6H:        return 143; // VK_FORMAT_BC6H_UFLOAT_BLOCK
+				case ImageFormat::BC7:         return 145; // VK_FORMAT_BC7_UNORM_BLOCK
+				case ImageFormat::BC7SRGB:     return 146; // VK_FORMAT_BC7_SRGB_BLOCK
+			}
+
+			AR_CORE_ASSERT(false, "Format can not be stored in a texture file!");
+			return 0;
+		}
+
+		static ImageFormat AFormatFromVkFormat(uint32_t format)
+		{
+			switch (format)
+			{
+				case 133:    return ImageFormat::BC1;
+				case 134:    return ImageFormat::BC1SRGB;
+				case 137:    return ImageFormat::BC3;
+				case 138:    return ImageFormat::BC3SRGB;
+				case 139:    return ImageFormat::BC4;
+				case 141:    return ImageFormat::BC5;
+				case 143:    return ImageFormat::BC6H;
+				case 145:    return ImageFormat::BC7;
+				case 146:    return ImageFormat::BC7SRGB;
+			}
+
+			return ImageFormat::None;
+		}
+
+		static uint32_t GetBlockSize(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::BC1:
+				case ImageFormat::BC1SRGB:
+				case ImageFormat::BC4:         return 8;
+				case ImageFormat::BC3:
+				case ImageFormat::BC3SRGB:
+				case ImageFormat::BC5:
+				case ImageFormat::BC6H:
+				case ImageFormat::BC7:
+				case ImageFormat::BC7SRGB:     return 16;
+			}
+
+			return 0;
+		}
+
+		static bool ReadTextureFileInfo(FileReader& reader, const std::string& filePath, TextureFileInfo& outInfo)
+		{
+			TextureFileHeader header = {};
+			bool valid = reader.Read(&header, sizeof(TextureFileHeader))
+				&& memcmp(header.Identifier, TextureFileIdentifier, sizeof(header.Identifier)) == 0
+				&& header.LevelCount > 0 && header.LevelCount <= MaxTextureFileLevels
+				&& header.Width > 0 && header.Height > 0;
+
+			ImageFormat format = valid ? AFormatFromVkFormat(header.VkFormat) : ImageFormat::None;
+
+			std::vector<TextureFileLevel> levelIndex(valid ? header.LevelCount : 0);
+			valid = valid && format != ImageFormat::None
+				&& reader.Read(levelIndex.data(), header.LevelCount * sizeof(TextureFileLevel));
+
+			for (uint32_t level = 0; level < levelIndex.size() && valid; level++)
+			{
+				uint32_t width = std::max(header.Width >> level, 1u);
+				uint32_t height = std::max(header.Height >> level, 1u);
+
+				valid = levelIndex[level].ByteLength == TextureFile::GetLevelSize(format, width, height);
+			}
+
+			if (!valid)
+			{
+				AR_CORE_ERROR_TAG("TextureFile", "'{0}' is not a valid texture file!", filePath);
+				return false;
+			}
+
+			outInfo.Format = format;
+			outInfo.Width = header.Width;
+			outInfo.Height = header.Height;
+			outInfo.Levels = std::move(levelIndex);
+
+			return true;
+		}
+
+		static bool ReadTextureFileLevel(FileReader& reader, const std::string& filePath, const TextureFileLevel& level, std::vector<Byte>& outData)
+		{
+			outData.resize(level.ByteLength);
+
+			if (!reader.Seek(level.ByteOffset) || !reader.Read(outData.data(), outData.size()))
+			{
+				AR_CORE_ERROR_TAG("TextureFile", "'{0}' is truncated or has a broken level index!", filePath);
+				outData.clear();
+				return false;
+			}
+
+			return true;
+		}
+
+	}
+
+	bool TextureFile::IsTextureFile(const std::string& filePath)
+	{
+		return std::filesystem::path(filePath).extension() == Extension;
+	}
+
+	bool TextureFile::IsBlockCompressed(ImageFormat format)
+	{
+		return Utils::GetBlockSize(format) != 0;
+	}
+
+	uint32_t TextureFile::GetLevelSize(ImageFormat format, uint32_t width, uint32_t height)
+	{
+		AR_CORE_ASSERT(IsBlockCompressed(format), "Only block compressed formats are supported!");
+
+		return ((width + 3) / 4) * ((height + 3) / 4) * Utils::GetBlockSize(format);
+	}
+
+	bool TextureFile::Write(const std::string& filePath, const CookedTexture& texture)
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint32_t levelCount = texture.GetLevelCount();
+		if (levelCount == 0 || levelCount > Utils::MaxTextureFileLevels)
+		{
+			AR_CORE_ERROR_TAG("TextureFile", "Can not write '{0}', it has {1} levels!", filePath, levelCount);
+			return false;
+		}
+
+		Utils::TextureFileHeader header = {};
+		memcpy(header.Identifier, Utils::TextureFileIdentifier, sizeof(header.Identifier));
+		header.VkFormat = Utils::VkFormatFromAFormat(texture.Format);
+		header.Width = texture.Width;
+		header.Height = texture.Height;
+		header.LevelCount = levelCount;
+
+		// Smallest level first, right after the level index
+		std::vector<TextureFileLevel> levelIndex(levelCount);
+		uint64_t offset = sizeof(Utils::TextureFileHeader) + levelCount * sizeof(TextureFileLevel);
+		for (uint32_t level = levelCount; level-- > 0;)
+		{
+			levelIndex[level].ByteOffset = offset;
+			levelIndex[level].ByteLength = texture.Levels[level].size();
+			offset += texture.Levels[level].size();
+		}
+
+		FILE* f;
+		fopen_s(&f, filePath.c_str(), "wb");
+		if (!f)
+		{
+			AR_CORE_ERROR_TAG("TextureFile", "Could not open '{0}' for writing!", filePath);
+			return false;
+		}
+
+		fwrite(&header, sizeof(Utils::TextureFileHeader), 1, f);
+		fwrite(levelIndex.data(), sizeof(TextureFileLevel), levelCount, f);
+		for (uint32_t level = levelCount; level-- > 0;)
+			fwrite(texture.Levels[level].data(), 1, texture.Levels[level].size(), f);
+
+		fclose(f);
+
+		return true;
+	}
+
+	bool TextureFile::Read(const std::string& filePath, CookedTexture& outTexture)
+	{
+		AR_PROFILE_FUNCTION();
+
+		FileReader reader(filePath);
+		if (!reader)
+		{
+			AR_CORE_ERROR_TAG("TextureFile", "Could not open '{0}'!", filePath);
+			return false;
+		}
+
+		TextureFileInfo info;
+		bool valid = Utils::ReadTextureFileInfo(reader, filePath, info);
+
+		if (valid)
+		{
+			outTexture.Format = info.Format;
+			outTexture.Width = info.Width;
+			outTexture.Height = info.Height;
+			outTexture.Levels.resize(info.GetLevelCount());
+
+			for (uint32_t level = 0; level < info.GetLevelCount() && valid; level++)
+				valid = Utils::ReadTextureFileLevel(reader, filePath, info.Levels[level], outTexture.Levels[level]);
+		}
+
+		if (!valid)
+			outTexture = CookedTexture();
+
+		return valid;
+	}
+
+	bool TextureFile::ReadInfo(const std::string& filePath, TextureFileInfo& outInfo)
+	{
+		AR_PROFILE_FUNCTION();
+
+		FileReader reader(filePath);
+		if (!reader)
+		{
+			AR_CORE_ERROR_TAG("TextureFile", "Could not open '{0}'!", filePath);
+			return false;
+		}
+
+		return Utils::ReadTextureFileInfo(reader, filePath, outInfo);
+	}
+
+	bool TextureFile::ReadLevel(const std::string& filePath, const TextureFileInfo& info, uint32_t level, std::vector<Byte>& outData)
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(level < info.GetLevelCount());
+
+		FileReader reader(filePath);
+		if (!reader)
+		{
+			AR_CORE_ERROR_TAG("TextureFile", "Could not open '{0}'!", filePath);
+			return false;
+		}
+
+		return Utils::ReadTextureFileLevel(reader, filePath, info.Levels[level], outData);
+	}
+
+}
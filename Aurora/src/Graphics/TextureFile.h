@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ * The container cooked textures are stored in (.atex), its layout follows KTX2: an identifier, a header that stores the format as
+ * a VkFormat number, a level index with the offset and size of every mip and then the mips themselves. Just like KTX2 the mips are
+ * stored smallest first, so that the low resolution levels of a texture are at the start of the file and can be read on their own.
+ * There is no data format descriptor or key/value data, so these are not actual KTX2 files.
+ *
+ * All the levels are already in the GPU's block compressed format so they are uploaded without any conversion.
+ */
+
+#include "Core/Base.h"
+#include "Texture.h"
+
+#include <string>
+#include <vector>
+
+namespace Aurora {
+
+	struct CookedTexture
+	{
+		ImageFormat Format = ImageFormat::None;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<std::vector<Byte>> Levels; // Level 0 is the full resolution one
+
+		inline uint32_t GetLevelCount() const { return (uint32_t)Levels.size(); }
+	};
+
+	// Where a level is in the file, this is also the on disk layout of the level index
+	struct TextureFileLevel
+	{
+		uint64_t ByteOffset;
+		uint64_t ByteLength;
+	};
+
+	// Everything but the levels themselves, enough to read single levels later on
+	struct TextureFileInfo
+	{
+		ImageFormat Format = ImageFormat::None;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<TextureFileLevel> Levels; // Level 0 is the full resolution one
+
+		inline uint32_t GetLevelCount() const { return (uint32_t)Levels.size(); }
+	};
+
+	class TextureFile
+	{
+	public:
+		static constexpr const char* Extension = ".atex";
+
+	public:
+		static bool Write(const std::string& filePath, const CookedTexture& texture);
+		static bool Read(const std::string& filePath, CookedTexture& outTexture);
+
+		// For reading the levels one at a time, ReadLevel can be called from any thread
+		static bool ReadInfo(const std::string& filePath, TextureFileInfo& outInfo);
+		static bool ReadLevel(const std::string& filePath, const TextureFileInfo& info, uint32_t level, std::vector<Byte>& outData);
+
+		static bool IsTextureFile(const std::string& filePath);
+
+		static bool IsBlockCompressed(ImageFormat format);
+		// Size in bytes of one width x height level of format, block compressed levels are padded to whole blocks
+		static uint32_t GetLevelSize(ImageFormat format, uint32_t width, uint32_t height);
+
+	};
+
+}
@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "UniformBuffer.h"
 
+#include "Renderer/RenderCommand.h"
+
 #include <glad/glad.h>
 
 namespace Aurora {
@@ -15,7 +17,7 @@ namespace Aurora {
 	{
 		glCreateBuffers(1, &m_BufferID);
 		glNamedBufferData(m_BufferID, size, nullptr, GL_DYNAMIC_DRAW);
-		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_BufferID);
+		RenderCommand::BindUniformBuffer(binding, m_BufferID);
 	}
 
 	UniformBuffer::~UniformBuffer()
@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "VertexArray.h"
 
+#include "Renderer/RenderCommand.h"
+
 #include <glad/glad.h>
 
 namespace Aurora {
@@ -44,18 +46,21 @@ namespace Aurora {
 		AR_PROFILE_FUNCTION();
 
 		glDeleteVertexArrays(1, &m_ArrayId);
+
+		// The name could be handed out again to a new vertex array which the cache would then think is already bound
+		RenderCommand::ResetStateCache();
 	}
 
 	void VertexArray::Bind() const
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_ArrayId);
+		RenderCommand::BindVertexArray(m_ArrayId);
 	}
 
 	void VertexArray::UnBind() const
 	{
-		glBindVertexArray(0);
+		RenderCommand::BindVertexArray(0);
 	}
 
 	void VertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
@@ -64,7 +69,7 @@ namespace Aurora {
 
 		AR_CORE_ASSERT(vertexBuffer->GetBufferLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-		glBindVertexArray(m_ArrayId);
+		RenderCommand::BindVertexArray(m_ArrayId);
 		vertexBuffer->Bind();
 
 		int index = 0;
@@ -134,7 +139,7 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_ArrayId);
+		RenderCommand::BindVertexArray(m_ArrayId);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;
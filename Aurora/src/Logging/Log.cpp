@@ -1,6 +1,7 @@
 #include "Aurorapch.h"
 #include "Log.h"
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
@@ -10,10 +11,15 @@ namespace Aurora {
 
 		std::shared_ptr<spdlog::logger> Log::s_CoreLogger;
 		std::shared_ptr<spdlog::logger> Log::s_ClientLogger;
+		Log::TagEntry Log::s_Tags[Log::MaxTags];
 
 		void Log::Init() 
 		{
 			Timer timer;
+
+			// One worker thread so that the order of the messages is kept
+			spdlog::init_thread_pool(AsyncQueueSize, 1);
+
 			std::vector<spdlog::sink_ptr> logSinks;
 			logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
 			logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("../Aurora/LogDump/Aurora.log", true));
@@ -21,24 +27,83 @@ namespace Aurora {
 			logSinks[0]->set_pattern("%^[%T] %n(%l): %v%$");
 			logSinks[1]->set_pattern("[%T] [%l] %n: %v");
 
-			s_CoreLogger = std::make_shared<spdlog::logger>("Aurora", begin(logSinks), end(logSinks));
+			// If the queue is full the caller blocks instead of dropping, we do not want to lose errors
+			s_CoreLogger = std::make_shared<spdlog::async_logger>("Aurora", begin(logSinks), end(logSinks), spdlog::thread_pool(), spdlog::async_overflow_policy::block);
 			spdlog::register_logger(s_CoreLogger);
 			s_CoreLogger->set_level(spdlog::level::trace);
-			s_CoreLogger->flush_on(spdlog::level::trace);
+			s_CoreLogger->flush_on(spdlog::level::warn);
 
-			s_ClientLogger = std::make_shared<spdlog::logger>("Client", begin(logSinks), end(logSinks));
+			s_ClientLogger = std::make_shared<spdlog::async_logger>("Client", begin(logSinks), end(logSinks), spdlog::thread_pool(), spdlog::async_overflow_policy::block);
 			spdlog::register_logger(s_ClientLogger);
 			s_ClientLogger->set_level(spdlog::level::trace);
-			s_ClientLogger->flush_on(spdlog::level::trace);
+			s_ClientLogger->flush_on(spdlog::level::warn);
+
+			// Everything below warnings gets written by the worker in batches and only hits the disk on this interval
+			spdlog::flush_every(std::chrono::seconds(1));
 
 			AR_CORE_DEBUG_TAG("Log", "Initialized logger! Initialization took : {}ms", timer.ElapsedMillis());
 		}
 
 		void Log::ShutDown()
 		{
+			s_CoreLogger->flush();
+			s_ClientLogger->flush();
+
 			s_CoreLogger.reset();
 			s_ClientLogger.reset();
-			spdlog::drop_all();
+
+			// Drains the queue and joins the worker thread
+			spdlog::shutdown();
+		}
+
+		Log::TagDetails& Log::GetTagDetails(uint32_t tagID, std::string_view tag)
+		{
+			// Open addressing with linear probing, slots are only ever claimed and never removed so this is safe to call from any thread
+			uint32_t index = tagID & (MaxTags - 1);
+			for (uint32_t i = 0; i < MaxTags; i++)
+			{
+				TagEntry& entry = s_Tags[(index + i) & (MaxTags - 1)];
+				uint32_t id = entry.ID.load(std::memory_order_acquire);
+				if (id == tagID)
+					return entry.Details;
+
+				if (id == 0)
+				{
+					if (entry.ID.compare_exchange_strong(id, tagID, std::memory_order_acq_rel))
+					{
+						size_t length = std::min(tag.size(), sizeof(entry.Name) - 1);
+						memcpy(entry.Name, tag.data(), length);
+						entry.Name[length] = '\0';
+
+						return entry.Details;
+					}
+
+					// Someone else claimed the slot first
+					if (id == tagID)
+						return entry.Details;
+				}
+			}
+
+			// Table is full, every unknown tag shares the default details
+			static TagDetails s_DefaultDetails;
+			return s_DefaultDetails;
+		}
+
+		bool Log::HasTag(std::string_view tag)
+		{
+			uint32_t tagID = HashTag(tag);
+			uint32_t index = tagID & (MaxTags - 1);
+			for (uint32_t i = 0; i < MaxTags; i++)
+			{
+				uint32_t id = s_Tags[(index + i) & (MaxTags - 1)].ID.load(std::memory_order_acquire);
+				if (id == tagID)
+					return true;
+
+				if (id == 0)
+					return false;
+			}
+
+			return false;
 		}
 	}
 
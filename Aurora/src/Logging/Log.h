@@ -1,10 +1,22 @@
 #pragma once
 
+/*
+ * Logging goes through spdlog async loggers, the calling thread only formats the message and pushes it into a bounded queue and
+ * a single worker thread writes to the console/file sinks and only flushes on warnings and up (and every second).
+ *
+ * Tags are hashed at compile time by the macros so filtering a message is a lookup into a small fixed table with an integer key
+ * instead of building a std::string and looking it up in a std::map.
+ *
+ * Trace and Debug messages are compiled away completely in Release and Dist, and everything is compiled away in Dist.
+ */
+
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/ostr.h>
 
-#include <map>
+#include <atomic>
 #include <memory>
+#include <string_view>
+#include <type_traits>
 
 namespace Aurora { namespace Logger {
 
@@ -27,17 +39,32 @@ namespace Aurora { namespace Logger {
 			Level LevelFilter = Level::Trace;
 		};
 
+		static constexpr uint32_t MaxTags = 256; // Has to be a power of 2
+		static constexpr size_t AsyncQueueSize = 8192;
+
 		static void Init();
 		static void ShutDown();
 
 		static const std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
 		static const std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
 
-		static bool HasTag(const std::string& tag) { return s_EnabledTags.find(tag) != s_EnabledTags.end(); }
-		static std::map<std::string, TagDetails>& EnabledTags() { return s_EnabledTags; }
+		// FNV-1a, used by the logging macros to turn the tag into an ID at compile time. 0 is reserved for empty slots
+		static constexpr uint32_t HashTag(std::string_view tag)
+		{
+			uint32_t hash = 2166136261u;
+			for (char c : tag)
+				hash = (hash ^ (uint32_t)c) * 16777619u;
+
+			return hash ? hash : 1;
+		}
+
+		// Returns the details of the tag, registering it with the default details if it was never seen before
+		static TagDetails& GetTagDetails(uint32_t tagID, std::string_view tag);
+		static TagDetails& GetTagDetails(std::string_view tag) { return GetTagDetails(HashTag(tag), tag); }
+		static bool HasTag(std::string_view tag);
 
 		template<typename... Args>
-		static void PrintMessage(Log::Type type, Log::Level level, std::string_view tag, Args&&... args);
+		static void PrintMessage(Log::Type type, Log::Level level, uint32_t tagID, std::string_view tag, Args&&... args);
 
 		template<typename... Args>
 		static void PrintAssertMessageWithTag(Log::Type type, std::string_view tag, std::string_view assertFailed, Args&&... args);
@@ -70,44 +97,55 @@ namespace Aurora { namespace Logger {
 			return Level::Trace;
 		}
 
+		static spdlog::level::level_enum LevelToSpdlogLevel(Level level)
+		{
+			switch (level)
+			{
+			    case Level::Trace: return spdlog::level::trace;
+			    case Level::Info:  return spdlog::level::info;
+			    case Level::Debug: return spdlog::level::debug;
+			    case Level::Warn:  return spdlog::level::warn;
+			    case Level::Error: return spdlog::level::err;
+			    case Level::Fatal: return spdlog::level::critical;
+			}
+
+			return spdlog::level::trace;
+		}
+
 	private:
+		struct TagEntry
+		{
+			std::atomic<uint32_t> ID{ 0 };
+			char Name[32] = {}; // Only for tools, truncated if needed
+			TagDetails Details;
+		};
+
 		static std::shared_ptr<spdlog::logger> s_CoreLogger;
 		static std::shared_ptr<spdlog::logger> s_ClientLogger;
 
-		inline static std::map<std::string, TagDetails> s_EnabledTags;
+		static TagEntry s_Tags[MaxTags];
 
 	};
 
 	template<typename... Args>
-	void Log::PrintMessage(Log::Type type, Log::Level level, std::string_view tag, Args&&... args)
+	void Log::PrintMessage(Log::Type type, Log::Level level, uint32_t tagID, std::string_view tag, Args&&... args)
 	{
-		const auto& detail = s_EnabledTags[std::string(tag)];
-		if (detail.Enabled && detail.LevelFilter <= level)
-		{
-			const auto& logger = (type == Type::Core) ? GetCoreLogger() : GetClientLogger();
-			std::string logString = tag.empty() ? "{0}{1}" : "[{0}]: {1}";
-			switch (level)
-			{
-			    case Level::Trace:
-			    	logger->trace(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			    case Level::Info:
-			    	logger->info(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			    case Level::Debug:
-			    	logger->debug(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			    case Level::Warn:
-			    	logger->warn(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			    case Level::Error:
-			    	logger->error(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			    case Level::Fatal:
-			    	logger->critical(logString, tag, fmt::format(std::forward<Args>(args)...));
-			    	break;
-			}
-		}
+		const TagDetails& detail = GetTagDetails(tagID, tag);
+		if (!detail.Enabled || detail.LevelFilter > level)
+			return;
+
+		const auto& logger = (type == Type::Core) ? GetCoreLogger() : GetClientLogger();
+		spdlog::level::level_enum spdLevel = LevelToSpdlogLevel(level);
+		if (!logger->should_log(spdLevel))
+			return;
+
+		// Format the whole message once on this thread, the async logger then only copies it into its queue
+		fmt::memory_buffer buffer;
+		if (!tag.empty())
+			fmt::format_to(std::back_inserter(buffer), "[{0}]: ", tag);
+		fmt::format_to(std::back_inserter(buffer), std::forward<Args>(args)...);
+
+		logger->log(spdLevel, spdlog::string_view_t(buffer.data(), buffer.size()));
 	}
 
 	template<typename... Args>
@@ -115,6 +153,7 @@ namespace Aurora { namespace Logger {
 	{
 		const auto& logger = (type == Type::Core) ? GetCoreLogger() : GetClientLogger();
 		logger->error("[{0}]: {1}\n\t\t\t  Error: {2}", tag, assertFailed, fmt::format(std::forward<Args>(args)...));
+		logger->flush(); // Asserts break right after, so at least try to get the message out before that
 	}
 
 	// Without this template specializtion, assert without messages are not possible since the function would still want more arguments for the variadic template!
@@ -123,41 +162,15 @@ namespace Aurora { namespace Logger {
 	{
 		const auto& logger = (type == Type::Core) ? GetCoreLogger() : GetClientLogger();
 		logger->error("[{0}]: {1}", tag, assertFailed);
+		logger->flush();
 	}
 
 } }
 
-#ifndef AURORA_DIST
-
-    #define AR_CORE_TRACE_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Trace, tag, __VA_ARGS__)
-    #define AR_CORE_INFO_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, tag, __VA_ARGS__)
-    #define AR_CORE_DEBUG_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Debug, tag, __VA_ARGS__)
-    #define AR_CORE_WARN_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, tag, __VA_ARGS__)
-    #define AR_CORE_ERROR_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, tag, __VA_ARGS__)
-    #define AR_CORE_CRITICAL_TAG(tag, ...)  ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, tag, __VA_ARGS__)
-
-	#define AR_CORE_TRACE(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Trace, "", __VA_ARGS__)
-    #define AR_CORE_INFO(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, "", __VA_ARGS__)
-    #define AR_CORE_DEBUG(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Debug, "", __VA_ARGS__)
-    #define AR_CORE_WARN(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, "", __VA_ARGS__)
-    #define AR_CORE_ERROR(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, "", __VA_ARGS__)
-    #define AR_CORE_CRITICAL(...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, "", __VA_ARGS__)
-
-	#define AR_TRACE_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Trace, tag, __VA_ARGS__)
-    #define AR_INFO_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, tag, __VA_ARGS__)
-    #define AR_DEBUG_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Debug, tag, __VA_ARGS__)
-    #define AR_WARN_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, tag, __VA_ARGS__)
-    #define AR_ERROR_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, tag, __VA_ARGS__)
-    #define AR_CRITICAL_TAG(tag, ...)       ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, tag, __VA_ARGS__)
-
-    #define AR_TRACE(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Trace, "", __VA_ARGS__)
-    #define AR_INFO(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, "", __VA_ARGS__)
-    #define AR_DEBUG(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Debug, "", __VA_ARGS__)
-    #define AR_WARN(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, "", __VA_ARGS__)
-    #define AR_ERROR(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, "", __VA_ARGS__)
-    #define AR_CRITICAL(...)                ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, "", __VA_ARGS__)
+// Resolves the tag into its ID at compile time
+#define AR_LOG_TAG_ID(tag) std::integral_constant<uint32_t, ::Aurora::Logger::Log::HashTag(tag)>::value
 
-#else
+#if defined(AURORA_DIST)
 
     #define AR_CORE_TRACE_TAG(tag, ...)
     #define AR_CORE_INFO_TAG(tag, ...)
@@ -187,4 +200,66 @@ namespace Aurora { namespace Logger {
     #define AR_ERROR(...)
     #define AR_CRITICAL(...)
 
+#elif defined(AURORA_RELEASE)
+
+    // Trace and Debug are stripped in Release (and Profile) so that they do not show up in startup and frame profiles
+
+    #define AR_CORE_TRACE_TAG(tag, ...)
+    #define AR_CORE_INFO_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_DEBUG_TAG(tag, ...)
+    #define AR_CORE_WARN_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_ERROR_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_CRITICAL_TAG(tag, ...)  ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+
+    #define AR_CORE_TRACE(...)
+    #define AR_CORE_INFO(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_DEBUG(...)
+    #define AR_CORE_WARN(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_ERROR(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_CRITICAL(...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+
+    #define AR_TRACE_TAG(tag, ...)
+    #define AR_INFO_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_DEBUG_TAG(tag, ...)
+    #define AR_WARN_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_ERROR_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CRITICAL_TAG(tag, ...)       ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+
+    #define AR_TRACE(...)
+    #define AR_INFO(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_DEBUG(...)
+    #define AR_WARN(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_ERROR(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CRITICAL(...)                ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+
+#else
+
+    #define AR_CORE_TRACE_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Trace, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_INFO_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_DEBUG_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Debug, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_WARN_TAG(tag, ...)      ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_ERROR_TAG(tag, ...)     ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CORE_CRITICAL_TAG(tag, ...)  ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+
+    #define AR_CORE_TRACE(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Trace, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_INFO(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_DEBUG(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Debug, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_WARN(...)               ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_ERROR(...)              ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CORE_CRITICAL(...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Core, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+
+    #define AR_TRACE_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Trace, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_INFO_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_DEBUG_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Debug, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_WARN_TAG(tag, ...)           ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_ERROR_TAG(tag, ...)          ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+    #define AR_CRITICAL_TAG(tag, ...)       ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(tag), tag, __VA_ARGS__)
+
+    #define AR_TRACE(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Trace, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_INFO(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Info, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_DEBUG(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Debug, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_WARN(...)                    ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Warn, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_ERROR(...)                   ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Error, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+    #define AR_CRITICAL(...)                ::Aurora::Logger::Log::PrintMessage(::Aurora::Logger::Log::Type::Client, ::Aurora::Logger::Log::Level::Fatal, AR_LOG_TAG_ID(""), "", __VA_ARGS__)
+
 #endif
\ No newline at end of file
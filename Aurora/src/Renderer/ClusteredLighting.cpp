@@ -0,0 +1,114 @@
+#include "Aurorapch.h"
+#include "ClusteredLighting.h"
+
+#include "RenderCommand.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		// The exponential slicing needs a near plane in front of the camera, orthographic cameras can have it at or behind it
+		static constexpr float MinClusterNearClip = 0.01f;
+
+	}
+
+	ClusteredLighting::ClusteredLighting()
+	{
+		m_CullingShader = Shader::Create("Resources/shaders/LightCulling.glsl");
+
+		m_LightingUniformBuffer = UniformBuffer::Create(sizeof(LightingUniforms), 2);
+		m_LightBuffer = StorageBuffer::Create(MaxLights * sizeof(LightData), 5);
+		m_ClusterBuffer = StorageBuffer::Create(ClusterCount * sizeof(glm::uvec2), 6);
+		m_LightIndexBuffer = StorageBuffer::Create((1 + MaxLightIndices) * sizeof(uint32_t), 7); // The counter comes first
+
+		m_Lights.reserve(MaxLights);
+	}
+
+	Ref<ClusteredLighting> ClusteredLighting::Create()
+	{
+		return CreateRef<ClusteredLighting>();
+	}
+
+	void ClusteredLighting::BeginFrame(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip)
+	{
+		AR_PROFILE_FUNCTION();
+
+		m_Lights.clear();
+
+		m_ViewMatrix = view;
+		m_Projection = projection;
+		m_NearClip = std::max(nearClip, Utils::MinClusterNearClip);
+		m_FarClip = std::max(farClip, m_NearClip * 2.0f);
+	}
+
+	void ClusteredLighting::AddPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius)
+	{
+		if (m_Lights.size() >= MaxLights)
+		{
+			AR_CORE_WARN_TAG("ClusteredLighting", "Reached the maximum of {0} lights, the rest of the lights is dropped!", MaxLights);
+			return;
+		}
+
+		LightData& light = m_Lights.emplace_back();
+		light.PositionRadius = { position, radius };
+		light.ColorIntensity = { color, intensity };
+		light.DirectionType = { 0.0f, 0.0f, -1.0f, 0.0f };
+		light.SpotCone = { -1.0f, -1.0f, 0.0f, 0.0f };
+	}
+
+	void ClusteredLighting::AddSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, float intensity, float radius, float innerConeAngle, float outerConeAngle)
+	{
+		if (m_Lights.size() >= MaxLights)
+		{
+			AR_CORE_WARN_TAG("ClusteredLighting", "Reached the maximum of {0} lights, the rest of the lights is dropped!", MaxLights);
+			return;
+		}
+
+		outerConeAngle = glm::clamp(outerConeAngle, 0.0f, 89.9f);
+		innerConeAngle = glm::clamp(innerConeAngle, 0.0f, outerConeAngle);
+
+		LightData& light = m_Lights.emplace_back();
+		light.PositionRadius = { position, radius };
+		light.ColorIntensity = { color, intensity };
+		light.DirectionType = { glm::normalize(direction), 1.0f };
+		light.SpotCone = { glm::cos(glm::radians(innerConeAngle)), glm::cos(glm::radians(outerConeAngle)), 0.0f, 0.0f };
+	}
+
+	void ClusteredLighting::Cull()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("ClusteredLighting::Cull");
+
+		uint32_t lightCount = (uint32_t)m_Lights.size();
+		float depthScale = (float)GridSizeZ / std::log(m_FarClip / m_NearClip);
+
+		LightingUniforms uniforms;
+		uniforms.ViewMatrix = m_ViewMatrix;
+		uniforms.ClusterGrid = { GridSizeX, GridSizeY, GridSizeZ, lightCount };
+		uniforms.ClusterDepth = { m_NearClip, m_FarClip, depthScale, std::log(m_NearClip) * depthScale };
+		uniforms.AmbientColor = { m_AmbientColor, 1.0f };
+		m_LightingUniformBuffer->SetData(&uniforms, sizeof(LightingUniforms));
+
+		// Without lights the shaders do not look at the clusters at all
+		if (lightCount == 0)
+			return;
+
+		m_LightBuffer->SetData(m_Lights.data(), lightCount * sizeof(LightData));
+
+		uint32_t zero = 0;
+		m_LightIndexBuffer->SetData(&zero, sizeof(uint32_t));
+
+		m_LightBuffer->Bind();
+		m_ClusterBuffer->Bind();
+		m_LightIndexBuffer->Bind();
+
+		m_CullingShader->Bind();
+		m_CullingShader->SetUniform("u_Culling.InverseProjection", glm::inverse(m_Projection));
+		m_CullingShader->SetUniform("u_Culling.MaxLightIndices", MaxLightIndices);
+
+		// One work group per depth slice, the tiles of a slice are the invocations of the group
+		RenderCommand::DispatchCompute(1, 1, GridSizeZ);
+		RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::ShaderStorage);
+	}
+
+}
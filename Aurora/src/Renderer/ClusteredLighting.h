@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+ * Clustered forward lighting. The view frustum is split into a grid of clusters (tiles on screen times exponential slices in depth)
+ * and every frame a compute pass (LightCulling.glsl) finds which of the lights touch which cluster. The result is an offset and a
+ * count per cluster into one big list of light indices, the shaders then find the cluster of their fragment and only loop over the
+ * lights in there, so the shading cost depends on how many lights are close by instead of how many lights there are in total.
+ *
+ * Everything lives on the GPU: lights (binding 5), clusters (binding 6) and the light index list (binding 7) are storage buffers and
+ * the grid/camera information is in the Lighting uniform buffer (binding 2), shaders that want lighting declare these the same way
+ * StaticMesh.glsl does. Lights are collected between BeginFrame and Cull, spot lights are binned with their bounding sphere.
+ *
+ * If no light is submitted the culling pass is skipped and the shaders keep everything fully lit.
+ */
+
+#include "Core/Base.h"
+#include "Graphics/Shader.h"
+#include "Graphics/StorageBuffer.h"
+#include "Graphics/UniformBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Aurora {
+
+	class ClusteredLighting : public RefCountedObject
+	{
+	public:
+		static constexpr uint32_t GridSizeX = 16; // X and Y have to match the local size in LightCulling.glsl
+		static constexpr uint32_t GridSizeY = 9;
+		static constexpr uint32_t GridSizeZ = 24;
+		static constexpr uint32_t ClusterCount = GridSizeX * GridSizeY * GridSizeZ;
+		static constexpr uint32_t MaxLights = 4096;
+		static constexpr uint32_t MaxLightsPerCluster = 64; // Has to match LightCulling.glsl
+		static constexpr uint32_t MaxLightIndices = ClusterCount * 32; // On average half of the per cluster maximum
+
+	public:
+		ClusteredLighting();
+		~ClusteredLighting() = default;
+
+		static Ref<ClusteredLighting> Create();
+
+		// Clears the lights of the last frame, near and far are the clip planes of the projection
+		void BeginFrame(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip);
+
+		void AddPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius);
+		// Cone angles are in degrees and are the half angles of the cone
+		void AddSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, float intensity, float radius, float innerConeAngle, float outerConeAngle);
+
+		// Uploads the lights and bins them into the clusters, has to run before anything that is lit is drawn
+		void Cull();
+
+		inline uint32_t GetLightCount() const { return (uint32_t)m_Lights.size(); }
+
+		inline void SetAmbientColor(const glm::vec3& color) { m_AmbientColor = color; }
+		inline const glm::vec3& GetAmbientColor() const { return m_AmbientColor; }
+
+	private:
+		// Has to match the std430 struct in the shaders
+		struct LightData
+		{
+			glm::vec4 PositionRadius;
+			glm::vec4 ColorIntensity;
+			glm::vec4 DirectionType; // w: 0 point, 1 spot
+			glm::vec4 SpotCone; // x: cos of the inner angle, y: cos of the outer angle
+		};
+
+		// Has to match the std140 Lighting block in the shaders
+		struct LightingUniforms
+		{
+			glm::mat4 ViewMatrix;
+			glm::uvec4 ClusterGrid; // xyz: size of the grid, w: light count
+			glm::vec4 ClusterDepth; // x: near, y: far, z: slices / log(far / near), w: log(near) * z
+			glm::vec4 AmbientColor;
+		};
+
+		Ref<Shader> m_CullingShader;
+		Ref<UniformBuffer> m_LightingUniformBuffer;
+		Ref<StorageBuffer> m_LightBuffer;
+		Ref<StorageBuffer> m_ClusterBuffer;
+		Ref<StorageBuffer> m_LightIndexBuffer;
+
+		std::vector<LightData> m_Lights;
+
+		glm::mat4 m_ViewMatrix = glm::mat4(1.0f);
+		glm::mat4 m_Projection = glm::mat4(1.0f);
+		float m_NearClip = 0.1f;
+		float m_FarClip = 1000.0f;
+
+		glm::vec3 m_AmbientColor = glm::vec3(0.03f);
+
+	};
+
+}
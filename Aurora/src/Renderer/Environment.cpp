@@ -0,0 +1,363 @@
+#include "Aurorapch.h"
+#include "Environment.h"
+
+#include "Asset/VirtualFileSystem.h"
+
+#include "Core/JobSystem.h"
+#include "Graphics/Shader.h"
+#include "RenderCommand.h"
+#include "RendererPorperties.h"
+
+#include <glad/glad.h>
+
+#include <iomanip>
+
+namespace Aurora {
+
+	struct EnvironmentData
+	{
+		// Only created once something has to be baked
+		Ref<Shader> IrradianceShader;
+		Ref<Shader> PrefilterShader;
+
+		uint32_t BRDFLutTextureID = 0;
+		bool Supported = false;
+	};
+
+	static EnvironmentData* s_Data = nullptr;
+
+	namespace Utils {
+
+		// Bump whenever the bake changes so that the old caches are not used anymore
+		static constexpr uint32_t EnvironmentCacheVersion = 1;
+		static constexpr char EnvironmentCacheMagic[4] = { 'A', 'E', 'N', 'V' };
+
+		// The irradiance is integrated from the radiance mip closest to this size, the samples are about one texel apart there
+		static constexpr float IrradianceSourceSize = 64.0f;
+
+		static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+		struct EnvironmentCacheHeader
+		{
+			char Magic[4];
+			uint32_t Version;
+			uint64_t Key; // Hash of the faces, 0 for the BRDF lookup table
+			uint32_t Sizes[3]; // The sizes and level counts the maps were baked with
+			uint32_t Padding;
+		};
+
+		static EnvironmentCacheHeader MakeCacheHeader(uint64_t key, uint32_t size0, uint32_t size1, uint32_t size2)
+		{
+			EnvironmentCacheHeader header = {};
+			memcpy(header.Magic, EnvironmentCacheMagic, sizeof(header.Magic));
+			header.Version = EnvironmentCacheVersion;
+			header.Key = key;
+			header.Sizes[0] = size0;
+			header.Sizes[1] = size1;
+			header.Sizes[2] = size2;
+
+			return header;
+		}
+
+		static std::string GetCachePath(const std::string& name)
+		{
+			return (std::filesystem::path(Environment::GetCacheDirectory()) / (name + ".aenv")).string();
+		}
+
+		static bool ReadCacheFile(const std::string& filePath, const EnvironmentCacheHeader& expectedHeader, uint64_t expectedSize, std::vector<Byte>& outData)
+		{
+			AR_PROFILE_FUNCTION();
+
+			FileReader reader(filePath);
+			if (!reader)
+				return false;
+
+			// Anything that does not match is just an old cache, it gets baked again and overwritten
+			EnvironmentCacheHeader header = {};
+			outData.resize(expectedSize);
+			bool valid = reader.Read(&header, sizeof(EnvironmentCacheHeader))
+				&& memcmp(&header, &expectedHeader, sizeof(EnvironmentCacheHeader)) == 0
+				&& reader.Read(outData.data(), outData.size());
+
+			if (!valid)
+				outData.clear();
+
+			return valid;
+		}
+
+		static void WriteCacheFile(const std::string& filePath, const EnvironmentCacheHeader& header, const std::vector<Byte>& data)
+		{
+			AR_PROFILE_FUNCTION();
+
+			std::filesystem::create_directories(Environment::GetCacheDirectory());
+
+			FILE* f;
+			fopen_s(&f, filePath.c_str(), "wb");
+			if (!f)
+			{
+				AR_CORE_ERROR_TAG("Environment", "Could not open '{0}' for writing!", filePath);
+				return;
+			}
+
+			fwrite(&header, sizeof(EnvironmentCacheHeader), 1, f);
+			fwrite(data.data(), 1, data.size(), f);
+			fclose(f);
+		}
+
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = FNVOffsetBasis)
+		{
+			const Byte* bytes = (const Byte*)data;
+			for (size_t i = 0; i < size; i++)
+				hash = (hash ^ bytes[i]) * FNVPrime;
+
+			return hash;
+		}
+
+		// FNV-1a of the contents of the files rather than their paths or timestamps, so that the cache survives a fresh checkout
+		static uint64_t HashCubeFaces(const std::vector<std::string>& faces)
+		{
+			AR_PROFILE_FUNCTION();
+
+			uint64_t faceHashes[CubeTexture::FaceCount] = {};
+			JobSystem::ParallelFor((uint32_t)faces.size(), 1, [&](uint32_t face)
+			{
+				std::vector<Byte> contents;
+				VirtualFileSystem::ReadFile(faces[face], contents);
+
+				faceHashes[face] = HashBytes(contents.data(), contents.size());
+			});
+
+			return HashBytes(faceHashes, sizeof(faceHashes));
+		}
+
+		static void BakeBRDFLut(uint32_t textureID)
+		{
+			AR_PROFILE_FUNCTION();
+			AR_SCOPE_PERF("Environment::BakeBRDFLut");
+
+			Ref<Shader> shader = Shader::Create("Resources/shaders/EnvironmentBRDF.glsl");
+			shader->Bind();
+			shader->SetUniform("u_Uniforms.OutputSize", (int)Environment::BRDFLutSize);
+
+			RenderCommand::BindImageTexture(0, textureID, 0, ImageAccess::WriteOnly, ImageFormat::RG16F);
+
+			const glm::uvec3& groupSize = shader->GetWorkGroupSize();
+			RenderCommand::DispatchCompute(RenderCommand::GetGroupCount(Environment::BRDFLutSize, groupSize.x), RenderCommand::GetGroupCount(Environment::BRDFLutSize, groupSize.y));
+			RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::TextureFetch | MemoryBarrierFlags::TextureUpdate);
+		}
+
+	}
+
+	void Environment::Init()
+	{
+		AR_PROFILE_FUNCTION();
+
+		s_Data = new EnvironmentData;
+
+		uint32_t textureUnits = RendererProperties::GetRendererProperties()->MaxTextureSlots;
+		s_Data->Supported = textureUnits > BRDFLutSlot;
+		if (!s_Data->Supported)
+		{
+			AR_CORE_WARN_TAG("Environment", "Image based lighting needs {0} texture units but there are only {1}, it is disabled", BRDFLutSlot + 1, textureUnits);
+			return;
+		}
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &s_Data->BRDFLutTextureID);
+		glTextureStorage2D(s_Data->BRDFLutTextureID, 1, GL_RG16F, BRDFLutSize, BRDFLutSize);
+		glTextureParameteri(s_Data->BRDFLutTextureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(s_Data->BRDFLutTextureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(s_Data->BRDFLutTextureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(s_Data->BRDFLutTextureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// Two half floats per texel
+		uint64_t lutSize = BRDFLutSize * BRDFLutSize * 2 * sizeof(uint16_t);
+		std::string cachePath = Utils::GetCachePath("BRDFLut");
+		Utils::EnvironmentCacheHeader header = Utils::MakeCacheHeader(0, BRDFLutSize, 0, 0);
+
+		std::vector<Byte> data;
+		if (Utils::ReadCacheFile(cachePath, header, lutSize, data))
+		{
+			glTextureSubImage2D(s_Data->BRDFLutTextureID, 0, 0, 0, BRDFLutSize, BRDFLutSize, GL_RG, GL_HALF_FLOAT, data.data());
+			return;
+		}
+
+		Utils::BakeBRDFLut(s_Data->BRDFLutTextureID);
+
+		data.resize(lutSize);
+		glGetTextureImage(s_Data->BRDFLutTextureID, 0, GL_RG, GL_HALF_FLOAT, (GLsizei)data.size(), data.data());
+		Utils::WriteCacheFile(cachePath, header, data);
+	}
+
+	void Environment::ShutDown()
+	{
+		AR_PROFILE_FUNCTION();
+
+		glDeleteTextures(1, &s_Data->BRDFLutTextureID);
+		RenderCommand::ResetStateCache();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	const char* Environment::GetCacheDirectory()
+	{
+		return "Resources/cache/environment";
+	}
+
+	bool Environment::IsSupported()
+	{
+		return s_Data->Supported;
+	}
+
+	uint32_t Environment::GetBRDFLutTextureID()
+	{
+		return s_Data->BRDFLutTextureID;
+	}
+
+	Environment::Environment(const std::string& directory)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("Environment::Environment");
+
+		m_RadianceMap = CubeTexture::Create(directory);
+		m_IrradianceMap = CubeTexture::Create(ImageFormat::RGBA16F, IrradianceMapSize, 1);
+		m_PrefilteredMap = CubeTexture::Create(ImageFormat::RGBA16F, PrefilteredMapSize, PrefilteredLevelCount);
+
+		if (!m_RadianceMap->IsLoaded() || !s_Data->Supported)
+		{
+			glClearTexImage(m_IrradianceMap->GetTextureID(), 0, GL_RGBA, GL_FLOAT, nullptr);
+			for (uint32_t level = 0; level < PrefilteredLevelCount; level++)
+				glClearTexImage(m_PrefilteredMap->GetTextureID(), level, GL_RGBA, GL_FLOAT, nullptr);
+
+			return;
+		}
+
+		m_SourceHash = Utils::HashCubeFaces(CubeTexture::GetFacePaths(directory));
+
+		std::stringstream cacheName;
+		cacheName << std::hex << std::setw(16) << std::setfill('0') << m_SourceHash;
+		std::string cachePath = Utils::GetCachePath(cacheName.str());
+
+		if (ReadCache(cachePath))
+			return;
+
+		AR_CORE_INFO_TAG("Environment", "Baking the image based lighting of '{0}'", directory);
+
+		Bake();
+		WriteCache(cachePath);
+	}
+
+	Ref<Environment> Environment::Create(const std::string& directory)
+	{
+		return CreateRef<Environment>(directory);
+	}
+
+	void Environment::Bind() const
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!s_Data->Supported)
+			return;
+
+		m_IrradianceMap->Bind(IrradianceMapSlot);
+		m_PrefilteredMap->Bind(PrefilteredMapSlot);
+		RenderCommand::BindTexture(BRDFLutSlot, s_Data->BRDFLutTextureID);
+	}
+
+	bool Environment::ReadCache(const std::string& cachePath)
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint64_t expectedSize = m_IrradianceMap->GetLevelSize(0);
+		for (uint32_t level = 0; level < PrefilteredLevelCount; level++)
+			expectedSize += m_PrefilteredMap->GetLevelSize(level);
+
+		Utils::EnvironmentCacheHeader header = Utils::MakeCacheHeader(m_SourceHash, IrradianceMapSize, PrefilteredMapSize, PrefilteredLevelCount);
+
+		std::vector<Byte> data;
+		if (!Utils::ReadCacheFile(cachePath, header, expectedSize, data))
+			return false;
+
+		uint64_t offset = 0;
+		m_IrradianceMap->SetLevelData(0, data.data(), m_IrradianceMap->GetLevelSize(0));
+		offset += m_IrradianceMap->GetLevelSize(0);
+
+		for (uint32_t level = 0; level < PrefilteredLevelCount; level++)
+		{
+			m_PrefilteredMap->SetLevelData(level, data.data() + offset, m_PrefilteredMap->GetLevelSize(level));
+			offset += m_PrefilteredMap->GetLevelSize(level);
+		}
+
+		return true;
+	}
+
+	void Environment::WriteCache(const std::string& cachePath) const
+	{
+		AR_PROFILE_FUNCTION();
+
+		std::vector<Byte> data;
+		std::vector<Byte> levelData;
+
+		m_IrradianceMap->GetLevelData(0, levelData);
+		data.insert(data.end(), levelData.begin(), levelData.end());
+
+		for (uint32_t level = 0; level < PrefilteredLevelCount; level++)
+		{
+			m_PrefilteredMap->GetLevelData(level, levelData);
+			data.insert(data.end(), levelData.begin(), levelData.end());
+		}
+
+		Utils::WriteCacheFile(cachePath, Utils::MakeCacheHeader(m_SourceHash, IrradianceMapSize, PrefilteredMapSize, PrefilteredLevelCount), data);
+	}
+
+	void Environment::Bake()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("Environment::Bake");
+
+		if (!s_Data->IrradianceShader)
+		{
+			s_Data->IrradianceShader = Shader::Create("Resources/shaders/EnvironmentIrradiance.glsl");
+			s_Data->PrefilterShader = Shader::Create("Resources/shaders/EnvironmentPrefilter.glsl");
+		}
+
+		uint32_t radianceSize = m_RadianceMap->GetSize();
+		m_RadianceMap->Bind(0);
+
+		// One invocation per texel of every face, the z of the dispatch is the face
+		{
+			const Ref<Shader>& shader = s_Data->IrradianceShader;
+			shader->Bind();
+			shader->SetUniform("u_Uniforms.OutputSize", (int)IrradianceMapSize);
+			shader->SetUniform("u_Uniforms.SourceLevel", std::max(std::log2((float)radianceSize / Utils::IrradianceSourceSize), 0.0f));
+
+			m_IrradianceMap->BindImage(1, ImageAccess::WriteOnly);
+
+			const glm::uvec3& groupSize = shader->GetWorkGroupSize();
+			RenderCommand::DispatchCompute(RenderCommand::GetGroupCount(IrradianceMapSize, groupSize.x), RenderCommand::GetGroupCount(IrradianceMapSize, groupSize.y), CubeTexture::FaceCount);
+		}
+
+		{
+			const Ref<Shader>& shader = s_Data->PrefilterShader;
+			shader->Bind();
+			shader->SetUniform("u_Uniforms.SourceSize", (float)radianceSize);
+
+			for (uint32_t level = 0; level < PrefilteredLevelCount; level++)
+			{
+				uint32_t levelSize = std::max(PrefilteredMapSize >> level, 1u);
+				shader->SetUniform("u_Uniforms.OutputSize", (int)levelSize);
+				shader->SetUniform("u_Uniforms.Roughness", (float)level / (float)(PrefilteredLevelCount - 1));
+
+				m_PrefilteredMap->BindImage(1, ImageAccess::WriteOnly, level);
+
+				const glm::uvec3& groupSize = shader->GetWorkGroupSize();
+				RenderCommand::DispatchCompute(RenderCommand::GetGroupCount(levelSize, groupSize.x), RenderCommand::GetGroupCount(levelSize, groupSize.y), CubeTexture::FaceCount);
+			}
+		}
+
+		// Sampled by the shaders from now on and read back for the cache right after
+		RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::TextureFetch | MemoryBarrierFlags::TextureUpdate);
+	}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+/*
+ * Image based lighting for an environment cube map. Besides the radiance map itself (what the skybox draws) PBR shading needs:
+ *  - An irradiance map, the cosine weighted integral of the radiance over the hemisphere around every direction, for diffuse
+ *  - A prefiltered radiance map, the radiance convolved with the GGX lobe with one mip per roughness from 0 to 1, for specular
+ *  - The BRDF lookup table of the split sum approximation, the scale and bias to F0 indexed by N.V and roughness. It does not
+ *    depend on the environment so there is only one of it and all the environments share it
+ *
+ * All of them are computed by compute shaders the first time and then cached in GetCacheDirectory(). The environment maps are keyed
+ * by a hash of the contents of the face images, so after the first run loading an environment only decodes the faces and uploads
+ * the cached maps.
+ */
+
+#include "Core/Base.h"
+#include "Graphics/CubeTexture.h"
+
+#include <string>
+
+namespace Aurora {
+
+	class Environment : public RefCountedObject
+	{
+	public:
+		static constexpr uint32_t IrradianceMapSize = 32;
+		static constexpr uint32_t PrefilteredMapSize = 128;
+		static constexpr uint32_t PrefilteredLevelCount = 6; // Down to 4x4, the last level is roughness 1
+		static constexpr uint32_t BRDFLutSize = 256;
+
+		// Where Bind puts the maps, right after the sprite arrays of the quad batch. AuroraPBRStatic.glsl samples them from there, if
+		// the context has fewer combined texture units than that nothing is baked or bound and the maps stay black
+		static constexpr uint32_t IrradianceMapSlot = 24;
+		static constexpr uint32_t PrefilteredMapSlot = 25;
+		static constexpr uint32_t BRDFLutSlot = 26;
+
+	public:
+		Environment(const std::string& directory); // Same as the directory of a CubeTexture
+		virtual ~Environment() = default;
+
+		static Ref<Environment> Create(const std::string& directory);
+
+		// Called by Renderer3D, Init loads or bakes the BRDF lookup table
+		static void Init();
+		static void ShutDown();
+
+		static const char* GetCacheDirectory();
+
+		void Bind() const;
+
+		[[nodiscard]] inline const Ref<CubeTexture>& GetRadianceMap() const { return m_RadianceMap; }
+		[[nodiscard]] inline const Ref<CubeTexture>& GetIrradianceMap() const { return m_IrradianceMap; }
+		[[nodiscard]] inline const Ref<CubeTexture>& GetPrefilteredMap() const { return m_PrefilteredMap; }
+		[[nodiscard]] static uint32_t GetBRDFLutTextureID();
+
+		// Whether the context has the texture units for BRDFLutSlot, see above
+		[[nodiscard]] static bool IsSupported();
+
+		// False if the faces could not be loaded, the irradiance and prefiltered maps are black then
+		[[nodiscard]] inline bool IsLoaded() const { return m_RadianceMap->IsLoaded(); }
+
+	private:
+		bool ReadCache(const std::string& cachePath);
+		void WriteCache(const std::string& cachePath) const;
+		void Bake();
+
+	private:
+		Ref<CubeTexture> m_RadianceMap;
+		Ref<CubeTexture> m_IrradianceMap;
+		Ref<CubeTexture> m_PrefilteredMap;
+
+		uint64_t m_SourceHash = 0;
+
+	};
+
+}
@@ -0,0 +1,236 @@
+#include "Aurorapch.h"
+#include "HiZBuffer.h"
+
+#include "RenderCommand.h"
+
+#include <glad/glad.h>
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static constexpr uint32_t MaxReadbackWidth = 128;
+		static constexpr uint32_t MaxTestedTexels = 256; // Bigger screen rects are just considered visible
+
+		static uint32_t MipSize(uint32_t size, uint32_t level)
+		{
+			return std::max(size >> level, 1u);
+		}
+
+	}
+
+	HiZBuffer::HiZBuffer()
+	{
+		m_BuildShader = Shader::Create("Resources/shaders/HiZBuild.glsl");
+	}
+
+	HiZBuffer::~HiZBuffer()
+	{
+		Release();
+	}
+
+	Ref<HiZBuffer> HiZBuffer::Create()
+	{
+		return CreateRef<HiZBuffer>();
+	}
+
+	void HiZBuffer::Release()
+	{
+		if (m_ReadbackFence)
+			glDeleteSync((GLsync)m_ReadbackFence);
+
+		glDeleteTextures(1, &m_TextureID);
+		glDeleteBuffers(1, &m_ReadbackBufferID);
+
+		m_ReadbackFence = nullptr;
+		m_TextureID = 0;
+		m_ReadbackBufferID = 0;
+	}
+
+	void HiZBuffer::Resize(uint32_t width, uint32_t height)
+	{
+		AR_PROFILE_FUNCTION();
+
+		Release();
+
+		m_Width = width;
+		m_Height = height;
+		m_MipCount = 1 + (uint32_t)std::floor(std::log2((float)std::max(width, height)));
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
+		glTextureStorage2D(m_TextureID, m_MipCount, GL_R32F, width, height);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// The readback level is the first one that is small enough to be tested against cheaply on the CPU
+		m_ReadbackLevel = 0;
+		while (Utils::MipSize(width, m_ReadbackLevel) > Utils::MaxReadbackWidth && m_ReadbackLevel + 1 < m_MipCount)
+			m_ReadbackLevel++;
+
+		m_ReadbackWidth = Utils::MipSize(width, m_ReadbackLevel);
+		m_ReadbackHeight = Utils::MipSize(height, m_ReadbackLevel);
+
+		glCreateBuffers(1, &m_ReadbackBufferID);
+		glNamedBufferStorage(m_ReadbackBufferID, m_ReadbackWidth * m_ReadbackHeight * sizeof(float), nullptr, GL_MAP_READ_BIT);
+
+		// The old readback does not match the new size anymore
+		m_HasCPUData = false;
+	}
+
+	void HiZBuffer::Build(uint32_t depthTextureID, uint32_t width, uint32_t height, const glm::mat4& viewProjection)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("HiZBuffer::Build");
+
+		if (width == 0 || height == 0)
+			return;
+
+		PollReadback();
+
+		if (width != m_Width || height != m_Height)
+			Resize(width, height);
+
+		m_BuildShader->Bind();
+
+		for (uint32_t level = 0; level < m_MipCount; level++)
+		{
+			bool copyLevel = level == 0;
+			uint32_t inputLevel = copyLevel ? 0 : level - 1;
+
+			glm::ivec2 inputSize = { (int)Utils::MipSize(width, inputLevel), (int)Utils::MipSize(height, inputLevel) };
+			glm::ivec2 outputSize = { (int)Utils::MipSize(width, level), (int)Utils::MipSize(height, level) };
+
+			m_BuildShader->SetUniform("u_Uniforms.InputSize", inputSize);
+			m_BuildShader->SetUniform("u_Uniforms.OutputSize", outputSize);
+			m_BuildShader->SetUniform("u_Uniforms.InputLevel", (int)inputLevel);
+			m_BuildShader->SetUniform("u_Uniforms.CopyLevel", copyLevel ? 1 : 0);
+
+			// Reading level - 1 while writing level is fine since they never overlap
+			RenderCommand::BindTexture(0, copyLevel ? depthTextureID : m_TextureID);
+			RenderCommand::BindImageTexture(1, m_TextureID, level, ImageAccess::WriteOnly, ImageFormat::R32F);
+
+			const glm::uvec3& groupSize = m_BuildShader->GetWorkGroupSize();
+			RenderCommand::DispatchCompute(RenderCommand::GetGroupCount(outputSize.x, groupSize.x), RenderCommand::GetGroupCount(outputSize.y, groupSize.y));
+			RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::TextureFetch);
+		}
+
+		m_ViewProjection = viewProjection;
+
+		// Only one readback in flight, if the last one is not done yet this frame just does not get read back
+		if (!m_ReadbackFence)
+			StartReadback(viewProjection);
+	}
+
+	void HiZBuffer::StartReadback(const glm::mat4& viewProjection)
+	{
+		AR_PROFILE_FUNCTION();
+
+		RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::TextureUpdate | MemoryBarrierFlags::PixelBuffer);
+
+		// With a pack buffer bound the copy goes into the buffer and the call does not wait for the GPU
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_ReadbackBufferID);
+		glGetTextureImage(m_TextureID, m_ReadbackLevel, GL_RED, GL_FLOAT, m_ReadbackWidth * m_ReadbackHeight * sizeof(float), nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		m_ReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_PendingViewProjection = viewProjection;
+	}
+
+	void HiZBuffer::PollReadback()
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!m_ReadbackFence)
+			return;
+
+		GLenum result = glClientWaitSync((GLsync)m_ReadbackFence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+			return;
+
+		glDeleteSync((GLsync)m_ReadbackFence);
+		m_ReadbackFence = nullptr;
+
+		if (result == GL_WAIT_FAILED)
+		{
+			AR_CORE_WARN_TAG("HiZBuffer", "Waiting on the Hi-Z readback failed!");
+			return;
+		}
+
+		uint32_t texelCount = m_ReadbackWidth * m_ReadbackHeight;
+		const float* data = (const float*)glMapNamedBufferRange(m_ReadbackBufferID, 0, texelCount * sizeof(float), GL_MAP_READ_BIT);
+		if (!data)
+			return;
+
+		m_CPUDepth.assign(data, data + texelCount);
+		glUnmapNamedBuffer(m_ReadbackBufferID);
+
+		m_CPUWidth = m_ReadbackWidth;
+		m_CPUHeight = m_ReadbackHeight;
+		m_CPULevel = m_ReadbackLevel;
+		m_CPUBaseWidth = m_Width;
+		m_CPUBaseHeight = m_Height;
+		m_CPUViewProjection = m_PendingViewProjection;
+		m_HasCPUData = true;
+	}
+
+	bool HiZBuffer::IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform) const
+	{
+		if (!m_HasCPUData)
+			return false;
+
+		glm::mat4 mvp = m_CPUViewProjection * transform;
+
+		glm::vec2 ndcMin = glm::vec2(1.0f);
+		glm::vec2 ndcMax = glm::vec2(-1.0f);
+		float nearestDepth = 1.0f;
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			glm::vec3 corner = { i & 1 ? boundsMax.x : boundsMin.x, i & 2 ? boundsMax.y : boundsMin.y, i & 4 ? boundsMax.z : boundsMin.z };
+			glm::vec4 clip = mvp * glm::vec4(corner, 1.0f);
+
+			// Crosses the near plane, the camera might as well be inside of it
+			if (clip.w <= 0.0f)
+				return false;
+
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, glm::vec2(ndc));
+			ndcMax = glm::max(ndcMax, glm::vec2(ndc));
+			nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+		}
+
+		// Outside of the screen is not the business of occlusion culling
+		if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f)
+			return false;
+
+		ndcMin = glm::clamp(ndcMin, glm::vec2(-1.0f), glm::vec2(1.0f));
+		ndcMax = glm::clamp(ndcMax, glm::vec2(-1.0f), glm::vec2(1.0f));
+
+		// The rect is found on level 0 first, mip sizes are floored so scaling by the readback size would miss the last rows/columns
+		// Those are folded into the last texel of every level, which is where clamping the shifted rect puts them
+		uint32_t x0 = std::min((uint32_t)((ndcMin.x * 0.5f + 0.5f) * m_CPUBaseWidth), m_CPUBaseWidth - 1);
+		uint32_t y0 = std::min((uint32_t)((ndcMin.y * 0.5f + 0.5f) * m_CPUBaseHeight), m_CPUBaseHeight - 1);
+		uint32_t x1 = std::min((uint32_t)((ndcMax.x * 0.5f + 0.5f) * m_CPUBaseWidth), m_CPUBaseWidth - 1);
+		uint32_t y1 = std::min((uint32_t)((ndcMax.y * 0.5f + 0.5f) * m_CPUBaseHeight), m_CPUBaseHeight - 1);
+
+		x0 = std::min(x0 >> m_CPULevel, m_CPUWidth - 1);
+		y0 = std::min(y0 >> m_CPULevel, m_CPUHeight - 1);
+		x1 = std::min(x1 >> m_CPULevel, m_CPUWidth - 1);
+		y1 = std::min(y1 >> m_CPULevel, m_CPUHeight - 1);
+
+		if ((x1 - x0 + 1) * (y1 - y0 + 1) > Utils::MaxTestedTexels)
+			return false;
+
+		float farthestDepth = 0.0f;
+		for (uint32_t y = y0; y <= y1; y++)
+		{
+			for (uint32_t x = x0; x <= x1; x++)
+				farthestDepth = std::max(farthestDepth, m_CPUDepth[y * m_CPUWidth + x]);
+		}
+
+		return nearestDepth > farthestDepth;
+	}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/*
+ * Hierarchical-Z buffer used for occlusion culling. Every frame the depth of the rendered scene is reduced into a mip pyramid with
+ * a compute shader, where every texel of a level holds the FARTHEST depth of the 2x2 texels it covers in the level above. Something
+ * whose nearest depth is still behind the farthest depth of all the texels its screen rect covers can not be visible.
+ *
+ * The culling itself runs on the CPU before the draws are recorded, so one coarse level of the pyramid is read back every frame
+ * through a pixel buffer with a fence and only used once the GPU is done with it (no stalls). That means the test is done against
+ * the depth of a frame or two ago together with the view projection of that same frame, which is what makes fast camera moves or
+ * objects popping out from behind a wall show up one frame late. If there is no readback available yet nothing is culled.
+ */
+
+#include "Core/Base.h"
+#include "Graphics/Shader.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Aurora {
+
+	class HiZBuffer : public RefCountedObject
+	{
+	public:
+		HiZBuffer();
+		~HiZBuffer();
+
+		static Ref<HiZBuffer> Create();
+
+		// depthTextureID has to be a single sampled depth texture of size width x height that was rendered with viewProjection
+		void Build(uint32_t depthTextureID, uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+
+		// Bounds are in local space of the transform, returns false when there is not enough information to tell
+		bool IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform) const;
+
+		inline bool HasData() const { return m_HasCPUData; }
+
+		// The pyramid itself, for culling on the GPU, it holds the depth rendered with GetViewProjection
+		inline bool IsBuilt() const { return m_TextureID != 0; }
+		inline uint32_t GetTextureID() const { return m_TextureID; }
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+		inline uint32_t GetMipCount() const { return m_MipCount; }
+		inline const glm::mat4& GetViewProjection() const { return m_ViewProjection; }
+
+	private:
+		void Resize(uint32_t width, uint32_t height);
+		void Release();
+
+		void PollReadback();
+		void StartReadback(const glm::mat4& viewProjection);
+
+	private:
+		Ref<Shader> m_BuildShader;
+
+		uint32_t m_TextureID = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_MipCount = 0;
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+
+		// Pending GPU -> CPU copy of the readback level
+		uint32_t m_ReadbackBufferID = 0;
+		void* m_ReadbackFence = nullptr; // GLsync
+		uint32_t m_ReadbackLevel = 0;
+		uint32_t m_ReadbackWidth = 0;
+		uint32_t m_ReadbackHeight = 0;
+		glm::mat4 m_PendingViewProjection = glm::mat4(1.0f);
+
+		// Last readback that finished, this is what IsOccluded tests against
+		std::vector<float> m_CPUDepth;
+		uint32_t m_CPUWidth = 0;
+		uint32_t m_CPUHeight = 0;
+		uint32_t m_CPULevel = 0;
+		uint32_t m_CPUBaseWidth = 0;
+		uint32_t m_CPUBaseHeight = 0;
+		glm::mat4 m_CPUViewProjection = glm::mat4(1.0f);
+		bool m_HasCPUData = false;
+
+	};
+
+}
@@ -1,14 +1,153 @@
 #include "Aurorapch.h"
 #include "RenderCommand.h"
 
+#include "Graphics/Pipeline.h"
+
 #include <glad/glad.h>
 
 namespace Aurora {
 
 	RenderFlags RenderCommand::m_Flags;
 
+	static constexpr uint32_t s_UnknownState = ~0u;
+	static constexpr uint32_t s_MaxCachedTextureSlots = 32;
+	static constexpr uint32_t s_MaxCachedUniformBufferBindings = 16;
+	static constexpr uint32_t s_MaxCachedStorageBufferBindings = 16;
+
+	struct GLStateCache
+	{
+		uint32_t Program = s_UnknownState;
+		uint32_t VertexArray = s_UnknownState;
+		uint32_t TextureSlots[s_MaxCachedTextureSlots];
+		uint32_t UniformBuffers[s_MaxCachedUniformBufferBindings];
+		uint32_t StorageBuffers[s_MaxCachedStorageBufferBindings];
+
+		// Indexed by FeatureControl
+		uint32_t Features[5];
+
+		uint32_t DepthFunction = s_UnknownState;
+		uint32_t CullFace = s_UnknownState;
+		uint32_t BlendDstFactor = s_UnknownState;
+		uint32_t BlendEquation = s_UnknownState;
+		uint32_t PolygonMode = s_UnknownState;
+		uint32_t DepthWrite = s_UnknownState;
+		uint32_t ColorWrite = s_UnknownState;
+
+		// Hash of the last bound pipeline, any state change from outside a pipeline resets it
+		uint64_t PipelineHash = 0;
+
+		RenderCommand::StateCacheStatistics Stats;
+
+		GLStateCache() { Reset(); }
+
+		void Reset()
+		{
+			Program = s_UnknownState;
+			VertexArray = s_UnknownState;
+			std::fill(std::begin(TextureSlots), std::end(TextureSlots), s_UnknownState);
+			std::fill(std::begin(UniformBuffers), std::end(UniformBuffers), s_UnknownState);
+			std::fill(std::begin(StorageBuffers), std::end(StorageBuffers), s_UnknownState);
+			std::fill(std::begin(Features), std::end(Features), s_UnknownState);
+			DepthFunction = s_UnknownState;
+			CullFace = s_UnknownState;
+			BlendDstFactor = s_UnknownState;
+			BlendEquation = s_UnknownState;
+			PolygonMode = s_UnknownState;
+			DepthWrite = s_UnknownState;
+			ColorWrite = s_UnknownState;
+			PipelineHash = 0;
+		}
+
+		// Returns true if the GL call has to be issued and updates the cached value
+		bool Update(uint32_t& cached, uint32_t value)
+		{
+			if (cached == value)
+			{
+				Stats.Filtered++;
+				return false;
+			}
+
+			cached = value;
+			Stats.Issued++;
+			return true;
+		}
+
+		// Same as Update but for state that is part of a pipeline, changing it means the last bound pipeline is no longer current
+		bool UpdatePipelineState(uint32_t& cached, uint32_t value)
+		{
+			if (!Update(cached, value))
+				return false;
+
+			PipelineHash = 0;
+			return true;
+		}
+	};
+
+	static GLStateCache s_StateCache;
+
+	static uint32_t s_IndirectBufferID = 0;
+
 	namespace Utils {
 
+		static GLenum GLImageAccessFromAccess(ImageAccess access)
+		{
+			switch (access)
+			{
+			    case ImageAccess::ReadOnly:           return GL_READ_ONLY;
+			    case ImageAccess::WriteOnly:          return GL_WRITE_ONLY;
+			    case ImageAccess::ReadWrite:          return GL_READ_WRITE;
+			}
+
+			AR_CORE_ASSERT(false, "Unknown Image Access!");
+			return 0;
+		}
+
+		// Only the formats that image load/store supports, has to match the format qualifier in the shader
+		static GLenum GLImageFormatFromAFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+			    case ImageFormat::R8I:                return GL_R8I;
+			    case ImageFormat::R8UI:               return GL_R8UI;
+			    case ImageFormat::R16I:               return GL_R16I;
+			    case ImageFormat::R16UI:              return GL_R16UI;
+			    case ImageFormat::R32I:               return GL_R32I;
+			    case ImageFormat::R32UI:              return GL_R32UI;
+			    case ImageFormat::R32F:               return GL_R32F;
+			    case ImageFormat::RG8:                return GL_RG8;
+			    case ImageFormat::RG16F:              return GL_RG16F;
+			    case ImageFormat::RG32F:              return GL_RG32F;
+			    case ImageFormat::RGBA:               return GL_RGBA8;
+			    case ImageFormat::RGBA16F:            return GL_RGBA16F;
+			    case ImageFormat::RGBA32F:            return GL_RGBA32F;
+			}
+
+			AR_CORE_ASSERT(false, "Image format can not be used for image load/store!");
+			return 0;
+		}
+
+		static GLbitfield GLBarrierBitsFromFlags(MemoryBarrierFlags flags)
+		{
+			if (flags == MemoryBarrierFlags::All)
+				return GL_ALL_BARRIER_BITS;
+
+			uint32_t bits = (uint32_t)flags;
+			GLbitfield result = 0;
+			if (bits & (uint32_t)MemoryBarrierFlags::ShaderStorage)       result |= GL_SHADER_STORAGE_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::ShaderImageAccess)   result |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::TextureFetch)        result |= GL_TEXTURE_FETCH_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::Command)             result |= GL_COMMAND_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::VertexAttribute)     result |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::ElementArray)        result |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::UniformBuffer)       result |= GL_UNIFORM_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::TextureUpdate)       result |= GL_TEXTURE_UPDATE_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::BufferUpdate)        result |= GL_BUFFER_UPDATE_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::PixelBuffer)         result |= GL_PIXEL_BUFFER_BARRIER_BIT;
+			if (bits & (uint32_t)MemoryBarrierFlags::Framebuffer)         result |= GL_FRAMEBUFFER_BARRIER_BIT;
+
+			return result;
+		}
+
 		static GLenum GLTypeFromRenderFlags(RenderFlags flag)
 		{
 			switch (flag)
@@ -98,6 +237,9 @@ namespace Aurora {
 		
 		glEnable(GL_MULTISAMPLE);
 
+		// Filtering across cube map faces, without it the blurry mips of the environment maps show their seams
+		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
 		//glEnable(GL_FRAMEBUFFER_SRGB);
 		// This is the shit that was giving me a very dull look on the screen when i was reworking the texture API
 
@@ -108,41 +250,227 @@ namespace Aurora {
 		SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::OneMinusSrcAlpha);
 
 		m_Flags = RenderFlags::Fill;
+
+		glCreateBuffers(1, &s_IndirectBufferID);
+		glNamedBufferStorage(s_IndirectBufferID, MaxIndirectCommands * sizeof(DrawIndexedIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
 	}
 
 	void RenderCommand::ShutDown()
 	{
+		glDeleteBuffers(1, &s_IndirectBufferID);
+		s_IndirectBufferID = 0;
+	}
+
+	void RenderCommand::BindShader(uint32_t programID)
+	{
+		if (s_StateCache.UpdatePipelineState(s_StateCache.Program, programID))
+			glUseProgram(programID);
+	}
+
+	void RenderCommand::BindVertexArray(uint32_t vertexArrayID)
+	{
+		if (s_StateCache.Update(s_StateCache.VertexArray, vertexArrayID))
+			glBindVertexArray(vertexArrayID);
+	}
+
+	void RenderCommand::BindTexture(uint32_t slot, uint32_t textureID)
+	{
+		if (slot >= s_MaxCachedTextureSlots)
+		{
+			s_StateCache.Stats.Issued++;
+			glBindTextureUnit(slot, textureID);
+
+			return;
+		}
+
+		if (s_StateCache.Update(s_StateCache.TextureSlots[slot], textureID))
+			glBindTextureUnit(slot, textureID);
+	}
+
+	void RenderCommand::BindUniformBuffer(uint32_t binding, uint32_t bufferID)
+	{
+		if (binding >= s_MaxCachedUniformBufferBindings)
+		{
+			s_StateCache.Stats.Issued++;
+			glBindBufferBase(GL_UNIFORM_BUFFER, binding, bufferID);
+
+			return;
+		}
+
+		if (s_StateCache.Update(s_StateCache.UniformBuffers[binding], bufferID))
+			glBindBufferBase(GL_UNIFORM_BUFFER, binding, bufferID);
+	}
+
+	void RenderCommand::BindStorageBuffer(uint32_t binding, uint32_t bufferID)
+	{
+		if (binding >= s_MaxCachedStorageBufferBindings)
+		{
+			s_StateCache.Stats.Issued++;
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, bufferID);
+
+			return;
+		}
+
+		if (s_StateCache.Update(s_StateCache.StorageBuffers[binding], bufferID))
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, bufferID);
+	}
+
+	void RenderCommand::OnStorageBufferDeleted(uint32_t bufferID)
+	{
+		for (uint32_t& binding : s_StateCache.StorageBuffers)
+		{
+			if (binding == bufferID)
+				binding = s_UnknownState;
+		}
+	}
+
+	void RenderCommand::OnTextureDeleted(uint32_t textureID)
+	{
+		for (uint32_t& slot : s_StateCache.TextureSlots)
+		{
+			if (slot == textureID)
+				slot = s_UnknownState;
+		}
+	}
+
+	void RenderCommand::BindImageTexture(uint32_t unit, uint32_t textureID, uint32_t mipLevel, ImageAccess access, ImageFormat format, bool layered)
+	{
+		s_StateCache.Stats.Issued++;
+		glBindImageTexture(unit, textureID, mipLevel, layered ? GL_TRUE : GL_FALSE, 0, Utils::GLImageAccessFromAccess(access), Utils::GLImageFormatFromAFormat(format));
+	}
+
+	void RenderCommand::BindPipeline(const Pipeline& pipeline)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (s_StateCache.PipelineHash == pipeline.GetHash())
+		{
+			s_StateCache.Stats.Filtered++;
+			return;
+		}
+
+		// Everything goes through the state cache so only the state that differs from the current one gets issued
+		const PipelineSpecification& spec = pipeline.GetSpecification();
+		spec.Shader->Bind();
+
+		if (spec.DepthTest)
+		{
+			Enable(FeatureControl::DepthTesting);
+			SetFeatureControlFunction(FeatureControl::DepthTesting, spec.DepthFunction);
+		}
+		else
+			Disable(FeatureControl::DepthTesting);
+
+		SetDepthWrite(spec.DepthWrite);
+		SetColorWrite(spec.ColorWrite);
+
+		if (spec.Culling != CullMode::None)
+		{
+			Enable(FeatureControl::Culling);
+			SetFeatureControlFunction(FeatureControl::Culling, spec.Culling == CullMode::Front ? OpenGLFunction::Front : OpenGLFunction::Back);
+		}
+		else
+			Disable(FeatureControl::Culling);
+
+		if (spec.Blend)
+		{
+			Enable(FeatureControl::Blending);
+			SetFeatureControlFunction(FeatureControl::Blending, spec.BlendDstFunction);
+		}
+		else
+			Disable(FeatureControl::Blending);
+
+		// This does not go through SetRenderFlag since that would overwrite the mode the editor has set
+		GLenum mode = Utils::GLTypeFromRenderFlags(spec.PolygonMode != RenderFlags::None ? spec.PolygonMode : m_Flags);
+		if (s_StateCache.UpdatePipelineState(s_StateCache.PolygonMode, mode))
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
+
+		// Set last since any of the calls above that issued something reset it
+		s_StateCache.PipelineHash = pipeline.GetHash();
+	}
+
+	void RenderCommand::ResetStateCache()
+	{
+		s_StateCache.Reset();
+	}
+
+	void RenderCommand::ResetStateCacheStats()
+	{
+		s_StateCache.Stats = {};
+	}
+
+	const RenderCommand::StateCacheStatistics& RenderCommand::GetStateCacheStats()
+	{
+		return s_StateCache.Stats;
 	}
 
 	void RenderCommand::SetRenderFlag(RenderFlags flag)
 	{
 		m_Flags = flag;
-		glPolygonMode(GL_FRONT_AND_BACK, Utils::GLTypeFromRenderFlags(flag));
+		GLenum mode = Utils::GLTypeFromRenderFlags(flag);
+		if (s_StateCache.UpdatePipelineState(s_StateCache.PolygonMode, mode))
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
 	}
 
 	void RenderCommand::Enable(FeatureControl feature)
 	{
-		glEnable(Utils::GLFeatureFromFeatureControl(feature));
+		if (s_StateCache.UpdatePipelineState(s_StateCache.Features[(uint32_t)feature], GL_TRUE))
+			glEnable(Utils::GLFeatureFromFeatureControl(feature));
 	}
 
 	void RenderCommand::Disable(FeatureControl feature)
 	{
-		glDisable(Utils::GLFeatureFromFeatureControl(feature));
+		if (s_StateCache.UpdatePipelineState(s_StateCache.Features[(uint32_t)feature], GL_FALSE))
+			glDisable(Utils::GLFeatureFromFeatureControl(feature));
 	}
 
 	void RenderCommand::SetBlendFunctionEquation(OpenGLEquation equation)
 	{
-		glBlendEquation(Utils::GLEquationfromOpenGLEquation(equation));
+		GLenum glEquation = Utils::GLEquationfromOpenGLEquation(equation);
+		if (s_StateCache.UpdatePipelineState(s_StateCache.BlendEquation, glEquation))
+			glBlendEquation(glEquation);
+	}
+
+	void RenderCommand::SetDepthWrite(bool enabled)
+	{
+		if (s_StateCache.UpdatePipelineState(s_StateCache.DepthWrite, enabled ? GL_TRUE : GL_FALSE))
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
+	void RenderCommand::SetColorWrite(bool enabled)
+	{
+		GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+		if (s_StateCache.UpdatePipelineState(s_StateCache.ColorWrite, mask))
+			glColorMask(mask, mask, mask, mask);
 	}
 
 	void RenderCommand::SetFeatureControlFunction(FeatureControl feature, OpenGLFunction function)
 	{
+		GLenum glFunction = Utils::GLFunctionFromEnum(function);
 		switch (feature)
 		{
 		    case Aurora::FeatureControl::None:                  break;
-		    case Aurora::FeatureControl::DepthTesting:          glDepthFunc(Utils::GLFunctionFromEnum(function)); break;
-		    case Aurora::FeatureControl::Culling:               glCullFace(Utils::GLFunctionFromEnum(function)); break;
-		    case Aurora::FeatureControl::Blending:              glBlendFunc(GL_SRC_ALPHA, Utils::GLFunctionFromEnum(function)); break;
+		    case Aurora::FeatureControl::DepthTesting:
+			{
+				if (s_StateCache.UpdatePipelineState(s_StateCache.DepthFunction, glFunction))
+					glDepthFunc(glFunction);
+
+				break;
+			}
+		    case Aurora::FeatureControl::Culling:
+			{
+				if (s_StateCache.UpdatePipelineState(s_StateCache.CullFace, glFunction))
+					glCullFace(glFunction);
+
+				break;
+			}
+		    case Aurora::FeatureControl::Blending:
+			{
+				if (s_StateCache.UpdatePipelineState(s_StateCache.BlendDstFactor, glFunction))
+					glBlendFunc(GL_SRC_ALPHA, glFunction);
+
+				break;
+			}
 		    case Aurora::FeatureControl::StencilTesting:        AR_CORE_ASSERT(false); break;
 		}
 	}
@@ -154,6 +482,10 @@ namespace Aurora {
 
 	void RenderCommand::Clear()
 	{
+		// glClear respects the depth and color masks so a pipeline that disabled writes would stop the buffers from being cleared
+		SetDepthWrite(true);
+		SetColorWrite(true);
+
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 	}
 
@@ -171,4 +503,54 @@ namespace Aurora {
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
+	void RenderCommand::MultiDrawIndexedIndirect(uint32_t vertexArrayID, const DrawIndexedIndirectCommand* commands, uint32_t drawCount)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(drawCount <= MaxIndirectCommands, "Too many indirect commands!");
+
+		if (drawCount == 0)
+			return;
+
+		glNamedBufferSubData(s_IndirectBufferID, 0, drawCount * sizeof(DrawIndexedIndirectCommand), commands);
+
+		BindVertexArray(vertexArrayID);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectBufferID);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, drawCount, 0);
+	}
+
+	void RenderCommand::MultiDrawIndexedIndirect(uint32_t vertexArrayID, uint32_t indirectBufferID, uint32_t firstCommand, uint32_t drawCount)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (drawCount == 0)
+			return;
+
+		BindVertexArray(vertexArrayID);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBufferID);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)((uintptr_t)firstCommand * sizeof(DrawIndexedIndirectCommand)), drawCount, 0);
+	}
+
+	void RenderCommand::DispatchCompute(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+			return;
+
+		glDispatchCompute(groupsX, groupsY, groupsZ);
+	}
+
+	void RenderCommand::DispatchComputeIndirect(uint32_t indirectBufferID, uint32_t offset)
+	{
+		AR_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBufferID);
+		glDispatchComputeIndirect((GLintptr)offset);
+	}
+
+	void RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags flags)
+	{
+		glMemoryBarrier(Utils::GLBarrierBitsFromFlags(flags));
+	}
+
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 namespace Aurora {
 
+	class Pipeline;
+
 	enum class RenderFlags
 	{
 		None = 0,
@@ -65,12 +67,88 @@ namespace Aurora {
 		// Stencil has the same function types as depth testing so it is not necessary to specify more enums for it
 	};
 
+	// Same layout as the command glMultiDrawElementsIndirect reads
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	// Same layout as the command glDispatchComputeIndirect reads
+	struct DispatchIndirectCommand
+	{
+		uint32_t GroupsX;
+		uint32_t GroupsY;
+		uint32_t GroupsZ;
+	};
+
+	// What has to see the writes done by the shaders before the barrier, can be or'ed together
+	enum class MemoryBarrierFlags : uint32_t
+	{
+		None              = 0,
+		ShaderStorage     = BIT(0), // Storage buffer reads/writes
+		ShaderImageAccess = BIT(1), // imageLoad/imageStore
+		TextureFetch      = BIT(2), // Sampling the texture
+		Command           = BIT(3), // Indirect draw/dispatch arguments
+		VertexAttribute   = BIT(4),
+		ElementArray      = BIT(5),
+		UniformBuffer     = BIT(6),
+		TextureUpdate     = BIT(7), // glTextureSubImage, glGetTextureImage...
+		BufferUpdate      = BIT(8), // glNamedBufferSubData, mapping...
+		PixelBuffer       = BIT(9),
+		Framebuffer       = BIT(10),
+		All               = 0xFFFFFFFF
+	};
+
+	inline MemoryBarrierFlags operator|(MemoryBarrierFlags left, MemoryBarrierFlags right)
+	{
+		return (MemoryBarrierFlags)((uint32_t)left | (uint32_t)right);
+	}
+
+	/*
+	 * RenderCommand keeps a shadow copy of the GL state it is responsible for (bound program, VAO, texture units, uniform buffer
+	 * bindings, blend/depth/cull state and polygon mode) and skips the GL call if the requested state is already the current one.
+	 * Everything that binds these has to go through here otherwise the cache goes out of sync, code that still has to bind things
+	 * manually (mostly while creating resources) should call ResetStateCache after it is done.
+	 */
 	class RenderCommand
 	{
+	public:
+		struct StateCacheStatistics
+		{
+			uint32_t Issued = 0;
+			uint32_t Filtered = 0;
+		};
+
 	public:
 		static void Init();
 		static void ShutDown();
 
+		// Binding... These all skip the call if the object is already bound
+		static void BindShader(uint32_t programID);
+		static void BindVertexArray(uint32_t vertexArrayID);
+		static void BindTexture(uint32_t slot, uint32_t textureID);
+		static void BindUniformBuffer(uint32_t binding, uint32_t bufferID);
+		static void BindStorageBuffer(uint32_t binding, uint32_t bufferID);
+		// Deleting a buffer unbinds it and its ID can be handed out again, so the cache has to forget it
+		static void OnStorageBufferDeleted(uint32_t bufferID);
+		// Same for textures, cheaper than ResetStateCache when only one texture goes away
+		static void OnTextureDeleted(uint32_t textureID);
+		// Image units are not cached, these are only bound around dispatches anyway. layered binds every face/layer of the level (imageCube, image2DArray)
+		static void BindImageTexture(uint32_t unit, uint32_t textureID, uint32_t mipLevel, ImageAccess access, ImageFormat format, bool layered = false);
+
+		// Applies the state of the pipeline that differs from the current one, nothing at all if it is the last bound pipeline
+		static void BindPipeline(const Pipeline& pipeline);
+
+		// Marks all the tracked state as unknown so the next call of each issues the GL call again
+		static void ResetStateCache();
+
+		static void ResetStateCacheStats();
+		static const StateCacheStatistics& GetStateCacheStats();
+
 		static void SetRenderFlag(RenderFlags flag);
 		static RenderFlags GetRenderFlag() { return m_Flags; }
 
@@ -78,6 +156,8 @@ namespace Aurora {
 		static void Disable(FeatureControl feature);
 		static void SetFeatureControlFunction(FeatureControl feature, OpenGLFunction function);
 		static void SetBlendFunctionEquation(OpenGLEquation equation);
+		static void SetDepthWrite(bool enabled);
+		static void SetColorWrite(bool enabled); // All the color attachments, turned off for depth only passes
 
 		static void SetClearColor(const glm::vec4& color);
 		static void Clear();
@@ -86,6 +166,20 @@ namespace Aurora {
 
 		static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0);
 
+		// Uploads the commands to the internal indirect buffer and draws all of them with one call
+		static constexpr uint32_t MaxIndirectCommands = 4096;
+		static void MultiDrawIndexedIndirect(uint32_t vertexArrayID, const DrawIndexedIndirectCommand* commands, uint32_t drawCount);
+		// Reads the commands straight from a buffer that is already on the GPU (filled by a compute pass...)
+		static void MultiDrawIndexedIndirect(uint32_t vertexArrayID, uint32_t indirectBufferID, uint32_t firstCommand, uint32_t drawCount);
+
+		// Compute, the shader has to be bound before dispatching. Use GetGroupCount with the work group size the shader reflected
+		static void DispatchCompute(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1);
+		// Reads a DispatchIndirectCommand from the buffer at the offset (in bytes)
+		static void DispatchComputeIndirect(uint32_t indirectBufferID, uint32_t offset = 0);
+		static void InsertMemoryBarrier(MemoryBarrierFlags flags);
+
+		static uint32_t GetGroupCount(uint32_t invocations, uint32_t groupSize) { return (invocations + groupSize - 1) / groupSize; }
+
 	private:
 		static RenderFlags m_Flags;
 
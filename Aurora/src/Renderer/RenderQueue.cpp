@@ -0,0 +1,148 @@
+#include "Aurorapch.h"
+#include "RenderQueue.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace Aurora {
+
+	namespace Utils {
+
+		static constexpr uint32_t AlignDrawCommandSize(uint32_t size)
+		{
+			constexpr uint32_t alignment = alignof(std::max_align_t);
+
+			return (size + alignment - 1) & ~(alignment - 1);
+		}
+
+		static uint64_t FoldID(uint64_t id)
+		{
+			uint64_t folded = id ^ (id >> 12) ^ (id >> 24) ^ (id >> 36) ^ (id >> 48);
+
+			return folded & 0xfff;
+		}
+
+		// Positive floats compare the same as their bits, negative depths (behind the camera) are clamped to zero
+		static uint64_t QuantizeDepth(float viewDepth)
+		{
+			viewDepth = std::max(viewDepth, 0.0f);
+
+			uint32_t bits;
+			memcpy(&bits, &viewDepth, sizeof(float));
+
+			return (bits >> 8) & 0xffffff;
+		}
+
+	}
+
+	RenderQueue::RenderQueue()
+	{
+		AR_PROFILE_FUNCTION();
+
+		m_CommandBuffer = new uint8_t[CommandBufferSize]; // new is aligned to at least max_align_t
+		m_CommandBufferPtr = m_CommandBuffer;
+
+		m_Entries.reserve(4096);
+		m_SortScratch.reserve(4096);
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+		AR_PROFILE_FUNCTION();
+
+		AR_CORE_ASSERT(m_Entries.empty(), "Render queue destroyed with draws that were never executed!");
+
+		delete[] m_CommandBuffer;
+	}
+
+	uint64_t RenderQueue::MakeOpaqueKey(RenderLayer layer, uint64_t pipelineID, uint64_t materialID, uint64_t textureSetID, float viewDepth)
+	{
+		return ((uint64_t)layer << 60)
+			| (Utils::FoldID(pipelineID) << 48)
+			| (Utils::FoldID(materialID) << 36)
+			| (Utils::FoldID(textureSetID) << 24)
+			| Utils::QuantizeDepth(viewDepth);
+	}
+
+	uint64_t RenderQueue::MakeTransparentKey(RenderLayer layer, uint64_t pipelineID, uint64_t materialID, uint64_t textureSetID, float viewDepth)
+	{
+		// Inverted so that the furthest draw has the smallest key
+		uint64_t depth = 0xffffff - Utils::QuantizeDepth(viewDepth);
+
+		return ((uint64_t)layer << 60)
+			| (depth << 36)
+			| (Utils::FoldID(pipelineID) << 24)
+			| (Utils::FoldID(materialID) << 12)
+			| Utils::FoldID(textureSetID);
+	}
+
+	void* RenderQueue::Allocate(uint64_t key, DrawCommandFn function, uint32_t size)
+	{
+		uint32_t alignedSize = Utils::AlignDrawCommandSize(size);
+		AR_CORE_ASSERT((uint32_t)(m_CommandBufferPtr - m_CommandBuffer) + alignedSize <= CommandBufferSize, "Render queue overflow!");
+
+		void* memory = m_CommandBufferPtr;
+		m_CommandBufferPtr += alignedSize;
+
+		m_Entries.push_back({ key, function, memory });
+
+		return memory;
+	}
+
+	void RenderQueue::Execute()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("RenderQueue::Execute");
+
+		Sort();
+
+		for (Entry& entry : m_Entries)
+			entry.Function(entry.Memory);
+
+		m_Entries.clear();
+		m_CommandBufferPtr = m_CommandBuffer;
+	}
+
+	void RenderQueue::Sort()
+	{
+		AR_PROFILE_FUNCTION();
+
+		size_t count = m_Entries.size();
+		if (count < 2)
+			return;
+
+		m_SortScratch.resize(count);
+
+		// LSD radix sort, 8 passes of 8 bits. It is stable so draws with equal keys keep their submission order
+		Entry* source = m_Entries.data();
+		Entry* destination = m_SortScratch.data();
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			uint32_t histogram[256] = {};
+			for (size_t i = 0; i < count; i++)
+				histogram[(source[i].Key >> shift) & 0xff]++;
+
+			// Every key has the same byte here (the layer bits for example) so this pass would not move anything
+			if (histogram[(source[0].Key >> shift) & 0xff] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram)
+			{
+				uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				destination[histogram[(source[i].Key >> shift) & 0xff]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		// The result ended up in the scratch buffer
+		if (source != m_Entries.data())
+			m_Entries.swap(m_SortScratch);
+	}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * A per frame queue of draws that get sorted before they are executed.
+ * Every submission carries a 64 bit sort key and a lambda that does the actual draw, once the frame is recorded the keys are radix
+ * sorted and the lambdas executed in key order. The keys are packed so that the most significant bits are what is the most expensive
+ * to change:
+ *
+ *  Opaque:      [layer 4][pipeline 12][material 12][texture set 12][depth 24]  -> grouped by state, front to back within the state
+ *  Transparent: [layer 4][depth 24 (inverted)][pipeline 12][material 12][texture set 12]  -> back to front, correct blending first
+ *
+ * Pipeline, material and texture set IDs are whatever identifies them (hashes/renderer IDs) folded into 12 bits, a collision only
+ * means two states might not end up next to each other, it never breaks the ordering of layers or transparent depth.
+ * Depth is the view space distance, the bits of a positive float are already monotonic so the top 24 bits are used directly.
+ */
+
+#include "Core/Base.h"
+
+#include <vector>
+
+namespace Aurora {
+
+	// Executed in this order
+	enum class RenderLayer : uint8_t
+	{
+		Opaque = 0,
+		SkyBox, // After the opaque geometry so that the depth test rejects everything that is covered
+		Transparent,
+		Overlay // Editor stuff like camera icons
+	};
+
+	class RenderQueue
+	{
+	public:
+		typedef void(*DrawCommandFn)(void*);
+
+		static constexpr uint32_t CommandBufferSize = 2 * 1024 * 1024; // 2 MBs
+
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		static uint64_t MakeOpaqueKey(RenderLayer layer, uint64_t pipelineID, uint64_t materialID, uint64_t textureSetID, float viewDepth);
+		static uint64_t MakeTransparentKey(RenderLayer layer, uint64_t pipelineID, uint64_t materialID, uint64_t textureSetID, float viewDepth);
+
+		template<typename FuncT>
+		void Submit(uint64_t key, FuncT&& func)
+		{
+			using Function = std::decay_t<FuncT>;
+
+			auto drawCommand = [](void* ptr)
+			{
+				Function* function = (Function*)ptr;
+				(*function)();
+				function->~Function();
+			};
+
+			void* storage = Allocate(key, drawCommand, sizeof(Function));
+			new (storage) Function(std::forward<FuncT>(func));
+		}
+
+		// Sorts all the submitted draws by their key and executes them, the queue is empty afterwards
+		void Execute();
+
+		inline uint32_t GetCommandCount() const { return (uint32_t)m_Entries.size(); }
+
+	private:
+		struct Entry
+		{
+			uint64_t Key;
+			DrawCommandFn Function;
+			void* Memory;
+		};
+
+		void* Allocate(uint64_t key, DrawCommandFn function, uint32_t size);
+		void Sort();
+
+	private:
+		uint8_t* m_CommandBuffer;
+		uint8_t* m_CommandBufferPtr;
+
+		std::vector<Entry> m_Entries;
+		std::vector<Entry> m_SortScratch;
+
+	};
+
+}
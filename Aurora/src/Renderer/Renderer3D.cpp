@@ -5,6 +5,10 @@
 // Aurora Uses a clockwise orientation to determine the backfaces of each quad for back face culling
 
 #include "Core/Application.h"
+#include "Graphics/GeometryPool.h"
+#include "Graphics/Model.h"
+#include "Graphics/Pipeline.h"
+#include "Graphics/StorageBuffer.h"
 #include "Graphics/UniformBuffer.h"
 
 #include <glad/glad.h>
@@ -25,6 +29,7 @@ namespace Aurora {
 		glm::vec3 Normals;
 		glm::vec2 TexCoords;
 		float TextureIndex;
+		float TextureLayer; // -1 for the regular texture slots, otherwise TextureIndex is a sprite array
 		float TilingFactor;
 		int light;
 
@@ -32,6 +37,46 @@ namespace Aurora {
 		int EntityID = -1;
 	};
 
+	// Per draw data of the multi draw indirect mesh batch, has to match the std430 struct in StaticMesh.glsl
+	struct MeshDrawData
+	{
+		glm::mat4 Transform;
+		int EntityID;
+		int TextureIndex;
+		int Padding[2];
+	};
+
+	// One mesh of one model, these are grouped into instanced draws when the mesh batch is flushed
+	struct MeshInstance
+	{
+		uint64_t GroupKey; // Same mesh and same texture means same indirect command
+		uint32_t FirstIndex;
+		uint32_t IndexCount;
+		int32_t BaseVertex;
+		MeshDrawData DrawData;
+		glm::vec3 BoundsMin;
+		glm::vec3 BoundsMax;
+	};
+
+	// One flush of mesh draws that waits for the depth pre-pass, it keeps everything that is needed to draw it a second time
+	struct MeshPass
+	{
+		Ref<StorageBuffer> DrawDataBuffer;
+		uint32_t IndirectBufferID = 0; // Set for the GPU culled flushes, Commands is then only used for the count
+		std::vector<DrawIndexedIndirectCommand> Commands;
+		std::vector<uint32_t> Textures;
+	};
+
+	// Input of the GPU culling pass, has to match the std430 struct in MeshCull.glsl
+	struct MeshCullData
+	{
+		MeshDrawData DrawData;
+		glm::vec4 BoundsMin;
+		glm::vec4 BoundsMax;
+		uint32_t CommandIndex;
+		uint32_t Padding[3];
+	};
+
 	// So for my laptop, it can not hit 60 fps if the MaxQuads is more than 1.5k since that is alot of memory to be transfered in one go
 	// from the CPU to the GPU, even if you are only rendering like 15 quads it will not peak in fps since, again, the memory is too big!
 	// Therefore for lowerend laptops, it is better to keep the MaxQuads under the 1.5k mark.
@@ -48,10 +93,13 @@ namespace Aurora {
 		Ref<VertexBuffer> SkyBoxVertexBuffer;
 		Ref<Shader> SkyBoxShader;
 		Ref<Shader> MatShader;
+		Ref<Pipeline> SkyBoxPipeline;
 
 		Ref<VertexArray> QuadVertexArray;
 		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<IndexBuffer> QuadIndexBuffer; // Also shared by the quad chunks of the static batches
 		Ref<Shader> QuadShader;
+		Ref<Pipeline> QuadPipeline;
 		Ref<Texture2D> WhiteTex;
 
 		uint32_t QuadIndexCount = 0;
@@ -62,6 +110,9 @@ namespace Aurora {
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
 		uint32_t TextureSlotIndex = 1; // 0 is the white texture
 
+		// Sprite textures that fit are packed into texture arrays instead of taking up one of the slots above
+		Ref<SpritePacker> Sprites;
+
 		glm::vec4 QuadVertexPositions[24];
 		glm::vec3 QuadNormalPositions[24];
 
@@ -69,8 +120,62 @@ namespace Aurora {
 
 		glm::vec2 textureCoords[24];
 
+		// Static meshes, all of them come from the GeometryPool so they are drawn in one multi draw per batch and every mesh that
+		// shows up more than once in a batch becomes one instanced command
+		static const uint32_t MaxMeshInstances = GeometryPool::MaxDrawsPerBatch;
+
+		Ref<Shader> StaticMeshShader;
+		Ref<Pipeline> StaticMeshPipeline;
+
+		// With the depth pre-pass the mesh draws of the opaque scene are only recorded, the depth pipeline then draws all of them before
+		// the shading pipeline draws them again and only passes the fragments that are in front, see FlushOpaqueMeshes
+		Ref<Shader> StaticMeshDepthShader;
+		Ref<Pipeline> StaticMeshDepthPipeline;
+		Ref<Pipeline> StaticMeshPrePassedPipeline;
+		std::vector<MeshPass> MeshPasses;
+		bool DepthPrePass = false;
+
+		Ref<HiZBuffer> HiZ; // Only exists while occlusion culling is enabled
+
+		// GPU culling, the commands are uploaded with no instances and the culling pass fills in the ones that are visible
+		Ref<Shader> MeshCullShader;
+		Ref<StorageBuffer> MeshCullDataBuffer;
+		std::vector<MeshCullData> MeshCullDatas;
+		bool GPUCulling = false;
+
+		Ref<ClusteredLighting> Lighting;
+
+		// A flush that waits for the depth pre-pass can not have its buffers overwritten by the next one, so every flush of the scene
+		// gets its own set. Without the pre-pass the flushes are drawn right away and only the first set is ever used
+		std::vector<Ref<StorageBuffer>> MeshDrawDataBuffers;
+		std::vector<Ref<StorageBuffer>> MeshCommandBuffers;
+		uint32_t MeshFlushCount = 0;
+
+		std::vector<MeshInstance> MeshInstances;
+		std::vector<DrawIndexedIndirectCommand> MeshDrawCommands;
+		std::vector<MeshDrawData> MeshDrawDatas;
+
+		std::array<uint32_t, MaxTextureSlots> MeshTextureSlots;
+		uint32_t MeshTextureSlotIndex = 1; // 0 is the white texture
+
+		// The static batch that is being baked between BeginStaticBatch and EndStaticBatch
+		Ref<StaticBatch> StaticBatchTarget;
+		std::vector<QuadVertex> StaticQuadVertices;
+		std::vector<Ref<Texture2D>> StaticQuadTextures;
+		std::vector<MeshInstance> StaticMeshInstances;
+		std::vector<Ref<Texture2D>> StaticMeshTextures;
+		std::vector<uint32_t> StaticMeshTextureIDs; // Of the chunk being drawn, the textures can be reloaded with a new id
+
 		Renderer3D::Statistics Stats;
 
+		RenderQueue DrawQueue;
+		glm::vec3 CameraPosition = glm::vec3(0.0f);
+
+		// What the texture streaming needs to turn a world space size into pixels on screen
+		float ProjectionScale = 1.0f;
+		float ViewportHeight = 1.0f;
+		bool OrthographicView = false;
+
 		struct CameraData
 		{
 			glm::mat4 ViewProjection;
@@ -82,6 +187,110 @@ namespace Aurora {
 
 	static RendererData* s_Data;
 
+	namespace Utils {
+
+		static void WriteQuadVertices(QuadVertex* vertices, const glm::mat4& transform, const glm::vec4& color, float textureIndex, float tiling, int entityID)
+		{
+			glm::mat3 normalMat = glm::mat3(glm::transpose(glm::inverse(transform)));
+
+			for (uint32_t i = 0; i < s_Data->quadVertexCount; i++)
+			{
+				vertices[i].Position = transform * s_Data->QuadVertexPositions[i];
+				vertices[i].Color = color;
+				vertices[i].Normals = normalMat * s_Data->QuadNormalPositions[i];
+				vertices[i].TexCoords = s_Data->textureCoords[i];
+				vertices[i].TextureIndex = textureIndex;
+				vertices[i].TextureLayer = -1.0f;
+				vertices[i].TilingFactor = tiling;
+				vertices[i].light = 0;
+				vertices[i].EntityID = entityID;
+			}
+		}
+
+		// Only the diffuse texture is used by the static mesh shader, null means the mesh has none
+		static const TextureMesh* FindMeshDiffuseTexture(const Mesh& mesh)
+		{
+			for (const TextureMesh& texture : mesh.textures)
+			{
+				if (texture.type == "texture_diffuse")
+					return &texture;
+			}
+
+			return nullptr;
+		}
+
+		static void SetStreamingView(const glm::mat4& projection, uint32_t viewportHeight)
+		{
+			s_Data->ProjectionScale = projection[1][1];
+			s_Data->ViewportHeight = (float)std::max(viewportHeight, 1u);
+			s_Data->OrthographicView = projection[3][3] == 1.0f;
+		}
+
+		// Reports the mip the texture is going to be sampled at when something of worldSize is drawn at center, one texel per pixel
+		static void ReportTextureUsage(const Texture2D& texture, const glm::vec3& center, float worldSize, float tiling)
+		{
+			if (!texture.IsStreamed())
+				return;
+
+			float distance = s_Data->OrthographicView ? 1.0f : std::max(glm::distance(center, s_Data->CameraPosition), 0.001f);
+			float pixels = std::max(worldSize * s_Data->ProjectionScale * s_Data->ViewportHeight / (2.0f * distance), 1.0f);
+			float texels = (float)std::max(texture.GetWidth(), texture.GetHeight()) * std::max(tiling, 1.0f);
+
+			TextureStreamer::ReportUsage(texture, (uint32_t)std::max(std::log2(texels / pixels), 0.0f));
+		}
+
+		static void ReportQuadTextureUsage(const Texture2D& texture, const glm::mat4& transform, float tiling)
+		{
+			float worldSize = std::max(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])));
+
+			ReportTextureUsage(texture, glm::vec3(transform[3]), worldSize, tiling);
+		}
+
+		// Instances of the same mesh end up next to each other so that their draw data is contiguous, which is what lets them
+		// share one command: the draw index attribute starts at BaseInstance and advances once per instance
+		static void BuildMeshCommands(std::vector<MeshInstance>& instances, std::vector<DrawIndexedIndirectCommand>& commands, std::vector<MeshDrawData>& drawDatas)
+		{
+			std::sort(instances.begin(), instances.end(), [](const MeshInstance& a, const MeshInstance& b) { return a.GroupKey < b.GroupKey; });
+
+			for (uint32_t i = 0; i < (uint32_t)instances.size(); i++)
+			{
+				const MeshInstance& instance = instances[i];
+				drawDatas.push_back(instance.DrawData);
+
+				if (i > 0 && instances[i - 1].GroupKey == instance.GroupKey)
+				{
+					commands.back().InstanceCount++;
+					continue;
+				}
+
+				DrawIndexedIndirectCommand& command = commands.emplace_back();
+				command.IndexCount = instance.IndexCount;
+				command.InstanceCount = 1;
+				command.FirstIndex = instance.FirstIndex;
+				command.BaseVertex = instance.BaseVertex;
+				command.BaseInstance = i; // This is what the shader uses to find its MeshDrawData
+			}
+		}
+
+		static MeshInstance MakeMeshInstance(const Mesh& mesh, const glm::mat4& transform, int entityID, int textureIndex)
+		{
+			// The first index is unique per mesh in the pool, so it identifies the mesh
+			MeshInstance instance;
+			instance.GroupKey = ((uint64_t)mesh.Allocation.FirstIndex << 8) | (uint64_t)textureIndex;
+			instance.FirstIndex = mesh.Allocation.FirstIndex;
+			instance.IndexCount = mesh.Allocation.IndexCount;
+			instance.BaseVertex = (int32_t)mesh.Allocation.BaseVertex;
+			instance.DrawData.Transform = transform;
+			instance.DrawData.EntityID = entityID;
+			instance.DrawData.TextureIndex = textureIndex;
+			instance.BoundsMin = mesh.BoundsMin;
+			instance.BoundsMax = mesh.BoundsMax;
+
+			return instance;
+		}
+
+	}
+
 	void Renderer3D::Init()
 	{
 		AR_PROFILE_FUNCTION();
@@ -90,6 +299,7 @@ namespace Aurora {
 
 		RendererProperties::Init();
 		RenderCommand::Init();
+		GeometryPool::Init();
 
 		s_Data->QuadVertexPositions[0] =  { -0.5f, -0.5f, -0.5f, 1.0f };
 		s_Data->QuadVertexPositions[1] =  {  0.5f, -0.5f, -0.5f, 1.0f };
@@ -220,6 +430,7 @@ namespace Aurora {
 			{ ShaderDataType::Float3, "a_Normals"      },
 			{ ShaderDataType::Float2, "a_TexCoord"     },
 			{ ShaderDataType::Float,  "a_TexIndex"     },
+			{ ShaderDataType::Float,  "a_TexLayer"     },
 			{ ShaderDataType::Float,  "a_TilingFactor" },
 			{ ShaderDataType::Int,    "a_Light"        },
 			{ ShaderDataType::Int,    "a_EntityID"     }
@@ -228,9 +439,9 @@ namespace Aurora {
 
 		s_Data->QuadVertexBufferBase = new QuadVertex[s_Data->MaxVertices];
 
-		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, s_Data->MaxIndices);
-		s_Data->QuadVertexArray->SetIndexBuffer(quadIB);
-		s_Data->SkyBoxVertexArray->SetIndexBuffer(quadIB);
+		s_Data->QuadIndexBuffer = IndexBuffer::Create(quadIndices, s_Data->MaxIndices);
+		s_Data->QuadVertexArray->SetIndexBuffer(s_Data->QuadIndexBuffer);
+		s_Data->SkyBoxVertexArray->SetIndexBuffer(s_Data->QuadIndexBuffer);
 		delete[] quadIndices;
 
 		constexpr uint32_t whiteTextureData = 0xffffffff;
@@ -244,6 +455,20 @@ namespace Aurora {
 		s_Data->SkyBoxShader = Shader::Create("Resources/shaders/Skybox.glsl");
 		s_Data->QuadShader = Shader::Create("Resources/shaders/MainShader.glsl");
 
+		PipelineSpecification quadPipelineSpec;
+		quadPipelineSpec.DebugName = "QuadPipeline";
+		quadPipelineSpec.Shader = s_Data->QuadShader;
+		quadPipelineSpec.Layout = s_Data->QuadVertexBuffer->GetBufferLayout();
+		s_Data->QuadPipeline = Pipeline::Create(quadPipelineSpec);
+
+		PipelineSpecification skyBoxPipelineSpec;
+		skyBoxPipelineSpec.DebugName = "SkyBoxPipeline";
+		skyBoxPipelineSpec.Shader = s_Data->SkyBoxShader;
+		skyBoxPipelineSpec.Layout = s_Data->SkyBoxVertexBuffer->GetBufferLayout();
+		skyBoxPipelineSpec.DepthFunction = OpenGLFunction::LessOrEqual;
+		skyBoxPipelineSpec.PolygonMode = RenderFlags::Fill;
+		s_Data->SkyBoxPipeline = Pipeline::Create(skyBoxPipelineSpec);
+
 		s_Data->TextureSlots[0] = s_Data->WhiteTex; // index 0 is for the white texture.
 
 		s_Data->textureCoords[0] =  { 1.0f, 0.0f };
@@ -307,13 +532,59 @@ namespace Aurora {
 		s_Data->QuadNormalPositions[23] = { 0.0f,  1.0f,  0.0f };
 
 		s_Data->CameraUniformBuffer = UniformBuffer::Create(sizeof(RendererData::CameraData), 0);
+
+		s_Data->StaticMeshShader = Shader::Create("Resources/shaders/StaticMesh.glsl");
+
+		// The meshes use the vertex array of the GeometryPool so the layout is not needed here
+		PipelineSpecification staticMeshPipelineSpec;
+		staticMeshPipelineSpec.DebugName = "StaticMeshPipeline";
+		staticMeshPipelineSpec.Shader = s_Data->StaticMeshShader;
+		s_Data->StaticMeshPipeline = Pipeline::Create(staticMeshPipelineSpec);
+
+		staticMeshPipelineSpec.DepthFunction = OpenGLFunction::LessOrEqual;
+		staticMeshPipelineSpec.DepthWrite = false;
+		staticMeshPipelineSpec.DebugName = "StaticMeshPrePassedPipeline";
+		s_Data->StaticMeshPrePassedPipeline = Pipeline::Create(staticMeshPipelineSpec);
+
+		s_Data->StaticMeshDepthShader = Shader::Create("Resources/shaders/StaticMeshDepth.glsl");
+
+		PipelineSpecification depthPipelineSpec;
+		depthPipelineSpec.DebugName = "StaticMeshDepthPipeline";
+		depthPipelineSpec.Shader = s_Data->StaticMeshDepthShader;
+		depthPipelineSpec.ColorWrite = false;
+		depthPipelineSpec.Blend = false;
+		s_Data->StaticMeshDepthPipeline = Pipeline::Create(depthPipelineSpec);
+
+		s_Data->MeshDrawDataBuffers.push_back(StorageBuffer::Create(RendererData::MaxMeshInstances * sizeof(MeshDrawData), 2));
+		s_Data->MeshCommandBuffers.push_back(StorageBuffer::Create(RendererData::MaxMeshInstances * sizeof(DrawIndexedIndirectCommand), 4));
+		s_Data->MeshInstances.reserve(RendererData::MaxMeshInstances);
+		s_Data->MeshDrawCommands.reserve(RendererData::MaxMeshInstances);
+		s_Data->MeshDrawDatas.reserve(RendererData::MaxMeshInstances);
+
+		s_Data->MeshCullShader = Shader::Create("Resources/shaders/MeshCull.glsl");
+		s_Data->MeshCullDataBuffer = StorageBuffer::Create(RendererData::MaxMeshInstances * sizeof(MeshCullData), 3);
+		s_Data->MeshCullDatas.reserve(RendererData::MaxMeshInstances);
+		s_Data->MeshTextureSlots[0] = s_Data->WhiteTex->GetTextureID();
+
+		s_Data->Lighting = ClusteredLighting::Create();
+		s_Data->Sprites = SpritePacker::Create();
+
+		TextureStreamer::Init();
+		Environment::Init();
 	}
 
 	void Renderer3D::ShutDown()
 	{
+		Environment::ShutDown();
+		TextureStreamer::ShutDown();
+
 		delete[] s_Data->QuadVertexBufferBase;
 		delete s_Data;
 
+		Pipeline::ClearCache();
+		GeometryPool::ShutDown();
+		RenderCommand::ShutDown();
+
 		RendererProperties::ShutDown();
 	}
 
@@ -335,6 +606,13 @@ namespace Aurora {
 		s_Data->CameraBuffer.ViewProjection = camera.GetProjection() * glm::inverse(transform);
 		s_Data->CameraBuffer.SkyVP = skyview;
 		s_Data->CameraUniformBuffer->SetData(&(s_Data->CameraBuffer), sizeof(RendererData::CameraData));
+		s_Data->CameraPosition = glm::vec3(transform[3]);
+
+		bool perspective = camera.GetProjectionType() == SceneCamera::ProjectionType::Perspective;
+		float nearClip = perspective ? camera.GetPerspectiveNearClip() : camera.GetOrthographicNearClip();
+		float farClip = perspective ? camera.GetPerspectiveFarClip() : camera.GetOrthographicFarClip();
+		s_Data->Lighting->BeginFrame(glm::inverse(transform), camera.GetProjection(), nearClip, farClip);
+		Utils::SetStreamingView(camera.GetProjection(), camera.GetViewportHeight());
 
 		s_Data->QuadShader->Bind();
 
@@ -351,6 +629,10 @@ namespace Aurora {
 		s_Data->CameraBuffer.ViewProjection = camera.GetViewProjection();
 		s_Data->CameraBuffer.SkyVP = skyViewProj;
 		s_Data->CameraUniformBuffer->SetData(&(s_Data->CameraBuffer), sizeof(RendererData::CameraData));
+		s_Data->CameraPosition = camera.GetPosition();
+
+		s_Data->Lighting->BeginFrame(camera.GetViewMatrix(), camera.GetProjection(), camera.GetNearClip(), camera.GetFarClip());
+		Utils::SetStreamingView(camera.GetProjection(), camera.GetViewportHeight());
 
 		s_Data->QuadShader->Bind();
 		
@@ -359,7 +641,20 @@ namespace Aurora {
 
 	void Renderer3D::EndScene()
 	{
+		AR_PROFILE_FUNCTION();
+
+		// The clusters have to be filled before any of the lit draws in the queue run
+		s_Data->Lighting->Cull();
+		s_Data->Stats.LightCount += s_Data->Lighting->GetLightCount();
+
+		s_Data->DrawQueue.Execute();
+
 		Flush();
+		FlushOpaqueMeshes();
+
+		// Everything that was drawn reported its textures by now
+		TextureStreamer::Update();
+		s_Data->Sprites->CollectGarbage();
 	}
 
 	void Renderer3D::StartBatch()
@@ -385,7 +680,9 @@ namespace Aurora {
 			for (uint32_t i = 0; i < s_Data->TextureSlotIndex; i++)
 				s_Data->TextureSlots[i]->Bind(i);
 
-			s_Data->QuadShader->Bind();
+			s_Data->Sprites->BindArrays();
+
+			s_Data->QuadPipeline->Bind();
 			RenderCommand::DrawIndexed(s_Data->QuadVertexArray, s_Data->QuadIndexCount);
 
 			s_Data->Stats.DrawCalls++;
@@ -398,30 +695,654 @@ namespace Aurora {
 		StartBatch();
 	}
 
+	void Renderer3D::FlushMeshes()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("Renderer3D::FlushMeshes");
+
+		std::vector<MeshInstance>& instances = s_Data->MeshInstances;
+		if (instances.size())
+		{
+			Utils::BuildMeshCommands(instances, s_Data->MeshDrawCommands, s_Data->MeshDrawDatas);
+
+			uint32_t bufferIndex = s_Data->DepthPrePass ? s_Data->MeshFlushCount++ : 0;
+			if (bufferIndex == (uint32_t)s_Data->MeshDrawDataBuffers.size())
+			{
+				s_Data->MeshDrawDataBuffers.push_back(StorageBuffer::Create(RendererData::MaxMeshInstances * sizeof(MeshDrawData), 2));
+				s_Data->MeshCommandBuffers.push_back(StorageBuffer::Create(RendererData::MaxMeshInstances * sizeof(DrawIndexedIndirectCommand), 4));
+			}
+
+			// Static batches bind their own draw data to the same binding point
+			const Ref<StorageBuffer>& drawDataBuffer = s_Data->MeshDrawDataBuffers[bufferIndex];
+			drawDataBuffer->Bind();
+
+			uint32_t indirectBufferID = 0;
+			if (s_Data->GPUCulling)
+			{
+				CullMeshesGPU(s_Data->MeshCommandBuffers[bufferIndex]);
+				indirectBufferID = s_Data->MeshCommandBuffers[bufferIndex]->GetBufferID();
+			}
+			else
+			{
+				drawDataBuffer->SetData(s_Data->MeshDrawDatas.data(), (uint32_t)s_Data->MeshDrawDatas.size() * sizeof(MeshDrawData));
+			}
+
+			SubmitMeshPass(drawDataBuffer, s_Data->MeshDrawCommands, s_Data->MeshTextureSlots.data(), s_Data->MeshTextureSlotIndex, indirectBufferID);
+		}
+
+		instances.clear();
+		s_Data->MeshDrawCommands.clear();
+		s_Data->MeshDrawDatas.clear();
+		s_Data->MeshTextureSlotIndex = 1;
+	}
+
+	void Renderer3D::CullMeshesGPU(const Ref<StorageBuffer>& commandBuffer)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("Renderer3D::CullMeshesGPU");
+
+		// Instances are sorted by now, so the ones of a command are the InstanceCount entries starting at its BaseInstance
+		std::vector<DrawIndexedIndirectCommand>& commands = s_Data->MeshDrawCommands;
+		for (uint32_t commandIndex = 0; commandIndex < (uint32_t)commands.size(); commandIndex++)
+		{
+			DrawIndexedIndirectCommand& command = commands[commandIndex];
+			for (uint32_t i = command.BaseInstance; i < command.BaseInstance + command.InstanceCount; i++)
+			{
+				const MeshInstance& instance = s_Data->MeshInstances[i];
+
+				MeshCullData& cullData = s_Data->MeshCullDatas.emplace_back();
+				cullData.DrawData = instance.DrawData;
+				cullData.BoundsMin = glm::vec4(instance.BoundsMin, 1.0f);
+				cullData.BoundsMax = glm::vec4(instance.BoundsMax, 1.0f);
+				cullData.CommandIndex = commandIndex;
+			}
+
+			command.InstanceCount = 0;
+		}
+
+		uint32_t instanceCount = (uint32_t)s_Data->MeshCullDatas.size();
+		s_Data->MeshCullDataBuffer->SetData(s_Data->MeshCullDatas.data(), instanceCount * sizeof(MeshCullData));
+		commandBuffer->SetData(commands.data(), (uint32_t)commands.size() * sizeof(DrawIndexedIndirectCommand));
+		s_Data->MeshCullDataBuffer->Bind();
+		commandBuffer->Bind();
+
+		const Ref<HiZBuffer>& hiZ = s_Data->HiZ;
+		bool occlusionCulling = hiZ && hiZ->IsBuilt();
+
+		s_Data->MeshCullShader->Bind();
+		s_Data->MeshCullShader->SetUniform("u_Cull.InstanceCount", instanceCount);
+		s_Data->MeshCullShader->SetUniform("u_Cull.OcclusionCulling", occlusionCulling ? 1 : 0);
+		if (occlusionCulling)
+		{
+			s_Data->MeshCullShader->SetUniform("u_Cull.HiZViewProjection", hiZ->GetViewProjection());
+			s_Data->MeshCullShader->SetUniform("u_Cull.HiZSize", glm::ivec2{ (int)hiZ->GetWidth(), (int)hiZ->GetHeight() });
+			s_Data->MeshCullShader->SetUniform("u_Cull.HiZMipCount", (int)hiZ->GetMipCount());
+			RenderCommand::BindTexture(0, hiZ->GetTextureID());
+		}
+
+		RenderCommand::DispatchCompute(RenderCommand::GetGroupCount(instanceCount, s_Data->MeshCullShader->GetWorkGroupSize().x));
+		RenderCommand::InsertMemoryBarrier(MemoryBarrierFlags::Command | MemoryBarrierFlags::ShaderStorage);
+
+		s_Data->MeshCullDatas.clear();
+	}
+
+	void Renderer3D::SubmitMeshPass(const Ref<StorageBuffer>& drawDataBuffer, const std::vector<DrawIndexedIndirectCommand>& commands, const uint32_t* textures, uint32_t textureCount, uint32_t indirectBufferID)
+	{
+		s_Data->Stats.MeshDrawCommands += (uint32_t)commands.size();
+
+		if (s_Data->DepthPrePass)
+		{
+			MeshPass& pass = s_Data->MeshPasses.emplace_back();
+			pass.DrawDataBuffer = drawDataBuffer;
+			pass.IndirectBufferID = indirectBufferID;
+			pass.Commands = commands;
+			pass.Textures.assign(textures, textures + textureCount);
+
+			return;
+		}
+
+		drawDataBuffer->Bind();
+		for (uint32_t i = 0; i < textureCount; i++)
+			RenderCommand::BindTexture(i, textures[i]);
+
+		s_Data->StaticMeshPipeline->Bind();
+		DrawMeshCommands(commands, indirectBufferID);
+	}
+
+	void Renderer3D::FlushOpaqueMeshes()
+	{
+		AR_PROFILE_FUNCTION();
+
+		FlushMeshes();
+
+		std::vector<MeshPass>& passes = s_Data->MeshPasses;
+		if (passes.size())
+		{
+			AR_SCOPE_PERF("Renderer3D::DepthPrePass");
+
+			s_Data->StaticMeshDepthPipeline->Bind();
+			for (const MeshPass& pass : passes)
+			{
+				pass.DrawDataBuffer->Bind();
+				DrawMeshCommands(pass.Commands, pass.IndirectBufferID);
+			}
+
+			s_Data->StaticMeshPrePassedPipeline->Bind();
+			for (const MeshPass& pass : passes)
+			{
+				pass.DrawDataBuffer->Bind();
+				for (uint32_t i = 0; i < (uint32_t)pass.Textures.size(); i++)
+					RenderCommand::BindTexture(i, pass.Textures[i]);
+
+				DrawMeshCommands(pass.Commands, pass.IndirectBufferID);
+			}
+		}
+
+		passes.clear();
+		s_Data->MeshFlushCount = 0;
+	}
+
+	void Renderer3D::DrawMeshCommands(const std::vector<DrawIndexedIndirectCommand>& commands, uint32_t indirectBufferID)
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint32_t commandCount = (uint32_t)commands.size();
+		if (indirectBufferID)
+		{
+			RenderCommand::MultiDrawIndexedIndirect(GeometryPool::GetVertexArrayID(), indirectBufferID, 0, commandCount);
+			s_Data->Stats.DrawCalls++;
+
+			return;
+		}
+
+		for (uint32_t first = 0; first < commandCount; first += RenderCommand::MaxIndirectCommands)
+		{
+			uint32_t count = std::min(commandCount - first, RenderCommand::MaxIndirectCommands);
+			RenderCommand::MultiDrawIndexedIndirect(GeometryPool::GetVertexArrayID(), commands.data() + first, count);
+
+			s_Data->Stats.DrawCalls++;
+		}
+	}
+
 	void Renderer3D::DrawSkyBox(const Ref<CubeTexture>& skybox) // TODO: Temp...
 	{
-		RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::LessOrEqual);
-		s_Data->SkyBoxShader->Bind();
+		// Quads and meshes drawn before this have to hit the depth buffer first
+		if (s_Data->QuadIndexCount)
+			NextBatch();
+		FlushOpaqueMeshes();
+
+		s_Data->SkyBoxPipeline->Bind();
 		s_Data->SkyBoxShader->SetUniform("u_MatsUniforms.c", 0.3f);
 		s_Data->SkyBoxShader->SetUniform("u_MatsUniforms.d", 0.3f);
 		skybox->Bind();
 
-		auto flag = RenderCommand::GetRenderFlag();
-		RenderCommand::SetRenderFlag(RenderFlags::Fill);
 		RenderCommand::DrawIndexed(s_Data->SkyBoxVertexArray, 36);
-		RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Less);
-		RenderCommand::SetRenderFlag(flag);
 	}
 
 	// TODO: TEMPORARY!!!!!!!!
 	void Renderer3D::DrawMaterial(const glm::mat4& transform, const Ref<Material>& mat, const glm::vec4& tint)
 	{
+		if (s_Data->QuadIndexCount)
+			NextBatch();
+		FlushOpaqueMeshes();
+
+		float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+		for (const auto& [slot, texture] : mat->GetTexture2Ds())
+			Utils::ReportTextureUsage(*texture, glm::vec3(transform[3]), scale, 1.0f);
+
 		mat->Set("u_Renderer.transform", transform);
 		//mat->Set("u_Materials.AlbedoColor", tint);
+		GetMaterialPipeline(mat)->Bind();
 		mat->SetUpForRendering();
-		RenderCommand::SetFeatureControlFunction(FeatureControl::Culling, OpenGLFunction::Front);
 		RenderCommand::DrawIndexed(s_Data->SkyBoxVertexArray, 36);
-		RenderCommand::SetFeatureControlFunction(FeatureControl::Culling, OpenGLFunction::Back);
+	}
+
+	const Ref<Pipeline>& Renderer3D::GetMaterialPipeline(const Ref<Material>& material)
+	{
+		if (material->GetPipeline())
+			return material->GetPipeline();
+
+		AR_PROFILE_FUNCTION();
+
+		// Materials are drawn on the skybox cube, which faces inwards, so its front faces are the ones to cull
+		PipelineSpecification spec;
+		spec.Shader = material->GetShader();
+		spec.Layout = s_Data->SkyBoxVertexBuffer->GetBufferLayout();
+		spec.DepthTest = material->HasFlag(MaterialFlag::DepthTest);
+		spec.Blend = material->HasFlag(MaterialFlag::Blend);
+		spec.Culling = material->HasFlag(MaterialFlag::TwoSided) ? CullMode::None : CullMode::Front;
+
+		material->SetPipeline(Pipeline::Create(spec));
+
+		return material->GetPipeline();
+	}
+
+	void Renderer3D::DrawModel(const Model& model, const glm::mat4& transform, int entityID)
+	{
+		AR_PROFILE_FUNCTION();
+
+		for (const Mesh& mesh : model.meshes)
+		{
+			if (!mesh.Allocation.IsValid())
+				continue;
+
+			if (!s_Data->GPUCulling && s_Data->HiZ && s_Data->HiZ->IsOccluded(mesh.BoundsMin, mesh.BoundsMax, transform))
+			{
+				s_Data->Stats.OccludedMeshCount++;
+				continue;
+			}
+
+			if (s_Data->MeshInstances.size() >= RendererData::MaxMeshInstances)
+				FlushMeshes();
+
+			const TextureMesh* diffuse = Utils::FindMeshDiffuseTexture(mesh);
+			uint32_t textureID = diffuse ? diffuse->GetTextureID() : 0;
+
+			if (diffuse && diffuse->texture)
+			{
+				glm::vec3 center = transform * glm::vec4((mesh.BoundsMin + mesh.BoundsMax) * 0.5f, 1.0f);
+				float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+
+				Utils::ReportTextureUsage(*diffuse->texture, center, glm::distance(mesh.BoundsMin, mesh.BoundsMax) * scale, 1.0f);
+			}
+
+			int textureIndex = 0;
+			if (textureID)
+			{
+				for (uint32_t i = 1; i < s_Data->MeshTextureSlotIndex; i++)
+				{
+					if (s_Data->MeshTextureSlots[i] == textureID)
+					{
+						textureIndex = (int)i;
+						break;
+					}
+				}
+
+				if (textureIndex == 0)
+				{
+					if (s_Data->MeshTextureSlotIndex >= RendererData::MaxTextureSlots)
+						FlushMeshes();
+
+					textureIndex = (int)s_Data->MeshTextureSlotIndex;
+					s_Data->MeshTextureSlots[s_Data->MeshTextureSlotIndex++] = textureID;
+				}
+			}
+
+			s_Data->MeshInstances.push_back(Utils::MakeMeshInstance(mesh, transform, entityID, textureIndex));
+
+			s_Data->Stats.MeshCount++;
+		}
+	}
+
+	void Renderer3D::BeginStaticBatch(const Ref<StaticBatch>& batch)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(!s_Data->StaticBatchTarget, "Another static batch is already being built!");
+
+		batch->Clear();
+		s_Data->StaticBatchTarget = batch;
+
+		s_Data->StaticQuadVertices.clear();
+		s_Data->StaticQuadTextures.assign(1, s_Data->WhiteTex);
+		s_Data->StaticMeshInstances.clear();
+		s_Data->StaticMeshTextures.assign(1, s_Data->WhiteTex);
+	}
+
+	void Renderer3D::AddStaticQuad(const glm::mat4& transform, const glm::vec4& color, int entityID)
+	{
+		AddStaticQuad(transform, s_Data->WhiteTex, 1.0f, color, entityID);
+	}
+
+	void Renderer3D::AddStaticQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tiling, const glm::vec4& tintColor, int entityID)
+	{
+		AR_CORE_ASSERT(s_Data->StaticBatchTarget, "AddStaticQuad called outside of Begin/EndStaticBatch!");
+
+		std::vector<Ref<Texture2D>>& textures = s_Data->StaticQuadTextures;
+
+		float textureIndex = -1.0f;
+		for (uint32_t i = 0; i < (uint32_t)textures.size(); i++)
+		{
+			if (*(textures[i]) == *texture)
+			{
+				textureIndex = (float)i;
+				break;
+			}
+		}
+
+		// A chunk is one draw call so it is limited by the quad index buffer and the texture slots just like the dynamic batch
+		bool chunkFull = s_Data->StaticQuadVertices.size() >= RendererData::MaxVertices;
+		if (chunkFull || (textureIndex < 0.0f && textures.size() >= RendererData::MaxTextureSlots))
+		{
+			FinishStaticQuadChunk();
+			textureIndex = *texture == *(s_Data->WhiteTex) ? 0.0f : -1.0f;
+		}
+
+		if (textureIndex < 0.0f)
+		{
+			textureIndex = (float)textures.size();
+			textures.push_back(texture);
+		}
+
+		size_t offset = s_Data->StaticQuadVertices.size();
+		s_Data->StaticQuadVertices.resize(offset + s_Data->quadVertexCount);
+		Utils::WriteQuadVertices(s_Data->StaticQuadVertices.data() + offset, transform, tintColor, textureIndex, tiling, entityID);
+
+		s_Data->StaticBatchTarget->m_QuadCount++;
+	}
+
+	void Renderer3D::AddStaticModel(const Model& model, const glm::mat4& transform, int entityID)
+	{
+		AR_CORE_ASSERT(s_Data->StaticBatchTarget, "AddStaticModel called outside of Begin/EndStaticBatch!");
+
+		std::vector<Ref<Texture2D>>& textures = s_Data->StaticMeshTextures;
+
+		for (const Mesh& mesh : model.meshes)
+		{
+			if (!mesh.Allocation.IsValid())
+				continue;
+
+			if (s_Data->StaticMeshInstances.size() >= RendererData::MaxMeshInstances)
+				FinishStaticMeshChunk();
+
+			int textureIndex = 0;
+			const TextureMesh* diffuse = Utils::FindMeshDiffuseTexture(mesh);
+			if (diffuse && diffuse->texture)
+			{
+				auto it = std::find_if(textures.begin(), textures.end(), [diffuse](const Ref<Texture2D>& texture) { return texture.raw() == diffuse->texture.raw(); });
+				if (it == textures.end())
+				{
+					if (textures.size() >= RendererData::MaxTextureSlots)
+						FinishStaticMeshChunk();
+
+					textures.push_back(diffuse->texture);
+					it = textures.end() - 1;
+				}
+
+				textureIndex = (int)(it - textures.begin());
+			}
+
+			s_Data->StaticMeshInstances.push_back(Utils::MakeMeshInstance(mesh, transform, entityID, textureIndex));
+
+			s_Data->StaticBatchTarget->m_MeshCount++;
+		}
+	}
+
+	void Renderer3D::EndStaticBatch()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_CORE_ASSERT(s_Data->StaticBatchTarget, "EndStaticBatch called without BeginStaticBatch!");
+
+		FinishStaticQuadChunk();
+		FinishStaticMeshChunk();
+
+		AR_CORE_TRACE_TAG("Renderer3D", "Baked static batch: {0} quads in {1} chunks, {2} meshes in {3} chunks", s_Data->StaticBatchTarget->m_QuadCount,
+			s_Data->StaticBatchTarget->m_QuadChunks.size(), s_Data->StaticBatchTarget->m_MeshCount, s_Data->StaticBatchTarget->m_MeshChunks.size());
+
+		s_Data->StaticBatchTarget = nullptr;
+	}
+
+	void Renderer3D::FinishStaticQuadChunk()
+	{
+		std::vector<QuadVertex>& vertices = s_Data->StaticQuadVertices;
+		if (vertices.empty())
+			return;
+
+		StaticBatch::QuadChunk& chunk = s_Data->StaticBatchTarget->m_QuadChunks.emplace_back();
+
+		Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create((float*)vertices.data(), (uint32_t)(vertices.size() * sizeof(QuadVertex)), VertexBufferUsage::Static);
+		vertexBuffer->SetLayout(s_Data->QuadVertexBuffer->GetBufferLayout());
+
+		chunk.VertexArray = VertexArray::Create();
+		chunk.VertexArray->AddVertexBuffer(vertexBuffer);
+		chunk.VertexArray->SetIndexBuffer(s_Data->QuadIndexBuffer);
+		chunk.IndexCount = (uint32_t)(vertices.size() / s_Data->quadVertexCount) * 36;
+		chunk.Textures = s_Data->StaticQuadTextures;
+
+		vertices.clear();
+		s_Data->StaticQuadTextures.assign(1, s_Data->WhiteTex);
+	}
+
+	void Renderer3D::FinishStaticMeshChunk()
+	{
+		std::vector<MeshInstance>& instances = s_Data->StaticMeshInstances;
+		if (instances.empty())
+			return;
+
+		StaticBatch::MeshChunk& chunk = s_Data->StaticBatchTarget->m_MeshChunks.emplace_back();
+
+		std::vector<MeshDrawData> drawDatas;
+		drawDatas.reserve(instances.size());
+		Utils::BuildMeshCommands(instances, chunk.Commands, drawDatas);
+
+		chunk.DrawDataBuffer = StorageBuffer::Create((uint32_t)(drawDatas.size() * sizeof(MeshDrawData)), s_Data->MeshDrawDataBuffers[0]->GetBinding());
+		chunk.DrawDataBuffer->SetData(drawDatas.data(), (uint32_t)(drawDatas.size() * sizeof(MeshDrawData)));
+		chunk.Textures = s_Data->StaticMeshTextures;
+
+		instances.clear();
+		s_Data->StaticMeshTextures.assign(1, s_Data->WhiteTex);
+	}
+
+	void Renderer3D::DrawStaticBatch(const Ref<StaticBatch>& batch)
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("Renderer3D::DrawStaticBatch");
+
+		if (batch->m_QuadChunks.size())
+		{
+			s_Data->QuadPipeline->Bind();
+
+			for (const StaticBatch::QuadChunk& chunk : batch->m_QuadChunks)
+			{
+				// There are no per quad bounds left in a baked chunk, so its textures are kept at full resolution
+				for (uint32_t i = 0; i < (uint32_t)chunk.Textures.size(); i++)
+				{
+					chunk.Textures[i]->Bind(i);
+					TextureStreamer::ReportUsage(*chunk.Textures[i], 0);
+				}
+
+				RenderCommand::DrawIndexed(chunk.VertexArray, chunk.IndexCount);
+
+				s_Data->Stats.DrawCalls++;
+			}
+		}
+
+		if (batch->m_MeshChunks.size())
+		{
+			std::vector<uint32_t>& textureIDs = s_Data->StaticMeshTextureIDs;
+			for (const StaticBatch::MeshChunk& chunk : batch->m_MeshChunks)
+			{
+				// Same as the quad chunks, there are no bounds per mesh left to pick a level with
+				textureIDs.clear();
+				for (const Ref<Texture2D>& texture : chunk.Textures)
+				{
+					textureIDs.push_back(texture->GetTextureID());
+					TextureStreamer::ReportUsage(*texture, 0);
+				}
+
+				SubmitMeshPass(chunk.DrawDataBuffer, chunk.Commands, textureIDs.data(), (uint32_t)textureIDs.size());
+			}
+		}
+
+		s_Data->Stats.StaticQuadCount += batch->m_QuadCount;
+		s_Data->Stats.StaticMeshCount += batch->m_MeshCount;
+	}
+
+	void Renderer3D::OnTextureReloaded(const Texture2D& texture)
+	{
+		s_Data->Sprites->Remove(texture);
+	}
+
+	void Renderer3D::SetDepthPrePass(bool enabled)
+	{
+		s_Data->DepthPrePass = enabled;
+	}
+
+	bool Renderer3D::IsDepthPrePassEnabled()
+	{
+		return s_Data->DepthPrePass;
+	}
+
+	void Renderer3D::SetOcclusionCulling(bool enabled)
+	{
+		if (enabled == (bool)s_Data->HiZ)
+			return;
+
+		s_Data->HiZ = enabled ? HiZBuffer::Create() : nullptr;
+	}
+
+	bool Renderer3D::IsOcclusionCullingEnabled()
+	{
+		return s_Data->HiZ ? true : false;
+	}
+
+	void Renderer3D::UpdateOcclusion(const Ref<Framebuffer>& framebuffer)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!s_Data->HiZ)
+			return;
+
+		const FramebufferSpecification& spec = framebuffer->GetSpecification();
+		if (!spec.DepthAttachmentAsTexture || spec.Samples > 1 || !framebuffer->HasDepthAttachment())
+		{
+			AR_CORE_WARN_TAG("Renderer3D", "Occlusion culling needs a single sampled depth texture, disabling it");
+			s_Data->HiZ = nullptr;
+
+			return;
+		}
+
+		s_Data->HiZ->Build(framebuffer->GetDepthAttachmentID(), spec.Width, spec.Height, s_Data->CameraBuffer.ViewProjection);
+	}
+
+	void Renderer3D::SubmitPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius)
+	{
+		s_Data->Lighting->AddPointLight(position, color, intensity, radius);
+	}
+
+	void Renderer3D::SubmitSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, float intensity, float radius, float innerConeAngle, float outerConeAngle)
+	{
+		s_Data->Lighting->AddSpotLight(position, direction, color, intensity, radius, innerConeAngle, outerConeAngle);
+	}
+
+	void Renderer3D::SetGPUCulling(bool enabled)
+	{
+		s_Data->GPUCulling = enabled;
+	}
+
+	bool Renderer3D::IsGPUCullingEnabled()
+	{
+		return s_Data->GPUCulling;
+	}
+
+	void Renderer3D::SubmitStaticBatch(const Ref<StaticBatch>& batch)
+	{
+		if (batch->IsEmpty())
+			return;
+
+		// Depth 0 so that it is drawn before the other opaque draws of the same pipeline, static geometry is usually the big occluders
+		uint64_t key = RenderQueue::MakeOpaqueKey(RenderLayer::Opaque, s_Data->QuadPipeline->GetHash(), (uint64_t)batch.raw(), 0, 0.0f);
+		s_Data->DrawQueue.Submit(key, [batch]()
+		{
+			DrawStaticBatch(batch);
+		});
+	}
+
+	void Renderer3D::SubmitModel(const Model* model, const glm::mat4& transform, int entityID)
+	{
+		// Meshes only get recorded into the batch, they are all drawn together when the batch is flushed
+		uint64_t key = RenderQueue::MakeOpaqueKey(RenderLayer::Opaque, s_Data->StaticMeshPipeline->GetHash(), 0, 0, GetViewDepth(glm::vec3(transform[3])));
+		s_Data->DrawQueue.Submit(key, [model, transform, entityID]()
+		{
+			DrawModel(*model, transform, entityID);
+		});
+	}
+
+	void Renderer3D::SubmitSkyBox(const Ref<CubeTexture>& skybox)
+	{
+		uint64_t key = RenderQueue::MakeOpaqueKey(RenderLayer::SkyBox, s_Data->SkyBoxPipeline->GetHash(), 0, skybox->GetTextureID(), 0.0f);
+		s_Data->DrawQueue.Submit(key, [skybox]()
+		{
+			DrawSkyBox(skybox);
+		});
+	}
+
+	void Renderer3D::SubmitMaterial(const glm::mat4& transform, const Ref<Material>& mat, const glm::vec4& tint)
+	{
+		const Ref<Pipeline>& pipeline = GetMaterialPipeline(mat);
+
+		float depth = GetViewDepth(glm::vec3(transform[3]));
+		uint64_t key = RenderQueue::MakeOpaqueKey(RenderLayer::Opaque, pipeline->GetHash(), (uint64_t)mat.raw(), (uint64_t)mat.raw(), depth);
+		s_Data->DrawQueue.Submit(key, [transform, mat, tint]()
+		{
+			DrawMaterial(transform, mat, tint);
+		});
+	}
+
+	void Renderer3D::SubmitRotatedQuad(const glm::vec3& position, const glm::vec3& rotations, const glm::vec3& scale, const glm::vec4& color, int entityID)
+	{
+		uint64_t key = RenderQueue::MakeOpaqueKey(RenderLayer::Opaque, s_Data->QuadPipeline->GetHash(), 0, s_Data->WhiteTex->GetTextureID(), GetViewDepth(position));
+		s_Data->DrawQueue.Submit(key, [position, rotations, scale, color, entityID]()
+		{
+			DrawRotatedQuad(position, rotations, scale, color, 0, entityID);
+		});
+	}
+
+	void Renderer3D::SubmitRotatedQuad(const glm::vec3& position, const glm::vec3& rotations, const glm::vec3& scale, const Ref<Texture2D>& texture, float tiling, const glm::vec4& tintColor, int entityID, RenderLayer layer)
+	{
+		uint64_t pipelineID = s_Data->QuadPipeline->GetHash();
+		float depth = GetViewDepth(position);
+
+		// Anything that is not opaque is assumed to need blending so it is sorted back to front
+		uint64_t key = layer == RenderLayer::Opaque
+			? RenderQueue::MakeOpaqueKey(layer, pipelineID, 0, texture->GetTextureID(), depth)
+			: RenderQueue::MakeTransparentKey(layer, pipelineID, 0, texture->GetTextureID(), depth);
+
+		s_Data->DrawQueue.Submit(key, [position, rotations, scale, texture, tiling, tintColor, entityID]()
+		{
+			DrawRotatedQuad(position, rotations, scale, texture, tiling, tintColor, entityID);
+		});
+	}
+
+	RenderQueue& Renderer3D::GetRenderQueue()
+	{
+		return s_Data->DrawQueue;
+	}
+
+	float Renderer3D::GetViewDepth(const glm::vec3& position)
+	{
+		return glm::length(position - s_Data->CameraPosition);
+	}
+
+	float Renderer3D::GetQuadTextureIndex(const Ref<Texture2D>& texture, float& outLayer)
+	{
+		SpritePacker::PackedSprite sprite;
+		if (s_Data->Sprites->Pack(texture, sprite))
+		{
+			outLayer = (float)sprite.Layer;
+			return (float)sprite.ArrayIndex;
+		}
+
+		outLayer = -1.0f;
+
+		// So here we need to find the texture index of the passed index and check if it has already been used.
+		// If it the case where it has been used before, the index will be already found in the array and we just return the index
+		for (uint32_t i = 1; i < s_Data->TextureSlotIndex; i++)
+		{
+			if (*(s_Data->TextureSlots[i]) == *texture)
+				return (float)i;
+		}
+
+		// All the slots are taken, the quads so far go out with the textures they have
+		if (s_Data->TextureSlotIndex >= RendererData::MaxTextureSlots)
+			NextBatch();
+
+		// s_Data.TextureSlotIndex is the next available index in the sampler
+		// If the case happens that it has never been used before, here we just add that index to the array so that it can be used later.
+		float textureIndex = (float)s_Data->TextureSlotIndex;
+		s_Data->TextureSlots[s_Data->TextureSlotIndex] = texture;
+		s_Data->TextureSlotIndex++;
+
+		return textureIndex;
 	}
 
 	void Renderer3D::DrawQuad(const glm::vec3& position, const glm::vec3& scale, const glm::vec4& color, int light, int entityID)
@@ -447,6 +1368,7 @@ namespace Aurora {
 			s_Data->QuadVertexBufferPtr->Normals = normalMat * s_Data->QuadNormalPositions[i];
 			s_Data->QuadVertexBufferPtr->TexCoords = s_Data->textureCoords[i];
 			s_Data->QuadVertexBufferPtr->TextureIndex = whiteTexIndex;
+			s_Data->QuadVertexBufferPtr->TextureLayer = -1.0f;
 			s_Data->QuadVertexBufferPtr->TilingFactor = TilingFactor;
 			s_Data->QuadVertexBufferPtr->light = light;
 			s_Data->QuadVertexBufferPtr->EntityID = entityID;
@@ -467,34 +1389,18 @@ namespace Aurora {
 			NextBatch();
 
 		// textureIndex is the index that will be submitted in the VBO with everything and then passed on to the fragment shader so 
-		// that the shader knows which index from the sampler to sample from.
-
-		// So here we need to find the texture index of the passed index and check if it has already been used.
-		// If it the case where it has been used before, the index will be already found in the array and we just return the index
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data->TextureSlotIndex; i++)
-		{
-			if (*(s_Data->TextureSlots[i]) == *texture)
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
-
-		// s_Data.TextureSlotIndex is the next available index in the sampler
-		// If the case happens that it has never been used before, here we just add that index to the array so that it can be used later.
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = (float)s_Data->TextureSlotIndex;
-			s_Data->TextureSlots[s_Data->TextureSlotIndex] = texture;
-			s_Data->TextureSlotIndex++;
-		}
+		// that the shader knows which index from the sampler to sample from. For packed sprites it is the index of the texture array
+		// and textureLayer the layer inside of it, otherwise the layer is -1 and the index is a regular texture slot
+		float textureLayer;
+		float textureIndex = GetQuadTextureIndex(texture, textureLayer);
 
 		const int light = 0;
 
 		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
 			* glm::scale(glm::mat4(1.0f), scale);
 
+		Utils::ReportQuadTextureUsage(*texture, transform, tiling);
+
 		glm::mat3 normalMat = glm::mat3(glm::transpose(glm::inverse(transform)));
 
 		for (uint32_t i = 0; i < s_Data->quadVertexCount; i++)
@@ -504,6 +1410,7 @@ namespace Aurora {
 			s_Data->QuadVertexBufferPtr->Normals = normalMat * s_Data->QuadNormalPositions[i];
 			s_Data->QuadVertexBufferPtr->TexCoords = s_Data->textureCoords[i];
 			s_Data->QuadVertexBufferPtr->TextureIndex = textureIndex;
+			s_Data->QuadVertexBufferPtr->TextureLayer = textureLayer;
 			s_Data->QuadVertexBufferPtr->TilingFactor = tiling;
 			s_Data->QuadVertexBufferPtr->light = light;
 			s_Data->QuadVertexBufferPtr->EntityID = entityID;
@@ -538,6 +1445,7 @@ namespace Aurora {
 			s_Data->QuadVertexBufferPtr->Normals = normalMat * s_Data->QuadNormalPositions[i];
 			s_Data->QuadVertexBufferPtr->TexCoords = s_Data->textureCoords[i];
 			s_Data->QuadVertexBufferPtr->TextureIndex = whiteTexIndex;
+			s_Data->QuadVertexBufferPtr->TextureLayer = -1.0f;
 			s_Data->QuadVertexBufferPtr->TilingFactor = TilingFactor;
 			s_Data->QuadVertexBufferPtr->light = light;
 			s_Data->QuadVertexBufferPtr->EntityID = entityID;
@@ -557,28 +1465,16 @@ namespace Aurora {
 		if (s_Data->QuadIndexCount >= RendererData::MaxIndices)
 			NextBatch();
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data->TextureSlotIndex; i++)
-		{
-			if (*(s_Data->TextureSlots[i]) == *texture)
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = (float)s_Data->TextureSlotIndex;
-			s_Data->TextureSlots[s_Data->TextureSlotIndex] = texture;
-			s_Data->TextureSlotIndex++;
-		}
+		float textureLayer;
+		float textureIndex = GetQuadTextureIndex(texture, textureLayer);
 
 		const int light = 0;
 
 		glm::mat4 Rotation = glm::toMat4(glm::quat(rotations));
 		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * Rotation * glm::scale(glm::mat4(1.0f), scale);
 
+		Utils::ReportQuadTextureUsage(*texture, transform, tiling);
+
 		glm::mat3 normalMat = glm::mat3(glm::transpose(glm::inverse(transform)));
 
 		for (uint32_t i = 0; i < s_Data->quadVertexCount; i++)
@@ -588,6 +1484,7 @@ namespace Aurora {
 			s_Data->QuadVertexBufferPtr->Normals = normalMat * s_Data->QuadNormalPositions[i];
 			s_Data->QuadVertexBufferPtr->TexCoords = s_Data->textureCoords[i];
 			s_Data->QuadVertexBufferPtr->TextureIndex = textureIndex;
+			s_Data->QuadVertexBufferPtr->TextureLayer = textureLayer;
 			s_Data->QuadVertexBufferPtr->TilingFactor = tiling;
 			s_Data->QuadVertexBufferPtr->light = light;
 			s_Data->QuadVertexBufferPtr->EntityID = entityID;
@@ -603,10 +1500,24 @@ namespace Aurora {
 	{
 		s_Data->Stats.DrawCalls = 0;
 		s_Data->Stats.QuadCount = 0;
+		s_Data->Stats.MeshCount = 0;
+		s_Data->Stats.MeshDrawCommands = 0;
+		s_Data->Stats.StaticQuadCount = 0;
+		s_Data->Stats.StaticMeshCount = 0;
+		s_Data->Stats.OccludedMeshCount = 0;
+		s_Data->Stats.LightCount = 0;
+
+		RenderCommand::ResetStateCacheStats();
 	}
 
 	Renderer3D::Statistics& Renderer3D::GetStats()
 	{
+		const RenderCommand::StateCacheStatistics& stateStats = RenderCommand::GetStateCacheStats();
+		s_Data->Stats.StateChangesIssued = stateStats.Issued;
+		s_Data->Stats.StateChangesFiltered = stateStats.Filtered;
+		s_Data->Stats.PackedSpriteCount = s_Data->Sprites->GetSpriteCount();
+		s_Data->Stats.SpriteArrayCount = s_Data->Sprites->GetArrayCount();
+
 		return s_Data->Stats;
 	}
 
@@ -3,14 +3,22 @@
 #include "Editor/EditorCamera.h"
 #include "Scene/SceneCamera.h"
 
+#include "ClusteredLighting.h"
+#include "Environment.h"
+#include "HiZBuffer.h"
 #include "RenderCommand.h"
+#include "RenderQueue.h"
 #include "RendererPorperties.h"
+#include "SpritePacker.h"
+#include "StaticBatch.h"
+#include "TextureStreamer.h"
 
 #include "Graphics/VertexArray.h"
 #include "Graphics/Texture.h"
 #include "Graphics/CubeTexture.h"
 #include "Graphics/Shader.h"
 #include "Graphics/Material.h"
+#include "Graphics/Pipeline.h"
 
 /*
  * The way this batching works is that it batches all the elements in one VertexBuffer and submits it every frame. If the amount 
@@ -23,6 +31,8 @@
 
 namespace Aurora {
 
+	class Model;
+
 	class Renderer3D
 	{
 	public:
@@ -39,6 +49,65 @@ namespace Aurora {
 		static void DrawSkyBox(const Ref<CubeTexture>& skybox);
 		static void DrawMaterial(const glm::mat4& transform, const Ref<Material>& mat, const glm::vec4& tint);
 
+		// Records all the meshes of the model into the static mesh batch, which is drawn with one multi draw indirect call
+		static void DrawModel(const Model& model, const glm::mat4& transform, int entityID = -1);
+
+		// Static geometry, everything added between Begin and End is baked in world space into the batch's own buffers. The batch is
+		// then drawn every frame with DrawStaticBatch/SubmitStaticBatch without any per frame vertex work
+		static void BeginStaticBatch(const Ref<StaticBatch>& batch);
+		static void AddStaticQuad(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
+		static void AddStaticQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tiling = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+		static void AddStaticModel(const Model& model, const glm::mat4& transform, int entityID = -1);
+		static void EndStaticBatch();
+		static void DrawStaticBatch(const Ref<StaticBatch>& batch);
+
+		// Called by Texture2D::Reload, drops what the renderer copied out of the old contents of the texture
+		static void OnTextureReloaded(const Texture2D& texture);
+
+		// Lays down the depth of all the opaque meshes of the scene before shading any of them, so that the fragment shader only runs
+		// for the visible fragments. The meshes are then drawn when the opaque geometry ends (at the skybox or EndScene)
+		static void SetDepthPrePass(bool enabled);
+		static bool IsDepthPrePassEnabled();
+
+		// Dynamic meshes get tested against the Hi-Z buffer of an earlier frame and skipped if they are hidden, see HiZBuffer.h
+		static void SetOcclusionCulling(bool enabled);
+		static bool IsOcclusionCullingEnabled();
+		// Call after the frame is rendered, the framebuffer needs a single sampled depth texture attachment
+		static void UpdateOcclusion(const Ref<Framebuffer>& framebuffer);
+
+		// Frustum (and Hi-Z occlusion if that is enabled) culling of the dynamic meshes is done by a compute pass that writes the
+		// surviving instances straight into the indirect commands, nothing is culled on the CPU then
+		static void SetGPUCulling(bool enabled);
+		static bool IsGPUCullingEnabled();
+
+		// Lights for the current scene, they are binned into the clusters at EndScene and light the meshes, see ClusteredLighting.h
+		static void SubmitPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float radius);
+		// Cone angles are the half angles of the cone in degrees
+		static void SubmitSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, float intensity, float radius, float innerConeAngle, float outerConeAngle);
+
+		// Pipeline made from the material's flags, it is kept on the material until one of its flags changes
+		static const Ref<Pipeline>& GetMaterialPipeline(const Ref<Material>& material);
+
+		// Sorted submission, these are recorded into the render queue and drawn in sort key order when EndScene is called
+		static void SubmitSkyBox(const Ref<CubeTexture>& skybox);
+		static void SubmitStaticBatch(const Ref<StaticBatch>& batch);
+		// The model has to stay alive until EndScene
+		static void SubmitModel(const Model* model, const glm::mat4& transform, int entityID = -1);
+		static void SubmitMaterial(const glm::mat4& transform, const Ref<Material>& mat, const glm::vec4& tint);
+		static void SubmitRotatedQuad(const glm::vec3& position, const glm::vec3& rotations, const glm::vec3& scale, const glm::vec4& color, int entityID = -1);
+		static void SubmitRotatedQuad(const glm::vec3& position, const glm::vec3& rotations, const glm::vec3& scale, const Ref<Texture2D>& texture, float tiling = 10.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1, RenderLayer layer = RenderLayer::Opaque);
+
+		// For draws that are not one of the above, the key should be made with RenderQueue::Make...Key
+		template<typename FuncT>
+		static void Submit(uint64_t key, FuncT&& func)
+		{
+			GetRenderQueue().Submit(key, std::forward<FuncT>(func));
+		}
+
+		static RenderQueue& GetRenderQueue();
+		// Distance from the camera of the current scene, used as the depth part of the sort keys
+		static float GetViewDepth(const glm::vec3& position);
+
 		static void DrawQuad(const glm::vec3& position, const glm::vec3& scale, const glm::vec4& color, int light = 0, int entityID = -1);
 		static void DrawQuad(const glm::vec3& position, const glm::vec3& scale, const Ref<Texture2D>& texture, float tiling = 1.0f, const glm::vec4& tintcolor = glm::vec4(1.0f), int entityID = -1);
 
@@ -50,6 +119,20 @@ namespace Aurora {
 		{
 			uint32_t DrawCalls = 0;
 			uint32_t QuadCount = 0;
+			uint32_t MeshCount = 0;
+			uint32_t MeshDrawCommands = 0; // Less than the mesh count when meshes get instanced
+			uint32_t StaticQuadCount = 0;
+			uint32_t StaticMeshCount = 0;
+			uint32_t OccludedMeshCount = 0;
+			uint32_t LightCount = 0;
+
+			// Taken from the RenderCommand state cache when GetStats is called
+			uint32_t StateChangesIssued = 0;
+			uint32_t StateChangesFiltered = 0;
+
+			// Taken from the SpritePacker when GetStats is called
+			uint32_t PackedSpriteCount = 0;
+			uint32_t SpriteArrayCount = 0;
 
 			uint32_t GetTotalVertexCount() { return QuadCount * 24; }
 			uint32_t GetTotalIndexCount() { return QuadCount * 36; }
@@ -62,6 +145,18 @@ namespace Aurora {
 	private:
 		static void StartBatch();
 		static void NextBatch();
+		// Packs the texture into a sprite array or finds it a texture slot, outLayer is -1 when it ends up in a slot
+		static float GetQuadTextureIndex(const Ref<Texture2D>& texture, float& outLayer);
+		static void FlushMeshes();
+		// FlushMeshes and then draws the mesh passes that were waiting for the depth pre-pass
+		static void FlushOpaqueMeshes();
+		static void CullMeshesGPU(const Ref<StorageBuffer>& commandBuffer);
+		// Draws the commands right away, or keeps them until FlushOpaqueMeshes when the depth pre-pass is enabled
+		static void SubmitMeshPass(const Ref<StorageBuffer>& drawDataBuffer, const std::vector<DrawIndexedIndirectCommand>& commands, const uint32_t* textures, uint32_t textureCount, uint32_t indirectBufferID = 0);
+		// If indirectBufferID is not 0 the commands are read from that buffer instead, the vector is then only used for the count
+		static void DrawMeshCommands(const std::vector<DrawIndexedIndirectCommand>& commands, uint32_t indirectBufferID = 0);
+		static void FinishStaticQuadChunk();
+		static void FinishStaticMeshChunk();
 
 		static Ref<Texture2D> m_ContainerTexture;
 
@@ -0,0 +1,156 @@
+#include "Aurorapch.h"
+#include "SpritePacker.h"
+
+#include <glad/glad.h>
+
+namespace Aurora {
+
+	SpritePacker::SpritePacker()
+	{
+		GLint maxLayerCount = 0;
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayerCount);
+		m_MaxLayerCount = std::max((uint32_t)maxLayerCount, m_MaxLayerCount);
+
+		m_Arrays.reserve(MaxArrays);
+	}
+
+	Ref<SpritePacker> SpritePacker::Create()
+	{
+		return CreateRef<SpritePacker>();
+	}
+
+	bool SpritePacker::CanPack(const Texture2D& texture) const
+	{
+		if (!texture.GetTextureID() || texture.IsStreamed())
+			return false;
+
+		if (texture.GetWidth() > MaxSpriteSize || texture.GetHeight() > MaxSpriteSize)
+			return false;
+
+		switch (texture.GetFormat())
+		{
+			case ImageFormat::RGB:
+			case ImageFormat::RGBA:
+			case ImageFormat::SRGB:
+			case ImageFormat::RGBA16F:
+			case ImageFormat::RGBA32F:
+			case ImageFormat::BC1:
+			case ImageFormat::BC1SRGB:
+			case ImageFormat::BC3:
+			case ImageFormat::BC3SRGB:
+			case ImageFormat::BC7:
+			case ImageFormat::BC7SRGB:
+				return true;
+		}
+
+		return false;
+	}
+
+	bool SpritePacker::Pack(const Ref<Texture2D>& texture, PackedSprite& outSprite)
+	{
+		auto it = m_Sprites.find(texture.raw());
+		if (it != m_Sprites.end())
+		{
+			outSprite = it->second.Location;
+			return true;
+		}
+
+		if (!CanPack(*texture))
+			return false;
+
+		AR_PROFILE_FUNCTION();
+
+		TextureProperties& props = texture->GetTextureProperties();
+		ArrayKey key = { texture->GetFormat(), texture->GetWidth(), texture->GetHeight(), texture->GetLevelCount(), props.SamplerFilter, props.SamplerWrap, props.GenerateMips };
+
+		uint32_t arrayIndex = 0;
+		while (arrayIndex < (uint32_t)m_Arrays.size() && !(m_Arrays[arrayIndex].Key == key))
+			arrayIndex++;
+
+		if (arrayIndex == (uint32_t)m_Arrays.size())
+		{
+			if (m_Arrays.size() >= MaxArrays)
+				return false;
+
+			TextureProperties arrayProps;
+			arrayProps.DebugName = "SpriteArray";
+			arrayProps.SamplerFilter = key.Filter;
+			arrayProps.SamplerWrap = key.Wrap;
+			arrayProps.GenerateMips = key.Mipmapped;
+
+			SpriteArray& spriteArray = m_Arrays.emplace_back();
+			spriteArray.Key = key;
+			spriteArray.Array = Texture2DArray::Create(key.Format, key.Width, key.Height, key.LevelCount, std::min(InitialLayerCount, m_MaxLayerCount), arrayProps);
+		}
+
+		SpriteArray& spriteArray = m_Arrays[arrayIndex];
+
+		uint32_t layer;
+		if (spriteArray.FreeLayers.size())
+		{
+			layer = spriteArray.FreeLayers.back();
+			spriteArray.FreeLayers.pop_back();
+		}
+		else
+		{
+			uint32_t layerCount = spriteArray.Array->GetLayerCount();
+			if (spriteArray.UsedLayers == layerCount)
+			{
+				if (layerCount >= m_MaxLayerCount)
+					return false;
+
+				// The layers that are already handed out keep their index, only the texture id of the array changes
+				spriteArray.Array->Resize(std::min(layerCount * 2, m_MaxLayerCount));
+			}
+
+			layer = spriteArray.UsedLayers++;
+		}
+
+		spriteArray.Array->CopyLayer(layer, *texture);
+
+		Sprite& sprite = m_Sprites[texture.raw()];
+		sprite.Texture = texture;
+		sprite.Location = { arrayIndex, layer };
+
+		outSprite = sprite.Location;
+		return true;
+	}
+
+	void SpritePacker::CollectGarbage()
+	{
+		AR_PROFILE_FUNCTION();
+
+		for (auto it = m_Sprites.begin(); it != m_Sprites.end();)
+		{
+			if (it->second.Texture->GetRefCount() > 1)
+			{
+				++it;
+				continue;
+			}
+
+			const PackedSprite& location = it->second.Location;
+			m_Arrays[location.ArrayIndex].FreeLayers.push_back(location.Layer);
+
+			it = m_Sprites.erase(it);
+		}
+	}
+
+	void SpritePacker::Remove(const Texture2D& texture)
+	{
+		auto it = m_Sprites.find(&texture);
+		if (it == m_Sprites.end())
+			return;
+
+		const PackedSprite& location = it->second.Location;
+		m_Arrays[location.ArrayIndex].FreeLayers.push_back(location.Layer);
+
+		m_Sprites.erase(it);
+	}
+
+	void SpritePacker::BindArrays() const
+	{
+		for (uint32_t i = 0; i < (uint32_t)m_Arrays.size(); i++)
+			m_Arrays[i].Array->Bind(FirstArraySlot + i);
+	}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+ * Packs the textures of the sprites (textured quads) into texture arrays so that the quad batch does not have to break every time
+ * it runs out of its 16 texture slots. Textures with the same format, size, mip count and sampler settings share one
+ * Texture2DArray and every texture gets a layer of it, the quad vertices then carry the array index and the layer instead of a
+ * texture slot. With MaxArrays arrays bound next to the regular slots, any number of sprite textures fits in one draw as long as
+ * they come in a handful of different sizes, which sprite sheets and UI textures usually do.
+ *
+ * Texture arrays were picked over a rectangle packed atlas since every layer still wraps on its own (the tiling factor keeps
+ * working) and the mips of one sprite never bleed into the next.
+ *
+ * A texture is copied into its layer on the GPU the first time it is drawn. The packer keeps a reference to every packed texture,
+ * CollectGarbage gives the layer back once the packer is the only one left holding it. A reloaded texture is removed through
+ * Renderer3D::OnTextureReloaded and copied again from its new contents the next time it is drawn. Textures that are streamed (their mips come
+ * and go), too big or in a format the arrays do not take are not packed and go through the regular texture slots.
+ */
+
+#include "Core/Base.h"
+#include "Graphics/Texture.h"
+#include "Graphics/TextureArray.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Aurora {
+
+	class SpritePacker : public RefCountedObject
+	{
+	public:
+		static constexpr uint32_t MaxArrays = 8; // Has to match the size of u_TextureArrays in MainShader.glsl
+		static constexpr uint32_t FirstArraySlot = 16; // The arrays are bound right after the regular texture slots of the batch
+		static constexpr uint32_t MaxSpriteSize = 1024;
+		static constexpr uint32_t InitialLayerCount = 16;
+
+		struct PackedSprite
+		{
+			uint32_t ArrayIndex = 0;
+			uint32_t Layer = 0;
+		};
+
+	public:
+		SpritePacker();
+		~SpritePacker() = default;
+
+		static Ref<SpritePacker> Create();
+
+		// Finds or makes the layer of the texture, returns false if the texture can not be packed
+		bool Pack(const Ref<Texture2D>& texture, PackedSprite& outSprite);
+
+		// Frees the layers of the textures that nothing but the packer holds on to anymore
+		void CollectGarbage();
+		// Frees the layer of the texture if it is packed
+		void Remove(const Texture2D& texture);
+
+		// Binds array i to texture slot FirstArraySlot + i
+		void BindArrays() const;
+
+		inline uint32_t GetSpriteCount() const { return (uint32_t)m_Sprites.size(); }
+		inline uint32_t GetArrayCount() const { return (uint32_t)m_Arrays.size(); }
+
+	private:
+		bool CanPack(const Texture2D& texture) const;
+
+	private:
+		struct ArrayKey
+		{
+			ImageFormat Format;
+			uint32_t Width;
+			uint32_t Height;
+			uint32_t LevelCount;
+			TextureFilter Filter;
+			TextureWrap Wrap;
+			bool Mipmapped;
+
+			bool operator==(const ArrayKey& other) const
+			{
+				return Format == other.Format && Width == other.Width && Height == other.Height && LevelCount == other.LevelCount
+					&& Filter == other.Filter && Wrap == other.Wrap && Mipmapped == other.Mipmapped;
+			}
+		};
+
+		struct SpriteArray
+		{
+			ArrayKey Key;
+			Ref<Texture2DArray> Array;
+			uint32_t UsedLayers = 0; // Layers past this were never handed out
+			std::vector<uint32_t> FreeLayers;
+		};
+
+		struct Sprite
+		{
+			Ref<Texture2D> Texture;
+			PackedSprite Location;
+		};
+
+		std::vector<SpriteArray> m_Arrays;
+		std::unordered_map<const Texture2D*, Sprite> m_Sprites;
+		uint32_t m_MaxLayerCount = 256; // GL_MAX_ARRAY_TEXTURE_LAYERS, 256 is the least GL 4.5 guarantees
+
+	};
+
+}
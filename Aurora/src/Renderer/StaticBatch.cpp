@@ -0,0 +1,20 @@
+#include "Aurorapch.h"
+#include "StaticBatch.h"
+
+namespace Aurora {
+
+	Ref<StaticBatch> StaticBatch::Create()
+	{
+		return CreateRef<StaticBatch>();
+	}
+
+	void StaticBatch::Clear()
+	{
+		m_QuadChunks.clear();
+		m_MeshChunks.clear();
+
+		m_QuadCount = 0;
+		m_MeshCount = 0;
+	}
+
+}
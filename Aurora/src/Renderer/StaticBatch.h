@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * Geometry of entities that never move, baked once into its own GPU buffers and then drawn every frame without touching any of the
+ * vertex data on the CPU again. It is filled through Renderer3D::BeginStaticBatch/AddStatic.../EndStaticBatch since the vertex
+ * generation is the same as the dynamic batch, and drawn with Renderer3D::SubmitStaticBatch.
+ *
+ * Quads are baked in world space into chunks, every chunk is one vertex buffer that shares the renderer's quad index buffer and has
+ * its own set of textures, so a chunk is one draw call. Meshes are baked into the same per draw data that the dynamic mesh batch
+ * uses (instanced indirect commands + a storage buffer) except that it is uploaded only once.
+ *
+ * Whoever owns the batch is responsible for rebuilding it when the static entities or their models change, see
+ * Scene::MarkStaticGeometryDirty. The textures are held by reference and bound by their current id, so reloading them is fine.
+ */
+
+#include "Core/Base.h"
+#include "Graphics/StorageBuffer.h"
+#include "Graphics/Texture.h"
+#include "Graphics/VertexArray.h"
+#include "RenderCommand.h"
+
+#include <vector>
+
+namespace Aurora {
+
+	class StaticBatch : public RefCountedObject
+	{
+	public:
+		StaticBatch() = default;
+		~StaticBatch() = default;
+
+		static Ref<StaticBatch> Create();
+
+		void Clear();
+
+		inline bool IsEmpty() const { return m_QuadChunks.empty() && m_MeshChunks.empty(); }
+		inline uint32_t GetQuadCount() const { return m_QuadCount; }
+		inline uint32_t GetMeshCount() const { return m_MeshCount; }
+
+	private:
+		struct QuadChunk
+		{
+			Ref<VertexArray> VertexArray;
+			uint32_t IndexCount = 0;
+			std::vector<Ref<Texture2D>> Textures; // Index 0 is the white texture
+		};
+
+		struct MeshChunk
+		{
+			Ref<StorageBuffer> DrawDataBuffer;
+			std::vector<DrawIndexedIndirectCommand> Commands;
+			std::vector<Ref<Texture2D>> Textures; // Index 0 is the white texture
+		};
+
+		std::vector<QuadChunk> m_QuadChunks;
+		std::vector<MeshChunk> m_MeshChunks;
+
+		uint32_t m_QuadCount = 0;
+		uint32_t m_MeshCount = 0;
+
+		friend class Renderer3D;
+
+	};
+
+}
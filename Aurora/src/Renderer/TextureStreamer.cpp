@@ -0,0 +1,327 @@
+#include "Aurorapch.h"
+#include "TextureStreamer.h"
+
+#include "Core/JobSystem.h"
+#include "Graphics/Texture.h"
+#include "Graphics/TextureFile.h"
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace Aurora {
+
+	struct StreamedTexture
+	{
+		Texture2D* Texture = nullptr;
+		std::string Name;
+		TextureFileInfo Info;
+
+		uint32_t PinnedLevel = 0;
+		uint32_t DesiredLevel = 0;
+		uint32_t ReportedLevel = ~0u; // Lowest level reported since the last Update
+		uint64_t LastUsedFrame = 0;
+
+		bool Loading = false;
+		bool Broken = false; // A level failed to load, the texture stays at what it has
+	};
+
+	// Written by the workers, picked up by Update on the main thread
+	struct StreamedLevel
+	{
+		uint64_t StreamID;
+		uint32_t Level;
+		uint64_t Size;
+		std::vector<Byte> Data;
+		bool Loaded;
+	};
+
+	struct TextureStreamerData
+	{
+		std::unordered_map<uint64_t, StreamedTexture> Textures;
+		uint64_t NextStreamID = 1; // 0 means the texture is not streamed
+
+		uint64_t Budget = TextureStreamer::DefaultBudget;
+		uint64_t ResidentBytes = 0;
+		uint64_t PendingBytes = 0;
+		uint32_t PendingLoads = 0;
+		uint64_t FrameIndex = 0;
+
+		std::mutex LoadedLevelsMutex;
+		std::vector<StreamedLevel> LoadedLevels;
+		JobCounter LoadCounter;
+
+		TextureStreamer::Statistics Stats;
+	};
+
+	static TextureStreamerData* s_Data = nullptr;
+
+	namespace Utils {
+
+		static uint64_t GetResidentBytes(const StreamedTexture& texture, uint32_t residentLevel)
+		{
+			uint64_t bytes = 0;
+			for (uint32_t level = residentLevel; level < texture.Info.GetLevelCount(); level++)
+				bytes += texture.Info.Levels[level].ByteLength;
+
+			return bytes;
+		}
+
+		// Whether a should lose a level before b does
+		static bool IsBetterEvictionCandidate(const StreamedTexture& a, const StreamedTexture& b)
+		{
+			bool aUnneeded = a.Texture->GetResidentLevel() < a.DesiredLevel;
+			bool bUnneeded = b.Texture->GetResidentLevel() < b.DesiredLevel;
+			if (aUnneeded != bUnneeded)
+				return aUnneeded;
+
+			if (a.LastUsedFrame != b.LastUsedFrame)
+				return a.LastUsedFrame < b.LastUsedFrame;
+
+			// The bigger the finest resident level, the more memory evicting it gives back
+			return a.Info.Levels[a.Texture->GetResidentLevel()].ByteLength > b.Info.Levels[b.Texture->GetResidentLevel()].ByteLength;
+		}
+
+	}
+
+	void TextureStreamer::Init()
+	{
+		AR_PROFILE_FUNCTION();
+
+		s_Data = new TextureStreamerData;
+	}
+
+	void TextureStreamer::ShutDown()
+	{
+		AR_PROFILE_FUNCTION();
+
+		// The loads in flight write into s_Data when they finish
+		JobSystem::Wait(s_Data->LoadCounter);
+
+		// Textures that outlive the renderer keep whatever they have resident
+		for (auto& [streamID, texture] : s_Data->Textures)
+			texture.Texture->m_StreamID = 0;
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	bool TextureStreamer::IsInitialized()
+	{
+		return s_Data != nullptr;
+	}
+
+	void TextureStreamer::SetBudget(uint64_t bytes)
+	{
+		s_Data->Budget = bytes;
+	}
+
+	uint64_t TextureStreamer::GetBudget()
+	{
+		return s_Data->Budget;
+	}
+
+	void TextureStreamer::Register(Texture2D* texture, const TextureFileInfo& info, uint32_t pinnedLevel)
+	{
+		AR_PROFILE_FUNCTION();
+
+		uint64_t streamID = s_Data->NextStreamID++;
+		texture->m_StreamID = streamID;
+
+		StreamedTexture& streamed = s_Data->Textures[streamID];
+		streamed.Texture = texture;
+		streamed.Name = std::filesystem::path(texture->GetAssetPath()).filename().string();
+		streamed.Info = info;
+		streamed.PinnedLevel = pinnedLevel;
+		streamed.DesiredLevel = pinnedLevel;
+		streamed.LastUsedFrame = s_Data->FrameIndex;
+
+		s_Data->ResidentBytes += Utils::GetResidentBytes(streamed, texture->GetResidentLevel());
+	}
+
+	void TextureStreamer::Unregister(Texture2D* texture)
+	{
+		AR_PROFILE_FUNCTION();
+
+		if (!s_Data)
+			return;
+
+		auto it = s_Data->Textures.find(texture->m_StreamID);
+		if (it == s_Data->Textures.end())
+			return;
+
+		// A load that is still in flight gets dropped by Update since the stream id is gone
+		s_Data->ResidentBytes -= Utils::GetResidentBytes(it->second, texture->GetResidentLevel());
+		s_Data->Textures.erase(it);
+
+		texture->m_StreamID = 0;
+	}
+
+	void TextureStreamer::ReportUsage(const Texture2D& texture, uint32_t level)
+	{
+		if (!texture.m_StreamID || !s_Data)
+			return;
+
+		auto it = s_Data->Textures.find(texture.m_StreamID);
+		if (it != s_Data->Textures.end())
+			it->second.ReportedLevel = std::min(it->second.ReportedLevel, level);
+	}
+
+	void TextureStreamer::Update()
+	{
+		AR_PROFILE_FUNCTION();
+		AR_SCOPE_PERF("TextureStreamer::Update");
+
+		s_Data->FrameIndex++;
+
+		// What every texture needs this frame, the ones that were not drawn only need what is pinned
+		for (auto& [streamID, texture] : s_Data->Textures)
+		{
+			if (texture.ReportedLevel != ~0u)
+			{
+				texture.DesiredLevel = std::min(texture.ReportedLevel, texture.PinnedLevel);
+				texture.LastUsedFrame = s_Data->FrameIndex;
+			}
+			else
+			{
+				texture.DesiredLevel = texture.PinnedLevel;
+			}
+
+			texture.ReportedLevel = ~0u;
+		}
+
+		// Upload what the workers finished, the rest waits for the next frame
+		std::vector<StreamedLevel> loadedLevels;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->LoadedLevelsMutex);
+
+			uint32_t uploadCount = std::min((uint32_t)s_Data->LoadedLevels.size(), MaxUploadsPerFrame);
+			auto end = s_Data->LoadedLevels.begin() + uploadCount;
+			loadedLevels.assign(std::make_move_iterator(s_Data->LoadedLevels.begin()), std::make_move_iterator(end));
+			s_Data->LoadedLevels.erase(s_Data->LoadedLevels.begin(), end);
+		}
+
+		for (StreamedLevel& loaded : loadedLevels)
+		{
+			s_Data->PendingLoads--;
+			s_Data->PendingBytes -= loaded.Size;
+
+			auto it = s_Data->Textures.find(loaded.StreamID);
+			if (it == s_Data->Textures.end())
+				continue; // The texture was destroyed while the level was loading
+
+			StreamedTexture& texture = it->second;
+			texture.Loading = false;
+
+			if (!loaded.Loaded)
+			{
+				AR_CORE_ERROR_TAG("TextureStreamer", "Failed to stream level {0} of '{1}', it stays at level {2}!", loaded.Level, texture.Name, texture.Texture->GetResidentLevel());
+				texture.Broken = true;
+				continue;
+			}
+
+			// Textures are not evicted while they are loading so this is always the next finer level, the chain has to stay whole though
+			if (loaded.Level + 1 != texture.Texture->GetResidentLevel())
+				continue;
+
+			texture.Texture->UploadLevel(loaded.Level, loaded.Data.data(), (uint32_t)loaded.Data.size());
+			s_Data->ResidentBytes += loaded.Data.size();
+			s_Data->Stats.LevelsStreamedIn++;
+		}
+
+		// Get back under the budget, one level at a time from the texture that needs it the least
+		while (s_Data->ResidentBytes > s_Data->Budget)
+		{
+			StreamedTexture* victim = nullptr;
+			for (auto& [streamID, texture] : s_Data->Textures)
+			{
+				if (texture.Loading || texture.Texture->GetResidentLevel() >= texture.PinnedLevel)
+					continue;
+
+				if (!victim || Utils::IsBetterEvictionCandidate(texture, *victim))
+					victim = &texture;
+			}
+
+			if (!victim)
+				break;
+
+			s_Data->ResidentBytes -= victim->Info.Levels[victim->Texture->GetResidentLevel()].ByteLength;
+			victim->Texture->EvictLevel();
+			s_Data->Stats.LevelsEvicted++;
+		}
+
+		// Request the next level of the textures that need more, the ones missing the most levels first
+		std::vector<StreamedTexture*> requests;
+		for (auto& [streamID, texture] : s_Data->Textures)
+		{
+			if (!texture.Loading && !texture.Broken && texture.DesiredLevel < texture.Texture->GetResidentLevel())
+				requests.push_back(&texture);
+		}
+
+		std::sort(requests.begin(), requests.end(), [](const StreamedTexture* a, const StreamedTexture* b)
+		{
+			return a->Texture->GetResidentLevel() - a->DesiredLevel > b->Texture->GetResidentLevel() - b->DesiredLevel;
+		});
+
+		for (StreamedTexture* texture : requests)
+		{
+			if (s_Data->PendingLoads >= MaxPendingLoads)
+				break;
+
+			uint32_t level = texture->Texture->GetResidentLevel() - 1;
+			uint64_t size = texture->Info.Levels[level].ByteLength;
+			if (s_Data->ResidentBytes + s_Data->PendingBytes + size > s_Data->Budget)
+				continue;
+
+			texture->Loading = true;
+			s_Data->PendingLoads++;
+			s_Data->PendingBytes += size;
+
+			// The job only reads the file, the upload happens in a later Update on the main thread
+			JobFunction load = [streamID = texture->Texture->m_StreamID, path = texture->Texture->GetAssetPath(), info = texture->Info, level, size]()
+			{
+				StreamedLevel loaded = { streamID, level, size };
+				loaded.Loaded = TextureFile::ReadLevel(path, info, level, loaded.Data);
+
+				std::scoped_lock<std::mutex> lock(s_Data->LoadedLevelsMutex);
+				s_Data->LoadedLevels.push_back(std::move(loaded));
+			};
+
+			if (JobSystem::GetWorkerCount())
+				JobSystem::Execute(std::move(load), &s_Data->LoadCounter);
+			else
+				load();
+		}
+	}
+
+	const TextureStreamer::Statistics& TextureStreamer::GetStats()
+	{
+		s_Data->Stats.TextureCount = (uint32_t)s_Data->Textures.size();
+		s_Data->Stats.PendingLoads = s_Data->PendingLoads;
+		s_Data->Stats.ResidentBytes = s_Data->ResidentBytes;
+
+		return s_Data->Stats;
+	}
+
+	void TextureStreamer::GetTextureStats(std::vector<TextureStats>& outStats)
+	{
+		AR_PROFILE_FUNCTION();
+
+		outStats.clear();
+		outStats.reserve(s_Data->Textures.size());
+
+		for (auto& [streamID, texture] : s_Data->Textures)
+		{
+			TextureStats& stats = outStats.emplace_back();
+			stats.Name = texture.Name;
+			stats.Width = texture.Info.Width;
+			stats.Height = texture.Info.Height;
+			stats.LevelCount = texture.Info.GetLevelCount();
+			stats.ResidentLevel = texture.Texture->GetResidentLevel();
+			stats.DesiredLevel = texture.DesiredLevel;
+			stats.ResidentBytes = Utils::GetResidentBytes(texture, texture.Texture->GetResidentLevel());
+			stats.Loading = texture.Loading;
+		}
+	}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ * Mip level streaming for cooked textures (see TextureFile.h). A streamed texture only gets its small mips loaded when it is created
+ * (everything at or below PinnedLevelSize, those never leave), the finer levels are read from the file on the JobSystem's workers
+ * and uploaded one level at a time once the renderer reports that the texture is drawn big enough on screen to need them.
+ *
+ * The renderer reports the level every streamed texture needs while drawing (ReportUsage), the lowest level reported in a frame
+ * wins. Update then runs once per frame on the main thread:
+ *  - Finished loads are uploaded, at most MaxUploadsPerFrame of them so that a camera cut does not stall a single frame
+ *  - If the resident levels are over the budget, the finest level of the texture that needs it the least is evicted. Textures
+ *    that have more resident than they currently need go first, then the ones that were drawn the longest time ago
+ *  - The next finer level of the textures that need more gets requested, as long as it fits in the budget
+ *
+ * Levels are only ever streamed in or out one at a time from the coarse end, so what is resident is always a full chain from
+ * the resident level down to the smallest mip and the texture stays complete for sampling the whole time. Every change of the
+ * resident level gives the texture a new GL texture (see Texture2D::Respecify), so bind streamed textures through the texture
+ * rather than keeping their ID around.
+ */
+
+#include "Core/Base.h"
+
+#include <string>
+#include <vector>
+
+namespace Aurora {
+
+	class Texture2D;
+	struct TextureFileInfo;
+
+	class TextureStreamer
+	{
+	public:
+		// Levels with both sides at or below this are loaded with the texture and never evicted
+		static constexpr uint32_t PinnedLevelSize = 64;
+		static constexpr uint32_t MaxUploadsPerFrame = 4;
+		static constexpr uint32_t MaxPendingLoads = 8;
+		static constexpr uint64_t DefaultBudget = 256ull * 1024 * 1024;
+
+		struct TextureStats
+		{
+			std::string Name;
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			uint32_t LevelCount = 0;
+			uint32_t ResidentLevel = 0;
+			uint32_t DesiredLevel = 0;
+			uint64_t ResidentBytes = 0;
+			bool Loading = false;
+		};
+
+		struct Statistics
+		{
+			uint32_t TextureCount = 0;
+			uint32_t PendingLoads = 0;
+			uint64_t ResidentBytes = 0;
+			uint64_t LevelsStreamedIn = 0;
+			uint64_t LevelsEvicted = 0;
+		};
+
+	public:
+		static void Init();
+		static void ShutDown();
+
+		// The budget only covers the streamed textures, the pinned levels count against it but are never evicted to meet it
+		static void SetBudget(uint64_t bytes);
+		static uint64_t GetBudget();
+
+		// level is the finest mip the texture is going to be sampled at this frame, does nothing for textures that are not streamed
+		static void ReportUsage(const Texture2D& texture, uint32_t level);
+
+		// Called once per frame by the renderer after all the usage has been reported
+		static void Update();
+
+		static const Statistics& GetStats();
+		static void GetTextureStats(std::vector<TextureStats>& outStats);
+
+	private:
+		// Texture2D registers itself once its pinned levels are uploaded, if the streamer is not running it loads every level instead
+		static bool IsInitialized();
+		static void Register(Texture2D* texture, const TextureFileInfo& info, uint32_t pinnedLevel);
+		static void Unregister(Texture2D* texture);
+
+		friend class Texture2D;
+
+	};
+
+}
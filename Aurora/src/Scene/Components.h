@@ -3,6 +3,7 @@
 // TODO: to be added, mesh components by refering to darianopolis on discord
 
 #include "SceneCamera.h"
+#include "Asset/AssetManager.h"
 #include "Graphics/Model.h"
 
 #include <glm/glm.hpp>
@@ -57,15 +58,26 @@ namespace Aurora {
 	// TODO: Rework...
 	struct ModelComponent
 	{
-		Model model;
+		Ref<Model> model;
 
 		ModelComponent() = default;
 		ModelComponent(const std::string& filepath)
-			: model(filepath) {}
+			: model(AssetManager::Load<Model>(filepath)) {}
 		ModelComponent(const ModelComponent&) = default;
 
 	};
 
+	// Marks an entity as never moving, its sprite/model is baked into the scene's static batch instead of being drawn every frame.
+	// Editing a static entity has to go through Entity::PatchComponent for the batch to pick up the change
+	struct StaticComponent
+	{
+		bool Reserved = true; // entt does not store empty components and Entity::AddComponent needs a reference back
+
+		StaticComponent() = default;
+		StaticComponent(const StaticComponent&) = default;
+
+	};
+
 	// TODO: Rework...
 	struct SpriteRendererComponent
 	{// This should contain a Ref<Material/MaterialInstance> and a shader to that material...(Materials are capable of holding both the shader and data
@@ -78,6 +90,26 @@ namespace Aurora {
 
 	};
 
+	enum class LightType : uint8_t
+	{
+		Point = 0, Spot
+	};
+
+	// Lights the meshes through the clustered lighting of the renderer. Spot lights shine along the -Z (forward) of the entity
+	struct LightComponent
+	{
+		LightType Type = LightType::Point;
+		glm::vec3 Color{ 1.0f };
+		float Intensity = 1.0f;
+		float Radius = 10.0f; // Nothing past this distance is lit
+		float InnerConeAngle = 20.0f; // Spot only, half angles in degrees
+		float OuterConeAngle = 30.0f;
+
+		LightComponent() = default;
+		LightComponent(const LightComponent&) = default;
+
+	};
+
 	// TODO: Rework...!
 	struct CameraComponent
 	{
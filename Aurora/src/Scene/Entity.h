@@ -43,6 +43,16 @@ namespace Aurora {
 			return m_Scene->m_Registry.get<T>(m_EntityHandle);
 		}
 
+		// Same as GetComponent but whoever listens for changes of T gets told (the scene rebuilds its static batch this way). The
+		// functions are called with the component before that happens
+		template<typename T, typename... Func>
+		T& PatchComponent(Func&&... func)
+		{
+			AR_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
+
+			return m_Scene->m_Registry.patch<T>(m_EntityHandle, std::forward<Func>(func)...);
+		}
+
 		template<typename T>
 		void RemoveComponent()
 		{
@@ -3,9 +3,9 @@
 #include "Entity.h"
 
 #include "Graphics/Model.h"
-#include "Graphics/UniformBuffer.h" // TODO: Temp...!
 #include "Components.h"
 #include "ScriptableEntity.h"
+#include "Renderer/Environment.h"
 #include "Renderer/Renderer3D.h"
 #include "Editor/EditorResources.h"
 
@@ -13,13 +13,11 @@
 
 namespace Aurora {
 
-	static Ref<UniformBuffer> s_ModelUniBuffer;
 	static Ref<Shader> s_MatShader;
 	static Ref<Material> s_Mat;
 	static Ref<Texture2D> s_Texture;
 	static TextureProperties s_Props;
-	static Ref<Shader> s_ModelShader;
-	static Ref<CubeTexture> s_EnvironmentMap;
+	static Ref<Environment> s_Environment;
 	static bool s_Created = false;
 
 	Ref<Scene> Scene::Create(const std::string& debugName)
@@ -30,21 +28,39 @@ namespace Aurora {
 	Scene::Scene(const std::string& debugName)
 		: m_Name(debugName)
 	{
+		m_StaticBatch = StaticBatch::Create();
+
+		m_Registry.on_construct<StaticComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_destroy<StaticComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_construct<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_construct<ModelComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_destroy<ModelComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_update<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_Registry.on_update<ModelComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+
+		// A reloaded model frees its old meshes from the GeometryPool, which the static batch might have baked
+		m_ReloadCallbackID = AssetManager::AddReloadCallback([this](AssetHandle handle, const Ref<RefCountedObject>& asset)
+		{
+			if (AssetManager::GetMetadata(handle).Type == AssetType::Model)
+				m_StaticGeometryDirty = true;
+		});
+
 		if (!s_Created)
 		{
-			s_MatShader = Shader::Create("Resources/shaders/AuroraPBRStatic.glsl");
+			s_MatShader = AssetManager::Load<Shader>("Resources/shaders/AuroraPBRStatic.glsl");
 			s_Mat = Material::Create("Test Mat", s_MatShader);
 			s_Props.FlipOnLoad = true;
-			s_EnvironmentMap = CubeTexture::Create("Resources/environment/skybox");
-			s_Texture = Texture2D::Create("Resources/textures/Qiyana2.png", s_Props);
-			s_ModelUniBuffer = UniformBuffer::Create(sizeof(glm::mat4) + sizeof(int), 1);
-			s_ModelShader = Shader::Create("Resources/shaders/model.glsl"); // TODO: Temp...
+			s_Environment = Environment::Create("Resources/environment/skybox");
+			s_Texture = AssetManager::LoadTexture("Resources/textures/Qiyana2.png", s_Props);
 			s_Created = true;
 		}
 	}
 
 	Scene::~Scene()
 	{
+		AssetManager::RemoveReloadCallback(m_ReloadCallbackID);
 	}
 
 	Entity Scene::CreateEntityWithUUID(UUID id, const std::string& name)
@@ -91,6 +107,12 @@ namespace Aurora {
 			result.AddComponent<CameraComponent>(cc);
 		}
 
+		if (entity.HasComponent<LightComponent>())
+		{
+			LightComponent lc = entity.GetComponent<LightComponent>();
+			result.AddComponent<LightComponent>(lc);
+		}
+
 		return result;
 	}
 
@@ -102,13 +124,73 @@ namespace Aurora {
 	void Scene::Clear()
 	{
 		m_Registry.clear();
+		m_StaticGeometryDirty = true;
+	}
+
+	void Scene::OnStaticGeometryChanged(entt::registry& registry, entt::entity entity)
+	{
+		// Also called for transforms, sprites and models, those only matter if they are on a static entity
+		if (registry.has<StaticComponent>(entity))
+			m_StaticGeometryDirty = true;
+	}
+
+	void Scene::RebuildStaticBatch()
+	{
+		AR_PROFILE_FUNCTION();
+
+		Renderer3D::BeginStaticBatch(m_StaticBatch);
+
+		auto spriteView = m_Registry.view<TransformComponent, SpriteRendererComponent, StaticComponent>();
+		for (auto entity : spriteView)
+		{
+			auto [transform, sprite] = spriteView.get<TransformComponent, SpriteRendererComponent>(entity);
+
+			Renderer3D::AddStaticQuad(transform.GetTransform(), sprite.Color, (int)entity);
+		}
+
+		auto modelView = m_Registry.view<TransformComponent, ModelComponent, StaticComponent>();
+		for (auto entity : modelView)
+		{
+			auto [transform, modelComp] = modelView.get<TransformComponent, ModelComponent>(entity);
+			if (!modelComp.model)
+				continue;
+
+			Renderer3D::AddStaticModel(*modelComp.model, transform.GetTransform(), (int)entity);
+		}
+
+		Renderer3D::EndStaticBatch();
+
+		m_StaticGeometryDirty = false;
+	}
+
+	void Scene::SubmitLights()
+	{
+		auto view = m_Registry.view<TransformComponent, LightComponent>();
+		for (auto entity : view)
+		{
+			auto [transform, light] = view.get<TransformComponent, LightComponent>(entity);
+
+			if (light.Type == LightType::Spot)
+			{
+				glm::vec3 direction = glm::quat(transform.Rotation) * glm::vec3(0.0f, 0.0f, -1.0f);
+				Renderer3D::SubmitSpotLight(transform.Translation, direction, light.Color, light.Intensity, light.Radius, light.InnerConeAngle, light.OuterConeAngle);
+			}
+			else
+			{
+				Renderer3D::SubmitPointLight(transform.Translation, light.Color, light.Intensity, light.Radius);
+			}
+		}
 	}
 
 	void Scene::OnUpdateEditor(TimeStep ts, const EditorCamera& camera, glm::vec4 puh) // TODO: TEMPORARY!!!!!!!!!
 	{
+		// Everything here is submitted into the render queue and drawn sorted by pipeline/material/texture/depth in EndScene
 		Renderer3D::BeginScene(camera);
 
-		Renderer3D::DrawSkyBox(s_EnvironmentMap); // TODO: TEMPORARY!!!!!!!!!
+		SubmitLights();
+
+		s_Environment->Bind();
+		Renderer3D::SubmitSkyBox(s_Environment->GetRadianceMap()); // TODO: TEMPORARY!!!!!!!!!
 
 		glm::mat4 transform(1.0f);
 		transform = glm::translate(glm::mat4(1.0f), {55.0f, 5.0f, 20.0f});
@@ -116,14 +198,19 @@ namespace Aurora {
 		transform *= glm::scale(glm::mat4(1.0f), {100.0f, 200.0f, 1.0f});
 		s_Mat->Set("u_AlbedoTexture", s_Texture);
 		//s_Mat->Set("u_Uniforms.AlbedoColor", glm::vec4(puh, 1.0f));
-		Renderer3D::DrawMaterial(transform, s_Mat, puh); // TODO: TEMPORARY!!!!!!!!!
+		Renderer3D::SubmitMaterial(transform, s_Mat, puh); // TODO: TEMPORARY!!!!!!!!!
+
+		if (m_StaticGeometryDirty)
+			RebuildStaticBatch();
+
+		Renderer3D::SubmitStaticBatch(m_StaticBatch);
 
-		auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>();
+		auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>(entt::exclude<StaticComponent>);
 		for (auto entity : view)
 		{
 			auto [transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
 
-			Renderer3D::DrawRotatedQuad(transform.Translation, transform.Rotation, transform.Scale, sprite.Color, 0, (int)entity);
+			Renderer3D::SubmitRotatedQuad(transform.Translation, transform.Rotation, transform.Scale, sprite.Color, (int)entity);
 		}
 
 		// entities with camera components are rendered as white planes for now!
@@ -133,25 +220,21 @@ namespace Aurora {
 			auto [transform, camera] = cameraView.get<TransformComponent, CameraComponent>(entity);
 
 			// TODO: Fix the way the camera icon is displayed
-			Renderer3D::DrawRotatedQuad(transform.Translation, transform.Rotation, { transform.Scale.x, transform.Scale.y, 0.0f },
-				EditorResources::CameraIcon, 1.0f, glm::vec4(1.0f), (int)entity);
+			Renderer3D::SubmitRotatedQuad(transform.Translation, transform.Rotation, { transform.Scale.x, transform.Scale.y, 0.0f },
+				EditorResources::CameraIcon, 1.0f, glm::vec4(1.0f), (int)entity, RenderLayer::Overlay);
 		}
 
-		auto ModelView = m_Registry.view<TransformComponent, ModelComponent>(); // TODO: Rework...!!!
+		auto ModelView = m_Registry.view<TransformComponent, ModelComponent>(entt::exclude<StaticComponent>); // TODO: Rework...!!!
 		for (auto entity : ModelView)
 		{
 			auto[transform, modelComp] = ModelView.get<TransformComponent, ModelComponent>(entity);
-
-			auto model = modelComp.model;
+			if (!modelComp.model)
+				continue;
 
 			auto rotation = glm::toMat4(glm::quat(transform.Rotation));
 			auto trans = glm::translate(glm::mat4(1.0f), transform.Translation) * rotation * glm::scale(glm::mat4(1.0f), transform.Scale);
 
-			s_ModelShader->Bind();
-
-			s_ModelUniBuffer->SetData(glm::value_ptr(trans), sizeof(glm::mat4));
-			s_ModelUniBuffer->SetData(&entity, sizeof(int), sizeof(glm::mat4));
-			model.Draw(*(s_ModelShader.raw()));
+			Renderer3D::SubmitModel(modelComp.model.raw(), trans, (int)entity);
 		}
 
 		Renderer3D::EndScene();
@@ -195,12 +278,19 @@ namespace Aurora {
 		{
 			Renderer3D::BeginScene(*mainCamera, mainTransform);
 
-			auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>();
+			SubmitLights();
+
+			if (m_StaticGeometryDirty)
+				RebuildStaticBatch();
+
+			Renderer3D::SubmitStaticBatch(m_StaticBatch);
+
+			auto view = m_Registry.view<TransformComponent, SpriteRendererComponent>(entt::exclude<StaticComponent>);
 			for (auto entity : view)
 			{
 				auto[transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
 
-				Renderer3D::DrawRotatedQuad(transform.Translation, transform.Rotation, transform.Scale, sprite.Color, (int)entity);
+				Renderer3D::SubmitRotatedQuad(transform.Translation, transform.Rotation, transform.Scale, sprite.Color, (int)entity);
 			}
 
 			Renderer3D::EndScene();
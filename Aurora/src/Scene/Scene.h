@@ -7,6 +7,7 @@
 #include "Graphics/Shader.h" // TODO: Temp...
 #include "Graphics/Model.h" // TODO: Temp...
 #include "Graphics/CubeTexture.h" // TODO: Temp...
+#include "Renderer/StaticBatch.h"
 
 #include <entt/entt.hpp>
 
@@ -36,6 +37,11 @@ namespace Aurora {
 		// This a conveniance function just in case
 		Entity GetPrimaryCameraEntity();
 
+		// Entities with a StaticComponent are baked into one static batch which is rebuilt on the next update after this. Adding or
+		// removing the components, patching their transform, sprite or model (Entity::PatchComponent) and reloading a model already
+		// call it
+		inline void MarkStaticGeometryDirty() { m_StaticGeometryDirty = true; }
+
 		template<typename... Args>
 		auto GetAllEntitiesWith()
 		{
@@ -44,10 +50,19 @@ namespace Aurora {
 
 		inline std::string& GetName() { return m_Name; }
 
+	private:
+		void RebuildStaticBatch();
+		void SubmitLights();
+		void OnStaticGeometryChanged(entt::registry& registry, entt::entity entity);
+
 	private:
 		std::string m_Name = "Untitled Scene";
 
 		entt::registry m_Registry;
+
+		Ref<StaticBatch> m_StaticBatch;
+		bool m_StaticGeometryDirty = true;
+		uint32_t m_ReloadCallbackID = 0;
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 
 		friend class Entity;
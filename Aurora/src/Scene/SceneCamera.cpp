@@ -7,6 +7,8 @@ namespace Aurora {
 
 	void SceneCamera::SetViewportSize(uint32_t width, uint32_t height)
 	{
+		m_ViewportHeight = height;
+
 		if (m_ProjectionType == ProjectionType::Perspective)
 		{
 			SetPerspectiveProjectionMatrix(m_DegPerspectiveFOV, (float)width, (float)height, m_PerspectiveNear, m_PerspectiveFar);
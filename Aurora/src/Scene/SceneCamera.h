@@ -13,6 +13,7 @@ namespace Aurora {
 		virtual ~SceneCamera() = default;
 
 		void SetViewportSize(uint32_t width, uint32_t height);
+		uint32_t GetViewportHeight() const { return m_ViewportHeight; }
 
 		void SetPerspective(float degVerticalFov, float nearClip, float farClip);
 		void SetOrthographic(float size, float nearClip, float farClip);
@@ -43,6 +44,8 @@ namespace Aurora {
 		float m_OrthoSize = 10.0f;
 		float m_OrthoNear = -1.0f, m_OrthoFar = 1.0f;
 
+		uint32_t m_ViewportHeight = 720; // Until the first SetViewportSize, same default as the EditorCamera
+
 	};
 
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "Entity.h"
 #include "Components.h"
+#include "Asset/VirtualFileSystem.h"
+#include "Utils/UtilFunctions.h"
 
 #include <yaml-cpp/yaml.h>
 
@@ -182,6 +184,33 @@ namespace Aurora {
 			out << YAML::EndMap; // Camera Component
 		}
 
+		if (entity.HasComponent<StaticComponent>())
+			out << YAML::Key << "StaticComponent" << YAML::Value << true;
+
+		if (entity.HasComponent<LightComponent>())
+		{
+			out << YAML::Key << "LightComponent";
+			out << YAML::BeginMap; // Light Component
+
+			auto& lightComp = entity.GetComponent<LightComponent>();
+
+			switch (lightComp.Type)
+			{
+			    case LightType::Point: out << YAML::Key << "Type" << YAML::Value << 0; out << YAML::Comment("Point"); break;
+			    case LightType::Spot:  out << YAML::Key << "Type" << YAML::Value << 1; out << YAML::Comment("Spot"); break;
+			}
+
+			out << YAML::Key << "Color" << YAML::Value << lightComp.Color;
+			out << YAML::Key << "Intensity" << YAML::Value << lightComp.Intensity;
+			out << YAML::Key << "Radius" << YAML::Value << lightComp.Radius;
+
+			// Degrees
+			out << YAML::Key << "InnerConeAngle" << YAML::Value << lightComp.InnerConeAngle;
+			out << YAML::Key << "OuterConeAngle" << YAML::Value << lightComp.OuterConeAngle;
+
+			out << YAML::EndMap; // Light Component
+		}
+
 		if (entity.HasComponent<SpriteRendererComponent>())
 		{
 			out << YAML::Key << "SpriteRendererComponent";
@@ -246,13 +275,13 @@ namespace Aurora {
 	{
 		AR_PROFILE_FUNCTION();
 
-		AR_CORE_ASSERT(std::filesystem::exists(filepath), "Path does not exist");
+		AR_CORE_ASSERT(VirtualFileSystem::Exists(filepath), "Path does not exist");
 
 		YAML::Node data;
 
 		try
 		{
-			data = YAML::LoadFile(filepath);
+			data = YAML::Load(Utils::FileIO::ReadTextFile(filepath));
 		}
 		catch (YAML::ParserException e)
 		{
@@ -320,6 +349,22 @@ namespace Aurora {
 
 					color = spriteRendComp["Color"].as<glm::vec4>();
 				}
+
+				if (entity["StaticComponent"])
+					deserializedEntity.AddComponent<StaticComponent>();
+
+				YAML::Node lightComp = entity["LightComponent"];
+				if (lightComp)
+				{
+					LightComponent& lc = deserializedEntity.AddComponent<LightComponent>();
+
+					lc.Type = (LightType)lightComp["Type"].as<int>();
+					lc.Color = lightComp["Color"].as<glm::vec3>();
+					lc.Intensity = lightComp["Intensity"].as<float>();
+					lc.Radius = lightComp["Radius"].as<float>();
+					lc.InnerConeAngle = lightComp["InnerConeAngle"].as<float>();
+					lc.OuterConeAngle = lightComp["OuterConeAngle"].as<float>();
+				}
 			}
 		}
 
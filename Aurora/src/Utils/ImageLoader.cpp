@@ -1,6 +1,8 @@
 #include "Aurorapch.h"
 #include "ImageLoader.h"
 
+#include "Asset/VirtualFileSystem.h"
+
 #include <stb_image/stb_image.h>
 #include <stb_image_writer/stb_image_write.h>
 
@@ -8,49 +10,134 @@ namespace Aurora {
 
 	namespace Utils {
 
-		ImageData ImageLoader::m_ImageData;
-		bool ImageLoader::m_Loading;
+		ImageData::~ImageData()
+		{
+			Release();
+		}
+
+		ImageData::ImageData(ImageData&& other) noexcept
+		{
+			*this = std::move(other);
+		}
+
+		ImageData& ImageData::operator=(ImageData&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+
+				m_Pixels = other.m_Pixels;
+				m_Width = other.m_Width;
+				m_Height = other.m_Height;
+				m_Channels = other.m_Channels;
+				m_SourceChannels = other.m_SourceChannels;
+				m_HDR = other.m_HDR;
+
+				other.m_Pixels = nullptr;
+				other.m_Width = 0;
+				other.m_Height = 0;
+				other.m_Channels = 0;
+				other.m_SourceChannels = 0;
+				other.m_HDR = false;
+			}
+
+			return *this;
+		}
 
-		ImageData ImageLoader::LoadImageFile(const std::string& filePath)
+		void ImageData::Release()
+		{
+			stbi_image_free(m_Pixels);
+			m_Pixels = nullptr;
+		}
+
+		ImageData ImageLoader::LoadImageFile(const std::string& filePath, const ImageLoadSettings& settings)
 		{
 			AR_PROFILE_FUNCTION();
 
-			AR_CORE_ASSERT(std::filesystem::exists(filePath), "Path does not exist!");
-			AR_CORE_ASSERT(!m_Loading, "You forgot to free an image after loading one somewhere!");
+			// Files in a pack are already in memory
+			if (VirtualFileSystem::IsPacked(filePath))
+			{
+				FileReader reader(filePath);
+				return reader ? LoadImageFromMemory(reader.GetData(), reader.GetSize(), settings) : ImageData();
+			}
+
+			// The flag is thread local so it does not leak into loads on other threads, it is set on every load for the same reason
+			stbi_set_flip_vertically_on_load_thread(settings.FlipVertically);
+
+			ImageData image;
+			int32_t width, height, sourceChannels;
+			image.m_HDR = settings.AllowHDR && stbi_is_hdr(filePath.c_str());
+			image.m_Pixels = image.m_HDR ? (Byte*)stbi_loadf(filePath.c_str(), &width, &height, &sourceChannels, (int)settings.Channels)
+				: (Byte*)stbi_load(filePath.c_str(), &width, &height, &sourceChannels, (int)settings.Channels);
+
+			if (!image.m_Pixels)
+				return ImageData();
 
-			m_Loading = true;
-			m_ImageData.PixelData = (Byte*)stbi_load(filePath.c_str(), (int*)&m_ImageData.Width, (int*)&m_ImageData.Height, (int*)&m_ImageData.Channels, 0);
+			image.m_Width = (uint32_t)width;
+			image.m_Height = (uint32_t)height;
+			image.m_SourceChannels = (uint32_t)sourceChannels;
+			image.m_Channels = settings.Channels ? settings.Channels : (uint32_t)sourceChannels;
 
-			return m_ImageData;
+			return image;
 		}
 
-		bool ImageLoader::WriteDataToPNGImage(const std::string& filePath, const void* data, uint32_t width, uint32_t height, uint32_t channels)
+		ImageData ImageLoader::LoadImageFromMemory(const void* data, size_t size, const ImageLoadSettings& settings)
 		{
-			// Should Return a bool if it works
-			// Should have an enum to select in what format to write the image (tga/png/jpg/hdr...)
-			if (stbi_write_png(filePath.c_str(), width, height, channels, data, width * channels))
-				return true;
+			AR_PROFILE_FUNCTION();
 
-			return false;
+			AR_CORE_ASSERT(size <= INT32_MAX, "stb can not decode images bigger than 2GB!");
+
+			stbi_set_flip_vertically_on_load_thread(settings.FlipVertically);
+
+			const stbi_uc* bytes = (const stbi_uc*)data;
+			ImageData image;
+			int32_t width, height, sourceChannels;
+			image.m_HDR = settings.AllowHDR && stbi_is_hdr_from_memory(bytes, (int)size);
+			image.m_Pixels = image.m_HDR ? (Byte*)stbi_loadf_from_memory(bytes, (int)size, &width, &height, &sourceChannels, (int)settings.Channels)
+				: (Byte*)stbi_load_from_memory(bytes, (int)size, &width, &height, &sourceChannels, (int)settings.Channels);
+
+			if (!image.m_Pixels)
+				return ImageData();
+
+			image.m_Width = (uint32_t)width;
+			image.m_Height = (uint32_t)height;
+			image.m_SourceChannels = (uint32_t)sourceChannels;
+			image.m_Channels = settings.Channels ? settings.Channels : (uint32_t)sourceChannels;
+
+			return image;
 		}
 
-		void ImageLoader::FreeImage()
+		bool ImageLoader::IsHDR(const std::string& filePath)
 		{
-			AR_PROFILE_FUNCTION();
+			if (VirtualFileSystem::IsPacked(filePath))
+			{
+				FileReader reader(filePath);
+				return reader && IsHDR(reader.GetData(), reader.GetSize());
+			}
 
-			AR_CORE_ASSERT(m_Loading, "Trying to call FreeImage without calling LoadImageFile which is not allowed!");
+			return stbi_is_hdr(filePath.c_str());
+		}
 
-			m_Loading = false;
-			stbi_image_free(m_ImageData.PixelData);
+		bool ImageLoader::IsHDR(const void* data, size_t size)
+		{
+			return stbi_is_hdr_from_memory((const stbi_uc*)data, (int)size);
 		}
 
-		void ImageLoader::SetFlipVertically(bool boolean)
+		const char* ImageLoader::GetFailureReason()
 		{
-			AR_PROFILE_FUNCTION();
+			const char* reason = stbi_failure_reason();
+			return reason ? reason : "Unknown error";
+		}
 
-			stbi_set_flip_vertically_on_load(boolean);
+		bool ImageLoader::WriteDataToPNGImage(const std::string& filePath, const void* data, uint32_t width, uint32_t height, uint32_t channels)
+		{
+			// Should have an enum to select in what format to write the image (tga/png/jpg/hdr...)
+			if (stbi_write_png(filePath.c_str(), width, height, channels, data, width * channels))
+				return true;
+
+			return false;
 		}
 
 	}
 
-}
\ No newline at end of file
+}
@@ -1,35 +1,79 @@
 #pragma once
 
+/*
+ * Image decoding through stb_image. Every load returns its own ImageData that owns the pixels, nothing is shared between loads and
+ * the flip setting is applied per thread (stb keeps it thread local), so any number of images can be decoded at the same time from
+ * any thread. The loads from memory are for images that are already in memory, e.g. read out of an archive or a mapped file.
+ */
+
 namespace Aurora {
 
 	namespace Utils {
 
-		struct ImageData
+		struct ImageLoadSettings
 		{
-			Byte* PixelData = nullptr;
-			uint32_t Width = 0;
-			uint32_t Height = 0;
-			uint8_t Channels = 0;
+			// 0 keeps the channels of the image, otherwise the pixels are converted to this many channels
+			uint32_t Channels = 0;
+			bool FlipVertically = false;
+			// HDR images are decoded into 32 bit floats, turning this off converts them to 8 bits per channel
+			bool AllowHDR = true;
 		};
 
-		class ImageLoader
+		// Decoded pixels, move only and frees them when destroyed. Width * Height * Channels of either bytes or floats (IsHDR)
+		class ImageData
 		{
 		public:
-			static ImageData LoadImageFile(const std::string& filePath);
-			static bool WriteDataToPNGImage(const std::string& filePath, const void* data, uint32_t width, uint32_t height, uint32_t channels);
-			static void FreeImage();
+			ImageData() = default;
+			~ImageData();
+
+			ImageData(ImageData&& other) noexcept;
+			ImageData& operator=(ImageData&& other) noexcept;
+
+			ImageData(const ImageData&) = delete;
+			ImageData& operator=(const ImageData&) = delete;
 
-			// This is to be used before calling LoadImageFile()!
-			static void SetFlipVertically(bool boolean);
+			void Release();
 
-			static inline ImageData GetImageData() { return m_ImageData; }
+			[[nodiscard]] inline Byte* GetPixels() { return m_Pixels; }
+			[[nodiscard]] inline const Byte* GetPixels() const { return m_Pixels; }
+			[[nodiscard]] inline uint32_t GetWidth() const { return m_Width; }
+			[[nodiscard]] inline uint32_t GetHeight() const { return m_Height; }
+			[[nodiscard]] inline uint32_t GetChannels() const { return m_Channels; }
+			[[nodiscard]] inline uint32_t GetSourceChannels() const { return m_SourceChannels; } // What the image itself has
+			[[nodiscard]] inline bool IsHDR() const { return m_HDR; }
+			[[nodiscard]] inline size_t GetSize() const { return (size_t)m_Width * m_Height * m_Channels * (m_HDR ? sizeof(float) : 1); }
+
+			operator bool() const { return m_Pixels; }
 
 		private:
-			static ImageData m_ImageData;
-			static bool m_Loading;
+			Byte* m_Pixels = nullptr;
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+			uint32_t m_Channels = 0;
+			uint32_t m_SourceChannels = 0;
+			bool m_HDR = false;
+
+			friend class ImageLoader;
+
+		};
+
+		class ImageLoader
+		{
+		public:
+			// These can be called from any thread, an empty ImageData is returned if the image could not be decoded
+			static ImageData LoadImageFile(const std::string& filePath, const ImageLoadSettings& settings = ImageLoadSettings());
+			static ImageData LoadImageFromMemory(const void* data, size_t size, const ImageLoadSettings& settings = ImageLoadSettings());
+
+			static bool IsHDR(const std::string& filePath);
+			static bool IsHDR(const void* data, size_t size);
+
+			// Why the last load on the calling thread failed
+			static const char* GetFailureReason();
+
+			static bool WriteDataToPNGImage(const std::string& filePath, const void* data, uint32_t width, uint32_t height, uint32_t channels);
 
 		};
 
 	}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,210 @@
+#include "Aurorapch.h"
+#include "LZ4.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		// Limits that come from the format
+		static constexpr size_t LZ4MinMatch = 4;
+		static constexpr size_t LZ4LastLiterals = 5; // The last 5 bytes are always literals
+		static constexpr size_t LZ4MatchFindLimit = 12; // The last match has to start at least 12 bytes before the end
+		static constexpr size_t LZ4MaxOffset = 65535;
+
+		static constexpr uint32_t LZ4HashBits = 16;
+		static constexpr uint32_t LZ4NoPosition = UINT32_MAX;
+
+		static uint32_t ReadU32(const Byte* data)
+		{
+			uint32_t value;
+			memcpy(&value, data, sizeof(uint32_t));
+
+			return value;
+		}
+
+		static uint32_t HashSequence(uint32_t sequence)
+		{
+			return (sequence * 2654435761u) >> (32 - LZ4HashBits);
+		}
+
+		// Lengths that do not fit in their 4 bits of the token go on in bytes of 255
+		static bool WriteLength(size_t length, Byte*& op, const Byte* opEnd)
+		{
+			for (; length >= 255; length -= 255)
+			{
+				if (op >= opEnd)
+					return false;
+
+				*op++ = 255;
+			}
+
+			if (op >= opEnd)
+				return false;
+
+			*op++ = (Byte)length;
+			return true;
+		}
+
+		static bool ReadLength(size_t& length, const Byte*& ip, const Byte* ipEnd)
+		{
+			Byte value;
+			do
+			{
+				if (ip >= ipEnd)
+					return false;
+
+				value = *ip++;
+				length += value;
+			} while (value == 255);
+
+			return true;
+		}
+
+		// A sequence without a match is the last literals of the block
+		static bool WriteSequence(const Byte* literals, size_t literalLength, size_t offset, size_t matchLength, Byte*& op, const Byte* opEnd)
+		{
+			if (op >= opEnd)
+				return false;
+
+			Byte* token = op++;
+			*token = (Byte)(std::min(literalLength, (size_t)15) << 4);
+			if (literalLength >= 15 && !WriteLength(literalLength - 15, op, opEnd))
+				return false;
+
+			if ((size_t)(opEnd - op) < literalLength)
+				return false;
+
+			memcpy(op, literals, literalLength);
+			op += literalLength;
+
+			if (matchLength == 0)
+				return true;
+
+			if (opEnd - op < 2)
+				return false;
+
+			*op++ = (Byte)(offset & 0xFF);
+			*op++ = (Byte)(offset >> 8);
+
+			size_t matchCode = matchLength - LZ4MinMatch;
+			*token |= (Byte)std::min(matchCode, (size_t)15);
+			if (matchCode >= 15 && !WriteLength(matchCode - 15, op, opEnd))
+				return false;
+
+			return true;
+		}
+
+		size_t LZ4::GetCompressBound(size_t size)
+		{
+			return size + size / 255 + 16;
+		}
+
+		size_t LZ4::Compress(const void* src, size_t srcSize, void* dst, size_t dstCapacity)
+		{
+			AR_PROFILE_FUNCTION();
+
+			AR_CORE_ASSERT(srcSize < UINT32_MAX, "LZ4 blocks are limited to 4GB!");
+
+			const Byte* source = (const Byte*)src;
+			Byte* op = (Byte*)dst;
+			const Byte* opEnd = op + dstCapacity;
+
+			size_t anchor = 0;
+			if (srcSize > LZ4MatchFindLimit)
+			{
+				std::vector<uint32_t> hashTable(1 << LZ4HashBits, LZ4NoPosition);
+
+				size_t matchFindEnd = srcSize - LZ4MatchFindLimit;
+				size_t matchEnd = srcSize - LZ4LastLiterals;
+
+				size_t position = 0;
+				while (position < matchFindEnd)
+				{
+					uint32_t sequence = ReadU32(source + position);
+					uint32_t& slot = hashTable[HashSequence(sequence)];
+					uint32_t candidate = slot;
+					slot = (uint32_t)position;
+
+					if (candidate == LZ4NoPosition || position - candidate > LZ4MaxOffset || ReadU32(source + candidate) != sequence)
+					{
+						position++;
+						continue;
+					}
+
+					size_t matchLength = LZ4MinMatch;
+					while (position + matchLength < matchEnd && source[candidate + matchLength] == source[position + matchLength])
+						matchLength++;
+
+					if (!WriteSequence(source + anchor, position - anchor, position - candidate, matchLength, op, opEnd))
+						return 0;
+
+					position += matchLength;
+					anchor = position;
+				}
+			}
+
+			if (!WriteSequence(source + anchor, srcSize - anchor, 0, 0, op, opEnd))
+				return 0;
+
+			return op - (Byte*)dst;
+		}
+
+		bool LZ4::Decompress(const void* src, size_t srcSize, void* dst, size_t dstSize)
+		{
+			AR_PROFILE_FUNCTION();
+
+			const Byte* ip = (const Byte*)src;
+			const Byte* ipEnd = ip + srcSize;
+			Byte* op = (Byte*)dst;
+			Byte* opStart = op;
+			Byte* opEnd = op + dstSize;
+
+			while (ip < ipEnd)
+			{
+				Byte token = *ip++;
+
+				size_t literalLength = token >> 4;
+				if (literalLength == 15 && !ReadLength(literalLength, ip, ipEnd))
+					return false;
+
+				if ((size_t)(ipEnd - ip) < literalLength || (size_t)(opEnd - op) < literalLength)
+					return false;
+
+				memcpy(op, ip, literalLength);
+				ip += literalLength;
+				op += literalLength;
+
+				// The last sequence only has literals
+				if (ip == ipEnd)
+					break;
+
+				if (ipEnd - ip < 2)
+					return false;
+
+				size_t offset = ip[0] | (ip[1] << 8);
+				ip += 2;
+				if (offset == 0 || offset > (size_t)(op - opStart))
+					return false;
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15 && !ReadLength(matchLength, ip, ipEnd))
+					return false;
+
+				matchLength += LZ4MinMatch;
+				if ((size_t)(opEnd - op) < matchLength)
+					return false;
+
+				// The match can overlap what it writes (an offset of 1 repeats a byte) so this has to go forward one byte at a time
+				const Byte* match = op - offset;
+				for (size_t i = 0; i < matchLength; i++)
+					op[i] = match[i];
+
+				op += matchLength;
+			}
+
+			return op == opEnd;
+		}
+
+	}
+
+}
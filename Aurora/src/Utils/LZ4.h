@@ -0,0 +1,33 @@
+#pragma once
+
+/*
+ * The LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), only blocks and no frames since whatever
+ * stores the blocks (the asset packs) already knows the compressed and decompressed sizes.
+ * The compressor is the simple greedy one with a single hash table, it does not get the ratio of LZ4HC but it is fast and its output
+ * can be read by any LZ4 decoder. Decompressing is what matters at runtime and that is bounds checked, a broken block fails instead
+ * of reading or writing out of bounds.
+ */
+
+#include "Core/Base.h"
+
+namespace Aurora {
+
+	namespace Utils {
+
+		class LZ4
+		{
+		public:
+			// The most the compressed data can take, for data that does not compress at all
+			static size_t GetCompressBound(size_t size);
+
+			// Returns the compressed size, 0 if dst is too small
+			static size_t Compress(const void* src, size_t srcSize, void* dst, size_t dstCapacity);
+
+			// dstSize has to be the exact decompressed size, returns false if the block is broken
+			static bool Decompress(const void* src, size_t srcSize, void* dst, size_t dstSize);
+
+		};
+
+	}
+
+}
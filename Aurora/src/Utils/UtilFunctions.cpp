@@ -1,6 +1,7 @@
 #include "Aurorapch.h"
 #include "UtilFunctions.h"
 
+#include "Asset/VirtualFileSystem.h"
 #include "Core/Application.h"
 
 #ifdef AURORA_PLATFORM_WINDOWS
@@ -76,16 +77,11 @@ namespace Aurora {
 			AR_PROFILE_FUNCTION();
 
 			std::string result;
-			FILE* f;
-			fopen_s(&f, filePath.string().c_str(), "rb");
-			if (f)
+			FileReader reader(filePath.string());
+			if (reader)
 			{
-				fseek(f, 0, SEEK_END);
-				uint64_t size = ftell(f);
-				result.resize(size);
-				fseek(f, 0, SEEK_SET);
-				fread(&result[0], sizeof(char), size, f);
-				fclose(f);
+				result.resize(reader.GetSize());
+				reader.Read(result.data(), result.size());
 			}
 			else
 			{
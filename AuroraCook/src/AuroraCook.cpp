@@ -0,0 +1,683 @@
+/*
+ * AuroraCook is the offline asset cooker. It turns the resources into what the runtime loads the fastest, so that nothing has to be
+ * processed the first time it is used:
+ *  - The textures of the models are cooked into TextureFiles (.atex) next to their sources, Model prefers those over the sources
+ *  - The shaders are compiled into the shader cache, where Shader finds the binaries instead of compiling them
+ *  - With --pack everything gets packed into the asset pack the VirtualFileSystem mounts on startup
+ *
+ * First the resources are scanned into a dependency graph. A model depends on the textures its materials reference and every
+ * texture is cooked with the settings of the material slot it is used in (normal maps are renormalized while their mips are built
+ * for example). The graph is then executed on the JobSystem, every node is a job and the job of a model only runs once the jobs of
+ * all its textures are done.
+ *
+ * Cooking is incremental. The manifest keeps a key for every node, the hash of the contents of its inputs and of its settings, and
+ * a node whose key did not change and whose outputs are still there is skipped. So touching a texture only cooks that texture again,
+ * and moving the slot it is used in to another one does too. Models keep the files their importer read (materials, buffers...) and
+ * the textures it found in the manifest so that unchanged models do not get imported again.
+ *
+ * Run it from the directory the editor runs in: AuroraCook [--force] [--pack]
+ *  --force ignores the manifest and cooks everything
+ *  --pack builds the asset pack once cooking is done
+ */
+
+#include "Core/Base.h"
+#include "Core/Initializers.h"
+#include "Core/JobSystem.h"
+#include "Asset/AssetPack.h"
+#include "Asset/VirtualFileSystem.h"
+#include "Debugging/Timer.h"
+#include "Graphics/Shader.h"
+#include "Graphics/TextureCooker.h"
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/DefaultIOSystem.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Aurora {
+
+	namespace Utils {
+
+		// Bump this whenever what the cooker outputs changes, it throws the manifest away so everything gets cooked again
+		static constexpr uint32_t CookVersion = 1;
+
+		static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+		static const char* GetResourceDirectory()
+		{
+			return "Resources";
+		}
+
+		static const char* GetManifestPath()
+		{
+			return "Resources/cache/cook/Manifest.acook";
+		}
+
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = FNVOffsetBasis)
+		{
+			const Byte* bytes = (const Byte*)data;
+			for (size_t i = 0; i < size; i++)
+				hash = (hash ^ bytes[i]) * FNVPrime;
+
+			return hash;
+		}
+
+		// Folds the contents of the file into the hash, false if it could not be read
+		static bool HashFile(const std::string& filePath, uint64_t& hash)
+		{
+			std::ifstream stream(filePath, std::ios::binary);
+			if (!stream)
+				return false;
+
+			std::vector<char> buffer(1024 * 1024);
+			while (stream.read(buffer.data(), buffer.size()) || stream.gcount() > 0)
+				hash = HashBytes(buffer.data(), (size_t)stream.gcount(), hash);
+
+			return true;
+		}
+
+		static uint64_t HashCookSettings(const TextureCookSettings& settings, uint64_t hash)
+		{
+			// Field by field, the padding of the struct is not guaranteed to be zero
+			hash = HashBytes(&settings.Compression, sizeof(settings.Compression), hash);
+			hash = HashBytes(&settings.SourceSRGB, sizeof(settings.SourceSRGB), hash);
+			hash = HashBytes(&settings.SRGB, sizeof(settings.SRGB), hash);
+			hash = HashBytes(&settings.NormalMap, sizeof(settings.NormalMap), hash);
+			hash = HashBytes(&settings.GenerateMips, sizeof(settings.GenerateMips), hash);
+			hash = HashBytes(&settings.FlipVertically, sizeof(settings.FlipVertically), hash);
+
+			return hash;
+		}
+
+		static bool IsModelFile(const std::filesystem::path& path)
+		{
+			std::string extension = path.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+
+			return extension == ".obj" || extension == ".fbx" || extension == ".gltf" || extension == ".glb" || extension == ".dae";
+		}
+
+		static bool IsShaderFile(const std::filesystem::path& path)
+		{
+			return path.extension() == ".glsl";
+		}
+
+		// The material slots Model loads textures from (see Model::processMesh) and how the textures in them are cooked. The shaders
+		// sample normal maps as three channels so those go into BC7 rather than the BC5 Auto would pick for them. Only the diffuse slot
+		// holds sRGB encoded color, the others are data and are filtered as is
+		struct MaterialSlot
+		{
+			aiTextureType Type;
+			const char* Name;
+			bool Color;
+			bool NormalMap;
+		};
+
+		static constexpr MaterialSlot MaterialSlots[] =
+		{
+			{ aiTextureType_DIFFUSE,  "Diffuse",  true,  false },
+			{ aiTextureType_SPECULAR, "Specular", false, false },
+			{ aiTextureType_HEIGHT,   "Normal",   false, true  },
+			{ aiTextureType_AMBIENT,  "Height",   false, false }
+		};
+
+		static constexpr uint32_t MaterialSlotCount = sizeof(MaterialSlots) / sizeof(MaterialSlot);
+
+		static TextureCookSettings GetSlotCookSettings(uint32_t slot)
+		{
+			TextureCookSettings settings;
+			settings.SourceSRGB = MaterialSlots[slot].Color;
+			settings.NormalMap = MaterialSlots[slot].NormalMap;
+			if (settings.NormalMap)
+				settings.Compression = TextureCompression::BC7;
+
+			return settings;
+		}
+
+		// Reads from disk like the default one, but remembers every file the importer opened since those are inputs of the model too
+		class RecordingIOSystem : public Assimp::DefaultIOSystem
+		{
+		public:
+			virtual Assimp::IOStream* Open(const char* filePath, const char* mode) override
+			{
+				Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(filePath, mode);
+				if (stream)
+					m_OpenedFiles.push_back(VirtualFileSystem::NormalizePath(filePath));
+
+				return stream;
+			}
+
+			inline const std::vector<std::string>& GetOpenedFiles() const { return m_OpenedFiles; }
+
+		private:
+			std::vector<std::string> m_OpenedFiles;
+		};
+
+	}
+
+	struct ModelTexture
+	{
+		uint32_t Slot; // Into Utils::MaterialSlots
+		std::string Path;
+	};
+
+	// What the last cook left behind, keyed by the path of the node
+	struct CookManifest
+	{
+		struct Entry
+		{
+			uint64_t Key = 0;
+			std::vector<std::string> Inputs; // Models only
+			std::vector<ModelTexture> Textures; // Models only
+		};
+
+		std::unordered_map<std::string, Entry> Entries;
+
+		// A line per node "N <key> <path>", models are followed by a line per input "I <path>" and per texture "T <slot> <path>".
+		// The fields are separated by tabs since paths can have spaces
+		static CookManifest Read(const std::string& filePath)
+		{
+			CookManifest manifest;
+
+			std::ifstream stream(filePath);
+			if (!stream)
+				return manifest;
+
+			std::string line;
+			if (!std::getline(stream, line) || line != "AuroraCook " + std::to_string(Utils::CookVersion))
+			{
+				AR_CORE_WARN_TAG("AuroraCook", "The manifest is from another version of the cooker, cooking everything");
+				return manifest;
+			}
+
+			Entry* entry = nullptr;
+			while (std::getline(stream, line))
+			{
+				size_t first = line.find('\t');
+				size_t second = line.find('\t', first + 1);
+				if (first != 1)
+					continue;
+
+				if (line[0] == 'N' && second != std::string::npos)
+				{
+					entry = &manifest.Entries[line.substr(second + 1)];
+					entry->Key = std::strtoull(line.substr(first + 1, second - first - 1).c_str(), nullptr, 16);
+				}
+				else if (line[0] == 'I' && entry)
+				{
+					entry->Inputs.push_back(line.substr(first + 1));
+				}
+				else if (line[0] == 'T' && entry && second != std::string::npos)
+				{
+					uint32_t slot = (uint32_t)std::strtoul(line.substr(first + 1, second - first - 1).c_str(), nullptr, 10);
+					if (slot < Utils::MaterialSlotCount)
+						entry->Textures.push_back({ slot, line.substr(second + 1) });
+				}
+			}
+
+			return manifest;
+		}
+
+		bool Write(const std::string& filePath) const
+		{
+			std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+
+			std::ofstream stream(filePath);
+			if (!stream)
+			{
+				AR_CORE_ERROR_TAG("AuroraCook", "Could not open '{0}' for writing!", filePath);
+				return false;
+			}
+
+			// Sorted so that the manifest does not change if nothing was cooked
+			std::vector<const std::pair<const std::string, Entry>*> sorted;
+			for (const auto& pair : Entries)
+				sorted.push_back(&pair);
+
+			std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+			stream << "AuroraCook " << Utils::CookVersion << '\n';
+			for (const auto* pair : sorted)
+			{
+				stream << "N\t" << std::hex << pair->second.Key << std::dec << '\t' << pair->first << '\n';
+
+				for (const std::string& input : pair->second.Inputs)
+					stream << "I\t" << input << '\n';
+
+				for (const ModelTexture& texture : pair->second.Textures)
+					stream << "T\t" << texture.Slot << '\t' << texture.Path << '\n';
+			}
+
+			return (bool)stream;
+		}
+	};
+
+	enum class CookNodeType : uint8_t
+	{
+		Model = 0,
+		Texture,
+		Shader
+	};
+
+	struct CookNode
+	{
+		CookNodeType Type;
+		std::string Path; // Normalized, what the node is known by in the manifest
+
+		TextureCookSettings Settings; // Textures only
+		std::vector<std::string> Inputs; // Models only, the model file first
+		std::vector<ModelTexture> Textures; // Models only
+
+		std::vector<CookNode*> Dependencies;
+
+		uint64_t Key = 0;
+		bool Resolved = true; // False for models that could not be imported
+		bool Cooked = false;
+		bool Succeeded = false;
+
+		JobCounter Counter; // Done once the node is
+		JobCounter DependenciesCounter; // Done once all of its dependencies are
+	};
+
+	struct CookOptions
+	{
+		bool Force = false;
+	};
+
+	class AssetCooker
+	{
+	public:
+		AssetCooker(const CookOptions& options)
+			: m_Options(options) {}
+
+		// False if anything failed to cook
+		bool Run()
+		{
+			AR_SCOPE_PERF("AssetCooker::Run");
+
+			if (!std::filesystem::is_directory(Utils::GetResourceDirectory()))
+			{
+				AR_CORE_ERROR_TAG("AuroraCook", "There is no '{0}' directory here, AuroraCook has to run from the directory the editor runs in!", Utils::GetResourceDirectory());
+				return false;
+			}
+
+			if (!m_Options.Force)
+				m_Manifest = CookManifest::Read(Utils::GetManifestPath());
+
+			Scan();
+			ResolveModels();
+			Execute();
+
+			CookManifest manifest;
+			uint32_t cooked = 0, upToDate = 0, failed = 0;
+			for (const Scope<CookNode>& node : m_Nodes)
+			{
+				if (!node->Succeeded)
+				{
+					failed++;
+					continue;
+				}
+
+				// Models have nothing of their own to cook
+				if (node->Type != CookNodeType::Model)
+					node->Cooked ? cooked++ : upToDate++;
+
+				CookManifest::Entry& entry = manifest.Entries[node->Path];
+				entry.Key = node->Key;
+				entry.Inputs = node->Inputs;
+				entry.Textures = node->Textures;
+			}
+
+			manifest.Write(Utils::GetManifestPath());
+
+			AR_CORE_INFO_TAG("AuroraCook", "{0} assets cooked, {1} up to date, {2} failed", cooked, upToDate, failed);
+
+			return failed == 0;
+		}
+
+	private:
+		CookNode& AddNode(CookNodeType type, const std::string& path)
+		{
+			m_Nodes.push_back(CreateScope<CookNode>());
+
+			CookNode& node = *m_Nodes.back();
+			node.Type = type;
+			node.Path = path;
+			m_NodesByPath[path] = &node;
+
+			return node;
+		}
+
+		void Scan()
+		{
+			AR_PROFILE_FUNCTION();
+
+			std::filesystem::path cacheDirectory = std::filesystem::path(Utils::GetResourceDirectory()) / "cache";
+
+			std::vector<std::string> models;
+			std::vector<std::string> shaders;
+			for (auto it = std::filesystem::recursive_directory_iterator(Utils::GetResourceDirectory()); it != std::filesystem::recursive_directory_iterator(); it++)
+			{
+				// The cache is output only
+				if (it->is_directory() && it->path() == cacheDirectory)
+				{
+					it.disable_recursion_pending();
+					continue;
+				}
+
+				if (!it->is_regular_file())
+					continue;
+
+				if (Utils::IsModelFile(it->path()))
+					models.push_back(VirtualFileSystem::NormalizePath(it->path().string()));
+				else if (Utils::IsShaderFile(it->path()))
+					shaders.push_back(VirtualFileSystem::NormalizePath(it->path().string()));
+			}
+
+			// Sorted so that the graph, and which model a shared texture takes its settings from, does not depend on the file system
+			std::sort(models.begin(), models.end());
+			std::sort(shaders.begin(), shaders.end());
+
+			for (const std::string& model : models)
+				AddNode(CookNodeType::Model, model);
+
+			for (const std::string& shader : shaders)
+				AddNode(CookNodeType::Shader, shader);
+
+			AR_CORE_INFO_TAG("AuroraCook", "Found {0} models and {1} shaders", models.size(), shaders.size());
+		}
+
+		// Finds the textures of every model, from the manifest if the model did not change and by importing it otherwise. Then every
+		// texture gets its node and the models their edges
+		void ResolveModels()
+		{
+			AR_PROFILE_FUNCTION();
+
+			std::vector<CookNode*> models;
+			for (Scope<CookNode>& node : m_Nodes)
+			{
+				if (node->Type == CookNodeType::Model)
+					models.push_back(node.raw());
+			}
+
+			JobSystem::ParallelFor((uint32_t)models.size(), 1, [&](uint32_t i)
+			{
+				ResolveModel(*models[i]);
+			});
+
+			for (CookNode* model : models)
+			{
+				for (const ModelTexture& texture : model->Textures)
+				{
+					TextureCookSettings settings = Utils::GetSlotCookSettings(texture.Slot);
+
+					auto it = m_NodesByPath.find(texture.Path);
+					CookNode* node = it != m_NodesByPath.end() ? it->second : nullptr;
+					if (!node)
+					{
+						node = &AddNode(CookNodeType::Texture, texture.Path);
+						node->Settings = settings;
+					}
+					else if (node->Type != CookNodeType::Texture)
+					{
+						AR_CORE_WARN_TAG("AuroraCook", "'{0}' references '{1}' as a texture!", model->Path, texture.Path);
+						continue;
+					}
+					else if (Utils::HashCookSettings(node->Settings, 0) != Utils::HashCookSettings(settings, 0))
+					{
+						AR_CORE_WARN_TAG("AuroraCook", "'{0}' uses '{1}' as a {2} texture but it is already cooked for another slot, keeping those settings", model->Path, texture.Path, Utils::MaterialSlots[texture.Slot].Name);
+					}
+
+					if (std::find(model->Dependencies.begin(), model->Dependencies.end(), node) == model->Dependencies.end())
+						model->Dependencies.push_back(node);
+				}
+			}
+		}
+
+		void ResolveModel(CookNode& model)
+		{
+			AR_PROFILE_FUNCTION();
+
+			// The importer only has to be run again if one of the files it read last time changed
+			auto it = m_Manifest.Entries.find(model.Path);
+			if (it != m_Manifest.Entries.end() && !it->second.Inputs.empty())
+			{
+				const CookManifest::Entry& entry = it->second;
+
+				uint64_t key = Utils::FNVOffsetBasis;
+				bool readable = true;
+				for (const std::string& input : entry.Inputs)
+					readable = readable && Utils::HashFile(input, key);
+
+				if (readable && key == entry.Key)
+				{
+					model.Key = key;
+					model.Inputs = entry.Inputs;
+					model.Textures = entry.Textures;
+
+					return;
+				}
+			}
+
+			Utils::RecordingIOSystem* ioSystem = new Utils::RecordingIOSystem();
+
+			Assimp::Importer importer;
+			importer.SetIOHandler(ioSystem); // The importer owns it from here on
+
+			// Only the materials are needed, so no post processing
+			const aiScene* scene = importer.ReadFile(model.Path, 0);
+			if (!scene)
+			{
+				AR_CORE_ERROR_TAG("AuroraCook", "Could not import '{0}': {1}", model.Path, importer.GetErrorString());
+				model.Resolved = false;
+
+				return;
+			}
+
+			// Same as Model::loadModel, texture paths are relative to the model
+			std::string directory = model.Path.substr(0, model.Path.find_last_of('/'));
+
+			std::unordered_set<std::string> found;
+			for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+			{
+				aiMaterial* material = scene->mMaterials[i];
+				for (uint32_t slot = 0; slot < Utils::MaterialSlotCount; slot++)
+				{
+					for (uint32_t j = 0; j < material->GetTextureCount(Utils::MaterialSlots[slot].Type); j++)
+					{
+						aiString path;
+						material->GetTexture(Utils::MaterialSlots[slot].Type, j, &path);
+
+						// Embedded textures ("*0") come with the model, there is no file to cook
+						if (path.length == 0 || path.C_Str()[0] == '*')
+							continue;
+
+						std::string texturePath = VirtualFileSystem::NormalizePath(directory + '/' + path.C_Str());
+						if (found.insert(texturePath).second)
+							model.Textures.push_back({ slot, texturePath });
+					}
+				}
+			}
+
+			model.Inputs.push_back(model.Path);
+			for (const std::string& input : ioSystem->GetOpenedFiles())
+			{
+				if (std::find(model.Inputs.begin(), model.Inputs.end(), input) == model.Inputs.end())
+					model.Inputs.push_back(input);
+			}
+
+			model.Key = Utils::FNVOffsetBasis;
+			for (const std::string& input : model.Inputs)
+				Utils::HashFile(input, model.Key);
+		}
+
+		// Every node is a job, models wait for all of their textures
+		void Execute()
+		{
+			AR_PROFILE_FUNCTION();
+
+			for (Scope<CookNode>& node : m_Nodes)
+			{
+				CookNode* cookNode = node.raw();
+				if (node->Type != CookNodeType::Model)
+				{
+					JobSystem::Execute([this, cookNode]() { ExecuteNode(*cookNode); }, &node->Counter);
+					continue;
+				}
+
+				// ExecuteAfter only waits on one counter, so every dependency holds the model's DependenciesCounter up until it is done
+				for (CookNode* dependency : node->Dependencies)
+					JobSystem::ExecuteAfter(dependency->Counter, []() {}, &node->DependenciesCounter);
+
+				JobSystem::ExecuteAfter(node->DependenciesCounter, [this, cookNode]() { ExecuteNode(*cookNode); }, &node->Counter);
+			}
+
+			for (Scope<CookNode>& node : m_Nodes)
+				JobSystem::Wait(node->Counter);
+		}
+
+		void ExecuteNode(CookNode& node)
+		{
+			AR_PROFILE_FUNCTION();
+
+			switch (node.Type)
+			{
+				case CookNodeType::Model:
+				{
+					uint32_t cooked = 0;
+					bool succeeded = node.Resolved;
+					for (const CookNode* dependency : node.Dependencies)
+					{
+						succeeded = succeeded && dependency->Succeeded;
+						cooked += dependency->Cooked ? 1 : 0;
+					}
+
+					if (!succeeded)
+						AR_CORE_ERROR_TAG("AuroraCook", "'{0}' is not ready, it or one of its textures failed", node.Path);
+					else if (cooked)
+						AR_CORE_INFO_TAG("AuroraCook", "'{0}' is ready, cooked {1} of its {2} textures", node.Path, cooked, node.Dependencies.size());
+
+					node.Succeeded = succeeded;
+					return;
+				}
+				case CookNodeType::Texture:
+				{
+					node.Key = Utils::HashCookSettings(node.Settings, Utils::FNVOffsetBasis);
+					if (!Utils::HashFile(node.Path, node.Key))
+					{
+						AR_CORE_ERROR_TAG("AuroraCook", "Could not read '{0}'!", node.Path);
+						return;
+					}
+
+					std::string cookedPath = TextureCooker::GetCookedPath(node.Path);
+					if (IsUpToDate(node) && std::filesystem::exists(cookedPath))
+					{
+						node.Succeeded = true;
+						return;
+					}
+
+					node.Succeeded = TextureCooker::CookFile(node.Path, cookedPath, node.Settings);
+					node.Cooked = node.Succeeded;
+					return;
+				}
+				case CookNodeType::Shader:
+				{
+					node.Key = Utils::FNVOffsetBasis;
+					if (!Utils::HashFile(node.Path, node.Key))
+					{
+						AR_CORE_ERROR_TAG("AuroraCook", "Could not read '{0}'!", node.Path);
+						return;
+					}
+
+					if (IsUpToDate(node) && HasCachedShader(node.Path))
+					{
+						node.Succeeded = true;
+						return;
+					}
+
+					AR_CORE_INFO_TAG("AuroraCook", "Compiling '{0}'", node.Path);
+					node.Succeeded = Shader::Precompile(node.Path);
+					node.Cooked = node.Succeeded;
+					return;
+				}
+			}
+		}
+
+		bool IsUpToDate(const CookNode& node) const
+		{
+			auto it = m_Manifest.Entries.find(node.Path);
+
+			return it != m_Manifest.Entries.end() && it->second.Key == node.Key;
+		}
+
+		// Shader caches its binaries under the file name of the shader, one per stage
+		static bool HasCachedShader(const std::string& shaderPath)
+		{
+			std::string prefix = std::filesystem::path(shaderPath).filename().string() + ".cachedOpenGL.";
+
+			std::error_code error;
+			for (const auto& entry : std::filesystem::directory_iterator(Shader::GetCacheDirectory(), error))
+			{
+				if (entry.path().filename().string().rfind(prefix, 0) == 0)
+					return true;
+			}
+
+			return false;
+		}
+
+	private:
+		CookOptions m_Options;
+		CookManifest m_Manifest;
+
+		std::vector<Scope<CookNode>> m_Nodes;
+		std::unordered_map<std::string, CookNode*> m_NodesByPath;
+
+	};
+
+}
+
+int main(int argc, char** argv)
+{
+	Aurora::InitializeCore();
+
+	Aurora::CookOptions options;
+	bool buildPack = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view argument = argv[i];
+		if (argument == "--force")
+		{
+			options.Force = true;
+		}
+		else if (argument == "--pack")
+		{
+			buildPack = true;
+		}
+		else
+		{
+			AR_CORE_ERROR_TAG("AuroraCook", "Unknown argument '{0}', usage: AuroraCook [--force] [--pack]", argument);
+			Aurora::ShutdownCore();
+
+			return 1;
+		}
+	}
+
+	bool succeeded = Aurora::AssetCooker(options).Run();
+
+	if (succeeded && buildPack)
+		succeeded = Aurora::AssetPack::BuildFromDirectory(Aurora::VirtualFileSystem::GetDefaultPackPath(), Aurora::Utils::GetResourceDirectory());
+
+	Aurora::ShutdownCore();
+
+	return succeeded ? 0 : 1;
+}
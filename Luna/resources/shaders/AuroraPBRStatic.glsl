@@ -4,6 +4,7 @@ layout (location = 0) in vec3 a_Position;
 layout (location = 1) in vec2 a_TexCoords;
 
 layout(location = 1) out vec2 v_TexCoords; // was 0
+layout(location = 2) out vec3 v_WorldPosition;
 
 layout(std140, binding = 0) uniform Camera
 {
@@ -21,7 +22,9 @@ void main()
     mat4 model = u_Renderer.transform;
 //    mat4 model = mat4(1.0f);
     v_TexCoords = a_TexCoords;
-    gl_Position = u_ViewProjMatrix * model * vec4(a_Position, 1.0);
+    vec4 worldPosition = model * vec4(a_Position, 1.0);
+    v_WorldPosition = worldPosition.xyz;
+    gl_Position = u_ViewProjMatrix * worldPosition;
 }  
 
 #pragma fragment
@@ -30,9 +33,117 @@ layout(location = 0) out vec4 o_Color;
 layout(location = 1) out int o_EntityID;
 
 layout(location = 1) in vec2 v_TexCoords; // was 0
+layout(location = 2) in vec3 v_WorldPosition;
 
 layout(binding = 0) uniform sampler2D u_AlbedoTexture;
 
+// Image based lighting of the environment, bound by Environment::Bind to the slots it declares
+layout(binding = 24) uniform samplerCube u_IrradianceMap;
+layout(binding = 25) uniform samplerCube u_PrefilteredMap;
+layout(binding = 26) uniform sampler2D u_BRDFLut;
+
+const float c_PrefilteredMaxLevel = 5.0f; // Environment::PrefilteredLevelCount - 1
+
+// The material has no inputs for these yet
+const float c_Roughness = 0.5f;
+const float c_Metalness = 0.0f;
+
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 u_ViewProjMatrix;
+    mat4 u_SkyVP;
+};
+
+struct Light
+{
+    vec4 PositionRadius;
+    vec4 ColorIntensity;
+    vec4 DirectionType; // w: 0 point, 1 spot
+    vec4 SpotCone; // x: cos of the inner angle, y: cos of the outer angle
+};
+
+layout(std140, binding = 2) uniform Lighting
+{
+    mat4 u_ViewMatrix;
+    uvec4 u_ClusterGrid; // xyz: size of the grid, w: light count
+    vec4 u_ClusterDepth; // x: near, y: far, z: slices / log(far / near), w: log(near) * z
+    vec4 u_AmbientColor;
+};
+
+layout(std430, binding = 5) readonly buffer LightBuffer
+{
+    Light u_Lights[];
+};
+
+layout(std430, binding = 6) readonly buffer ClusterBuffer
+{
+    uvec2 u_Clusters[];
+};
+
+layout(std430, binding = 7) readonly buffer LightIndexBuffer
+{
+    uint u_LightIndexCount;
+    uint u_LightIndices[];
+};
+
+// Split sum approximation, the diffuse part from the irradiance map and the specular part from the prefiltered map scaled by the
+// BRDF lookup table
+vec3 ComputeEnvironmentLighting(vec3 normal, vec3 view, vec3 albedo)
+{
+    vec3 F0 = mix(vec3(0.04f), albedo, c_Metalness);
+    float NdotV = max(dot(normal, view), 0.0f);
+
+    vec3 F = F0 + (max(vec3(1.0f - c_Roughness), F0) - F0) * pow(1.0f - NdotV, 5.0f);
+    vec2 brdf = texture(u_BRDFLut, vec2(NdotV, c_Roughness)).rg;
+
+    vec3 diffuse = texture(u_IrradianceMap, normal).rgb * albedo * (1.0f - F) * (1.0f - c_Metalness);
+    vec3 specular = textureLod(u_PrefilteredMap, reflect(-view, normal), c_Roughness * c_PrefilteredMaxLevel).rgb * (F0 * brdf.x + brdf.y);
+
+    return diffuse + specular;
+}
+
+// Same as in StaticMesh.glsl except that the environment takes the place of the flat ambient color. Only loops over the lights
+// that LightCulling.glsl binned into the cluster of the fragment
+vec3 ComputeLighting(vec3 worldPosition, vec3 normal, vec3 albedo, vec3 cameraPosition)
+{
+    // Without any lights everything stays fully lit like before there were lights at all
+    if (u_ClusterGrid.w == 0)
+        return albedo;
+
+    vec4 clip = u_ViewProjMatrix * vec4(worldPosition, 1.0f);
+    vec2 ndc = clip.xy / clip.w;
+    float viewDepth = -(u_ViewMatrix * vec4(worldPosition, 1.0f)).z;
+
+    uvec2 tile = uvec2(clamp((ndc * 0.5f + 0.5f) * vec2(u_ClusterGrid.xy), vec2(0.0f), vec2(u_ClusterGrid.xy) - 1.0f));
+    uint slice = uint(clamp(log(max(viewDepth, u_ClusterDepth.x)) * u_ClusterDepth.z - u_ClusterDepth.w, 0.0f, float(u_ClusterGrid.z) - 1.0f));
+    uvec2 cluster = u_Clusters[tile.x + tile.y * u_ClusterGrid.x + slice * u_ClusterGrid.x * u_ClusterGrid.y];
+
+    vec3 result = ComputeEnvironmentLighting(normal, normalize(cameraPosition - worldPosition), albedo);
+    for (uint i = 0; i < cluster.y; i++)
+    {
+        Light light = u_Lights[u_LightIndices[cluster.x + i]];
+
+        vec3 toLight = light.PositionRadius.xyz - worldPosition;
+        float distance = length(toLight);
+        float radius = light.PositionRadius.w;
+        if (distance >= radius)
+            continue;
+
+        vec3 lightDirection = toLight / distance;
+
+        // Inverse square falloff that is windowed to reach exactly 0 at the radius of the light
+        float window = clamp(1.0f - pow(distance / radius, 4.0f), 0.0f, 1.0f);
+        float attenuation = window * window / (distance * distance + 1.0f);
+
+        if (light.DirectionType.w == 1.0f)
+            attenuation *= smoothstep(light.SpotCone.y, light.SpotCone.x, dot(-lightDirection, light.DirectionType.xyz));
+
+        result += albedo * light.ColorIntensity.rgb * light.ColorIntensity.w * max(dot(normal, lightDirection), 0.0f) * attenuation;
+    }
+
+    return result;
+}
+
 layout(push_constant) uniform Materials
 {
     vec4 AlbedoColor;
@@ -40,6 +151,13 @@ layout(push_constant) uniform Materials
 
 void main()
 {    
-    o_Color = texture(u_AlbedoTexture, v_TexCoords);// * u_Materials.AlbedoColor;
+    // The cube has no normals so the face normal comes from the derivatives, flipped to face the camera
+    vec3 normal = normalize(cross(dFdx(v_WorldPosition), dFdy(v_WorldPosition)));
+    vec3 cameraPosition = -transpose(mat3(u_ViewMatrix)) * u_ViewMatrix[3].xyz;
+    if (dot(normal, cameraPosition - v_WorldPosition) < 0.0)
+        normal = -normal;
+
+    vec4 albedo = texture(u_AlbedoTexture, v_TexCoords);// * u_Materials.AlbedoColor;
+    o_Color = vec4(ComputeLighting(v_WorldPosition, normal, albedo.rgb, cameraPosition), albedo.a);
     o_EntityID = -1;
 }
\ No newline at end of file
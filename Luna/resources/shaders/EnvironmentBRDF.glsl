@@ -0,0 +1,87 @@
+#pragma compute
+#version 450 core
+
+// The BRDF lookup table of the split sum approximation. x is N.V, y the roughness, red the scale and green the bias to F0.
+// Does not depend on the environment so it is only baked once, see Environment.cpp
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding = 0, rg16f) uniform writeonly image2D o_BRDFLut;
+
+layout(push_constant) uniform Uniforms
+{
+	int OutputSize;
+} u_Uniforms;
+
+const float PI = 3.14159265359f;
+const uint SampleCount = 1024u;
+
+// Same as in EnvironmentPrefilter.glsl
+vec2 Hammersley(uint i, uint count)
+{
+	uint bits = bitfieldReverse(i);
+	return vec2(float(i) / float(count), float(bits) * 2.3283064365386963e-10f);
+}
+
+vec3 ImportanceSampleGGX(vec2 xi, vec3 normal, float roughness)
+{
+	float a = roughness * roughness;
+
+	float phi = 2.0f * PI * xi.x;
+	float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+	float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+
+	vec3 halfway = vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+
+	vec3 up = abs(normal.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+	vec3 tangent = normalize(cross(up, normal));
+	vec3 bitangent = cross(normal, tangent);
+
+	return normalize(tangent * halfway.x + bitangent * halfway.y + normal * halfway.z);
+}
+
+// Schlick-GGX with the k that is used for image based lighting
+float GeometrySmith(float NdotV, float NdotL, float roughness)
+{
+	float k = roughness * roughness * 0.5f;
+
+	float ggxV = NdotV / (NdotV * (1.0f - k) + k);
+	float ggxL = NdotL / (NdotL * (1.0f - k) + k);
+
+	return ggxV * ggxL;
+}
+
+void main()
+{
+	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+	if (coord.x >= u_Uniforms.OutputSize || coord.y >= u_Uniforms.OutputSize)
+		return;
+
+	float NdotV = (float(coord.x) + 0.5f) / float(u_Uniforms.OutputSize);
+	float roughness = (float(coord.y) + 0.5f) / float(u_Uniforms.OutputSize);
+
+	vec3 viewDirection = vec3(sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+	vec3 normal = vec3(0.0f, 0.0f, 1.0f);
+
+	float scale = 0.0f;
+	float bias = 0.0f;
+	for (uint i = 0u; i < SampleCount; i++)
+	{
+		vec3 halfway = ImportanceSampleGGX(Hammersley(i, SampleCount), normal, roughness);
+		vec3 lightDirection = normalize(2.0f * dot(viewDirection, halfway) * halfway - viewDirection);
+
+		float NdotL = max(lightDirection.z, 0.0f);
+		float NdotH = max(halfway.z, 0.0f);
+		float VdotH = max(dot(viewDirection, halfway), 0.0f);
+		if (NdotL <= 0.0f)
+			continue;
+
+		float visibility = GeometrySmith(NdotV, NdotL, roughness) * VdotH / (NdotH * NdotV);
+		float fresnel = pow(1.0f - VdotH, 5.0f);
+
+		scale += (1.0f - fresnel) * visibility;
+		bias += fresnel * visibility;
+	}
+
+	imageStore(o_BRDFLut, coord, vec4(scale, bias, 0.0f, 0.0f) / float(SampleCount));
+}
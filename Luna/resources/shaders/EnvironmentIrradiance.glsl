@@ -0,0 +1,68 @@
+#pragma compute
+#version 450 core
+
+// Diffuse irradiance of the environment, for every direction the cosine weighted integral of the radiance over the hemisphere
+// around it. Runs once per environment, see Environment.cpp
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding = 0) uniform samplerCube u_Radiance;
+layout(binding = 1, rgba16f) uniform writeonly imageCube o_Irradiance;
+
+layout(push_constant) uniform Uniforms
+{
+	int OutputSize;
+	float SourceLevel; // Mip of the radiance that is sampled, coarse enough that the samples do not skip over texels
+} u_Uniforms;
+
+const float PI = 3.14159265359f;
+const float SampleDelta = 0.025f;
+
+// Same as in EnvironmentPrefilter.glsl. The direction through the center of a texel of a face, in the GL cube map face order
+vec3 GetCubeDirection(uvec3 id, int size)
+{
+	vec2 uv = (vec2(id.xy) + 0.5f) / float(size) * 2.0f - 1.0f;
+
+	vec3 direction;
+	switch (id.z)
+	{
+		case 0: direction = vec3(1.0f, -uv.y, -uv.x); break;
+		case 1: direction = vec3(-1.0f, -uv.y, uv.x); break;
+		case 2: direction = vec3(uv.x, 1.0f, uv.y); break;
+		case 3: direction = vec3(uv.x, -1.0f, -uv.y); break;
+		case 4: direction = vec3(uv.x, -uv.y, 1.0f); break;
+		case 5: direction = vec3(-uv.x, -uv.y, -1.0f); break;
+	}
+
+	return normalize(direction);
+}
+
+void main()
+{
+	uvec3 id = gl_GlobalInvocationID;
+	if (id.x >= u_Uniforms.OutputSize || id.y >= u_Uniforms.OutputSize)
+		return;
+
+	vec3 normal = GetCubeDirection(id, u_Uniforms.OutputSize);
+	vec3 up = abs(normal.y) < 0.999f ? vec3(0.0f, 1.0f, 0.0f) : vec3(0.0f, 0.0f, 1.0f);
+	vec3 right = normalize(cross(up, normal));
+	up = cross(normal, right);
+
+	// Uniform steps over the hemisphere, the sin(theta) makes up for the samples bunching up at the pole
+	vec3 irradiance = vec3(0.0f);
+	float sampleCount = 0.0f;
+	for (float phi = 0.0f; phi < 2.0f * PI; phi += SampleDelta)
+	{
+		for (float theta = 0.0f; theta < 0.5f * PI; theta += SampleDelta)
+		{
+			vec3 tangentSample = vec3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+			vec3 sampleDirection = tangentSample.x * right + tangentSample.y * up + tangentSample.z * normal;
+
+			irradiance += textureLod(u_Radiance, sampleDirection, u_Uniforms.SourceLevel).rgb * cos(theta) * sin(theta);
+			sampleCount++;
+		}
+	}
+
+	irradiance = PI * irradiance / sampleCount;
+	imageStore(o_Irradiance, ivec3(id), vec4(irradiance, 1.0f));
+}
@@ -0,0 +1,116 @@
+#pragma compute
+#version 450 core
+
+// One level of the prefiltered radiance, the environment convolved with the GGX lobe of the roughness of the level. Runs once
+// per level of every environment, see Environment.cpp
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding = 0) uniform samplerCube u_Radiance;
+layout(binding = 1, rgba16f) uniform writeonly imageCube o_Prefiltered;
+
+layout(push_constant) uniform Uniforms
+{
+	int OutputSize;
+	float SourceSize;
+	float Roughness;
+} u_Uniforms;
+
+const float PI = 3.14159265359f;
+const uint SampleCount = 1024u;
+
+// Same as in EnvironmentIrradiance.glsl
+vec3 GetCubeDirection(uvec3 id, int size)
+{
+	vec2 uv = (vec2(id.xy) + 0.5f) / float(size) * 2.0f - 1.0f;
+
+	vec3 direction;
+	switch (id.z)
+	{
+		case 0: direction = vec3(1.0f, -uv.y, -uv.x); break;
+		case 1: direction = vec3(-1.0f, -uv.y, uv.x); break;
+		case 2: direction = vec3(uv.x, 1.0f, uv.y); break;
+		case 3: direction = vec3(uv.x, -1.0f, -uv.y); break;
+		case 4: direction = vec3(uv.x, -uv.y, 1.0f); break;
+		case 5: direction = vec3(-uv.x, -uv.y, -1.0f); break;
+	}
+
+	return normalize(direction);
+}
+
+// Same as in EnvironmentBRDF.glsl
+vec2 Hammersley(uint i, uint count)
+{
+	uint bits = bitfieldReverse(i);
+	return vec2(float(i) / float(count), float(bits) * 2.3283064365386963e-10f);
+}
+
+vec3 ImportanceSampleGGX(vec2 xi, vec3 normal, float roughness)
+{
+	float a = roughness * roughness;
+
+	float phi = 2.0f * PI * xi.x;
+	float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+	float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+
+	vec3 halfway = vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+
+	vec3 up = abs(normal.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+	vec3 tangent = normalize(cross(up, normal));
+	vec3 bitangent = cross(normal, tangent);
+
+	return normalize(tangent * halfway.x + bitangent * halfway.y + normal * halfway.z);
+}
+
+float DistributionGGX(float NdotH, float roughness)
+{
+	float a = roughness * roughness;
+	float a2 = a * a;
+	float denominator = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+
+	return a2 / (PI * denominator * denominator);
+}
+
+void main()
+{
+	uvec3 id = gl_GlobalInvocationID;
+	if (id.x >= u_Uniforms.OutputSize || id.y >= u_Uniforms.OutputSize)
+		return;
+
+	// Assumes N = V = R like every split sum prefilter, the lobe loses its stretch at grazing angles because of it
+	vec3 normal = GetCubeDirection(id, u_Uniforms.OutputSize);
+
+	// A perfect mirror is just the radiance itself
+	if (u_Uniforms.Roughness == 0.0f)
+	{
+		imageStore(o_Prefiltered, ivec3(id), vec4(textureLod(u_Radiance, normal, 0.0f).rgb, 1.0f));
+		return;
+	}
+
+	// Solid angle of a texel of the source, samples are taken from the mip that matches their own solid angle so that the
+	// bright spots of the environment do not show up as fireflies
+	float texelSolidAngle = 4.0f * PI / (6.0f * u_Uniforms.SourceSize * u_Uniforms.SourceSize);
+
+	vec3 prefiltered = vec3(0.0f);
+	float totalWeight = 0.0f;
+	for (uint i = 0u; i < SampleCount; i++)
+	{
+		vec3 halfway = ImportanceSampleGGX(Hammersley(i, SampleCount), normal, u_Uniforms.Roughness);
+		vec3 lightDirection = normalize(2.0f * dot(normal, halfway) * halfway - normal);
+
+		float NdotL = dot(normal, lightDirection);
+		if (NdotL <= 0.0f)
+			continue;
+
+		// With N = V the pdf of the reflected direction simplifies to D / 4
+		float NdotH = max(dot(normal, halfway), 0.0f);
+		float pdf = DistributionGGX(NdotH, u_Uniforms.Roughness) * 0.25f + 0.0001f;
+		float sampleSolidAngle = 1.0f / (float(SampleCount) * pdf + 0.0001f);
+		float level = max(0.5f * log2(sampleSolidAngle / texelSolidAngle), 0.0f);
+
+		prefiltered += textureLod(u_Radiance, lightDirection, level).rgb * NdotL;
+		totalWeight += NdotL;
+	}
+
+	imageStore(o_Prefiltered, ivec3(id), vec4(prefiltered / totalWeight, 1.0f));
+}
@@ -0,0 +1,58 @@
+#pragma compute
+#version 450 core
+
+// Builds one level of the Hi-Z pyramid, every texel keeps the farthest depth of the texels it covers in the level above.
+// Level 0 is just a copy of the depth buffer (InputLevel is then the only level of the depth texture)
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding = 0) uniform sampler2D u_Input;
+layout(binding = 1, r32f) uniform writeonly image2D o_Output;
+
+layout(push_constant) uniform Uniforms
+{
+	ivec2 InputSize;
+	ivec2 OutputSize;
+	int InputLevel;
+	int CopyLevel; // 1 when building level 0
+} u_Uniforms;
+
+float FetchDepth(ivec2 coord)
+{
+	return texelFetch(u_Input, min(coord, u_Uniforms.InputSize - 1), u_Uniforms.InputLevel).r;
+}
+
+void main()
+{
+	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+	if (coord.x >= u_Uniforms.OutputSize.x || coord.y >= u_Uniforms.OutputSize.y)
+		return;
+
+	if (u_Uniforms.CopyLevel == 1)
+	{
+		imageStore(o_Output, coord, vec4(FetchDepth(coord)));
+		return;
+	}
+
+	ivec2 inputCoord = coord * 2;
+	float depth = max(max(FetchDepth(inputCoord), FetchDepth(inputCoord + ivec2(1, 0))),
+	                  max(FetchDepth(inputCoord + ivec2(0, 1)), FetchDepth(inputCoord + ivec2(1, 1))));
+
+	// Odd sized inputs have one extra row/column that would otherwise fall between two output texels
+	bool extraColumn = (u_Uniforms.InputSize.x & 1) != 0 && coord.x == u_Uniforms.OutputSize.x - 1;
+	bool extraRow = (u_Uniforms.InputSize.y & 1) != 0 && coord.y == u_Uniforms.OutputSize.y - 1;
+	if (extraColumn)
+	{
+		depth = max(depth, FetchDepth(inputCoord + ivec2(2, 0)));
+		depth = max(depth, FetchDepth(inputCoord + ivec2(2, 1)));
+	}
+	if (extraRow)
+	{
+		depth = max(depth, FetchDepth(inputCoord + ivec2(0, 2)));
+		depth = max(depth, FetchDepth(inputCoord + ivec2(1, 2)));
+	}
+	if (extraColumn && extraRow)
+		depth = max(depth, FetchDepth(inputCoord + ivec2(2, 2)));
+
+	imageStore(o_Output, coord, vec4(depth));
+}
@@ -0,0 +1,144 @@
+#pragma compute
+#version 450 core
+
+// Bins the lights of the frame into the cluster grid, one invocation per cluster and one work group per depth slice. The grid splits
+// the view frustum into u_ClusterGrid.x * u_ClusterGrid.y tiles on screen and u_ClusterGrid.z slices in depth, the slices are
+// exponential so the ones close to the camera stay thin. Every cluster ends up with an offset and a count into one light index list
+// that the shading passes loop over, see ClusteredLighting.h
+
+#define MAX_LIGHTS_PER_CLUSTER 64 // Has to match ClusteredLighting::MaxLightsPerCluster
+
+layout(local_size_x = 16, local_size_y = 9, local_size_z = 1) in; // Has to match ClusteredLighting::GridSizeX and GridSizeY
+
+struct Light
+{
+	vec4 PositionRadius;
+	vec4 ColorIntensity;
+	vec4 DirectionType; // w: 0 point, 1 spot
+	vec4 SpotCone; // x: cos of the inner angle, y: cos of the outer angle
+};
+
+layout(std140, binding = 2) uniform Lighting
+{
+	mat4 u_ViewMatrix;
+	uvec4 u_ClusterGrid; // xyz: size of the grid, w: light count
+	vec4 u_ClusterDepth; // x: near, y: far, z: slices / log(far / near), w: log(near) * z
+	vec4 u_AmbientColor;
+};
+
+layout(std430, binding = 5) readonly buffer LightBuffer
+{
+	Light u_Lights[];
+};
+
+layout(std430, binding = 6) writeonly buffer ClusterBuffer
+{
+	uvec2 o_Clusters[]; // Offset and count into the light index list
+};
+
+layout(std430, binding = 7) buffer LightIndexBuffer
+{
+	uint u_LightIndexCount;
+	uint u_LightIndices[];
+};
+
+layout(push_constant) uniform Uniforms
+{
+	mat4 InverseProjection;
+	uint MaxLightIndices;
+} u_Culling;
+
+const uint c_GroupSize = gl_WorkGroupSize.x * gl_WorkGroupSize.y;
+
+// Lights are brought into view space once per group and shared by all of its clusters
+shared vec4 s_LightSpheres[c_GroupSize];
+
+vec3 NDCToView(vec2 ndc, float ndcDepth)
+{
+	vec4 position = u_Culling.InverseProjection * vec4(ndc, ndcDepth, 1.0f);
+	return position.xyz / position.w;
+}
+
+// The point on the line going through the tile corner that is depth units in front of the camera, this works for both perspective
+// and orthographic projections
+vec3 PointAtDepth(vec3 nearPoint, vec3 farPoint, float depth)
+{
+	float t = (depth + nearPoint.z) / (nearPoint.z - farPoint.z);
+	return mix(nearPoint, farPoint, t);
+}
+
+bool SphereIntersectsAABB(vec4 sphere, vec3 aabbMin, vec3 aabbMax)
+{
+	vec3 closest = clamp(sphere.xyz, aabbMin, aabbMax);
+	vec3 delta = closest - sphere.xyz;
+
+	return dot(delta, delta) <= sphere.w * sphere.w;
+}
+
+void main()
+{
+	uvec3 clusterCoord = gl_GlobalInvocationID;
+	uint clusterIndex = clusterCoord.x + clusterCoord.y * u_ClusterGrid.x + clusterCoord.z * u_ClusterGrid.x * u_ClusterGrid.y;
+
+	// View space bounds of the cluster
+	vec2 tileSize = 2.0f / vec2(u_ClusterGrid.xy);
+	vec2 tileMin = vec2(-1.0f) + vec2(clusterCoord.xy) * tileSize;
+	vec2 tileMax = tileMin + tileSize;
+
+	float nearClip = u_ClusterDepth.x;
+	float farClip = u_ClusterDepth.y;
+	float sliceNear = nearClip * pow(farClip / nearClip, float(clusterCoord.z) / float(u_ClusterGrid.z));
+	float sliceFar = nearClip * pow(farClip / nearClip, float(clusterCoord.z + 1) / float(u_ClusterGrid.z));
+
+	vec3 aabbMin = vec3(1e30f);
+	vec3 aabbMax = vec3(-1e30f);
+	for (int i = 0; i < 4; i++)
+	{
+		vec2 corner = vec2((i & 1) != 0 ? tileMax.x : tileMin.x, (i & 2) != 0 ? tileMax.y : tileMin.y);
+		vec3 nearPoint = NDCToView(corner, -1.0f);
+		vec3 farPoint = NDCToView(corner, 1.0f);
+
+		vec3 a = PointAtDepth(nearPoint, farPoint, sliceNear);
+		vec3 b = PointAtDepth(nearPoint, farPoint, sliceFar);
+		aabbMin = min(aabbMin, min(a, b));
+		aabbMax = max(aabbMax, max(a, b));
+	}
+
+	uint visibleLights[MAX_LIGHTS_PER_CLUSTER];
+	uint visibleCount = 0;
+
+	uint lightCount = u_ClusterGrid.w;
+	for (uint batchStart = 0; batchStart < lightCount; batchStart += c_GroupSize)
+	{
+		uint lightIndex = batchStart + gl_LocalInvocationIndex;
+		if (lightIndex < lightCount)
+		{
+			Light light = u_Lights[lightIndex];
+			vec3 viewPosition = (u_ViewMatrix * vec4(light.PositionRadius.xyz, 1.0f)).xyz;
+			s_LightSpheres[gl_LocalInvocationIndex] = vec4(viewPosition, light.PositionRadius.w);
+		}
+
+		barrier();
+
+		uint batchCount = min(c_GroupSize, lightCount - batchStart);
+		for (uint i = 0; i < batchCount && visibleCount < MAX_LIGHTS_PER_CLUSTER; i++)
+		{
+			if (SphereIntersectsAABB(s_LightSpheres[i], aabbMin, aabbMax))
+				visibleLights[visibleCount++] = batchStart + i;
+		}
+
+		barrier();
+	}
+
+	// When the list is full the clusters that come last just lose their lights
+	uint offset = atomicAdd(u_LightIndexCount, visibleCount);
+	if (offset >= u_Culling.MaxLightIndices)
+		visibleCount = 0;
+	else
+		visibleCount = min(visibleCount, u_Culling.MaxLightIndices - offset);
+
+	for (uint i = 0; i < visibleCount; i++)
+		u_LightIndices[offset + i] = visibleLights[i];
+
+	o_Clusters[clusterIndex] = uvec2(offset, visibleCount);
+}
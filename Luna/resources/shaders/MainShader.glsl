@@ -7,9 +7,10 @@ layout(location = 1) in vec4 a_Color;
 layout(location = 2) in vec3 a_Normals;
 layout(location = 3) in vec2 a_TexCoords;
 layout(location = 4) in float a_TexIndex;
-layout(location = 5) in float a_TilingFactor;
-layout(location = 6) in int a_Light;
-layout(location = 7) in int a_EntityID;
+layout(location = 5) in float a_TexLayer; // -1 if a_TexIndex is a texture slot, otherwise the layer of sprite array a_TexIndex
+layout(location = 6) in float a_TilingFactor;
+layout(location = 7) in int a_Light;
+layout(location = 8) in int a_EntityID;
 
 layout(std140, binding = 0) uniform Camera // This is the uniform buffer and this is written in vulkan type and vulkan does not support plain uniforms
 {
@@ -30,6 +31,7 @@ layout(location = 0) out VertexOutput Output;
 layout(location = 5) out flat int v_EntityID; // 5 since VertexOutput contains 5 attributes
 layout(location = 6) out flat float TexIndex;
 layout(location = 7) out flat int lightCube;
+layout(location = 8) out flat float TexLayer;
 
 void main()
 {
@@ -38,6 +40,7 @@ void main()
 	Output.Normals = a_Normals;
 	Output.TexCoords = a_TexCoords;
 	TexIndex = a_TexIndex;
+	TexLayer = a_TexLayer;
 	Output.TilingFactor = a_TilingFactor;
 	lightCube = a_Light;
 	v_EntityID = a_EntityID;
@@ -54,6 +57,7 @@ layout(location = 0) out vec4 o_Color;
 layout(location = 1) out int o_EntityID;
 
 layout(binding = 0) uniform sampler2D u_Textures[16];
+layout(binding = 16) uniform sampler2DArray u_TextureArrays[8]; // SpritePacker::FirstArraySlot and SpritePacker::MaxArrays
 
 struct VertexOutput
 {
@@ -68,6 +72,7 @@ layout(location = 0) in VertexOutput Input;
 layout(location = 5) in flat int v_EntityID;
 layout(location = 6) in flat float TexIndex;
 layout(location = 7) in flat int lightCube;
+layout(location = 8) in flat float TexLayer;
 
 void main()
 {
@@ -82,8 +87,11 @@ void main()
 //		FragColor = Input.Color;// This is for light source cubes
 //	}
 	
+	vec2 texCoords = Input.TexCoords * Input.TilingFactor;
+	vec4 texColor = TexLayer < 0.0f ? texture(u_Textures[int(TexIndex)], texCoords) : texture(u_TextureArrays[int(TexIndex)], vec3(texCoords, TexLayer));
+
 	vec3 tempColor = vec3(Input.Color.rgb);
-	FragColor = vec4(vec3(texture(u_Textures[int(TexIndex)], Input.TexCoords * Input.TilingFactor)) * tempColor, Input.Color.a);
+	FragColor = vec4(vec3(texColor) * tempColor, Input.Color.a);
 	o_Color = FragColor;
 	o_EntityID = v_EntityID;
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma compute
+#version 450 core
+
+// GPU side culling of the mesh batch. Every invocation tests one mesh instance against the view frustum and, if enabled, against the
+// Hi-Z buffer of the last frame. Instances that survive get appended to their indirect command (InstanceCount starts at 0) and their
+// draw data is written where the draw index of that command will read it, see GeometryPool.h
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjMatrix;
+	mat4 u_SkyVP;
+};
+
+struct DrawData
+{
+	mat4 Transform;
+	int EntityID;
+	int TextureIndex;
+};
+
+struct CullData
+{
+	DrawData Data;
+	vec4 BoundsMin;
+	vec4 BoundsMax;
+	uint CommandIndex;
+};
+
+struct DrawCommand
+{
+	uint IndexCount;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout(std430, binding = 2) writeonly buffer DrawDataBuffer
+{
+	DrawData o_DrawData[];
+};
+
+layout(std430, binding = 3) readonly buffer CullDataBuffer
+{
+	CullData u_CullData[];
+};
+
+layout(std430, binding = 4) buffer DrawCommandBuffer
+{
+	DrawCommand u_Commands[];
+};
+
+layout(binding = 0) uniform sampler2D u_HiZ;
+
+layout(push_constant) uniform Uniforms
+{
+	mat4 HiZViewProjection; // The Hi-Z buffer is from the last frame so it has to be tested with the camera of that frame
+	ivec2 HiZSize;
+	int HiZMipCount;
+	int OcclusionCulling;
+	uint InstanceCount;
+} u_Cull;
+
+vec3 GetCorner(CullData cullData, int i)
+{
+	return vec3((i & 1) != 0 ? cullData.BoundsMax.x : cullData.BoundsMin.x,
+	            (i & 2) != 0 ? cullData.BoundsMax.y : cullData.BoundsMin.y,
+	            (i & 4) != 0 ? cullData.BoundsMax.z : cullData.BoundsMin.z);
+}
+
+bool IsOutsideFrustum(CullData cullData)
+{
+	mat4 mvp = u_ViewProjMatrix * cullData.Data.Transform;
+
+	// One bit per clip plane, the box is outside if all of its corners are outside the same plane
+	uint outside = 0x3Fu;
+	for (int i = 0; i < 8; i++)
+	{
+		vec4 clip = mvp * vec4(GetCorner(cullData, i), 1.0f);
+
+		uint mask = 0u;
+		mask |= clip.x < -clip.w ? 0x01u : 0u;
+		mask |= clip.x >  clip.w ? 0x02u : 0u;
+		mask |= clip.y < -clip.w ? 0x04u : 0u;
+		mask |= clip.y >  clip.w ? 0x08u : 0u;
+		mask |= clip.z < -clip.w ? 0x10u : 0u;
+		mask |= clip.z >  clip.w ? 0x20u : 0u;
+		outside &= mask;
+	}
+
+	return outside != 0u;
+}
+
+bool IsOccluded(CullData cullData)
+{
+	mat4 mvp = u_Cull.HiZViewProjection * cullData.Data.Transform;
+
+	vec2 ndcMin = vec2(1.0f);
+	vec2 ndcMax = vec2(-1.0f);
+	float nearestDepth = 1.0f;
+	for (int i = 0; i < 8; i++)
+	{
+		vec4 clip = mvp * vec4(GetCorner(cullData, i), 1.0f);
+
+		// Crosses the near plane
+		if (clip.w <= 0.0f)
+			return false;
+
+		vec3 ndc = clip.xyz / clip.w;
+		ndcMin = min(ndcMin, ndc.xy);
+		ndcMax = max(ndcMax, ndc.xy);
+		nearestDepth = min(nearestDepth, ndc.z * 0.5f + 0.5f);
+	}
+
+	vec2 uvMin = clamp(ndcMin * 0.5f + 0.5f, 0.0f, 1.0f);
+	vec2 uvMax = clamp(ndcMax * 0.5f + 0.5f, 0.0f, 1.0f);
+
+	// The level where the rect is at most one texel wide, so it touches at most 2x2 texels
+	vec2 rectSize = (uvMax - uvMin) * vec2(u_Cull.HiZSize);
+	int level = clamp(int(ceil(log2(max(max(rectSize.x, rectSize.y), 1.0f)))), 0, u_Cull.HiZMipCount - 1);
+
+	ivec2 levelSize = max(u_Cull.HiZSize >> level, ivec2(1));
+	ivec2 texelMin = clamp(ivec2(uvMin * vec2(levelSize)), ivec2(0), levelSize - 1);
+	ivec2 texelMax = clamp(ivec2(uvMax * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+	float farthestDepth = max(max(texelFetch(u_HiZ, texelMin, level).r, texelFetch(u_HiZ, ivec2(texelMax.x, texelMin.y), level).r),
+	                          max(texelFetch(u_HiZ, ivec2(texelMin.x, texelMax.y), level).r, texelFetch(u_HiZ, texelMax, level).r));
+
+	return nearestDepth > farthestDepth;
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= u_Cull.InstanceCount)
+		return;
+
+	CullData cullData = u_CullData[index];
+	if (IsOutsideFrustum(cullData))
+		return;
+
+	if (u_Cull.OcclusionCulling == 1 && IsOccluded(cullData))
+		return;
+
+	uint slot = atomicAdd(u_Commands[cullData.CommandIndex].InstanceCount, 1u);
+	o_DrawData[u_Commands[cullData.CommandIndex].BaseInstance + slot] = cullData.Data;
+}
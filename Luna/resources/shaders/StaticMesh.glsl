@@ -0,0 +1,160 @@
+#pragma vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 7) in uint a_DrawIndex; // baseInstance of the indirect command, see GeometryPool.h
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjMatrix;
+	mat4 u_SkyVP;
+};
+
+struct DrawData
+{
+	mat4 Transform;
+	int EntityID;
+	int TextureIndex;
+};
+
+layout(std430, binding = 2) readonly buffer DrawDataBuffer
+{
+	DrawData u_DrawData[];
+};
+
+struct VertexOutput
+{
+	vec3 WorldPosition;
+	vec3 Normal;
+	vec2 TexCoords;
+};
+
+layout(location = 0) out VertexOutput Output;
+layout(location = 3) out flat int v_EntityID;
+layout(location = 4) out flat int v_TextureIndex;
+
+// Has to match StaticMeshDepth.glsl for the depth pre-pass
+invariant gl_Position;
+
+void main()
+{
+	DrawData drawData = u_DrawData[a_DrawIndex];
+
+	vec4 worldPosition = drawData.Transform * vec4(a_Position, 1.0f);
+	Output.WorldPosition = worldPosition.xyz;
+	Output.Normal = mat3(drawData.Transform) * a_Normal;
+	Output.TexCoords = a_TexCoords;
+
+	v_EntityID = drawData.EntityID;
+	v_TextureIndex = drawData.TextureIndex;
+
+	gl_Position = u_ViewProjMatrix * worldPosition;
+}
+
+#pragma fragment
+#version 450 core
+
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec3 WorldPosition;
+	vec3 Normal;
+	vec2 TexCoords;
+};
+
+layout(location = 0) in VertexOutput Input;
+layout(location = 3) in flat int v_EntityID;
+layout(location = 4) in flat int v_TextureIndex;
+
+layout(binding = 0) uniform sampler2D u_Textures[16];
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjMatrix;
+	mat4 u_SkyVP;
+};
+
+struct Light
+{
+	vec4 PositionRadius;
+	vec4 ColorIntensity;
+	vec4 DirectionType; // w: 0 point, 1 spot
+	vec4 SpotCone; // x: cos of the inner angle, y: cos of the outer angle
+};
+
+layout(std140, binding = 2) uniform Lighting
+{
+	mat4 u_ViewMatrix;
+	uvec4 u_ClusterGrid; // xyz: size of the grid, w: light count
+	vec4 u_ClusterDepth; // x: near, y: far, z: slices / log(far / near), w: log(near) * z
+	vec4 u_AmbientColor;
+};
+
+layout(std430, binding = 5) readonly buffer LightBuffer
+{
+	Light u_Lights[];
+};
+
+layout(std430, binding = 6) readonly buffer ClusterBuffer
+{
+	uvec2 u_Clusters[];
+};
+
+layout(std430, binding = 7) readonly buffer LightIndexBuffer
+{
+	uint u_LightIndexCount;
+	uint u_LightIndices[];
+};
+
+// Same as in AuroraPBRStatic.glsl. Only loops over the lights that LightCulling.glsl binned into the cluster of the fragment
+vec3 ComputeLighting(vec3 worldPosition, vec3 normal, vec3 albedo)
+{
+	// Without any lights everything stays fully lit like before there were lights at all
+	if (u_ClusterGrid.w == 0)
+		return albedo;
+
+	vec4 clip = u_ViewProjMatrix * vec4(worldPosition, 1.0f);
+	vec2 ndc = clip.xy / clip.w;
+	float viewDepth = -(u_ViewMatrix * vec4(worldPosition, 1.0f)).z;
+
+	uvec2 tile = uvec2(clamp((ndc * 0.5f + 0.5f) * vec2(u_ClusterGrid.xy), vec2(0.0f), vec2(u_ClusterGrid.xy) - 1.0f));
+	uint slice = uint(clamp(log(max(viewDepth, u_ClusterDepth.x)) * u_ClusterDepth.z - u_ClusterDepth.w, 0.0f, float(u_ClusterGrid.z) - 1.0f));
+	uvec2 cluster = u_Clusters[tile.x + tile.y * u_ClusterGrid.x + slice * u_ClusterGrid.x * u_ClusterGrid.y];
+
+	vec3 result = albedo * u_AmbientColor.rgb;
+	for (uint i = 0; i < cluster.y; i++)
+	{
+		Light light = u_Lights[u_LightIndices[cluster.x + i]];
+
+		vec3 toLight = light.PositionRadius.xyz - worldPosition;
+		float distance = length(toLight);
+		float radius = light.PositionRadius.w;
+		if (distance >= radius)
+			continue;
+
+		vec3 lightDirection = toLight / distance;
+
+		// Inverse square falloff that is windowed to reach exactly 0 at the radius of the light
+		float window = clamp(1.0f - pow(distance / radius, 4.0f), 0.0f, 1.0f);
+		float attenuation = window * window / (distance * distance + 1.0f);
+
+		if (light.DirectionType.w == 1.0f)
+			attenuation *= smoothstep(light.SpotCone.y, light.SpotCone.x, dot(-lightDirection, light.DirectionType.xyz));
+
+		result += albedo * light.ColorIntensity.rgb * light.ColorIntensity.w * max(dot(normal, lightDirection), 0.0f) * attenuation;
+	}
+
+	return result;
+}
+
+void main()
+{
+	vec4 albedo = texture(u_Textures[v_TextureIndex], Input.TexCoords);
+	FragColor = vec4(ComputeLighting(Input.WorldPosition, normalize(Input.Normal), albedo.rgb), albedo.a);
+
+	o_EntityID = v_EntityID;
+}
@@ -0,0 +1,43 @@
+#pragma vertex
+#version 450 core
+
+// Depth only version of StaticMesh.glsl for the depth pre-pass, the position has to be computed with the exact same expression and
+// both are invariant so that the shading pass gets bit identical depths to test against
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 7) in uint a_DrawIndex; // baseInstance of the indirect command, see GeometryPool.h
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjMatrix;
+	mat4 u_SkyVP;
+};
+
+struct DrawData
+{
+	mat4 Transform;
+	int EntityID;
+	int TextureIndex;
+};
+
+layout(std430, binding = 2) readonly buffer DrawDataBuffer
+{
+	DrawData u_DrawData[];
+};
+
+invariant gl_Position;
+
+void main()
+{
+	DrawData drawData = u_DrawData[a_DrawIndex];
+
+	vec4 worldPosition = drawData.Transform * vec4(a_Position, 1.0f);
+	gl_Position = u_ViewProjMatrix * worldPosition;
+}
+
+#pragma fragment
+#version 450 core
+
+void main()
+{
+}
@@ -39,6 +39,9 @@ namespace Aurora {
 
 		EditorResources::Init();
 
+		// Textures and models that are saved while the editor is open show up without restarting it
+		AssetManager::EnableHotReload();
+
 		FramebufferSpecification specification;
 		specification.AttachmentsSpecification = { ImageFormat::RGBA, ImageFormat::R32I, ImageFormat::Depth};
 		specification.Width = 1280;
@@ -48,9 +51,10 @@ namespace Aurora {
 		m_MSAAFramebuffer = Framebuffer::Create(specification);
 
 		FramebufferSpecification spec2;
-		spec2.AttachmentsSpecification = { ImageFormat::RGBA, ImageFormat::R32I };
+		spec2.AttachmentsSpecification = { ImageFormat::RGBA, ImageFormat::R32I, ImageFormat::Depth };
 		spec2.Width = 1280;
 		spec2.Height = 720;
+		spec2.DepthAttachmentAsTexture = true; // Resolved depth is what the Hi-Z buffer is built from
 		m_IntermediateFramebuffer = Framebuffer::Create(spec2);
 
 		m_EditorScene = Scene::Create("Editor Scene");
@@ -59,7 +63,7 @@ namespace Aurora {
 
 		// TODO: This is the screenshot demo that i will continue sometime later
 		//auto data = Utils::ImageLoader::LoadImageFile("Resources/textures/Qiyana2.png");
-		//if (Utils::ImageLoader::WriteDataToPNGImage("Resources/Wassup.png", data.PixelData, data.Width, data.Height, data.Channels))
+		//if (Utils::ImageLoader::WriteDataToPNGImage("Resources/Wassup.png", data.GetPixels(), data.GetWidth(), data.GetHeight(), data.GetChannels()))
 		//	AR_WARN("Wrote Image Correctly");
 
 		// Default open scene for now...!
@@ -143,8 +147,15 @@ namespace Aurora {
 				m_IntermediateFramebuffer->GetSpecification().Width,
 				m_IntermediateFramebuffer->GetSpecification().Height,
 				1);
+
+			Framebuffer::BlitDepth(m_MSAAFramebuffer->GetFramebufferID(),
+				m_IntermediateFramebuffer->GetFramebufferID(),
+				m_IntermediateFramebuffer->GetSpecification().Width,
+				m_IntermediateFramebuffer->GetSpecification().Height);
 		}
 
+		Renderer3D::UpdateOcclusion(m_IntermediateFramebuffer);
+
 		auto [mx, my] = ImGui::GetMousePos();
 		mx -= m_ViewportRect.Min.x;
 		my -= m_ViewportRect.Min.y;
@@ -174,16 +185,16 @@ namespace Aurora {
 
 	void EditorLayer::OnTick()
 	{
-		const std::unordered_map<const char*, float>& mp = Application::GetApp().GetPerformanceProfiler()->GetPerFrameData();
+		uint32_t counterCount = PerformanceProfiler::GetCounterCount();
 
 		m_SortedTimerValues.clear();
-		m_SortedTimerValues.reserve(mp.size());
-		for (auto& [name, val] : mp)
-			m_SortedTimerValues.emplace_back(name, val);
+		m_SortedTimerValues.reserve(counterCount);
+		for (uint32_t i = 0; i < counterCount; i++)
+			m_SortedTimerValues.emplace_back(i, PerformanceProfiler::GetCounterStats(i));
 
-		std::sort(m_SortedTimerValues.begin(), m_SortedTimerValues.end(), [](const std::tuple<const char*, float>& a, const std::tuple<const char*, float>& b) -> bool
+		std::sort(m_SortedTimerValues.begin(), m_SortedTimerValues.end(), [](const std::tuple<uint32_t, PerformanceProfiler::CounterStats>& a, const std::tuple<uint32_t, PerformanceProfiler::CounterStats>& b) -> bool
 		{
-			return std::get<1>(a) > std::get<1>(b);
+			return std::get<1>(a).Avg > std::get<1>(b).Avg;
 		});
 	}
 
@@ -792,6 +803,7 @@ namespace Aurora {
 		if (entity.HasComponent<T>())
 		{
 			T& component = entity.GetComponent<T>();
+			bool edited = false;
 			ImVec2 contentRegionAvail = ImGui::GetContentRegionAvail();
 
 			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2{ 4.0f, 4.0f });
@@ -819,6 +831,7 @@ namespace Aurora {
 				if (ImGui::ImageButton(textureID, ImVec2{ lineHeight - 8.0f, lineHeight - 6.0f }, ImVec2{ 0, 0 }, ImVec2{ 1, 1 }))
 				{
 					resetFunction(component);
+					edited = true;
 				}
 
 				if (ImGui::IsItemHovered())
@@ -832,6 +845,7 @@ namespace Aurora {
 				if (ImGui::ImageButton(textureID, ImVec2{ lineHeight - 8.0f, lineHeight - 6.0f }, ImVec2{ 0, 0 }, ImVec2{ 1, 1 }))
 				{
 					resetFunction(component);
+					edited = true;
 				}
 
 				if (ImGui::IsItemHovered())
@@ -849,12 +863,19 @@ namespace Aurora {
 
 			if (open)
 			{
+				// Grouped so that ImGui can tell whether any of the widgets changed the component
+				ImGui::BeginGroup();
 				uiFunction(component);
+				ImGui::EndGroup();
+				edited |= ImGui::IsItemEdited();
+
 				ImGui::TreePop();
 			}
 
 			if (removeComponent)
 				entity.RemoveComponent<T>();
+			else if (edited && entity.HasComponent<T>())
+				entity.PatchComponent<T>(); // Lets the scene know, static entities have to be baked again
 		}
 	}
 
@@ -996,6 +1017,8 @@ namespace Aurora {
 			DrawPopUpMenuItems<CameraComponent>("Camera", entity, m_SelectionContext);
 			DrawPopUpMenuItems<SpriteRendererComponent>("Sprite Renderer", entity, m_SelectionContext);
 			DrawPopUpMenuItems<ModelComponent>("Model Component", entity, m_SelectionContext);
+			DrawPopUpMenuItems<StaticComponent>("Static", entity, m_SelectionContext);
+			DrawPopUpMenuItems<LightComponent>("Light", entity, m_SelectionContext);
 
 			ImGui::EndPopup();
 		}
@@ -1163,7 +1186,7 @@ namespace Aurora {
 
 		DrawComponent<ModelComponent>("Model", entity, [](ModelComponent& component)
 		{
-			std::string path = component.model.directory;
+			std::string path = component.model ? component.model->directory : std::string();
 			char buffer[256];
 			memset(buffer, 0, sizeof(buffer));
 			strcpy_s(buffer, sizeof(buffer), path.c_str());
@@ -1198,6 +1221,115 @@ namespace Aurora {
 			glm::vec4& color = component.Color;
 			color = glm::vec4(1.0f);
 		});
+
+		DrawComponent<StaticComponent>("Static", entity, [](StaticComponent& component)
+		{
+			ImGui::TextDisabled("Baked into the static batch of the scene");
+		},
+		[](StaticComponent& component) // Reset Function
+		{
+		});
+
+		DrawComponent<LightComponent>("Light", entity, [](LightComponent& component)
+		{
+			ImGui::Columns(2);
+			ImGui::SetColumnWidth(0, 100.0f);
+
+			static const char* lightTypeString[] = { "Point", "Spot" };
+			const char* currentLightTypeString = lightTypeString[(int)component.Type];
+
+			ImGui::Text("Type");
+			ImGui::NextColumn();
+
+			ImGui::PushItemWidth(-1);
+			if (ImGui::BeginCombo("##LightType", currentLightTypeString))
+			{
+				for (int type = 0; type < 2; type++)
+				{
+					bool isSelected = currentLightTypeString == lightTypeString[type];
+					if (ImGui::Selectable(lightTypeString[type], &isSelected))
+						component.Type = (LightType)type;
+
+					if (isSelected)
+						ImGui::SetItemDefaultFocus();
+				}
+
+				ImGui::EndCombo();
+			}
+			ImGui::PopItemWidth();
+
+			ImGui::NextColumn();
+			ImGui::Separator();
+
+			ImGui::Text("Color");
+			ImGui::NextColumn();
+
+			ImGui::PushItemWidth(-1);
+			ImGui::ColorEdit3("##LightColor", glm::value_ptr(component.Color), ImGuiColorEditFlags_PickerHueWheel);
+			ImGui::PopItemWidth();
+
+			ImGui::NextColumn();
+			ImGui::Separator();
+
+			ImGui::Text("Intensity");
+			ImGui::NextColumn();
+
+			ImGui::PushItemWidth(-1);
+			ImGui::DragFloat("##Intensity", &component.Intensity, 0.05f, 0.0f, 1000.0f);
+			ImGui::PopItemWidth();
+
+			ImGui::NextColumn();
+			ImGui::Separator();
+
+			ImGui::Text("Radius");
+			if (ImGui::IsItemHovered())
+				ImGuiUtils::ToolTip("Nothing past this distance is lit");
+
+			ImGui::NextColumn();
+
+			ImGui::PushItemWidth(-1);
+			ImGui::DragFloat("##Radius", &component.Radius, 0.1f, 0.01f, 10000.0f);
+			ImGui::PopItemWidth();
+
+			if (component.Type == LightType::Spot)
+			{
+				ImGui::NextColumn();
+				ImGui::Separator();
+
+				ImGui::Text("Inner Cone");
+				if (ImGui::IsItemHovered())
+					ImGuiUtils::ToolTip("Half angle in degrees");
+
+				ImGui::NextColumn();
+
+				ImGui::PushItemWidth(-1);
+				ImGui::DragFloat("##InnerCone", &component.InnerConeAngle, 0.1f, 0.0f, component.OuterConeAngle);
+				ImGui::PopItemWidth();
+
+				ImGui::NextColumn();
+				ImGui::Separator();
+
+				ImGui::Text("Outer Cone");
+				if (ImGui::IsItemHovered())
+					ImGuiUtils::ToolTip("Half angle in degrees");
+
+				ImGui::NextColumn();
+
+				ImGui::PushItemWidth(-1);
+				ImGui::DragFloat("##OuterCone", &component.OuterConeAngle, 0.1f, component.InnerConeAngle, 89.9f);
+				ImGui::PopItemWidth();
+			}
+
+			ImGui::Columns(1);
+		},
+		[](LightComponent& component) // Reset Function
+		{
+			component.Color = glm::vec3(1.0f);
+			component.Intensity = 1.0f;
+			component.Radius = 10.0f;
+			component.InnerConeAngle = 20.0f;
+			component.OuterConeAngle = 30.0f;
+		});
 	}
 
 #pragma endregion
@@ -1283,6 +1415,16 @@ namespace Aurora {
 		serializer.SerializeToText(path.string());
 	}
 
+	void EditorLayer::BuildAssetPack()
+	{
+		// The mapped pack can not be overwritten, it is mounted again once the new one is written
+		const char* packPath = VirtualFileSystem::GetDefaultPackPath();
+		VirtualFileSystem::Unmount(packPath);
+
+		if (AssetPack::BuildFromDirectory(packPath, "Resources"))
+			VirtualFileSystem::Mount(packPath);
+	}
+
 #pragma endregion
 
 #pragma region RendererPanels
@@ -1317,9 +1459,18 @@ namespace Aurora {
 		//ImGui::Text("Hovered Entity: %s", name.c_str());
 		ImGui::Text("Draw Calls: %d", Renderer3D::GetStats().DrawCalls);
 		ImGui::Text("Quad Count: %d", Renderer3D::GetStats().QuadCount);
+		ImGui::Text("Mesh Count: %d", Renderer3D::GetStats().MeshCount);
+		ImGui::Text("Mesh Draw Commands: %d", Renderer3D::GetStats().MeshDrawCommands);
+		ImGui::Text("Static Quad Count: %d", Renderer3D::GetStats().StaticQuadCount);
+		ImGui::Text("Static Mesh Count: %d", Renderer3D::GetStats().StaticMeshCount);
+		ImGui::Text("Occluded Mesh Count: %d", Renderer3D::GetStats().OccludedMeshCount);
+		ImGui::Text("Light Count: %d", Renderer3D::GetStats().LightCount);
+		ImGui::Text("Packed Sprites: %d (%d arrays)", Renderer3D::GetStats().PackedSpriteCount, Renderer3D::GetStats().SpriteArrayCount);
 		ImGui::Text("Vertex Count: %d", Renderer3D::GetStats().GetTotalVertexCount());
 		ImGui::Text("Index Count: %d", Renderer3D::GetStats().GetTotalIndexCount());
 		ImGui::Text("Vertex Buffer Usage: %.3f Megabytes", Renderer3D::GetStats().GetTotalVertexBufferMemory() / (1024.0f * 1024.0f));
+		ImGui::Text("State Changes Issued: %d", Renderer3D::GetStats().StateChangesIssued);
+		ImGui::Text("State Changes Filtered: %d", Renderer3D::GetStats().StateChangesFiltered);
 
 		static bool wireFrame = false;
 		static bool vertices = false;
@@ -1343,6 +1494,18 @@ namespace Aurora {
 			Application::GetApp().GetWindow().SetVSync(VSyncState);
 		}
 
+		bool depthPrePass = Renderer3D::IsDepthPrePassEnabled();
+		if (ImGui::Checkbox("Depth Pre-Pass", &depthPrePass))
+			Renderer3D::SetDepthPrePass(depthPrePass);
+
+		bool occlusionCulling = Renderer3D::IsOcclusionCullingEnabled();
+		if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling))
+			Renderer3D::SetOcclusionCulling(occlusionCulling);
+
+		bool gpuCulling = Renderer3D::IsGPUCullingEnabled();
+		if (ImGui::Checkbox("GPU Culling", &gpuCulling))
+			Renderer3D::SetGPUCulling(gpuCulling);
+
 		ImGui::End();
 	}
 
@@ -1397,15 +1560,159 @@ namespace Aurora {
 		ImGui::End();
 	}
 
+	void EditorLayer::ShowTextureStreamingPanel()
+	{
+		ImGui::Begin("Texture Streaming", &m_ShowTextureStreamingPanel);
+
+		constexpr float megabyte = 1024.0f * 1024.0f;
+
+		int budget = (int)(TextureStreamer::GetBudget() / (1024 * 1024));
+		if (ImGui::DragInt("Budget (MB)", &budget, 1.0f, 16, 16 * 1024))
+			TextureStreamer::SetBudget((uint64_t)std::max(budget, 16) * 1024 * 1024);
+
+		const TextureStreamer::Statistics& stats = TextureStreamer::GetStats();
+		ImGui::Text("Streamed Textures: %u", stats.TextureCount);
+		ImGui::Text("Resident: %.2f / %.2f Megabytes", stats.ResidentBytes / megabyte, TextureStreamer::GetBudget() / megabyte);
+		ImGui::Text("Pending Loads: %u", stats.PendingLoads);
+		ImGui::Text("Levels Streamed In: %llu", stats.LevelsStreamedIn);
+		ImGui::Text("Levels Evicted: %llu", stats.LevelsEvicted);
+
+		TextureStreamer::GetTextureStats(m_TextureStreamingStats);
+		std::sort(m_TextureStreamingStats.begin(), m_TextureStreamingStats.end(), [](const auto& a, const auto& b) { return a.ResidentBytes > b.ResidentBytes; });
+
+		ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("TextureStreamingTable", 5, tableFlags))
+		{
+			ImGui::TableSetupColumn("Name");
+			ImGui::TableSetupColumn("Size");
+			ImGui::TableSetupColumn("Resident");
+			ImGui::TableSetupColumn("Wanted");
+			ImGui::TableSetupColumn("Memory (MB)");
+			ImGui::TableHeadersRow();
+
+			for (const TextureStreamer::TextureStats& texture : m_TextureStreamingStats)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(texture.Name.c_str());
+				ImGui::TableNextColumn(); ImGui::Text("%ux%u", texture.Width, texture.Height);
+				ImGui::TableNextColumn(); ImGui::Text("%u/%u%s", texture.ResidentLevel, texture.LevelCount - 1, texture.Loading ? " (loading)" : "");
+				ImGui::TableNextColumn(); ImGui::Text("%u", texture.DesiredLevel);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", texture.ResidentBytes / megabyte);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+
+	void EditorLayer::ShowAssetManagerPanel()
+	{
+		ImGui::Begin("Asset Manager", &m_ShowAssetManagerPanel);
+
+		constexpr float megabyte = 1024.0f * 1024.0f;
+
+		bool hotReload = AssetManager::IsHotReloadEnabled();
+		if (ImGui::Checkbox("Hot Reload", &hotReload))
+		{
+			if (hotReload)
+				AssetManager::EnableHotReload();
+			else
+				AssetManager::DisableHotReload();
+		}
+
+		ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("AssetManagerTable", 9, tableFlags))
+		{
+			ImGui::TableSetupColumn("Type");
+			ImGui::TableSetupColumn("Loaded");
+			ImGui::TableSetupColumn("Used");
+			ImGui::TableSetupColumn("Pending");
+			ImGui::TableSetupColumn("Memory (MB)");
+			ImGui::TableSetupColumn("Loads");
+			ImGui::TableSetupColumn("Cache Hits");
+			ImGui::TableSetupColumn("Evictions");
+			ImGui::TableSetupColumn("Reloads");
+			ImGui::TableHeadersRow();
+
+			for (uint32_t type = (uint32_t)AssetType::None + 1; type < (uint32_t)AssetType::Count; type++)
+			{
+				AssetManager::TypeStats stats = AssetManager::GetStats((AssetType)type);
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(AssetManager::AssetTypeToString((AssetType)type));
+				ImGui::TableNextColumn(); ImGui::Text("%u", stats.LoadedCount);
+				ImGui::TableNextColumn(); ImGui::Text("%u", stats.UsedCount);
+				ImGui::TableNextColumn(); ImGui::Text("%u", stats.PendingCount);
+				if (stats.Budget)
+				{
+					ImGui::TableNextColumn(); ImGui::Text("%.2f / %.2f", stats.MemoryUsage / megabyte, stats.Budget / megabyte);
+				}
+				else
+				{
+					ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.MemoryUsage / megabyte);
+				}
+				ImGui::TableNextColumn(); ImGui::Text("%llu", stats.Loads);
+				ImGui::TableNextColumn(); ImGui::Text("%llu", stats.CacheHits);
+				ImGui::TableNextColumn(); ImGui::Text("%llu", stats.Evictions);
+				ImGui::TableNextColumn(); ImGui::Text("%llu", stats.Reloads);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+
 #pragma endregion
 
 #pragma region PerformancePanel
 
 	void EditorLayer::ShowTimers()
 	{
-		for (const auto& [name, value] : m_SortedTimerValues)
+		ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("PerformanceTimersTable", 7, tableFlags))
+		{
+			ImGui::TableSetupColumn("Name");
+			ImGui::TableSetupColumn("Last");
+			ImGui::TableSetupColumn("Min");
+			ImGui::TableSetupColumn("Avg");
+			ImGui::TableSetupColumn("P95");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableSetupColumn("Calls");
+			ImGui::TableHeadersRow();
+
+			for (const auto& [counterID, stats] : m_SortedTimerValues)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(PerformanceProfiler::GetCounterName(counterID));
+				ImGui::TableNextColumn(); ImGui::Text("%.4f", stats.Last);
+				ImGui::TableNextColumn(); ImGui::Text("%.4f", stats.Min);
+				ImGui::TableNextColumn(); ImGui::Text("%.4f", stats.Avg);
+				ImGui::TableNextColumn(); ImGui::Text("%.4f", stats.P95);
+				ImGui::TableNextColumn(); ImGui::Text("%.4f", stats.P99);
+				ImGui::TableNextColumn(); ImGui::Text("%u", stats.LastCallCount);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+
+	void EditorLayer::ShowTimerGraphs()
+	{
+		uint32_t historySize = PerformanceProfiler::GetHistorySize();
+		if (historySize == 0)
+			return;
+
+		uint32_t historyOffset = PerformanceProfiler::GetHistoryOffset();
+		for (const auto& [counterID, stats] : m_SortedTimerValues)
 		{
-			ImGui::Text("%s, %.4f", name, value);
+			char overlay[64];
+			sprintf_s(overlay, "avg %.3f | p95 %.3f | p99 %.3f", stats.Avg, stats.P95, stats.P99);
+
+			// Scale to the max of the history so that spikes are not clipped and the percentiles are readable relative to them
+			ImGui::PlotLines(PerformanceProfiler::GetCounterName(counterID), PerformanceProfiler::GetCounterHistory(counterID), (int)historySize,
+				(int)historyOffset, overlay, 0.0f, stats.Max > 0.0f ? stats.Max * 1.1f : 1.0f, ImVec2{ 0.0f, 50.0f });
 		}
 	}
 
@@ -1430,6 +1737,29 @@ namespace Aurora {
 			ImGui::TreePop();
 		}
 
+		if (ImGui::TreeNodeEx("CPU Timer Graphs", flags & ~ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ShowTimerGraphs();
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::Button("Export CSV"))
+		{
+			std::filesystem::path filepath = Utils::WindowsFileDialogs::SaveFileDialog("CSV File (*.csv)\0*.csv\0");
+			if (!filepath.empty())
+				PerformanceProfiler::ExportToCSV(filepath.string());
+		}
+
+		ImGui::SameLine();
+
+		if (ImGui::Button("Export JSON"))
+		{
+			std::filesystem::path filepath = Utils::WindowsFileDialogs::SaveFileDialog("JSON File (*.json)\0*.json\0");
+			if (!filepath.empty())
+				PerformanceProfiler::ExportToJSON(filepath.string());
+		}
+
 		ImGui::End();
 	}
 
@@ -1617,6 +1947,11 @@ namespace Aurora {
 				if (ImGui::MenuItem("Save As...", "Ctrl+Shift+S"))
 					SaveSceneAs();
 
+				ImGui::Separator();
+
+				if (ImGui::MenuItem("Build Asset Pack"))
+					BuildAssetPack();
+
 				ImGui::EndMenu();
 			}
 
@@ -1640,6 +1975,12 @@ namespace Aurora {
 				if (ImGui::MenuItem("Renderer Stats", NULL, m_ShowRenderStatsUI))
 					m_ShowRenderStatsUI = !m_ShowRenderStatsUI;
 
+				if (ImGui::MenuItem("Texture Streaming", NULL, m_ShowTextureStreamingPanel))
+					m_ShowTextureStreamingPanel = !m_ShowTextureStreamingPanel;
+
+				if (ImGui::MenuItem("Asset Manager", NULL, m_ShowAssetManagerPanel))
+					m_ShowAssetManagerPanel = !m_ShowAssetManagerPanel;
+
 				ImGui::Separator();
 
 				if (ImGui::MenuItem("Renderer Info", NULL, m_ShowRendererVendorInfo)) 
@@ -1760,6 +2101,9 @@ namespace Aurora {
 					break;
 				}
 			}
+
+			// Patched once the drag is over, see ShowViewport
+			m_GizmoEditedEntity = m_SelectionContext;
 		}
 	}
 
@@ -1801,6 +2145,15 @@ namespace Aurora {
 			ManipulateGizmos();
 		}
 
+		// Static entities get baked once with the final transform rather than on every frame of the drag
+		if (m_GizmoEditedEntity && !ImGuizmo::IsUsing())
+		{
+			if (m_GizmoEditedEntity == m_SelectionContext)
+				m_GizmoEditedEntity.PatchComponent<TransformComponent>();
+
+			m_GizmoEditedEntity = Entity::nullEntity;
+		}
+
 		if(m_ShowImGuizmoGrid)
 			ImGuizmo::DrawGrid(glm::value_ptr(m_EditorCamera.GetViewMatrix()), glm::value_ptr(m_EditorCamera.GetProjection()), glm::value_ptr(glm::mat4(1.0f)), 100.0f);
 
@@ -1810,45 +2163,14 @@ namespace Aurora {
 		ImGui::End();
 	}
 
-	// TODO: Probably needs to be changed lol hard work for nothing xD
-	template<typename UIFunction>
-	static void DrawSettingsFeatureCheckbox(const std::string& name, const std::string& description, bool* controller, FeatureControl feature, UIFunction func)
-	{
-		ImGui::Text((name + ":").c_str());
-		ImGui::SameLine();
-		ImGuiUtils::ShowHelpMarker(description.c_str());
-
-		ImGui::Columns(2);
-		ImGui::SetColumnWidth(0, 200.0f);
-		
-		ImGui::Text("Enabled: ");
-		ImGui::NextColumn();
-		ImGui::Checkbox(("##" + name).c_str(), controller);
-
-		ImGui::Columns(1);
-
-		if (!(*controller))
-			RenderCommand::Disable(feature);
-		else
-			RenderCommand::Enable(feature);
-
-		func();
-	}
-
 	// TODO: Probably needs to be changed lol hard work for nothing xD
 	void EditorLayer::ShowSettingsUI()
 	{
 		// TODO: Make it so when someone changes the global settings of the editor they are saved in an auroraeditor.ini file and loaded when reopened
-		// Control settings such as enable back face culling, depth testing, blending, blend function...
+		// Culling, depth testing and blending are part of the pipeline every draw binds, so only the blend equation is left here
 		// TODO: Add explanation in the HelpMarker for each setting in each combo!
-		static bool enableCulling = true;
-		static bool enableBlending = true;
-		static bool enableDepthTesting = true;
 		static bool allowGizmoAxisFlip = true;
 
-		static std::string cullOption = "Back";
-		static std::string blendOption = "One Minus Source Alpha";
-		static std::string depthOption = "Less";
 		static std::string blendEquation = "Add";
 		static float TickDelta = 1.0f;
 
@@ -1886,71 +2208,9 @@ namespace Aurora {
 
 		ImGui::Separator();
 
-		std::string blendDesc = "Blending is the technique that allows and implements the \"Transparency\" within objects.";
-		DrawSettingsFeatureCheckbox("Blending", blendDesc, &enableBlending, FeatureControl::Blending, []()
-		{
-			ImGui::Columns(2);
-			ImGui::SetColumnWidth(0, 200.0f);
-
-			ImGui::Text("Blending Function");
-			ImGui::NextColumn();
-			if (ImGui::BeginCombo("##BlendingFunction", blendOption.c_str()))
-			{
-				if (ImGui::Selectable("Zero"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::Zero);
-					blendOption = "Zero";
-				}
-
-				else if (ImGui::Selectable("One"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::One);
-					blendOption = "One";
-				}
-
-				else if (ImGui::Selectable("Source Color"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::SrcColor);
-					blendOption = "Source Color";
-				}
-
-				else if (ImGui::Selectable("Source Alpha"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::SrcAlpha);
-					blendOption = "Source Alpha";
-				}
-
-				else if (ImGui::Selectable("Destination Color"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::DstColor);
-					blendOption = "Destination Color";
-				}
-
-				else if (ImGui::Selectable("One Minus Source Color"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::OneMinusSrcColor);
-					blendOption = "One Minus Source Color";
-				}
-
-				else if (ImGui::Selectable("One Minus Source Alpha"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::OneMinusSrcAlpha);
-					blendOption = "One Minus Source Alpha";
-				}
-
-				else if (ImGui::Selectable("One Minus Destination Color"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Blending, OpenGLFunction::OneMinusDstColor);
-					blendOption = "One Minus Destination Color";
-				}
-
-				ImGui::Columns(1);
-				ImGui::EndCombo();
-			}
-		});
-
 		// Blend equation
-		ImGui::NextColumn();
+		ImGui::Columns(2);
+		ImGui::SetColumnWidth(0, 200.0f);
 		ImGui::Text("Blending Equation");
 		ImGui::NextColumn();
 		if (ImGui::BeginCombo("##BlendingEquation", blendEquation.c_str())) // TODO: Fix the naming to display in the combo label
@@ -1985,111 +2245,9 @@ namespace Aurora {
 				blendEquation = "Maximum";
 			}
 
-			ImGui::Columns(1);
 			ImGui::EndCombo();
 		}
-
-		ImGui::Separator();
-
 		ImGui::Columns(1);
-		std::string cullingDesc = "Culling is used to specify to the renderer what face is not to be processed thus reducing processing time.";
-		DrawSettingsFeatureCheckbox("Culling", cullingDesc, &enableCulling, FeatureControl::Culling, []()
-		{
-			ImGui::Columns(2);
-			ImGui::SetColumnWidth(0, 200.0f);
-
-			ImGui::Text("Culling Function");
-			ImGui::NextColumn();
-			if (ImGui::BeginCombo("##CullingFunction", cullOption.c_str())) // TODO: Fix the naming to display in the combo label
-			{
-				if (ImGui::Selectable("Back"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Culling, OpenGLFunction::Back);
-					cullOption = "Back";
-				}
-
-				else if (ImGui::Selectable("Front"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Culling, OpenGLFunction::Front);
-					cullOption = "Front";
-				}
-
-				else if (ImGui::Selectable("Front and Back"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::Culling, OpenGLFunction::FrontAndBack);
-					cullOption = "FronAndBack";
-				}
-
-				ImGui::EndCombo();
-			}
-			ImGui::Columns(1);
-
-		});
-
-		ImGui::Separator();
-
-		std::string depthDesc = "Depth testing is what allows for 3D objects to appear on the screen via a depth buffer.";
-		DrawSettingsFeatureCheckbox("DepthTesting", depthDesc, &enableDepthTesting, FeatureControl::DepthTesting, []()
-		{
-			ImGui::Columns(2);
-			ImGui::SetColumnWidth(0, 200.0f);
-
-			ImGui::Text("Depth Function");
-			ImGui::NextColumn();
-			if (ImGui::BeginCombo("##DepthFunction", depthOption.c_str()))
-			{
-				if (ImGui::Selectable("Never"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Never);
-					depthOption = "Never";
-				}
-
-				else if (ImGui::Selectable("Equal"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Equal);
-					depthOption = "Equal";
-				}
-
-				else if (ImGui::Selectable("Not Equal"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::NotEqual);
-					depthOption = "Not Equal";
-				}
-
-				else if (ImGui::Selectable("Less"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Less);
-					depthOption = "Less";
-				}
-
-				if (ImGui::Selectable("Less Or Equal"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::LessOrEqual);
-					depthOption = "Less Or Equal";
-				}
-
-				else if (ImGui::Selectable("Greater"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Greater);
-					depthOption = "Greater";
-				}
-
-				else if (ImGui::Selectable("Greater Or Equal"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::GreaterOrEqual);
-					depthOption = "Greater Or Equal";
-				}
-
-				else if (ImGui::Selectable("Always"))
-				{
-					RenderCommand::SetFeatureControlFunction(FeatureControl::DepthTesting, OpenGLFunction::Always);
-					depthOption = "Always";
-				}
-
-				ImGui::EndCombo();
-			}
-			ImGui::Columns(1);
-		});
 
 		ImGui::End();
 	}
@@ -2167,6 +2325,12 @@ namespace Aurora {
 		if (m_ShowShadersPanel)
 			ShowShadersPanel();
 
+		if (m_ShowTextureStreamingPanel)
+			ShowTextureStreamingPanel();
+
+		if (m_ShowAssetManagerPanel)
+			ShowAssetManagerPanel();
+
 		if (m_ShowPerformance)
 			ShowPerformanceUI();
 
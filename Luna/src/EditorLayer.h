@@ -44,18 +44,24 @@ namespace Aurora {
 		void ShowRendererVendorInfoUI();
 		//void ShowRendererOverlay(); // To be implemented later
 		void ShowShadersPanel();
+		void ShowTextureStreamingPanel();
+		void ShowAssetManagerPanel();
 
 		bool m_ShowRendererVendorInfo = false;
 		bool m_ShowRenderStatsUI = true;
 		//bool m_ShowRendererOverlay = false;
 		bool m_ShowShadersPanel = true;
+		bool m_ShowTextureStreamingPanel = false;
+		std::vector<TextureStreamer::TextureStats> m_TextureStreamingStats;
+		bool m_ShowAssetManagerPanel = false;
 
 	// Performance Panel
 	private:
 		void ShowTimers();
+		void ShowTimerGraphs();
 		void ShowPerformanceUI();
 
-		std::vector<std::tuple<const char*, float>> m_SortedTimerValues;
+		std::vector<std::tuple<uint32_t, PerformanceProfiler::CounterStats>> m_SortedTimerValues;
 		bool m_ShowPerformance = true;
 		float m_Peak = 0;
 
@@ -88,6 +94,7 @@ namespace Aurora {
 		void SaveScene();
 		void SaveSceneAs();
 		void SerializeScene(const Ref<Scene>& scene, const std::filesystem::path& path);
+		void BuildAssetPack();
 
 		std::filesystem::path m_EditorScenePath;
 
@@ -123,6 +130,7 @@ namespace Aurora {
 		ImVec2 m_ViewportSize = { 0.0f, 0.0f };
 
 		int16_t m_GizmoType = -1;
+		Entity m_GizmoEditedEntity; // Moved by the gizmo during the current drag
 
 		bool m_ViewportFocused = false;
 		bool m_ViewportHovered = false;
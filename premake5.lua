@@ -35,4 +35,8 @@ group ""
 
 group "Runtime"
     include "SandBox"
-group "Runtime"
\ No newline at end of file
+group ""
+
+group "Tools"
+    include "AuroraCook"
+group ""
\ No newline at end of file